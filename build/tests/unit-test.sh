@@ -22,7 +22,7 @@ check_python_version
 PDO_LOG_LEVEL=${PDO_LOG_LEVEL:-info}
 
 # -----------------------------------------------------------------
-yell run unit tests for python, common, contracts and eservice
+yell run unit tests for python, common, contracts, eservice and pservice
 # -----------------------------------------------------------------
 say run unit tests for python package
 cd ${PDO_SOURCE_ROOT}/python
@@ -36,6 +36,10 @@ say run unit tests for eservice
 cd ${PDO_SOURCE_ROOT}/eservice
 try make TEST_LOG_LEVEL=${PDO_LOG_LEVEL} test > /dev/null
 
+say run unit tests for pservice
+cd ${PDO_SOURCE_ROOT}/pservice
+try make TEST_LOG_LEVEL=${PDO_LOG_LEVEL} test > /dev/null
+
 say run unit tests for contracts
 cd ${PDO_SOURCE_ROOT}/contracts
 try make TEST_LOG_LEVEL=${PDO_LOG_LEVEL} test > /dev/null
@@ -43,6 +47,18 @@ try make TEST_LOG_LEVEL=${PDO_LOG_LEVEL} test > /dev/null
 # -----------------------------------------------------------------
 yell start tests without provisioning or enclave services
 # -----------------------------------------------------------------
+say start block store test
+try pdo-test-block-store --logfile __screen__ --loglevel ${PDO_LOG_LEVEL}
+
+say start contract state test
+try pdo-test-contract-state --logfile __screen__ --loglevel ${PDO_LOG_LEVEL}
+
+say start submitter test
+try pdo-test-submitter --logfile __screen__ --loglevel ${PDO_LOG_LEVEL}
+
+say start speculative evaluation test
+try pdo-test-speculative --logfile __screen__ --loglevel ${PDO_LOG_LEVEL}
+
 say start request test
 try pdo-test-request --no-ledger --iterations 100 \
     --logfile __screen__ --loglevel ${PDO_LOG_LEVEL}
@@ -70,6 +86,12 @@ for test_file in ${PDO_SOURCE_ROOT}/build/tests/${INTERPRETER_NAME}/*.json ; do
         --logfile __screen__ --loglevel ${PDO_LOG_LEVEL}
 done
 
+say start test mock-contract without services with a custom state layout
+try pdo-test-contract --no-ledger --contract mock-contract \
+    --expressions ${PDO_SOURCE_ROOT}/build/tests/common/mock-contract.json \
+    --data-node-size 4096 --extent-threshold 512 \
+    --logfile __screen__ --loglevel ${PDO_LOG_LEVEL}
+
 say start request test with tampered block order, this should fail
 pdo-test-request --no-ledger \
     --tamper-block-order \
@@ -0,0 +1,259 @@
+#!/usr/bin/env python
+
+# Copyright 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Measure the rate at which the PDO TP commits contract state updates.
+
+The test registers a synthetic enclave and a synthetic contract, then
+commits a chain of signed state updates either one update per ccl_update
+transaction or several updates per ccl_update_batch transaction. The
+enclave keys are generated locally so the ledger must accept enclave
+registration without attestation (the default for a virtual-mode node
+once the attestation policy has been registered).
+"""
+
+import argparse
+import base64
+import hashlib
+import json
+import os
+import sys
+import time
+
+from cryptography.hazmat.backends import default_backend
+from cryptography.hazmat.primitives import hashes
+from cryptography.hazmat.primitives import serialization
+from cryptography.hazmat.primitives.asymmetric import ec
+
+from ccf.clients import CCFClient
+
+from utils import parse_ledger_url
+# pick up the logger used by the rest of CCF
+from loguru import logger as LOG
+
+## -----------------------------------------------------------------
+ContractHome = os.environ.get("PDO_HOME") or os.path.realpath("/opt/pdo")
+CCF_Etc = os.path.join(ContractHome, "ccf", "etc")
+CCF_Keys = os.environ.get("PDO_LEDGER_KEY_ROOT") or os.path.join(ContractHome, "ccf", "keys")
+
+# -----------------------------------------------------------------
+class SigningKey(object) :
+    """ECDSA key pair in the format used by PDO for enclave and client keys"""
+
+    def __init__(self) :
+        self.private_key = ec.generate_private_key(ec.SECP256K1(), default_backend())
+        self.verifying_key = self.private_key.public_key().public_bytes(
+            serialization.Encoding.PEM,
+            serialization.PublicFormat.SubjectPublicKeyInfo).decode('ascii')
+
+    def sign(self, message) :
+        if isinstance(message, str) :
+            message = message.encode('ascii')
+        return self.private_key.sign(bytes(message), ec.ECDSA(hashes.SHA256()))
+
+# -----------------------------------------------------------------
+def random_hash() :
+    return hashlib.sha256(os.urandom(32)).digest()
+
+# -----------------------------------------------------------------
+def submit(client, method, params) :
+    response = client.post("/app/" + method, params, log_capture=[])
+    if response.status_code != 200 :
+        raise Exception('{0} failed: {1}'.format(method, response.body))
+    return response.body.json()
+
+# -----------------------------------------------------------------
+def create_contract(client, enclave_keys, creator_keys) :
+    """register an enclave and a contract, initialize the contract state
+
+    :return: tuple (contract id, contract code hash, initial state hash)
+    """
+
+    # register the enclave, the creator acts as the enclave hosting service
+    params = dict()
+    params['verifying_key'] = enclave_keys.verifying_key
+    params['encryption_key'] = enclave_keys.verifying_key
+    params['proof_data'] = ''
+    params['enclave_persistent_id'] = 'ignored field, no proof data'
+    params['registration_block_context'] = ''
+    params['organizational_info'] = ''
+    params['EHS_verifying_key'] = creator_keys.verifying_key
+    message = creator_keys.verifying_key
+    for field in ['verifying_key', 'encryption_key', 'proof_data', 'enclave_persistent_id',
+                  'registration_block_context', 'organizational_info'] :
+        message += params[field]
+    params['signature'] = list(creator_keys.sign(message))
+    submit(client, "register_enclave", params)
+
+    # register the contract
+    code_hash = random_hash()
+    nonce = time.time().hex()
+    signature = creator_keys.sign(creator_keys.verifying_key.encode('ascii') + code_hash + nonce.encode('ascii'))
+    contract_id = base64.b64encode(hashlib.sha256(signature).digest()).decode('ascii')
+
+    params = dict()
+    params['contract_code_hash'] = list(code_hash)
+    params['contract_creator_verifying_key_PEM'] = creator_keys.verifying_key
+    params['nonce'] = nonce
+    params['signature'] = list(signature)
+    params['contract_id'] = contract_id
+    params['provisioning_service_ids'] = []
+    submit(client, "register_contract", params)
+
+    # add the enclave to the contract
+    encrypted_state_key = os.urandom(32)
+    enclave_signature = enclave_keys.sign(
+        (contract_id + creator_keys.verifying_key).encode('ascii') + encrypted_state_key)
+
+    enclave_info = dict()
+    enclave_info['contract_enclave_id'] = enclave_keys.verifying_key
+    enclave_info['contract_id'] = contract_id
+    enclave_info['encrypted_state_encryption_key'] = base64.b64encode(encrypted_state_key).decode('ascii')
+    enclave_info['signature'] = base64.b64encode(enclave_signature).decode('ascii')
+    enclave_info['provisioning_key_state_secret_pairs'] = []
+
+    params = dict()
+    params['contract_id'] = contract_id
+    params['enclave_info'] = json.dumps([enclave_info], sort_keys=True)
+    params['signature'] = list(creator_keys.sign(creator_keys.verifying_key + contract_id + params['enclave_info']))
+    submit(client, "add_enclave_to_contract", params)
+
+    # initialize the contract state
+    nonce = os.urandom(16)
+    initial_state_hash = random_hash()
+    message_hash = random_hash()
+    metadata_hash = random_hash()
+    enclave_signature = enclave_keys.sign(
+        nonce + contract_id.encode('ascii') + code_hash + message_hash +
+        creator_keys.verifying_key.encode('ascii') + metadata_hash + initial_state_hash)
+
+    params = dict()
+    params['nonce'] = list(nonce)
+    params['contract_id'] = contract_id
+    params['initial_state_hash'] = list(initial_state_hash)
+    params['message_hash'] = list(message_hash)
+    params['metadata_hash'] = list(metadata_hash)
+    params['contract_enclave_id'] = enclave_keys.verifying_key
+    params['contract_enclave_signature'] = list(enclave_signature)
+    params['creator_signature'] = list(creator_keys.sign(enclave_signature))
+    submit(client, "ccl_initialize", params)
+
+    return (contract_id, code_hash, initial_state_hash)
+
+# -----------------------------------------------------------------
+def create_updates(enclave_keys, contract_id, code_hash, initial_state_hash, count) :
+    """create a chain of signed ccl_update payloads starting from the initial state"""
+
+    updates = []
+    previous_state_hash = initial_state_hash
+    for _ in range(count) :
+        nonce = os.urandom(16)
+        current_state_hash = random_hash()
+        message_hash = random_hash()
+
+        state_update_info = dict()
+        state_update_info['contract_id'] = contract_id
+        state_update_info['current_state_hash'] = list(current_state_hash)
+        state_update_info['previous_state_hash'] = list(previous_state_hash)
+        state_update_info['message_hash'] = list(message_hash)
+        state_update_info['dependency_list'] = []
+
+        enclave_signature = enclave_keys.sign(
+            nonce + contract_id.encode('ascii') + code_hash + message_hash + previous_state_hash + current_state_hash)
+
+        params = dict()
+        params['nonce'] = list(nonce)
+        params['state_update_info'] = json.dumps(state_update_info, sort_keys=True)
+        params['contract_enclave_id'] = enclave_keys.verifying_key
+        params['contract_enclave_signature'] = list(enclave_signature)
+        updates.append(params)
+
+        previous_state_hash = current_state_hash
+
+    return updates
+
+# -----------------------------------------------------------------
+def update_load_test(client, options) :
+    enclave_keys = SigningKey()
+    creator_keys = SigningKey()
+
+    (contract_id, code_hash, initial_state_hash) = create_contract(client, enclave_keys, creator_keys)
+    updates = create_updates(enclave_keys, contract_id, code_hash, initial_state_hash, options.num_updates)
+
+    committed = 0
+    start_time = time.time()
+
+    if options.batch_size <= 1 :
+        for params in updates :
+            submit(client, "ccl_update", params)
+            committed += 1
+    else :
+        for first in range(0, len(updates), options.batch_size) :
+            params = dict()
+            params['updates'] = updates[first:first+options.batch_size]
+            params['atomic'] = not options.per_item
+            result = submit(client, "ccl_update_batch", params)
+            committed += len([r for r in result['results'] if r['status']])
+
+    end_time = time.time()
+
+    total_time = end_time - start_time
+    commit_throughput = committed/total_time
+
+    LOG.info("Committed {0} of {1} updates with batch size {2}. Average throughput is {3} commits per second".format(
+        committed, options.num_updates, max(1, options.batch_size), commit_throughput))
+
+# -----------------------------------------------------------------
+def Main() :
+    parser = argparse.ArgumentParser(description='Script to measure the contract state update rate of the PDO TP')
+
+    parser.add_argument('--logfile', help='Name of the log file, __screen__ for standard output', type=str)
+    parser.add_argument('--loglevel', help='Logging level', default='INFO', type=str)
+    parser.add_argument('--num-updates', help="Number of state updates to commit", default = 1000, type=int)
+    parser.add_argument('--batch-size', help="Number of updates per transaction, 1 uses ccl_update", default = 1, type=int)
+    parser.add_argument('--per-item', help="Report per update status instead of failing the whole batch", action='store_true')
+
+    options = parser.parse_args()
+
+    # -----------------------------------------------------------------
+    LOG.remove()
+    LOG.add(sys.stderr, level=options.loglevel)
+
+    # -----------------------------------------------------------------
+    network_cert = os.path.join(CCF_Keys, "networkcert.pem")
+
+    host, port = parse_ledger_url()
+
+    try :
+        user_client = CCFClient(
+            host,
+            port,
+            network_cert)
+    except Exception as e:
+        LOG.error('failed to connect to CCF service: {}'.format(str(e)))
+        sys.exit(-1)
+
+    try :
+        update_load_test(user_client, options)
+    except Exception as e:
+        LOG.error('update load test failed: {}'.format(str(e)))
+        sys.exit(-1)
+
+    sys.exit(0)
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+Main()
@@ -38,6 +38,7 @@ namespace ccf
     vector<uint8_t> previous_state_hash;
     vector<uint8_t> message_hash;
     vector<ContractStateDependecy> dependency_list;
+    uint64_t sequence_number = 0; // position of the state in the contract history, the initial state is 0
   };
 
   DECLARE_JSON_TYPE(ContractStateInfo);
@@ -46,6 +47,10 @@ namespace ccf
     previous_state_hash, 
     message_hash,
     dependency_list);
+  // optional so that entries written before sequence numbers were recorded still
+  // parse; they are numbered when the contract is next updated
+  DECLARE_JSON_OPTIONAL_FIELDS(ContractStateInfo,
+    sequence_number);
 
   struct StateUpdateInfo {
     string contract_id;
@@ -87,6 +92,26 @@ namespace ccf
 
   };
 
+  // a batch of state updates applied in a single ledger transaction, updates
+  // are applied in order so later updates may extend the state of earlier ones;
+  // when atomic is set the first failure discards the whole batch, otherwise
+  // each update reports its own status
+  struct Update_contract_state_result {
+    bool status;
+    string message;
+  };
+
+  struct Update_contract_states {
+    struct In{
+      vector<Update_contract_state::In> updates;
+      bool atomic;
+    };
+
+    struct Out {
+      vector<Update_contract_state_result> results;
+    };
+  };
+
   struct Get_current_state_info {
       struct In{
           string contract_id;
@@ -100,6 +125,52 @@ namespace ccf
       };
   };
 
+  // state info for several contracts, contracts that are unknown or not yet
+  // initialized are left out of the response
+  struct Current_state_info {
+      string contract_id;
+      string state_hash;
+      bool is_active;
+      string signature;
+  };
+
+  struct Get_current_state_info_for_contracts {
+      struct In{
+          vector<string> contract_ids;
+      };
+
+      struct Out {
+          vector<Current_state_info> contracts;
+      };
+  };
+
+  // walk the history of a contract backwards; the walk starts at state_hash when
+  // it is not empty, at sequence_number when it is not negative and at the current
+  // state otherwise, and returns at most max_entries states
+  struct State_history_entry {
+      string state_hash;
+      uint64_t sequence_number;
+      string transaction_id;
+      string previous_state_hash;
+      string message_hash;
+      string dependency_list;  //json string
+  };
+
+  struct Get_state_history {
+      struct In {
+          string contract_id;
+          vector<uint8_t> state_hash;
+          int64_t sequence_number;
+          uint64_t max_entries;
+      };
+
+      struct Out {
+          vector<State_history_entry> entries;
+          bool complete; // the last entry is the initial state of the contract
+          string signature;
+      };
+  };
+
   struct Get_state_details {
       struct In {
           string contract_id;
@@ -131,12 +202,92 @@ namespace ccf
   DECLARE_JSON_REQUIRED_FIELDS(Update_contract_state::In, nonce, state_update_info, contract_enclave_id, \
                                contract_enclave_signature);
 
+  // updates submitted through ccl_submit_update whose previous state or dependencies
+  // have not been committed wait in the pending queue until those states arrive or
+  // until the timeout expires
+  struct PendingStateUpdate {
+    Update_contract_state::In update;
+    uint64_t enqueue_time;   // microseconds
+    uint64_t queue_sequence;
+    vector<string> waiting_for;  // ccl keys of the states the update waits for
+  };
+
+  DECLARE_JSON_TYPE(PendingStateUpdate);
+  DECLARE_JSON_REQUIRED_FIELDS(PendingStateUpdate, update, enqueue_time, queue_sequence, waiting_for);
+
+  struct PendingQueueInfo {
+    uint64_t depth;          // includes expired entries that have not been swept yet
+    uint64_t head_sequence;  // no entry older than this is still queued
+    uint64_t next_sequence;
+    uint64_t committed;      // pending updates that were committed
+    uint64_t expired;        // pending updates dropped after the timeout
+    uint64_t rejected;       // pending updates that failed once their dependencies arrived
+    uint64_t total_wait;     // microseconds, over the committed updates
+    uint64_t max_wait;       // microseconds
+  };
+
+  DECLARE_JSON_TYPE(PendingQueueInfo);
+  DECLARE_JSON_REQUIRED_FIELDS(PendingQueueInfo, depth, head_sequence, next_sequence, committed, expired, \
+                               rejected, total_wait, max_wait);
+
+  struct Submit_contract_state_update {
+    struct Out {
+      bool committed;  // false when the update was queued
+    };
+  };
+
+  DECLARE_JSON_TYPE(Submit_contract_state_update::Out);
+  DECLARE_JSON_REQUIRED_FIELDS(Submit_contract_state_update::Out, committed);
+
+  struct Get_pending_update_info {
+    struct Out {
+      uint64_t depth;
+      uint64_t committed;
+      uint64_t expired;
+      uint64_t rejected;
+      uint64_t average_wait_ms;
+      uint64_t max_wait_ms;
+    };
+  };
+
+  DECLARE_JSON_TYPE(Get_pending_update_info::Out);
+  DECLARE_JSON_REQUIRED_FIELDS(Get_pending_update_info::Out, depth, committed, expired, rejected, \
+                               average_wait_ms, max_wait_ms);
+
+  DECLARE_JSON_TYPE(Update_contract_state_result);
+  DECLARE_JSON_REQUIRED_FIELDS(Update_contract_state_result, status, message);
+
+  DECLARE_JSON_TYPE(Update_contract_states::In);
+  DECLARE_JSON_REQUIRED_FIELDS(Update_contract_states::In, updates, atomic);
+
+  DECLARE_JSON_TYPE(Update_contract_states::Out);
+  DECLARE_JSON_REQUIRED_FIELDS(Update_contract_states::Out, results);
+
   DECLARE_JSON_TYPE(Get_current_state_info::In);
   DECLARE_JSON_REQUIRED_FIELDS(Get_current_state_info::In, contract_id);
 
   DECLARE_JSON_TYPE(Get_current_state_info::Out);
   DECLARE_JSON_REQUIRED_FIELDS(Get_current_state_info::Out, state_hash, is_active, signature);
 
+  DECLARE_JSON_TYPE(Current_state_info);
+  DECLARE_JSON_REQUIRED_FIELDS(Current_state_info, contract_id, state_hash, is_active, signature);
+
+  DECLARE_JSON_TYPE(Get_current_state_info_for_contracts::In);
+  DECLARE_JSON_REQUIRED_FIELDS(Get_current_state_info_for_contracts::In, contract_ids);
+
+  DECLARE_JSON_TYPE(Get_current_state_info_for_contracts::Out);
+  DECLARE_JSON_REQUIRED_FIELDS(Get_current_state_info_for_contracts::Out, contracts);
+
+  DECLARE_JSON_TYPE(State_history_entry);
+  DECLARE_JSON_REQUIRED_FIELDS(State_history_entry, state_hash, sequence_number, transaction_id, \
+   previous_state_hash, message_hash, dependency_list);
+
+  DECLARE_JSON_TYPE(Get_state_history::In);
+  DECLARE_JSON_REQUIRED_FIELDS(Get_state_history::In, contract_id, state_hash, sequence_number, max_entries);
+
+  DECLARE_JSON_TYPE(Get_state_history::Out);
+  DECLARE_JSON_REQUIRED_FIELDS(Get_state_history::Out, entries, complete, signature);
+
   DECLARE_JSON_TYPE(Get_state_details::In);
   DECLARE_JSON_REQUIRED_FIELDS(Get_state_details::In, contract_id, state_hash);
 
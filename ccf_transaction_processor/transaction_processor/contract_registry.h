@@ -55,8 +55,8 @@ namespace ccf
     std::vector<uint8_t> contract_metadata_hash;
     string contract_creator_verifying_key_PEM;
     std::vector<string> provisioning_service_ids;
-    std::vector<ContractEnclaveInfo> enclave_info;
     std::vector<uint8_t> current_state_hash;
+    uint64_t state_count = 0; // number of states committed, the next state gets this sequence number
     bool is_active;
   };
 
@@ -67,9 +67,12 @@ namespace ccf
     contract_metadata_hash,
     contract_creator_verifying_key_PEM,
     provisioning_service_ids,
-    enclave_info,
     current_state_hash,
     is_active);
+  // optional so that contracts registered before states were counted still parse;
+  // an initialized contract with a count of 0 is counted on its next update
+  DECLARE_JSON_OPTIONAL_FIELDS(ContractInfo,
+    state_count);
 
   struct Register_contract {
     struct In {
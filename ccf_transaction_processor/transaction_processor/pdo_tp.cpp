@@ -26,10 +26,63 @@ namespace ccfapp
 
     string TPHandlerRegistry ::sign_document(const string& document){
         vector<uint8_t> doc_vector(document.begin(), document.end());
-        auto sign = ledger_signer_local->sign(doc_vector);
+        auto sign = get_ledger_signer()->sign(doc_vector);
         return b64_from_raw(sign.data(), sign.size());
     }
 
+    string TPHandlerRegistry ::sign_document_cached(const string& cache_key, const string& document){
+        {
+            std::lock_guard<std::mutex> guard(signature_cache_lock);
+            auto entry = signature_cache.find(cache_key);
+            if (entry != signature_cache.end() && entry->second.document == document) {
+                return entry->second.signature;
+            }
+        }
+
+        auto signature = sign_document(document);
+
+        std::lock_guard<std::mutex> guard(signature_cache_lock);
+        auto entry = signature_cache.find(cache_key);
+        if (entry != signature_cache.end()) {
+            entry->second = SignedDocument{document, signature};
+            return signature;
+        }
+
+        // evict the oldest query when the cache is full
+        if (signature_cache.size() >= SIGNATURE_CACHE_SIZE) {
+            signature_cache.erase(signature_cache_order.front());
+            signature_cache_order.pop_front();
+        }
+        signature_cache[cache_key] = SignedDocument{document, signature};
+        signature_cache_order.push_back(cache_key);
+        return signature;
+    }
+
+    KeyPairPtr TPHandlerRegistry ::get_ledger_signer(){
+        std::lock_guard<std::mutex> guard(ledger_signer_lock);
+        return ledger_signer_local;
+    }
+
+    bool TPHandlerRegistry ::load_ledger_signer(kv::ReadOnlyTx& tx){
+        // read-only endpoints run concurrently, the signer is created once
+        // under the lock
+        std::lock_guard<std::mutex> guard(ledger_signer_lock);
+        if (ledger_signer_local != NULL) {
+            return true;
+        }
+
+        auto signer_view = tx.ro(signer);
+        auto signer_global = signer_view->get_globally_committed("signer");
+        if (!signer_global.has_value()) {
+            return false;
+        }
+
+        auto key_pair = signer_global.value();
+        auto privk_pem = crypto::Pem(key_pair["privk"]);
+        ledger_signer_local = make_key_pair(privk_pem, nullb);
+        return true;
+    }
+
     string TPHandlerRegistry ::vector_to_string(const vector<uint8_t>& vec){
         string s;
         for (auto v : vec){
@@ -38,12 +91,190 @@ namespace ccfapp
         return s;
     }
 
+    bool TPHandlerRegistry ::apply_contract_state_update(
+        kv::Tx& tx,
+        const Update_contract_state::In& in,
+        string& error_message,
+        vector<string>* missing_states,
+        string* committed_key)
+    {
+        // parse the state update info json string
+        StateUpdateInfo state_update_info;
+        try {
+            auto j = nlohmann::json::parse(in.state_update_info);
+            state_update_info = j.get<StateUpdateInfo>();
+        }
+        catch(...){
+            error_message = "Unable to parse StateUpdateInfo json string";
+            return false;
+        }
+
+        // Capture  the current view of all tables
+        auto contract_view = tx.rw(contracttable);
+        auto enclave_view = tx.rw(enclavetable);
+        auto contract_enclave_view = tx.ro(contractenclavetable);
+        auto ccl_view = tx.rw(ccltable);
+        auto sequence_view = tx.rw(cclsequencetable);
+
+        auto contract_r = contract_view->get(state_update_info.contract_id);
+        auto enclave_r = enclave_view->get(in.contract_enclave_id);
+
+        // ensure that the contract is registered
+        if (!contract_r.has_value()) {
+            error_message = "Contract not yet registered";
+            return false;
+        }
+        auto contract_info = contract_r.value();
+
+        //ensure that the contract is active
+        if (!contract_info.is_active) {
+            error_message = "Contract has been turned inactive. No more upates permitted";
+            return false;
+        }
+
+        // ensure that the enclave is part of the contract (no need to separately check if enclave is registered)
+        if (!contract_enclave_view->get(state_update_info.contract_id + in.contract_enclave_id).has_value()) {
+            error_message = "Enclave used for state update not part of contract";
+            return false;
+        }
+
+        // Ensure the following:
+        // 1. the previous state hash (from incoming data) is the latest state hash known to CCF (this also ensures that
+        //                there was an init)
+        // 2. depedencies are met (meaning these transactions have been committed in the past)
+        // 3. there is a change in state, else nothing to commit
+        // when the caller collects missing states, a previous state or dependency that has
+        // not been committed yet is recorded instead of failing the update immediately
+        vector<string> missing;
+        if (state_update_info.previous_state_hash != contract_info.current_state_hash){
+            string previous_key = state_update_info.contract_id +
+                TPHandlerRegistry ::vector_to_string(state_update_info.previous_state_hash);
+            if (missing_states == nullptr || ccl_view->get(previous_key).has_value()) {
+                error_message = "Update can be performed only on the latest state registered with the ledger";
+                return false;
+            }
+            missing.push_back(previous_key);
+        }
+
+        for (auto dep: state_update_info.dependency_list){
+            string dep_key = dep.contract_id + TPHandlerRegistry ::vector_to_string(dep.state_hash);
+            auto dep_r = ccl_view->get(dep_key);
+            if (!dep_r.has_value()) {
+                if (missing_states == nullptr) {
+                    error_message = "Unknown CCL dependencies. Cannot commit state";
+                    return false;
+                }
+                missing.push_back(dep_key);
+            }
+        }
+
+        if (state_update_info.current_state_hash == contract_info.current_state_hash){
+            error_message = "Update can be commited only if there is a change in state";
+            return false;
+        }
+
+        // verify contract enclave signature. This signature also ensures (via the notion of channel ids) that
+        // the contract invocation was performed by the transaction submitter.
+        if (!verify_enclave_signature_update_contract_state(
+                in.nonce,
+                contract_info.contract_code_hash,
+                state_update_info,
+                in.contract_enclave_signature,
+                this->enclave_pubk_verifier[enclave_r.value().verifying_key]))
+        {
+            error_message = "Invalid enclave signature for contract update operation";
+            return false;
+        }
+
+        if (!missing.empty()) {
+            *missing_states = missing;
+            error_message = "Update depends on states that have not been committed";
+            return false;
+        }
+
+
+        // contracts initialized before states were counted get their sequence numbers now
+        if (contract_info.state_count == 0) {
+            contract_info.state_count = number_contract_states(
+                tx, state_update_info.contract_id, contract_info.current_state_hash);
+        }
+
+        // store update info in ccl tables
+        ContractStateInfo contract_state_info;
+        contract_state_info.transaction_id = in.nonce;
+        contract_state_info.message_hash = state_update_info.message_hash;
+        contract_state_info.previous_state_hash = state_update_info.previous_state_hash;
+        contract_state_info.dependency_list = state_update_info.dependency_list;
+        contract_state_info.sequence_number = contract_info.state_count;
+        string key_for_put =  state_update_info.contract_id +
+            TPHandlerRegistry ::vector_to_string(state_update_info.current_state_hash);
+        ccl_view->put(key_for_put, contract_state_info);
+        sequence_view->put(
+            sequence_key(state_update_info.contract_id, contract_state_info.sequence_number),
+            state_update_info.current_state_hash);
+
+        // update the latest state hash known to CCF (with the incoming state hash)
+        contract_info.current_state_hash = state_update_info.current_state_hash;
+        contract_info.state_count = contract_state_info.sequence_number + 1;
+        contract_view->put(state_update_info.contract_id, contract_info);
+
+        if (committed_key != nullptr) {
+            *committed_key = key_for_put;
+        }
+
+        return true;
+    }
+
+    string TPHandlerRegistry ::sequence_key(const string& contract_id, uint64_t sequence_number){
+        return contract_id + "#" + to_string(sequence_number);
+    }
+
+    // walk the history of a contract back from state_hash to the initial state, record the
+    // sequence number of each state in the ccl and sequence tables and return the number of
+    // states; this runs once for a contract whose states were committed without sequence numbers
+    uint64_t TPHandlerRegistry ::number_contract_states(
+        kv::Tx& tx, const string& contract_id, const vector<uint8_t>& state_hash){
+
+        auto ccl_view = tx.rw(ccltable);
+        auto sequence_view = tx.rw(cclsequencetable);
+
+        vector<vector<uint8_t>> history;
+        vector<uint8_t> hash = state_hash;
+        while (hash.size() > 0) {
+            auto ccl_r = ccl_view->get(contract_id + TPHandlerRegistry ::vector_to_string(hash));
+            if (!ccl_r.has_value()) {
+                break;
+            }
+            history.push_back(hash);
+            hash = ccl_r.value().previous_state_hash;
+        }
+
+        uint64_t count = history.size();
+        for (uint64_t i = 0; i < count; i++) {
+            const auto& current = history[count - 1 - i];
+            string key = contract_id + TPHandlerRegistry ::vector_to_string(current);
+            auto contract_state_info = ccl_view->get(key).value();
+            contract_state_info.sequence_number = i;
+            ccl_view->put(key, contract_state_info);
+            sequence_view->put(sequence_key(contract_id, i), current);
+        }
+
+        return count;
+    }
+
     TPHandlerRegistry ::TPHandlerRegistry (AbstractNodeContext& context):
         UserEndpointRegistry(context),
         attestation_policy_table("attestation_policy"),
         enclavetable("enclaves"),
         contracttable("contracts"),
+        contractenclavetable("contract_enclaves"),
+        contractenclavelist("contract_enclave_ids"),
         ccltable("ccl_updates"),
+        cclsequencetable("ccl_sequence"),
+        pendingtable("pending_updates"),
+        pendingwaiters("pending_waiters"),
+        pendingorder("pending_order"),
+        pendinginfo("pending_info"),
         signer("signer")
     {
         ledger_signer_local = NULL;
@@ -126,6 +357,7 @@ namespace ccfapp
             if (signer_global.has_value()){
                 try{
                     auto key_pair = signer_global.value();
+                    std::lock_guard<std::mutex> guard(ledger_signer_lock);
                     if (ledger_signer_local == NULL){
                         auto privk_pem = crypto::Pem(key_pair["privk"]);
                         ledger_signer_local = make_key_pair(privk_pem, nullb);
@@ -369,6 +601,7 @@ namespace ccfapp
                 new_contract.provisioning_service_ids = in.provisioning_service_ids;
                 new_contract.is_active = true;
                 new_contract.current_state_hash=std::vector<uint8_t>{};
+                new_contract.state_count = 0;
                 }
             catch(...){
                 return ccf::make_error(
@@ -390,8 +623,10 @@ namespace ccfapp
             const auto in = params.get<Add_enclave::In>();
 
             // Capture  the current view of contract and encalve tables
-            auto contract_view = ctx.tx.rw(contracttable);
+            auto contract_view = ctx.tx.ro(contracttable);
             auto enclave_view = ctx.tx.rw(enclavetable);
+            auto contract_enclave_view = ctx.tx.rw(contractenclavetable);
+            auto contract_enclave_list_view = ctx.tx.rw(contractenclavelist);
 
             // ensure that contract was previously registered
             auto contract_r = contract_view->get(in.contract_id);
@@ -427,6 +662,12 @@ namespace ccfapp
                     HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Provide at least one encalve to add to contract");
             }
 
+            auto enclave_ids_r = contract_enclave_list_view->get(in.contract_id);
+            vector<string> enclave_ids;
+            if (enclave_ids_r.has_value()) {
+                enclave_ids = enclave_ids_r.value();
+            }
+
             // check each element of the array
             for (auto enclave_info_temp: enclave_info_array){
 
@@ -444,12 +685,12 @@ namespace ccfapp
                 }
                 auto enclave_info_ledger = enclave_r.value();
 
-                //check if this enclave has already been added to the contract
-                for (auto enclave_in_contract: contract_info.enclave_info){
-                    if (enclave_info_temp.contract_enclave_id == enclave_in_contract.contract_enclave_id) {
-                        return ccf::make_error(
-                            HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Enclave already part of contract");
-                    }
+                //check if this enclave has already been added to the contract, this also catches
+                //enclaves repeated in the request since earlier entries are written below
+                string membership_key = in.contract_id + enclave_info_temp.contract_enclave_id;
+                if (contract_enclave_view->get(membership_key).has_value()) {
+                    return ccf::make_error(
+                        HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Enclave already part of contract");
                 }
 
                 //verify enclave signature
@@ -460,12 +701,13 @@ namespace ccfapp
                     return ccf::make_error( HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Invalid enclave signature");
                 }
 
-                //all good, add enclave to contract
-                contract_info.enclave_info.push_back(enclave_info_temp);
+                //all good, add enclave to contract; the writes are discarded if a later enclave fails
+                contract_enclave_view->put(membership_key, enclave_info_temp);
+                enclave_ids.push_back(enclave_info_temp.contract_enclave_id);
             }
 
             //store the data
-            contract_view->put(in.contract_id, contract_info);
+            contract_enclave_list_view->put(in.contract_id, enclave_ids);
 
             return ccf::make_success(true);
         };
@@ -479,7 +721,9 @@ namespace ccfapp
             // Capture  the current view of all tables
             auto contract_view = ctx.tx.rw(contracttable);
             auto enclave_view = ctx.tx.rw(enclavetable);
+            auto contract_enclave_view = ctx.tx.ro(contractenclavetable);
             auto ccl_view = ctx.tx.rw(ccltable);
+            auto sequence_view = ctx.tx.rw(cclsequencetable);
 
             auto contract_r = contract_view->get(in.contract_id);
             auto enclave_r = enclave_view->get(in.contract_enclave_id);
@@ -504,17 +748,7 @@ namespace ccfapp
             }
 
             // ensure that the enclave is part of the contract (no need to separately check if enclave is registered)
-            bool is_enclave_in_contract = false;
-            for (auto enclave_in_contract: contract_info.enclave_info)
-            {
-                if (in.contract_enclave_id == enclave_in_contract.contract_enclave_id)
-                {
-                    is_enclave_in_contract = true;
-                    break;
-                }
-            }
-
-            if (! is_enclave_in_contract)
+            if (! contract_enclave_view->get(in.contract_id + in.contract_enclave_id).has_value())
             {
                 return ccf::make_error(
                         HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Enclave used for state update not part of contract");
@@ -553,15 +787,21 @@ namespace ccfapp
             contract_state_info.message_hash = in.message_hash;
             contract_state_info.previous_state_hash = {};
             contract_state_info.dependency_list = {};
+            contract_state_info.sequence_number = 0;
 
             string key_for_put = in.contract_id + TPHandlerRegistry ::vector_to_string(in.initial_state_hash);
             ccl_view->put(key_for_put, contract_state_info);
+            sequence_view->put(sequence_key(in.contract_id, 0), in.initial_state_hash);
 
             // update the latest state hash known to CCF (with the incoming state hash)
             contract_info.current_state_hash = in.initial_state_hash;
             contract_info.contract_metadata_hash = in.metadata_hash;
+            contract_info.state_count = 1;
             contract_view->put(in.contract_id, contract_info);
 
+            // pending updates may be waiting for the initial state
+            commit_pending_updates(ctx.tx, key_for_put);
+
             return ccf::make_success(true);
         };
 
@@ -571,128 +811,90 @@ namespace ccfapp
 
             const auto in = params.get<Update_contract_state::In>();
 
-            // parse the state update info json string
-            StateUpdateInfo state_update_info;
-            try {
-                auto j = nlohmann::json::parse(in.state_update_info);
-                state_update_info = j.get<StateUpdateInfo>();
-            }
-            catch(...){
+            string error_message;
+            string committed_key;
+            if (!apply_contract_state_update(ctx.tx, in, error_message, nullptr, &committed_key)) {
                 return ccf::make_error(
-                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to parse StateUpdateInfo json string");
+                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, error_message);
             }
 
-            // Capture  the current view of all tables
-            auto contract_view = ctx.tx.rw(contracttable);
-            auto enclave_view = ctx.tx.rw(enclavetable);
-            auto ccl_view = ctx.tx.rw(ccltable);
+            commit_pending_updates(ctx.tx, committed_key);
 
-            auto contract_r = contract_view->get(state_update_info.contract_id);
-            auto enclave_r = enclave_view->get(in.contract_enclave_id);
+            return ccf::make_success(true);
+        };
 
-            // ensure that the contract is registered
-            if (!contract_r.has_value()) {
-                return ccf::make_error(
-                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Contract not yet registered");
-            }
-            auto contract_info = contract_r.value();
+        //======================================================================================================
+        // submit contract state update handler implementation, an update whose previous state or
+        // dependencies have not been committed is queued until they are
+        auto submit_contract_state_update = [this](auto& ctx, const nlohmann::json& params) {
 
-            //ensure that the contract is active
-            if (!contract_info.is_active) {
-                return ccf::make_error(
-                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Contract has been turned inactive. No more upates permitted");
-            }
+            const auto in = params.get<Update_contract_state::In>();
 
-            // ensure that the enclave is part of the contract (no need to separately check if enclave is registered)
-            bool is_enclave_in_contract = false;
-            for (auto enclave_in_contract: contract_info.enclave_info){
-                if (in.contract_enclave_id == enclave_in_contract.contract_enclave_id) {
-                    is_enclave_in_contract = true;
-                    break;
-                }
-            }
-            if (!is_enclave_in_contract) {
-                return ccf::make_error(
-                        HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Enclave used for state update not part of contract");
+            string error_message;
+            string committed_key;
+            vector<string> missing_states;
+            if (apply_contract_state_update(ctx.tx, in, error_message, &missing_states, &committed_key)) {
+                commit_pending_updates(ctx.tx, committed_key);
+                return ccf::make_success(Submit_contract_state_update::Out{true});
             }
 
-            // Ensure the following:
-            // 1. the previous state hash (from incoming data) is the latest state hash known to CCF (this also ensures that
-            //                there was an init)
-            // 2. depedencies are met (meaning these transactions have been committed in the past)
-            // 3. there is a change in state, else nothing to commit
-            if (state_update_info.previous_state_hash != contract_info.current_state_hash){
+            if (missing_states.empty()) {
                 return ccf::make_error(
-                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Update can be performed only on the latest state registered with the ledger");
+                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, error_message);
             }
 
-            for (auto dep: state_update_info.dependency_list){
-                auto dep_r = ccl_view->get(dep.contract_id +
-                    TPHandlerRegistry ::vector_to_string(dep.state_hash));
-                if (!dep_r.has_value()) {
-                    return ccf::make_error(
-                        HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unknown CCL dependencies. Cannot commit state");
-                }
-            }
-
-            if (state_update_info.current_state_hash == contract_info.current_state_hash){
+            if (!enqueue_pending_update(ctx.tx, in, missing_states, error_message)) {
                 return ccf::make_error(
-                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Update can be commited only if there is a change in state");
+                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, error_message);
             }
 
-            // verify contract enclave signature. This signature also ensures (via the notion of channel ids) that
-            // the contract invocation was performed by the transaction submitter.
-            if (!verify_enclave_signature_update_contract_state(
-                    in.nonce,
-                    contract_info.contract_code_hash,
-                    state_update_info,
-                    in.contract_enclave_signature,
-                    this->enclave_pubk_verifier[enclave_r.value().verifying_key]))
-            {
-                return ccf::make_error(
-                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Invalid enclave signature for contract update operation");
-            }
+            return ccf::make_success(Submit_contract_state_update::Out{false});
+        };
 
+        //======================================================================================================
+        // batched update contract state handler implementation, all updates are applied in a single transaction
+        auto update_contract_states = [this](auto& ctx, const nlohmann::json& params) {
 
-            // store update info in ccl tables
-            ContractStateInfo contract_state_info;
-            contract_state_info.transaction_id = in.nonce;
-            contract_state_info.message_hash = state_update_info.message_hash;
-            contract_state_info.previous_state_hash = state_update_info.previous_state_hash;
-            contract_state_info.dependency_list = state_update_info.dependency_list;
-            string key_for_put =  state_update_info.contract_id +
-                TPHandlerRegistry ::vector_to_string(state_update_info.current_state_hash);
-            ccl_view->put(key_for_put, contract_state_info);
+            const auto in = params.get<Update_contract_states::In>();
 
-            // update the latest state hash known to CCF (with the incoming state hash)
-            contract_info.current_state_hash = state_update_info.current_state_hash;
-            contract_view->put(state_update_info.contract_id, contract_info);
+            if (in.updates.empty() || in.updates.size() > MAX_STATE_UPDATES_PER_BATCH) {
+                return ccf::make_error(
+                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Invalid number of updates in batch");
+            }
 
-            return ccf::make_success(true);
+            // failed updates write nothing, so the successful ones are committed as a group when the
+            // batch is not atomic; an error response discards every write made by the transaction
+            Update_contract_states::Out out;
+            for (size_t i = 0; i < in.updates.size(); i++) {
+                Update_contract_state_result result;
+                string committed_key;
+                result.status = apply_contract_state_update(ctx.tx, in.updates[i], result.message, nullptr, &committed_key);
+                if (result.status) {
+                    commit_pending_updates(ctx.tx, committed_key);
+                }
+                else if (in.atomic) {
+                    return ccf::make_error(
+                        HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput,
+                        "Update " + to_string(i) + " failed: " + result.message);
+                }
+                out.results.push_back(result);
+            }
 
+            return ccf::make_success(out);
         };
 
         ///======================================================================================================
         // verify enclave handler implementation
         auto verify_enclave = [this](auto& ctx, const nlohmann::json& params) {
             const auto in = params.get<Verify_enclave::In>();
-            auto enclave_view = ctx.tx.rw(enclavetable);
+            auto enclave_view = ctx.tx.ro(enclavetable);
             auto enclave_r = enclave_view->get_globally_committed(in.enclave_id);
 
             if (enclave_r.has_value())
             {
-                if (ledger_signer_local == NULL) {
-                    auto signer_view = ctx.tx.rw(signer);
-                    auto signer_global = signer_view->get_globally_committed("signer");
-                    if (signer_global.has_value()){
-                        auto key_pair = signer_global.value();
-                        auto privk_pem = crypto::Pem(key_pair["privk"]);
-                        ledger_signer_local = make_key_pair(privk_pem, nullb);
-                    }
-                    else {
-                        return ccf::make_error(
-                            HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
-                    }
+                if (!load_ledger_signer(ctx.tx)) {
+                    return ccf::make_error(
+                        HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
                 }
 
                 string doc_to_sign;
@@ -716,25 +918,29 @@ namespace ccfapp
         // get_contract_provisioning_info handler implementation
         auto get_contract_provisioning_info = [this](auto& ctx, const nlohmann::json& params) {
             const auto in = params.get<Get_contract_provisioning_info::In>();
-            auto view = ctx.tx.rw(contracttable);
+            auto view = ctx.tx.ro(contracttable);
             auto contract_r = view->get_globally_committed(in.contract_id);
 
             if (contract_r.has_value())
             {
-                if (ledger_signer_local == NULL) {
-                    auto signer_view = ctx.tx.rw(signer);
-                    auto signer_global = signer_view->get_globally_committed("signer");
-                    if (signer_global.has_value()){
-                        auto key_pair = signer_global.value();
-                        auto privk_pem = crypto::Pem(key_pair["privk"]);
-                        ledger_signer_local = make_key_pair(privk_pem, nullb);
-                    }
-                    else {
-                        return ccf::make_error(
-                            HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
+                // collect the enclaves in the order they were added to the contract
+                auto contract_enclave_view = ctx.tx.ro(contractenclavetable);
+                auto enclave_ids_r = ctx.tx.ro(contractenclavelist)->get_globally_committed(in.contract_id);
+                vector<ContractEnclaveInfo> enclaves_info;
+                if (enclave_ids_r.has_value()) {
+                    for (auto enclave_id : enclave_ids_r.value()) {
+                        auto enclave_r = contract_enclave_view->get_globally_committed(in.contract_id + enclave_id);
+                        if (enclave_r.has_value()) {
+                            enclaves_info.push_back(enclave_r.value());
+                        }
                     }
                 }
 
+                if (!load_ledger_signer(ctx.tx)) {
+                    return ccf::make_error(
+                        HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
+                }
+
                 auto contract_code_hash = contract_r.value().contract_code_hash;
                 auto encoded_code_hash = b64_from_raw(contract_code_hash.data(), contract_code_hash.size());
 
@@ -747,7 +953,7 @@ namespace ccfapp
                 nlohmann::json serializer;
                 serializer["contract_id"] = in.contract_id;
                 serializer["contract_creator"] = contract_r.value().contract_creator_verifying_key_PEM;
-                serializer["enclaves_info"] = contract_r.value().enclave_info;
+                serializer["enclaves_info"] = enclaves_info;
                 serializer["provisioning_services"] = contract_r.value().provisioning_service_ids;
                 doc_to_sign = serializer.dump();
 
@@ -755,7 +961,7 @@ namespace ccfapp
 
                 return ccf::make_success(Get_contract_provisioning_info::Out{contract_r.value().contract_creator_verifying_key_PEM,
                             contract_r.value().provisioning_service_ids,
-                            contract_r.value().enclave_info, signature});
+                            enclaves_info, signature});
             }
             return ccf::make_error(HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Contract not found");
 
@@ -766,7 +972,7 @@ namespace ccfapp
         auto get_contract_info = [this](auto& ctx, const nlohmann::json& params) {
 
             const auto in = params.get<Get_current_state_info::In>();
-            auto view = ctx.tx.rw(contracttable);
+            auto view = ctx.tx.ro(contracttable);
             auto contract_r = view->get_globally_committed(in.contract_id);
 
             if (! contract_r.has_value())
@@ -774,18 +980,9 @@ namespace ccfapp
                 return ccf::make_error(HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Contract not found");
             }
 
-            if (ledger_signer_local == NULL) {
-                auto signer_view = ctx.tx.rw(signer);
-                auto signer_global = signer_view->get_globally_committed("signer");
-                if (signer_global.has_value()){
-                    auto key_pair = signer_global.value();
-                    auto privk_pem = crypto::Pem(key_pair["privk"]);
-                    ledger_signer_local = make_key_pair(privk_pem, nullb);
-                }
-                else {
-                    return ccf::make_error(
-                        HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
-                }
+            if (!load_ledger_signer(ctx.tx)) {
+                return ccf::make_error(
+                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
             }
 
             auto contract_code_hash = contract_r.value().contract_code_hash;
@@ -795,7 +992,7 @@ namespace ccfapp
             auto creator_key = contract_r.value().contract_creator_verifying_key_PEM;
 
             string doc_to_sign = in.contract_id + creator_key + encoded_code_hash + encoded_metadata_hash;
-            auto signature = TPHandlerRegistry ::sign_document(doc_to_sign);
+            auto signature = TPHandlerRegistry ::sign_document_cached("contract:" + in.contract_id, doc_to_sign);
 
             return ccf::make_success(Get_contract_info::Out{creator_key, encoded_code_hash, encoded_metadata_hash, signature});
         };
@@ -805,7 +1002,7 @@ namespace ccfapp
         auto get_current_state_info_for_contract = [this](auto& ctx, const nlohmann::json& params) {
 
             const auto in = params.get<Get_current_state_info::In>();
-            auto view = ctx.tx.rw(contracttable);
+            auto view = ctx.tx.ro(contracttable);
             auto contract_r = view->get_globally_committed(in.contract_id);
 
             if (!contract_r.has_value())
@@ -817,35 +1014,63 @@ namespace ccfapp
                 return ccf::make_error(HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Contract not yet initialized");
             }
 
-            if (ledger_signer_local == NULL) {
-                auto signer_view = ctx.tx.rw(signer);
-                auto signer_global = signer_view->get_globally_committed("signer");
-                if (signer_global.has_value()){
-                    auto key_pair = signer_global.value();
-                    auto privk_pem = crypto::Pem(key_pair["privk"]);
-                    ledger_signer_local = make_key_pair(privk_pem, nullb);
-                }
-                else {
-                    return ccf::make_error(
-                        HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
-                }
+            if (!load_ledger_signer(ctx.tx)) {
+                return ccf::make_error(
+                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
             }
 
             auto current_state_hash = contract_r.value().current_state_hash;
             auto encoded_state_hash = b64_from_raw(current_state_hash.data(), current_state_hash.size());
             string doc_to_sign = in.contract_id + encoded_state_hash;
-            auto signature = TPHandlerRegistry ::sign_document(doc_to_sign);
+            auto signature = TPHandlerRegistry ::sign_document_cached("state:" + in.contract_id, doc_to_sign);
 
             return ccf::make_success(Get_current_state_info::Out{encoded_state_hash, contract_r.value().is_active, signature});
 
         };
 
+        //======================================================================================================
+        // get current state info for several contracts handler implementation
+        auto get_current_state_info_for_contracts = [this](auto& ctx, const nlohmann::json& params) {
+
+            const auto in = params.get<Get_current_state_info_for_contracts::In>();
+            if (in.contract_ids.size() > MAX_CONTRACTS_PER_STATE_QUERY) {
+                return ccf::make_error(HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Too many contracts in query");
+            }
+
+            if (!load_ledger_signer(ctx.tx)) {
+                return ccf::make_error(
+                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
+            }
+
+            auto view = ctx.tx.ro(contracttable);
+
+            // each entry carries the same signature as get_current_state_info_for_contract
+            Get_current_state_info_for_contracts::Out out;
+            for (auto contract_id : in.contract_ids) {
+                auto contract_r = view->get_globally_committed(contract_id);
+                if (!contract_r.has_value())
+                    continue;
+
+                auto current_state_hash = contract_r.value().current_state_hash;
+                if (current_state_hash.size() == 0)
+                    continue;
+
+                auto encoded_state_hash = b64_from_raw(current_state_hash.data(), current_state_hash.size());
+                string doc_to_sign = contract_id + encoded_state_hash;
+                auto signature = TPHandlerRegistry ::sign_document_cached("state:" + contract_id, doc_to_sign);
+
+                out.contracts.push_back(Current_state_info{contract_id, encoded_state_hash, contract_r.value().is_active, signature});
+            }
+
+            return ccf::make_success(out);
+        };
+
         //======================================================================================================
         // get state details handler implementation
         auto get_details_about_state = [this](auto& ctx, const nlohmann::json& params) {
 
             const auto in = params.get<Get_state_details::In>();
-            auto view = ctx.tx.rw(ccltable);
+            auto view = ctx.tx.ro(ccltable);
 
             string key_for_get =  in.contract_id + TPHandlerRegistry ::vector_to_string(in.state_hash);
 
@@ -860,18 +1085,9 @@ namespace ccfapp
             nlohmann::json j = ccl_r.value().dependency_list;
             string dep_list_string= j.dump();
 
-            if (ledger_signer_local == NULL) {
-                auto signer_view = ctx.tx.rw(signer);
-                auto signer_global = signer_view->get_globally_committed("signer");
-                if (signer_global.has_value()){
-                    auto key_pair = signer_global.value();
-                    auto privk_pem = crypto::Pem(key_pair["privk"]);
-                    ledger_signer_local = make_key_pair(privk_pem, nullb);
-                }
-                else {
-                    return ccf::make_error(
-                        HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
-                }
+            if (!load_ledger_signer(ctx.tx)) {
+                return ccf::make_error(
+                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
             }
 
             auto ccl_value = ccl_r.value();
@@ -891,12 +1107,134 @@ namespace ccfapp
             doc_to_sign += encoded_mh;
             doc_to_sign += encoded_txnid;
             doc_to_sign += dep_list_string;
-            auto signature = TPHandlerRegistry ::sign_document(doc_to_sign);
+            auto signature = TPHandlerRegistry ::sign_document_cached("details:" + key_for_get, doc_to_sign);
 
             return ccf::make_success(Get_state_details::Out{encoded_txnid, encoded_psh, encoded_mh, dep_list_string, signature});
 
         };
 
+        //======================================================================================================
+        // get state history handler implementation, walks the ccl table backwards from the start state
+        auto get_state_history = [this](auto& ctx, const nlohmann::json& params) {
+
+            const auto in = params.get<Get_state_history::In>();
+
+            if (in.max_entries == 0 || in.max_entries > MAX_STATE_HISTORY_ENTRIES) {
+                return ccf::make_error(HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Invalid number of history entries");
+            }
+
+            auto contract_view = ctx.tx.ro(contracttable);
+            auto ccl_view = ctx.tx.ro(ccltable);
+
+            // find the state where the walk starts
+            vector<uint8_t> state_hash = in.state_hash;
+            if (state_hash.size() == 0 && in.sequence_number >= 0) {
+                auto sequence_r = ctx.tx.ro(cclsequencetable)->get_globally_committed(
+                    sequence_key(in.contract_id, in.sequence_number));
+                if (!sequence_r.has_value()) {
+                    return ccf::make_error(HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unknown (contract_id, sequence_number) pair");
+                }
+                state_hash = sequence_r.value();
+            }
+            else if (state_hash.size() == 0) {
+                auto contract_r = contract_view->get_globally_committed(in.contract_id);
+                if (!contract_r.has_value()) {
+                    return ccf::make_error(HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Contract not found");
+                }
+                state_hash = contract_r.value().current_state_hash;
+                if (state_hash.size() == 0) {
+                    return ccf::make_error(HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Contract not yet initialized");
+                }
+            }
+
+            if (!load_ledger_signer(ctx.tx)) {
+                return ccf::make_error(
+                    HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unable to locate ledger authority for signing read rpcs");
+            }
+
+            // the previous state hash of the initial state is empty and b64_from_raw fails on empty input
+            auto encode = [](const vector<uint8_t>& raw) {
+                return raw.size() == 0 ? string("") : b64_from_raw(raw.data(), raw.size());
+            };
+
+            // one signature covers the whole page; the document starts with the contract id and
+            // the request parameters so that a page cannot be passed off as the answer to another
+            // request, the document for each entry extends the one signed by get_details_about_state
+            // with the state hash and the sequence number, and the complete flag ends the document
+            Get_state_history::Out out;
+            out.complete = false;
+            string doc_to_sign;
+            doc_to_sign += in.contract_id;
+            doc_to_sign += encode(in.state_hash);
+            doc_to_sign += to_string(in.sequence_number);
+            doc_to_sign += to_string(in.max_entries);
+
+            while (out.entries.size() < in.max_entries) {
+                auto ccl_r = ccl_view->get_globally_committed(in.contract_id + TPHandlerRegistry ::vector_to_string(state_hash));
+                if (!ccl_r.has_value()) {
+                    if (out.entries.size() == 0) {
+                        return ccf::make_error(
+                            HTTP_STATUS_BAD_REQUEST, ccf::errors::InvalidInput, "Unknown (contract_id, state_hash) pair");
+                    }
+                    break;
+                }
+
+                auto ccl_value = ccl_r.value();
+                nlohmann::json j = ccl_value.dependency_list;
+
+                State_history_entry entry;
+                entry.state_hash = encode(state_hash);
+                entry.sequence_number = ccl_value.sequence_number;
+                entry.transaction_id = encode(ccl_value.transaction_id);
+                entry.previous_state_hash = encode(ccl_value.previous_state_hash);
+                entry.message_hash = encode(ccl_value.message_hash);
+                entry.dependency_list = j.dump();
+
+                doc_to_sign += entry.state_hash;
+                doc_to_sign += entry.previous_state_hash;
+                doc_to_sign += entry.message_hash;
+                doc_to_sign += entry.transaction_id;
+                doc_to_sign += entry.dependency_list;
+                doc_to_sign += to_string(entry.sequence_number);
+                out.entries.push_back(entry);
+
+                if (ccl_value.previous_state_hash.size() == 0) {
+                    out.complete = true;
+                    break;
+                }
+                state_hash = ccl_value.previous_state_hash;
+            }
+
+            doc_to_sign += out.complete ? "true" : "false";
+            out.signature = TPHandlerRegistry ::sign_document(doc_to_sign);
+            return ccf::make_success(out);
+        };
+
+        //======================================================================================================
+        // get pending update info handler implementation
+        auto get_pending_update_info = [this](auto& ctx, const nlohmann::json& params) {
+
+            auto info_r = ctx.tx.ro(pendinginfo)->get(PENDING_QUEUE_INFO);
+
+            PendingQueueInfo info = {};
+            if (info_r.has_value()) {
+                info = info_r.value();
+            }
+
+            // expired entries are swept only by writes to the queue, they are not part of the depth
+            uint64_t expired = count_expired_pending_updates(ctx.tx, info);
+
+            Get_pending_update_info::Out out;
+            out.depth = info.depth > expired ? info.depth - expired : 0;
+            out.committed = info.committed;
+            out.expired = info.expired;
+            out.rejected = info.rejected;
+            out.average_wait_ms = info.committed == 0 ? 0 : info.total_wait / info.committed / 1000;
+            out.max_wait_ms = info.max_wait / 1000;
+
+            return ccf::make_success(out);
+        };
+
         // policy used by pdo clients. We will no longer generate a universal ccf user key and share with pdo clients
         // as did with ccf version 0.17
         const ccf::AuthnPolicies no_auth_policy = {ccf::no_auth_required};
@@ -904,8 +1242,8 @@ namespace ccfapp
         // policy used by consortium that deploys PDO TP
         const ccf::AuthnPolicies member_cert_sign_required = {ccf::member_signature_auth_policy};
 
-        // Not making any distinction between write and read-only end points while installing end points
-        // We will revisit this in a later PR.
+        // Endpoints that only read the tables are installed as read-only so that they never
+        // create a write transaction
         make_endpoint(
             GEN_SIGNING_KEY,
             HTTP_POST,
@@ -955,33 +1293,63 @@ namespace ccfapp
             no_auth_policy).install();
 
         make_endpoint(
-            VERIFY_ENCLAVE_REGISTRATION,
+            SUBMIT_CONTRACT_STATE_UPDATE,
             HTTP_POST,
-            json_adapter(verify_enclave),
+            json_adapter(submit_contract_state_update),
             no_auth_policy).install();
 
         make_endpoint(
+            UPDATE_CONTRACT_STATES,
+            HTTP_POST,
+            json_adapter(update_contract_states),
+            no_auth_policy).install();
+
+        make_read_only_endpoint(
+            VERIFY_ENCLAVE_REGISTRATION,
+            HTTP_POST,
+            json_read_only_adapter(verify_enclave),
+            no_auth_policy).install();
+
+        make_read_only_endpoint(
             GET_CONTRACT_PROVISIONING_INFO,
             HTTP_POST,
-            json_adapter(get_contract_provisioning_info),
+            json_read_only_adapter(get_contract_provisioning_info),
             no_auth_policy).install();
 
-        make_endpoint(
+        make_read_only_endpoint(
             GET_CONTRACT_INFO,
             HTTP_POST,
-            json_adapter(get_contract_info),
+            json_read_only_adapter(get_contract_info),
             no_auth_policy).install();
 
-        make_endpoint(
+        make_read_only_endpoint(
             GET_CURRENT_STATE_INFO_FOR_CONTRACT,
             HTTP_POST,
-            json_adapter(get_current_state_info_for_contract),
+            json_read_only_adapter(get_current_state_info_for_contract),
             no_auth_policy).install();
 
-        make_endpoint(
+        make_read_only_endpoint(
+            GET_CURRENT_STATE_INFO_FOR_CONTRACTS,
+            HTTP_POST,
+            json_read_only_adapter(get_current_state_info_for_contracts),
+            no_auth_policy).install();
+
+        make_read_only_endpoint(
             GET_DETAILS_ABOUT_STATE,
             HTTP_POST,
-            json_adapter(get_details_about_state),
+            json_read_only_adapter(get_details_about_state),
+            no_auth_policy).install();
+
+        make_read_only_endpoint(
+            GET_STATE_HISTORY,
+            HTTP_POST,
+            json_read_only_adapter(get_state_history),
+            no_auth_policy).install();
+
+        make_read_only_endpoint(
+            GET_PENDING_UPDATE_INFO,
+            HTTP_POST,
+            json_read_only_adapter(get_pending_update_info),
             no_auth_policy).install();
 
         make_endpoint(
@@ -28,8 +28,11 @@
 #include "ccf/app_interface.h"
 #include "ccf/user_frontend.h"
 #include "apps/utils/metrics_tracker.h"
+#include "enclave/enclave_time.h"
 
+#include <deque>
 #include <map>
+#include <mutex>
 #include <sgx_quote.h>
 
 using namespace std;
@@ -55,6 +58,13 @@ namespace ccfapp
     const string SW_HARDENING_NEEDED_QUOTE_STATUS{"SW_HARDENING_NEEDED"};
     const int BASENAME_SIZE{32};
     const int ORIGINATOR_KEY_HASH_SIZE{64};
+    const size_t MAX_STATE_UPDATES_PER_BATCH{256};
+    const size_t MAX_CONTRACTS_PER_STATE_QUERY{256};
+    const size_t SIGNATURE_CACHE_SIZE{4096};
+    const uint64_t MAX_STATE_HISTORY_ENTRIES{256};
+    const string PENDING_QUEUE_INFO{"pending_queue_info"};
+    const uint64_t MAX_PENDING_UPDATES{1024};
+    const uint64_t PENDING_UPDATE_TIMEOUT{60 * 1000 * 1000}; // microseconds
 
     // test method
     static constexpr auto PingMe = "ping";
@@ -66,13 +76,18 @@ namespace ccfapp
     static constexpr auto ADD_ENCLAVE_TO_CONTRACT ="add_enclave_to_contract";
     static constexpr auto INITIALIZE_CONTRACT_STATE ="ccl_initialize";
     static constexpr auto UPDATE_CONTRACT_STATE ="ccl_update";
+    static constexpr auto UPDATE_CONTRACT_STATES ="ccl_update_batch";
+    static constexpr auto SUBMIT_CONTRACT_STATE_UPDATE ="ccl_submit_update";
 
     //methods that read the tables, used by PDO to verify write transactions
     static constexpr auto VERIFY_ENCLAVE_REGISTRATION = "verify_enclave_registration";
     static constexpr auto GET_CONTRACT_PROVISIONING_INFO = "get_contract_provisioning_info";
     static constexpr auto GET_CONTRACT_INFO = "get_contract_info";
     static constexpr auto GET_CURRENT_STATE_INFO_FOR_CONTRACT = "get_current_state_info_for_contract";
+    static constexpr auto GET_CURRENT_STATE_INFO_FOR_CONTRACTS = "get_current_state_info_for_contracts";
     static constexpr auto GET_DETAILS_ABOUT_STATE = "get_details_about_state";
+    static constexpr auto GET_STATE_HISTORY = "get_state_history";
+    static constexpr auto GET_PENDING_UPDATE_INFO = "get_pending_update_info";
 
     //methods that create and read ledger authority keys.
     static constexpr auto GEN_SIGNING_KEY = "generate_signing_key_for_read_payloads";
@@ -88,7 +103,17 @@ namespace ccfapp
                         // Can be generalized if multiple enclave "types" need to be verified.
             kv::Map<string, EnclaveInfo> enclavetable; // key is encalve_id
             kv::Map<string, ContractInfo> contracttable; // key is contract_id
+            kv::Map<string, ContractEnclaveInfo> contractenclavetable; // key is contract_id + enclave_id (string addition)
+            kv::Map<string, vector<string>> contractenclavelist; // key is contract_id, value is the enclave ids
+                                                                  // in the order they were added to the contract
             kv::Map<string, ContractStateInfo> ccltable; // key is contract_id + state_hash (string addition)
+            kv::Map<string, vector<uint8_t>> cclsequencetable; // key is contract_id + "#" + sequence number, value
+                                                               // is the state hash
+            kv::Map<string, PendingStateUpdate> pendingtable; // key is contract_id + previous_state_hash (string addition)
+            kv::Map<string, vector<string>> pendingwaiters; // key is the ccl key of a missing state, value is the
+                                                             // pending updates waiting for it
+            kv::Map<uint64_t, string> pendingorder; // key is the queue sequence number, value is the pending key
+            kv::Map<string, PendingQueueInfo> pendinginfo; // single entry with key PENDING_QUEUE_INFO
             kv::Map<string, map<string, string>> signer; //There is at most one entry in this map. if there is an
                                                          //entry key="signer".  value is pubk:privk
 
@@ -164,10 +189,56 @@ namespace ccfapp
                 const vector<uint8_t>& enclave_signature,
                 const PublicKeyPtr & enclave_verifying_key);
 
+            // apply one state update within the transaction, the tables are written
+            // only when every check passes; on failure the reason is returned in
+            // error_message and the transaction is left unchanged. When missing_states
+            // is given, an update that is valid except for states that have not been
+            // committed yet fails with the ccl keys of those states in missing_states.
+            // On success committed_key receives the ccl key of the new state.
+            bool apply_contract_state_update(
+                kv::Tx& tx,
+                const Update_contract_state::In& in,
+                string& error_message,
+                vector<string>* missing_states = nullptr,
+                string* committed_key = nullptr);
+
+            // pending updates, see pending_updates.cpp
+            bool enqueue_pending_update(
+                kv::Tx& tx,
+                const Update_contract_state::In& in,
+                const vector<string>& missing_states,
+                string& error_message);
+
+            void commit_pending_updates(kv::Tx& tx, const string& committed_key);
+
+            // number of entries counted in the queue depth that have expired but
+            // have not been swept from the queue yet
+            uint64_t count_expired_pending_updates(kv::ReadOnlyTx& tx, const PendingQueueInfo& info);
+
+            // created on first use by concurrent read-only endpoints, always
+            // accessed under the lock
             KeyPairPtr ledger_signer_local;
-
+            std::mutex ledger_signer_lock;
+
+            // signatures for read responses keyed by the query; an entry is reused only
+            // while the signed document is unchanged, so a write to the underlying row
+            // replaces it on the next read; when the cache is full the oldest query
+            // is evicted
+            struct SignedDocument {
+                string document;
+                string signature;
+            };
+            map<string, SignedDocument> signature_cache;
+            deque<string> signature_cache_order;
+            std::mutex signature_cache_lock;
+
+            KeyPairPtr get_ledger_signer();
+            bool load_ledger_signer(kv::ReadOnlyTx& tx);
             string sign_document(const string& document);
+            string sign_document_cached(const string& cache_key, const string& document);
             string vector_to_string(const vector<uint8_t>& vec);
+            string sequence_key(const string& contract_id, uint64_t sequence_number);
+            uint64_t number_contract_states(kv::Tx& tx, const string& contract_id, const vector<uint8_t>& state_hash);
 
         public:
 
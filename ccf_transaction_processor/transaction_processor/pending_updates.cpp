@@ -0,0 +1,264 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pdo_tp.h"
+
+#include <algorithm>
+#include <deque>
+
+using namespace std;
+using namespace ccf;
+
+namespace ccfapp
+{
+    // the host provided time is used only to expire pending updates, a
+    // wrong clock delays or hastens expiration but cannot commit an update
+    static uint64_t current_time()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(enclave::get_enclave_time()).count();
+    }
+
+    // the host clock may go backwards, an update enqueued "in the future" has waited for no time
+    static uint64_t pending_age(uint64_t now, const PendingStateUpdate& pending)
+    {
+        return now > pending.enqueue_time ? now - pending.enqueue_time : 0;
+    }
+
+    static void add_waiter(
+        kv::Map<string, vector<string>>::Handle* waiters_view,
+        const string& state_key,
+        const string& pending_key)
+    {
+        vector<string> waiters;
+        auto waiters_r = waiters_view->get(state_key);
+        if (waiters_r.has_value()) {
+            waiters = waiters_r.value();
+        }
+
+        if (find(waiters.begin(), waiters.end(), pending_key) == waiters.end()) {
+            waiters.push_back(pending_key);
+            waiters_view->put(state_key, waiters);
+        }
+    }
+
+    static void remove_waiter(
+        kv::Map<string, vector<string>>::Handle* waiters_view,
+        const string& state_key,
+        const string& pending_key)
+    {
+        auto waiters_r = waiters_view->get(state_key);
+        if (!waiters_r.has_value()) {
+            return;
+        }
+
+        vector<string> waiters = waiters_r.value();
+        waiters.erase(remove(waiters.begin(), waiters.end(), pending_key), waiters.end());
+        if (waiters.empty()) {
+            waiters_view->remove(state_key);
+        }
+        else {
+            waiters_view->put(state_key, waiters);
+        }
+    }
+
+    // remove a pending update and every waiter entry that refers to it, so the waiter
+    // table never holds keys of updates that are no longer queued
+    static void remove_pending_update(
+        kv::Map<string, PendingStateUpdate>::Handle* pending_view,
+        kv::Map<string, vector<string>>::Handle* waiters_view,
+        const string& pending_key,
+        const PendingStateUpdate& pending)
+    {
+        for (auto state_key : pending.waiting_for) {
+            remove_waiter(waiters_view, state_key, pending_key);
+        }
+        pending_view->remove(pending_key);
+    }
+
+    uint64_t TPHandlerRegistry ::count_expired_pending_updates(kv::ReadOnlyTx& tx, const PendingQueueInfo& info)
+    {
+        auto pending_view = tx.ro(pendingtable);
+        auto order_view = tx.ro(pendingorder);
+
+        uint64_t now = current_time();
+
+        // entries are queued in time order so the expired entries that have not been
+        // swept yet are the ones at the head of the queue
+        uint64_t expired = 0;
+        for (uint64_t sequence = info.head_sequence; sequence < info.next_sequence; sequence++) {
+            auto order_r = order_view->get(sequence);
+            if (!order_r.has_value()) {
+                continue;
+            }
+            auto pending_r = pending_view->get(order_r.value());
+            if (!pending_r.has_value() || pending_r.value().queue_sequence != sequence) {
+                continue;
+            }
+            if (pending_age(now, pending_r.value()) <= PENDING_UPDATE_TIMEOUT) {
+                break;
+            }
+            expired++;
+        }
+
+        return expired;
+    }
+
+    bool TPHandlerRegistry ::enqueue_pending_update(
+        kv::Tx& tx,
+        const Update_contract_state::In& in,
+        const vector<string>& missing_states,
+        string& error_message)
+    {
+        // the update was parsed successfully by apply_contract_state_update
+        StateUpdateInfo state_update_info = nlohmann::json::parse(in.state_update_info).get<StateUpdateInfo>();
+        string pending_key = state_update_info.contract_id +
+            TPHandlerRegistry ::vector_to_string(state_update_info.previous_state_hash);
+
+        auto pending_view = tx.rw(pendingtable);
+        auto waiters_view = tx.rw(pendingwaiters);
+        auto order_view = tx.rw(pendingorder);
+        auto info_view = tx.rw(pendinginfo);
+
+        PendingQueueInfo info = {};
+        auto info_r = info_view->get(PENDING_QUEUE_INFO);
+        if (info_r.has_value()) {
+            info = info_r.value();
+        }
+
+        uint64_t now = current_time();
+
+        // drop expired updates from the head of the queue, entries are queued in time order
+        // so the walk stops at the first live entry that has not expired
+        while (info.head_sequence < info.next_sequence) {
+            auto order_r = order_view->get(info.head_sequence);
+            if (order_r.has_value()) {
+                auto head_r = pending_view->get(order_r.value());
+                if (head_r.has_value() && head_r.value().queue_sequence == info.head_sequence) {
+                    if (pending_age(now, head_r.value()) <= PENDING_UPDATE_TIMEOUT) {
+                        break;
+                    }
+                    remove_pending_update(pending_view, waiters_view, order_r.value(), head_r.value());
+                    info.depth--;
+                    info.expired++;
+                }
+                order_view->remove(info.head_sequence);
+            }
+            info.head_sequence++;
+        }
+
+        if (info.depth >= MAX_PENDING_UPDATES) {
+            error_message = "Pending update queue is full";
+            return false;
+        }
+
+        if (pending_view->get(pending_key).has_value()) {
+            error_message = "Another update of this state is already pending";
+            return false;
+        }
+
+        PendingStateUpdate pending;
+        pending.update = in;
+        pending.enqueue_time = now;
+        pending.queue_sequence = info.next_sequence;
+        pending.waiting_for = missing_states;
+        pending_view->put(pending_key, pending);
+        order_view->put(info.next_sequence, pending_key);
+
+        for (auto state_key : missing_states) {
+            add_waiter(waiters_view, state_key, pending_key);
+        }
+
+        info.next_sequence++;
+        info.depth++;
+        info_view->put(PENDING_QUEUE_INFO, info);
+
+        return true;
+    }
+
+    void TPHandlerRegistry ::commit_pending_updates(kv::Tx& tx, const string& committed_key)
+    {
+        auto info_view = tx.rw(pendinginfo);
+        auto info_r = info_view->get(PENDING_QUEUE_INFO);
+        if (!info_r.has_value() || info_r.value().depth == 0) {
+            return;
+        }
+        PendingQueueInfo info = info_r.value();
+
+        auto pending_view = tx.rw(pendingtable);
+        auto waiters_view = tx.rw(pendingwaiters);
+
+        uint64_t now = current_time();
+
+        // each committed state may release pending updates, which commit new states in turn;
+        // walking the released states in order commits the queue in topological order
+        deque<string> committed_states{committed_key};
+        while (!committed_states.empty()) {
+            string state_key = committed_states.front();
+            committed_states.pop_front();
+
+            auto waiters_r = waiters_view->get(state_key);
+            if (!waiters_r.has_value()) {
+                continue;
+            }
+            waiters_view->remove(state_key);
+
+            for (auto pending_key : waiters_r.value()) {
+                auto pending_r = pending_view->get(pending_key);
+                if (!pending_r.has_value()) {
+                    continue;
+                }
+                auto pending = pending_r.value();
+
+                if (pending_age(now, pending) > PENDING_UPDATE_TIMEOUT) {
+                    remove_pending_update(pending_view, waiters_view, pending_key, pending);
+                    info.depth--;
+                    info.expired++;
+                    continue;
+                }
+
+                string error_message;
+                vector<string> missing_states;
+                string new_state_key;
+                if (apply_contract_state_update(tx, pending.update, error_message, &missing_states, &new_state_key)) {
+                    remove_pending_update(pending_view, waiters_view, pending_key, pending);
+                    info.depth--;
+                    info.committed++;
+                    info.total_wait += pending_age(now, pending);
+                    info.max_wait = max(info.max_wait, pending_age(now, pending));
+                    committed_states.push_back(new_state_key);
+                }
+                else if (!missing_states.empty()) {
+                    for (auto state_key : pending.waiting_for) {
+                        remove_waiter(waiters_view, state_key, pending_key);
+                    }
+                    for (auto missing_key : missing_states) {
+                        add_waiter(waiters_view, missing_key, pending_key);
+                    }
+                    pending.waiting_for = missing_states;
+                    pending_view->put(pending_key, pending);
+                }
+                else {
+                    // the update can no longer be committed, for example because another
+                    // update of the same state was committed first
+                    remove_pending_update(pending_view, waiters_view, pending_key, pending);
+                    info.depth--;
+                    info.rejected++;
+                }
+            }
+        }
+
+        info_view->put(PENDING_QUEUE_INFO, info);
+    }
+}
@@ -78,12 +78,12 @@ def __add_enclave_secrets__(ledger_config, contract_id, client_keys, enclaveclie
     return encrypted_state_encryption_keys
 
 ## -----------------------------------------------------------------
-def __create_contract__(ledger_config, client_keys, preferred_eservice_client, eservice_clients, contract) :
+def __create_contract__(ledger_config, client_keys, preferred_eservice_client, eservice_clients, contract, state_layout=None) :
     """Create the initial contract state
     """
 
     logger.debug('Requesting that the enclave initialize the contract...')
-    initialize_request = contract.create_initialize_request(client_keys, preferred_eservice_client)
+    initialize_request = contract.create_initialize_request(client_keys, preferred_eservice_client, state_layout)
     initialize_response = initialize_request.evaluate()
     if not initialize_response.status :
         raise Exception("failed to initialize the contract; %s", initialize_response.result)
@@ -119,6 +119,8 @@ def create_contract(state, save_file, contract_source, **kwargs) :
     @param sservice_group : name of the sservice group to specify storage parameters
     @param interpreter : name of the interpreter that is expected from the eservices
     @param extra_data : opaque data that can be store in the contract file
+    @param data_node_size : optional size in bytes of the data nodes of the contract state
+    @param extent_threshold : optional size in bytes of the values stored in extents
     """
 
     contract_class = kwargs.get('contract_class') or os.path.basename(contract_source)
@@ -128,6 +130,14 @@ def create_contract(state, save_file, contract_source, **kwargs) :
     interpreter = kwargs.get('interpreter') or state.get(['Contract', 'Interpreter'])
     extra_data = kwargs.get('extra_data') or dict()
 
+    # the layout of the state is fixed when the state is created, the
+    # enclave checks the values and uses its defaults for those not given
+    state_layout = dict()
+    if kwargs.get('data_node_size') :
+        state_layout['DataNodeSize'] = kwargs.get('data_node_size')
+    if kwargs.get('extent_threshold') :
+        state_layout['ExtentThreshold'] = kwargs.get('extent_threshold')
+
     # ---------- pull out replication parameters ----------
     replica_count = get_replica_count(state, sservice_group)
     replica_duration = get_replica_duration(state, sservice_group)
@@ -215,7 +225,8 @@ def create_contract(state, save_file, contract_source, **kwargs) :
 
     # create the initial contract state
     try :
-        __create_contract__(ledger_config, client_keys, preferred_eservice_client, eservice_clients, contract)
+        __create_contract__(ledger_config, client_keys, preferred_eservice_client, eservice_clients, contract,
+                            state_layout or None)
 
         contract.save_to_file(contract_file, data_dir=data_directory)
     except Exception as e :
@@ -238,6 +249,9 @@ def command_create(state, bindings, pargs) :
     parser.add_argument('-r', '--sservice-group', help='Name of the storage service group to use', type=str)
     parser.add_argument('-s', '--contract-source', help='File that contains contract source code', required=True, type=str)
 
+    parser.add_argument('--data-node-size', help='Size in bytes of the data nodes of the contract state', type=int)
+    parser.add_argument('--extent-threshold', help='Size in bytes of values stored in extents', type=int)
+
     parser.add_argument('--symbol', help='binding symbol for result', type=str)
     parser.add_argument('--extra-data', help='Extra data to be associated with the contract file', nargs=2, action='append')
 
@@ -31,28 +31,90 @@
 namespace pcrypto = pdo::crypto;
 
 // -----------------------------------------------------------------
-// Hash Functions
+// Incremental Hash
 // -----------------------------------------------------------------
-static void _ComputeHash_(
-    const EVP_MD *hashfunc(void),
-    const ByteArray& message,
-    ByteArray& hash)
+pcrypto::Hasher::Hasher(pcrypto::HashFunction hashfunc) : md_(hashfunc()), ctx_(EVP_MD_CTX_new())
 {
-    const EVP_MD *md = hashfunc();
-    hash.resize(EVP_MD_size(md));
+    pdo::error::ThrowIfNull(ctx_, "invalid hash context");
+    Init();
+}
 
-    std::unique_ptr<EVP_MD_CTX, void (*)(EVP_MD_CTX*)> evp_md_ctx(EVP_MD_CTX_new(), EVP_MD_CTX_free);
-    pdo::error::ThrowIfNull(evp_md_ctx.get(), "invalid hash context");
+pcrypto::Hasher::~Hasher()
+{
+    EVP_MD_CTX_free(ctx_);
+}
 
-    int ret;
-    ret = EVP_DigestInit_ex(evp_md_ctx.get(), md, NULL);
+void pcrypto::Hasher::Init(void)
+{
+    int ret = EVP_DigestInit_ex(ctx_, md_, NULL);
     pdo::error::ThrowIf<pdo::error::RuntimeError>(ret == 0, "hash init failed");
+}
 
-    ret = EVP_DigestUpdate(evp_md_ctx.get(), message.data(), message.size());
+pcrypto::Hasher& pcrypto::Hasher::Update(const uint8_t* data, size_t size)
+{
+    int ret = EVP_DigestUpdate(ctx_, data, size);
     pdo::error::ThrowIf<pdo::error::RuntimeError>(ret == 0, "hash update failed");
+    return *this;
+}
 
-    ret = EVP_DigestFinal_ex(evp_md_ctx.get(), hash.data(), NULL);
+pcrypto::Hasher& pcrypto::Hasher::Update(const ByteArray& message)
+{
+    return Update(message.data(), message.size());
+}
+
+pcrypto::Hasher& pcrypto::Hasher::Update(const std::string& message)
+{
+    return Update((const uint8_t*)message.data(), message.size());
+}
+
+void pcrypto::Hasher::Final(ByteArray& hash)
+{
+    hash.resize(EVP_MD_size(md_));
+
+    int ret = EVP_DigestFinal_ex(ctx_, hash.data(), NULL);
     pdo::error::ThrowIf<pdo::error::RuntimeError>(ret == 0, "hash final failed");
+
+    // reset the context so that the hasher can be reused
+    Init();
+}
+
+ByteArray pcrypto::Hasher::Final(void)
+{
+    ByteArray hash;
+    Final(hash);
+    return hash;
+}
+
+size_t pcrypto::Hasher::DigestSize(void) const
+{
+    return EVP_MD_size(md_);
+}
+
+// -----------------------------------------------------------------
+// Hash Functions
+// -----------------------------------------------------------------
+static void _ComputeHash_(
+    const EVP_MD *hashfunc(void),
+    const ByteArray& message,
+    ByteArray& hash)
+{
+    pcrypto::Hasher hasher(hashfunc);
+    hasher.Update(message);
+    hasher.Final(hash);
+}
+
+static void _ComputeHash_(
+    const EVP_MD *hashfunc(void),
+    const pcrypto::ByteArrayRefArray& message_parts,
+    ByteArray& hash)
+{
+    pcrypto::Hasher hasher(hashfunc);
+    for (auto part : message_parts)
+    {
+        pdo::error::ThrowIfNull(part, "invalid message part");
+        hasher.Update(*part);
+    }
+    hasher.Final(hash);
 }
 
 void pcrypto::SHA256Hash(const ByteArray& message, ByteArray& hash)
@@ -70,6 +132,21 @@ void pcrypto::SHA512Hash(const ByteArray& message, ByteArray& hash)
     _ComputeHash_(EVP_sha512, message, hash);
 }
 
+void pcrypto::SHA256Hash(const pcrypto::ByteArrayRefArray& message_parts, ByteArray& hash)
+{
+    _ComputeHash_(EVP_sha256, message_parts, hash);
+}
+
+void pcrypto::SHA384Hash(const pcrypto::ByteArrayRefArray& message_parts, ByteArray& hash)
+{
+    _ComputeHash_(EVP_sha384, message_parts, hash);
+}
+
+void pcrypto::SHA512Hash(const pcrypto::ByteArrayRefArray& message_parts, ByteArray& hash)
+{
+    _ComputeHash_(EVP_sha512, message_parts, hash);
+}
+
 // -----------------------------------------------------------------
 // HMAC Functions
 // -----------------------------------------------------------------
@@ -159,6 +236,17 @@ ByteArray pcrypto::ComputeMessageHash(const ByteArray& message)
     return hash;
 }  // pcrypto::ComputeMessageHash
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Compute SHA256 hash of the concatenation of the message parts
+// without materializing the concatenated message
+// returns ByteArray containing raw binary data
+ByteArray pcrypto::ComputeMessageHash(const pcrypto::ByteArrayRefArray& message_parts)
+{
+    ByteArray hash(SHA256_DIGEST_LENGTH);
+    pcrypto::SHA256Hash(message_parts, hash);
+    return hash;
+}  // pcrypto::ComputeMessageHash
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 // Compute SHA256-based HMAC of message.data()
 // returns ByteArray containing raw binary data
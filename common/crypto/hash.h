@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <openssl/evp.h>
+
 #include "types.h"
 
 namespace pdo
@@ -23,6 +25,43 @@ namespace crypto
 {
     const unsigned int PBDK_Iterations = 10000;
 
+    // hash functions are identified by the openssl message digest accessor,
+    // e.g. EVP_sha256, EVP_sha384 or EVP_sha512
+    typedef const EVP_MD* (*HashFunction)(void);
+
+    // list of buffers that are hashed as if they were concatenated,
+    // this avoids copying large messages into a temporary buffer
+    typedef std::vector<const ByteArray*> ByteArrayRefArray;
+
+    // Incremental hash computation; the digest context is allocated
+    // once and is re-initialized after each call to Final so the same
+    // object can be used to compute several hashes
+    // throws RuntimeError
+    class Hasher
+    {
+    public:
+        Hasher(HashFunction hashfunc = EVP_sha256);
+        ~Hasher();
+
+        void Init(void);
+
+        Hasher& Update(const uint8_t* data, size_t size);
+        Hasher& Update(const ByteArray& message);
+        Hasher& Update(const std::string& message);
+
+        void Final(ByteArray& hash);
+        ByteArray Final(void);
+
+        size_t DigestSize(void) const;
+
+    private:
+        Hasher(const Hasher&) = delete;
+        Hasher& operator=(const Hasher&) = delete;
+
+        const EVP_MD* md_;
+        EVP_MD_CTX* ctx_;
+    };
+
     void SHA256Hash(const ByteArray& message, ByteArray& hash);
     void SHA256HMAC(const ByteArray& message, const ByteArray& key, ByteArray& hmac);
 
@@ -30,13 +69,25 @@ namespace crypto
     void SHA384HMAC(const ByteArray& message, const ByteArray& key, ByteArray& hmac);
 
     void SHA512Hash(const ByteArray& message, ByteArray& hash);
+
+    void SHA256Hash(const ByteArrayRefArray& message_parts, ByteArray& hash);
+    void SHA384Hash(const ByteArrayRefArray& message_parts, ByteArray& hash);
+    void SHA512Hash(const ByteArrayRefArray& message_parts, ByteArray& hash);
     void SHA512HMAC(const ByteArray& message, const ByteArray& key, ByteArray& hmac);
 
     void SHA512PasswordBasedKeyDerivation(const std::string& password, const ByteArray& salt, ByteArray& hmac);
 
     // these default to the sha256 hash functions
     ByteArray ComputeMessageHash(const ByteArray& message);
+    ByteArray ComputeMessageHash(const ByteArrayRefArray& message_parts);
     ByteArray ComputeMessageHMAC(const ByteArray& key, const ByteArray& message);
     ByteArray ComputePasswordBasedKeyDerivation(const std::string& password, const ByteArray& salt);
+
+    // sha256 hash of each message independently; when supported by the
+    // processor several messages are hashed in parallel vector lanes
+    void ComputeMessageHashes(const ByteArrayRefArray& messages, std::vector<ByteArray>& hashes);
+    std::vector<ByteArray> ComputeMessageHashes(const std::vector<ByteArray>& messages);
+    void ComputeMessageHashesScalar(const ByteArrayRefArray& messages, std::vector<ByteArray>& hashes);
+    bool ComputeMessageHashesVector(const ByteArrayRefArray& messages, std::vector<ByteArray>& hashes);
 }
 }
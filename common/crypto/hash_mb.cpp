@@ -0,0 +1,382 @@
+/* Copyright 2022 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Multi-buffer SHA256. Independent messages are hashed in parallel
+ * lanes of 256-bit vector registers (8 lanes of 32-bit words), one
+ * message per lane. Lanes whose message has fewer blocks than the
+ * longest message in the group keep their state unchanged for the
+ * remaining rounds.
+ *
+ * The vector engine is used only when AVX2 is known to be available
+ * and the processor does not implement the SHA extensions; with the
+ * SHA extensions the single buffer openssl implementation is faster.
+ * Inside the enclave cpuid cannot be executed, so the engine is used
+ * only when the enclave itself is compiled with AVX2 enabled.
+ * Everything else falls back to the scalar openssl hash.
+ */
+
+#include <algorithm>
+#include <string.h>
+
+#include <openssl/sha.h>
+
+#include "error.h"
+#include "hash.h"
+
+#if defined(__x86_64__) && !defined(PDO_DISABLE_MB_SHA256)
+#define MB_SHA256_AVX2 1
+#include <immintrin.h>
+#if _UNTRUSTED_
+#include <cpuid.h>
+#endif
+#endif
+
+namespace pcrypto = pdo::crypto;
+
+#if MB_SHA256_AVX2
+
+#define MB_SHA256_LANES 8
+#define MB_SHA256_BLOCK_SIZE 64
+
+static const uint32_t sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t sha256_h0[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static bool _avx2_supported_(bool& sha)
+{
+#if _UNTRUSTED_
+    static int available = -1;
+    static bool sha_extensions = false;
+    if (available < 0)
+    {
+        unsigned int eax, ebx, ecx, edx;
+        bool avx2 = false;
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        {
+            avx2 = (ebx & (1 << 5)) != 0;
+            sha_extensions = (ebx & (1 << 29)) != 0;
+        }
+
+        // avx2 also requires the os to save the ymm registers
+        if (avx2 && __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1 << 27)))
+        {
+            unsigned int xcr0_lo, xcr0_hi;
+            __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+            avx2 = (xcr0_lo & 0x6) == 0x6;
+        }
+        else
+            avx2 = false;
+
+        available = avx2 ? 1 : 0;
+    }
+    sha = sha_extensions;
+    return available == 1;
+#elif defined(__AVX2__)
+    sha = false;
+    return true;
+#else
+    sha = false;
+    return false;
+#endif
+}
+
+static bool _avx2_engine_available_(void)
+{
+    bool sha;
+    return _avx2_supported_(sha) && ! sha;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Per-lane view of a message: the full blocks are read in place, the
+// last one or two blocks (remainder of the message plus padding) are
+// assembled in the tail buffer
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+typedef struct
+{
+    const uint8_t* data;
+    size_t full_blocks;
+    size_t total_blocks;
+    uint8_t tail[2 * MB_SHA256_BLOCK_SIZE];
+} mb_lane_t;
+
+static size_t _padded_block_count_(size_t length)
+{
+    // message, one byte for the 0x80 marker and 8 bytes for the length
+    return (length + 9 + MB_SHA256_BLOCK_SIZE - 1) / MB_SHA256_BLOCK_SIZE;
+}
+
+static void _init_lane_(const ByteArray& message, mb_lane_t& lane)
+{
+    size_t length = message.size();
+
+    lane.data = message.data();
+    lane.full_blocks = length / MB_SHA256_BLOCK_SIZE;
+    lane.total_blocks = _padded_block_count_(length);
+
+    size_t tail_size = (lane.total_blocks - lane.full_blocks) * MB_SHA256_BLOCK_SIZE;
+    size_t remainder = length - lane.full_blocks * MB_SHA256_BLOCK_SIZE;
+
+    memset(lane.tail, 0, sizeof(lane.tail));
+    if (remainder > 0)
+        memcpy(lane.tail, lane.data + lane.full_blocks * MB_SHA256_BLOCK_SIZE, remainder);
+    lane.tail[remainder] = 0x80;
+
+    uint64_t bit_length = (uint64_t)length * 8;
+    for (int i = 0; i < 8; i++)
+        lane.tail[tail_size - 1 - i] = (uint8_t)(bit_length >> (8 * i));
+}
+
+static const uint8_t* _lane_block_(const mb_lane_t& lane, size_t block)
+{
+    if (block < lane.full_blocks)
+        return lane.data + block * MB_SHA256_BLOCK_SIZE;
+    return lane.tail + (block - lane.full_blocks) * MB_SHA256_BLOCK_SIZE;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// AVX2 round functions
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+#define MB_TARGET __attribute__((target("avx2")))
+
+#define ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+#define SHR(x, n) _mm256_srli_epi32((x), (n))
+#define XOR3(a, b, c) _mm256_xor_si256(_mm256_xor_si256((a), (b)), (c))
+#define ADD(a, b) _mm256_add_epi32((a), (b))
+
+#define BSIG0(x) XOR3(ROTR((x), 2), ROTR((x), 13), ROTR((x), 22))
+#define BSIG1(x) XOR3(ROTR((x), 6), ROTR((x), 11), ROTR((x), 25))
+#define SSIG0(x) XOR3(ROTR((x), 7), ROTR((x), 18), SHR((x), 3))
+#define SSIG1(x) XOR3(ROTR((x), 17), ROTR((x), 19), SHR((x), 10))
+#define CH(e, f, g) _mm256_xor_si256(_mm256_and_si256((e), (f)), _mm256_andnot_si256((e), (g)))
+#define MAJ(a, b, c) _mm256_or_si256(_mm256_and_si256((a), (b)), _mm256_and_si256((c), _mm256_or_si256((a), (b))))
+
+MB_TARGET
+static void _compress_lanes_(__m256i state[8], const uint8_t* blocks[MB_SHA256_LANES], __m256i active)
+{
+    __m256i w[64];
+
+    // load the message words of all lanes, converting from big endian
+    {
+        uint32_t words[16][MB_SHA256_LANES] __attribute__((aligned(32)));
+        for (int lane = 0; lane < MB_SHA256_LANES; lane++)
+        {
+            const uint8_t* b = blocks[lane];
+            for (int t = 0; t < 16; t++)
+                words[t][lane] = ((uint32_t)b[4 * t] << 24) | ((uint32_t)b[4 * t + 1] << 16) |
+                                 ((uint32_t)b[4 * t + 2] << 8) | ((uint32_t)b[4 * t + 3]);
+        }
+        for (int t = 0; t < 16; t++)
+            w[t] = _mm256_load_si256((const __m256i*)words[t]);
+    }
+
+    for (int t = 16; t < 64; t++)
+        w[t] = ADD(ADD(SSIG1(w[t - 2]), w[t - 7]), ADD(SSIG0(w[t - 15]), w[t - 16]));
+
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int t = 0; t < 64; t++)
+    {
+        __m256i k = _mm256_set1_epi32((int)sha256_k[t]);
+        __m256i t1 = ADD(ADD(ADD(h, BSIG1(e)), ADD(CH(e, f, g), k)), w[t]);
+        __m256i t2 = ADD(BSIG0(a), MAJ(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = ADD(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = ADD(t1, t2);
+    }
+
+    // lanes that have already consumed their message keep their state
+    state[0] = _mm256_blendv_epi8(state[0], ADD(state[0], a), active);
+    state[1] = _mm256_blendv_epi8(state[1], ADD(state[1], b), active);
+    state[2] = _mm256_blendv_epi8(state[2], ADD(state[2], c), active);
+    state[3] = _mm256_blendv_epi8(state[3], ADD(state[3], d), active);
+    state[4] = _mm256_blendv_epi8(state[4], ADD(state[4], e), active);
+    state[5] = _mm256_blendv_epi8(state[5], ADD(state[5], f), active);
+    state[6] = _mm256_blendv_epi8(state[6], ADD(state[6], g), active);
+    state[7] = _mm256_blendv_epi8(state[7], ADD(state[7], h), active);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Hash up to MB_SHA256_LANES messages, one per lane
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+MB_TARGET
+static void _hash_lane_group_(const ByteArray* messages[], ByteArray* hashes[], size_t count)
+{
+    static const uint8_t idle_block[MB_SHA256_BLOCK_SIZE] = { 0 };
+
+    mb_lane_t lanes[MB_SHA256_LANES];
+    size_t max_blocks = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        _init_lane_(*messages[i], lanes[i]);
+        max_blocks = std::max(max_blocks, lanes[i].total_blocks);
+    }
+
+    __m256i state[8];
+    for (int i = 0; i < 8; i++)
+        state[i] = _mm256_set1_epi32((int)sha256_h0[i]);
+
+    for (size_t block = 0; block < max_blocks; block++)
+    {
+        const uint8_t* blocks[MB_SHA256_LANES];
+        int32_t mask[MB_SHA256_LANES] __attribute__((aligned(32)));
+        for (size_t lane = 0; lane < MB_SHA256_LANES; lane++)
+        {
+            bool active = (lane < count && block < lanes[lane].total_blocks);
+            blocks[lane] = active ? _lane_block_(lanes[lane], block) : idle_block;
+            mask[lane] = active ? -1 : 0;
+        }
+
+        _compress_lanes_(state, blocks, _mm256_load_si256((const __m256i*)mask));
+    }
+
+    uint32_t digest[8][MB_SHA256_LANES] __attribute__((aligned(32)));
+    for (int i = 0; i < 8; i++)
+        _mm256_store_si256((__m256i*)digest[i], state[i]);
+
+    for (size_t lane = 0; lane < count; lane++)
+    {
+        ByteArray& hash = *hashes[lane];
+        hash.resize(SHA256_DIGEST_LENGTH);
+        for (int i = 0; i < 8; i++)
+        {
+            uint32_t v = digest[i][lane];
+            hash[4 * i] = (uint8_t)(v >> 24);
+            hash[4 * i + 1] = (uint8_t)(v >> 16);
+            hash[4 * i + 2] = (uint8_t)(v >> 8);
+            hash[4 * i + 3] = (uint8_t)v;
+        }
+    }
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static void _hash_messages_(
+    const pcrypto::ByteArrayRefArray& messages,
+    std::vector<ByteArray>& hashes)
+{
+    hashes.resize(messages.size());
+
+    // group messages of similar length so that few lanes sit idle
+    std::vector<size_t> order(messages.size());
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        pdo::error::ThrowIfNull(messages[i], "invalid message");
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [&messages](size_t x, size_t y) { return messages[x]->size() > messages[y]->size(); });
+
+    for (size_t first = 0; first < order.size(); first += MB_SHA256_LANES)
+    {
+        size_t count = std::min((size_t)MB_SHA256_LANES, order.size() - first);
+
+        const ByteArray* group_messages[MB_SHA256_LANES];
+        ByteArray* group_hashes[MB_SHA256_LANES];
+        for (size_t lane = 0; lane < count; lane++)
+        {
+            group_messages[lane] = messages[order[first + lane]];
+            group_hashes[lane] = &hashes[order[first + lane]];
+        }
+
+        _hash_lane_group_(group_messages, group_hashes, count);
+    }
+}
+
+#endif  // MB_SHA256_AVX2
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Scalar implementation, also used as reference in the tests
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pcrypto::ComputeMessageHashesScalar(
+    const pcrypto::ByteArrayRefArray& messages,
+    std::vector<ByteArray>& hashes)
+{
+    hashes.resize(messages.size());
+
+    pcrypto::Hasher hasher(EVP_sha256);
+    for (size_t i = 0; i < messages.size(); i++)
+    {
+        pdo::error::ThrowIfNull(messages[i], "invalid message");
+        hasher.Update(*messages[i]).Final(hashes[i]);
+    }
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Compute the SHA256 hash of each message independently
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pcrypto::ComputeMessageHashes(
+    const pcrypto::ByteArrayRefArray& messages,
+    std::vector<ByteArray>& hashes)
+{
+#if MB_SHA256_AVX2
+    if (messages.size() > 1 && _avx2_engine_available_())
+    {
+        _hash_messages_(messages, hashes);
+        return;
+    }
+#endif
+
+    pcrypto::ComputeMessageHashesScalar(messages, hashes);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Vector implementation regardless of the processor's SHA extensions,
+// returns false when the lanes are not available; used by the tests
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+bool pcrypto::ComputeMessageHashesVector(
+    const pcrypto::ByteArrayRefArray& messages,
+    std::vector<ByteArray>& hashes)
+{
+#if MB_SHA256_AVX2
+    bool sha;
+    if (_avx2_supported_(sha))
+    {
+        _hash_messages_(messages, hashes);
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+std::vector<ByteArray> pcrypto::ComputeMessageHashes(const std::vector<ByteArray>& messages)
+{
+    pcrypto::ByteArrayRefArray refs;
+    refs.reserve(messages.size());
+    for (size_t i = 0; i < messages.size(); i++)
+        refs.push_back(&messages[i]);
+
+    std::vector<ByteArray> hashes;
+    pcrypto::ComputeMessageHashes(refs, hashes);
+    return hashes;
+}
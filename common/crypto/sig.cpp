@@ -23,9 +23,9 @@ namespace pcsig = pdo::crypto::sig;
 namespace Error = pdo::error;
 
 const pcsig::sig_details_t pcsig::SigDetails[static_cast<int>(pcsig::SigCurve::CURVE_COUNT)] = {
-    {pcsig::SigCurve::UNDEFINED, 0, NULL, 0},
-    {pcsig::SigCurve::SECP256K1, NID_secp256k1, &pdo::crypto::SHA256Hash, SHA256_DIGEST_LENGTH, 72},
-    {pcsig::SigCurve::SECP384R1, NID_secp384r1, &pdo::crypto::SHA384Hash, SHA384_DIGEST_LENGTH, 104}
+    {pcsig::SigCurve::UNDEFINED, 0, NULL, 0, 0, NULL},
+    {pcsig::SigCurve::SECP256K1, NID_secp256k1, &pdo::crypto::SHA256Hash, SHA256_DIGEST_LENGTH, 72, EVP_sha256},
+    {pcsig::SigCurve::SECP384R1, NID_secp384r1, &pdo::crypto::SHA384Hash, SHA384_DIGEST_LENGTH, 104, EVP_sha384}
 };
 
 const std::map<int, pcsig::SigCurve> pcsig::NidToSigCurveMap = {
@@ -38,6 +38,11 @@ unsigned int pcsig::Key::MaxSigSize() const
     return sigDetails_.maxSigSize;
 }
 
+pdo::crypto::HashFunction pcsig::Key::GetHashFunction() const
+{
+    return sigDetails_.hashFunc;
+}
+
 void pcsig::Key::SetSigDetailsFromDeserializedKey()
 {
     int nid = EC_GROUP_get_curve_name(EC_KEY_get0_group(key_));
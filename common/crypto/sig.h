@@ -20,6 +20,7 @@
 #include <openssl/obj_mac.h> //for the NIDs
 #include <string>
 
+#include "hash.h"
 #include "types.h"
 
 namespace pdo
@@ -53,6 +54,7 @@ namespace crypto
             void (*SHAFunc)(const ByteArray& message, ByteArray& hash);
             unsigned int shaDigestLength;
             unsigned int maxSigSize;
+            HashFunction hashFunc;
         } sig_details_t;
 
         extern const sig_details_t SigDetails[];
@@ -65,6 +67,9 @@ namespace crypto
             virtual void SetSigDetailsFromDeserializedKey();
             virtual std::string Serialize() const = 0;
             virtual unsigned int MaxSigSize() const;
+            // hash function to use with a Hasher that computes the
+            // digest passed to SignDigest
+            HashFunction GetHashFunction() const;
 
         protected:
             EC_KEY* key_;
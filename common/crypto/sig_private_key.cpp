@@ -265,6 +265,16 @@ ByteArray pcrypto::sig::PrivateKey::SignMessage(const ByteArray& message) const
     // Hash
     sigDetails_.SHAFunc(message, hash);
     // Then Sign
+    return SignDigest(hash);
+}  // pcrypto::sig::PrivateKey::SignMessage
+
+// Sign a previously computed message digest
+// returns ByteArray containing raw binary signature
+// throws RuntimeError
+ByteArray pcrypto::sig::PrivateKey::SignDigest(const ByteArray& hash) const
+{
+    pdo::error::ThrowIf<Error::RuntimeError>(
+        hash.size() != sigDetails_.shaDigestLength, "Crypto Error (SignDigest): invalid digest length");
 
     ECDSA_SIG_ptr sig(ECDSA_do_sign(hash.data(), hash.size(), key_), ECDSA_SIG_free);
     pdo::error::ThrowIf<Error::RuntimeError>(!sig, "Crypto Error (SignMessage): Could not compute ECDSA signature");
@@ -312,4 +322,4 @@ ByteArray pcrypto::sig::PrivateKey::SignMessage(const ByteArray& message) const
     pdo::error::ThrowIf<Error::RuntimeError>(!res, "Crypto Error (SignMessage): Could not convert signatureto DER");
 
     return der_SIG;
-}  // pcrypto::sig::PrivateKey::SignMessage
+}  // pcrypto::sig::PrivateKey::SignDigest
@@ -62,6 +62,10 @@ namespace crypto
             // Sign message.data() and return ByteArray containing raw binary signature
             // throws RuntimeError
             ByteArray SignMessage(const ByteArray& message) const;
+            // Sign a digest computed with the hash function returned by
+            // GetHashFunction(), e.g. the output of a Hasher
+            // throws RuntimeError
+            ByteArray SignDigest(const ByteArray& digest) const;
         };
     }
 }
@@ -18,6 +18,8 @@
 #include <string>
 #include <map>
 
+#include "error.h"
+#include "resource_counters.h"
 #include "state.h"
 #include "ContractCode.h"
 #include "ContractMessage.h"
@@ -26,6 +28,16 @@ namespace pdo
 {
     namespace contracts
     {
+        // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+        // raised when an invocation runs out of its execution budget
+        class ExecutionBudgetExceeded : public pdo::error::ValueError
+        {
+        public:
+            explicit ExecutionBudgetExceeded(
+                const std::string& msg
+                ) : pdo::error::ValueError(msg) {}
+        }; // class ExecutionBudgetExceeded
+
         // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
         class ContractInterpreter
         {
@@ -51,6 +63,14 @@ namespace pdo
                 std::string& outMessageResult
                 ) = 0;
 
+            // work done by the interpreter in the most recent invocation,
+            // the work done by the contract state is counted by the state
+            virtual const pdo_resource_counters_t& ResourceCounters(void) const = 0;
+
+            // limit on the work done by each invocation in units chosen by
+            // the interpreter, zero selects the interpreter default
+            virtual void SetExecutionBudget(uint64_t budget) = 0;
+
             virtual void Finalize(void) = 0;
             virtual void Initialize(void) = 0;
         };
@@ -52,6 +52,8 @@ extern "C" bool b64_encode_wrapper(
     int32 enc_length_pointer_offset  // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* dec_buffer = (uint8_t*)get_buffer(module_inst, dec_buffer_offset, dec_buffer_length);
@@ -87,6 +89,8 @@ extern "C" bool b64_decode_wrapper(
     int32 dec_length_pointer_offset  // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* enc_buffer = (uint8_t*)get_buffer(module_inst, enc_buffer_offset, enc_buffer_length);
@@ -124,6 +128,8 @@ extern "C" bool ecdsa_create_signing_keys_wrapper(
     int32 public_length_pointer_offset   // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         pcrypto::sig::PrivateKey privkey;
@@ -164,6 +170,8 @@ extern "C" bool ecdsa_sign_message_wrapper(
     int32 sig_length_pointer_offset  // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         const uint8_t* msg_buffer = (uint8_t*)get_buffer(module_inst, msg_buffer_offset, msg_length);
@@ -208,6 +216,8 @@ extern "C" bool ecdsa_verify_signature_wrapper(
     const int32 sig_length         // size_t
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         const uint8_t* msg_buffer = (uint8_t*)get_buffer(module_inst, msg_buffer_offset, msg_length);
@@ -248,6 +258,8 @@ extern "C" bool aes_generate_key_wrapper(
     int32 key_length_pointer_offset  // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         ByteArray key = pcrypto::skenc::GenerateKey();
@@ -278,6 +290,8 @@ extern "C" bool aes_generate_iv_wrapper(
     int32 iv_length_pointer_offset  // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         const uint8_t* buffer = (uint8_t*)get_buffer(module_inst, buffer_offset, buffer_length);
@@ -316,6 +330,8 @@ extern "C" bool aes_encrypt_message_wrapper(
     int32 cipher_length_pointer_offset  // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* msg_buffer = (uint8_t*)get_buffer(module_inst, msg_buffer_offset, msg_length);
@@ -367,6 +383,8 @@ extern "C" bool aes_decrypt_message_wrapper(
     int32 msg_length_pointer_offset   // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* cipher_buffer = (uint8_t*)get_buffer(module_inst, cipher_buffer_offset, cipher_length);
@@ -414,6 +432,8 @@ extern "C" bool rsa_generate_keys_wrapper(
     int32 public_length_pointer_offset   // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         pcrypto::pkenc::PrivateKey privkey;
@@ -454,6 +474,8 @@ extern "C" bool rsa_encrypt_message_wrapper(
     int32 cipher_length_pointer_offset  // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* msg_buffer = (uint8_t*)get_buffer(module_inst, msg_buffer_offset, msg_length);
@@ -501,6 +523,8 @@ extern "C" bool rsa_decrypt_message_wrapper(
     int32 msg_length_pointer_offset   // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* cipher_buffer = (uint8_t*)get_buffer(module_inst, cipher_buffer_offset, cipher_length);
@@ -545,6 +569,8 @@ extern "C" bool sha256_hash_wrapper(
     int32 hash_buffer_pointer_offset, // uint8_t**
     int32 hash_length_pointer_offset) // size_t*
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* msg_buffer = (uint8_t*)get_buffer(module_inst, msg_buffer_offset, msg_buffer_length);
@@ -582,6 +608,8 @@ extern "C" bool sha384_hash_wrapper(
     int32 hash_buffer_pointer_offset, // uint8_t**
     int32 hash_length_pointer_offset) // size_t*
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* msg_buffer = (uint8_t*)get_buffer(module_inst, msg_buffer_offset, msg_buffer_length);
@@ -619,6 +647,8 @@ extern "C" bool sha512_hash_wrapper(
     int32 hash_buffer_pointer_offset, // uint8_t**
     int32 hash_length_pointer_offset) // size_t*
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* msg_buffer = (uint8_t*)get_buffer(module_inst, msg_buffer_offset, msg_buffer_length);
@@ -655,6 +685,8 @@ extern "C" bool random_identifier_wrapper(
     int32 buffer_offset         // uint8_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     if (length <= 0)
         return false;
@@ -693,6 +725,8 @@ extern "C" bool sha256_hmac_wrapper(
     int32 hmac_buffer_pointer_offset, // uint8_t**
     int32 hmac_length_pointer_offset) // size_t*
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* msg_buffer = (uint8_t*)get_buffer(module_inst, msg_buffer_offset, msg_buffer_length);
@@ -739,6 +773,8 @@ extern "C" bool sha384_hmac_wrapper(
     int32 hmac_buffer_pointer_offset, // uint8_t**
     int32 hmac_length_pointer_offset) // size_t*
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* msg_buffer = (uint8_t*)get_buffer(module_inst, msg_buffer_offset, msg_buffer_length);
@@ -785,6 +821,8 @@ extern "C" bool sha512_hmac_wrapper(
     int32 hmac_buffer_pointer_offset, // uint8_t**
     int32 hmac_length_pointer_offset) // size_t*
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t* msg_buffer = (uint8_t*)get_buffer(module_inst, msg_buffer_offset, msg_buffer_length);
@@ -832,6 +870,8 @@ extern "C" bool sha512_pbkd_wrapper(
     int32 key_length_pointer_offset  // size_t*
     )
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         const char* pw_buffer = (const char*)get_buffer(module_inst, pw_buffer_offset, pw_length);
@@ -875,6 +915,8 @@ extern "C" bool verify_sgx_report_wrapper(
     const int32 signature_buffer_offset,    // char*
     const int32 signature_buffer_length)    // size_t
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         const char* signing_cert_buffer =
@@ -916,6 +958,8 @@ extern "C" bool parse_sgx_report_wrapper(
     int32 msg_buffer_pointer_offset,
     int32 msg_length_pointer_offset)
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         uint8_t *pointer;
@@ -33,6 +33,7 @@
 
 #include "WasmCryptoExtensions.h"
 #include "WasmStateExtensions.h"
+#include "WasmStringExtensions.h"
 #include "WasmUtil.h"
 
 namespace pe = pdo::error;
@@ -46,6 +47,8 @@ extern "C" int32 memchr_wrapper(
     int32 ch,
     uint32 src_size)
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         if (src_size == 0)
@@ -75,6 +78,8 @@ extern "C" bool contract_log_wrapper(
     const int32 loglevel,
     const char* buffer)
 {
+    count_native_call(exec_env);
+
     // wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         SAFE_LOG(loglevel, "CONTRACT: %s", buffer);
@@ -94,6 +99,8 @@ extern "C" int simple_hash_wrapper(
     uint8_t* buffer,
     const int buffer_length)
 {
+    count_native_call(exec_env);
+
     // wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         if (buffer == NULL)
@@ -123,6 +130,8 @@ extern "C" double strtod_wrapper(
     const char *nptr,
     char **endptr)
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     double num = 0;
 
@@ -147,7 +156,11 @@ extern "C" {
 #endif
 
 #define WASM_PASSTHRU_FUNCTION(function) \
-    static int function##_wrapper(wasm_module_inst_t m, int c) { return function(c); }
+    static int function##_wrapper(wasm_exec_env_t exec_env, int c)     \
+    {                                                                   \
+        count_native_call(exec_env);                                    \
+        return function(c);                                             \
+    }
 
 WASM_PASSTHRU_FUNCTION(iscntrl)
 WASM_PASSTHRU_FUNCTION(islower)
@@ -197,6 +210,7 @@ static NativeSymbol native_symbols[] =
     /* Persistent store operations from WasmStateExtensions.h */
     EXPORT_WASM_API_WITH_SIG2(key_value_set,"(i*~*~)i"),
     EXPORT_WASM_API_WITH_SIG2(key_value_get,"(i*~ii)i"),
+    EXPORT_WASM_API_WITH_SIG2(key_value_get_into,"(i*~*~ii)i"),
     EXPORT_WASM_API_WITH_SIG2(privileged_key_value_get,"(*~ii)i"),
 
     EXPORT_WASM_API_WITH_SIG2(key_value_create,"(*~)i"),
@@ -204,6 +218,18 @@ static NativeSymbol native_symbols[] =
     EXPORT_WASM_API_WITH_SIG2(key_value_finalize,"(iii)i"),
 
 
+    /* Memory and string operations from WasmStringExtensions.h */
+    EXPORT_WASM_API_WITH_SIG2(buffer_compare,"(*~*~i)i"),
+    EXPORT_WASM_API_WITH_SIG2(buffer_find,"(*~*~)i"),
+    EXPORT_WASM_API_WITH_SIG2(buffer_move,"(*~*~)i"),
+    EXPORT_WASM_API_WITH_SIG2(sort_records,"(*~iii)i"),
+    EXPORT_WASM_API_WITH_SIG2(parse_integer,"(*~ii)i"),
+    EXPORT_WASM_API_WITH_SIG2(format_integer,"(Ii*~i)i"),
+    EXPORT_WASM_API_WITH_SIG2(hex_encode,"(*~*~i)i"),
+    EXPORT_WASM_API_WITH_SIG2(hex_decode,"(*~*~i)i"),
+    EXPORT_WASM_API_WITH_SIG2(b64_encode_into,"(*~*~i)i"),
+    EXPORT_WASM_API_WITH_SIG2(b64_decode_into,"(*~*~i)i"),
+
     /* Utility functions */
     EXPORT_WASM_API_WITH_SIG2(contract_log, "(i$)i"),
     EXPORT_WASM_API_WITH_SIG2(simple_hash, "(*~)i"),
@@ -43,6 +43,19 @@ bool key_value_get(
     uint8_t** val_buffer_pointer,
     size_t* val_length_pointer);
 
+// copies the value into val_buffer, val_length_pointer always receives
+// the size of the value; a value that does not fit is returned in a new
+// buffer through val_buffer_pointer, which the caller must free, or the
+// call fails when val_buffer_pointer is NULL
+bool key_value_get_into(
+    const size_t handle,
+    const uint8_t* key_buffer,
+    const size_t key_buffer_length,
+    uint8_t* val_buffer,
+    const size_t val_buffer_length,
+    uint8_t** val_buffer_pointer,
+    size_t* val_length_pointer);
+
 bool privileged_key_value_get(
     const uint8_t* key_buffer,
     const size_t key_buffer_length,
@@ -219,6 +232,76 @@ bool parse_sgx_report(
     char** msg_buffer,
     size_t* msg_length);
 
+// From WasmStringExtensions; functions that produce output write into
+// the buffer provided, the length pointer always receives the size of
+// the result so a short buffer can be retried
+bool buffer_compare(
+    const uint8_t* buffer1,
+    const size_t buffer1_length,
+    const uint8_t* buffer2,
+    const size_t buffer2_length,
+    int* result);
+
+int buffer_find(
+    const uint8_t* buffer,
+    const size_t buffer_length,
+    const uint8_t* pattern,
+    const size_t pattern_length);
+
+bool buffer_move(
+    uint8_t* dst_buffer,
+    const size_t dst_length,
+    const uint8_t* src_buffer,
+    const size_t src_length);
+
+bool sort_records(
+    uint8_t* buffer,
+    const size_t buffer_length,
+    const size_t record_size,
+    const size_t key_offset,
+    const size_t key_size);
+
+bool parse_integer(
+    const char* buffer,
+    const size_t buffer_length,
+    const int base,
+    int64_t* value);
+
+bool format_integer(
+    const int64_t value,
+    const int base,
+    char* buffer,
+    const size_t buffer_length,
+    size_t* length_pointer);
+
+bool hex_encode(
+    const uint8_t* src_buffer,
+    const size_t src_length,
+    char* dst_buffer,
+    const size_t dst_length,
+    size_t* length_pointer);
+
+bool hex_decode(
+    const char* src_buffer,
+    const size_t src_length,
+    uint8_t* dst_buffer,
+    const size_t dst_length,
+    size_t* length_pointer);
+
+bool b64_encode_into(
+    const uint8_t* src_buffer,
+    const size_t src_length,
+    char* dst_buffer,
+    const size_t dst_length,
+    size_t* length_pointer);
+
+bool b64_decode_into(
+    const char* src_buffer,
+    const size_t src_length,
+    uint8_t* dst_buffer,
+    const size_t dst_length,
+    size_t* length_pointer);
+
 // From WasmExtensions
 bool contract_log(
     const uint32_t loglevel,
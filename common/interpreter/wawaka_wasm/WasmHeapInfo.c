@@ -0,0 +1,55 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// this file is C and uses the WAMR internal headers, the layout of the
+// module instance depends on the WAMR build definitions so it must be
+// compiled with the same configuration as the runtime
+
+#include "WasmHeapInfo.h"
+
+#if WAMR_HAS_HEAP_STATS
+#include "wasm_runtime.h"
+#include "ems/ems_gc.h"
+#endif
+
+bool wawaka_get_app_heap_info(
+    wasm_module_inst_t module_inst,
+    uint32 *total_size,
+    uint32 *free_size,
+    uint32 *highmark_size)
+{
+#if WAMR_HAS_HEAP_STATS
+    WASMModuleInstance *instance = (WASMModuleInstance *)module_inst;
+    WASMMemoryInstance *memory;
+    uint32 stats[GC_STAT_HIGHMARK + 1];
+
+    // wawaka only runs the interpreter
+    if (instance == NULL || instance->module_type != Wasm_Module_Bytecode)
+        return false;
+
+    memory = instance->default_memory;
+    if (memory == NULL || memory->heap_handle == NULL)
+        return false;
+
+    gc_heap_stats(memory->heap_handle, stats, GC_STAT_HIGHMARK + 1);
+
+    *total_size = stats[GC_STAT_TOTAL];
+    *free_size = stats[GC_STAT_FREE];
+    *highmark_size = stats[GC_STAT_HIGHMARK];
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,37 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "wasm_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The app heap of a module instance serves the malloc and free calls
+// of the contract. WAMR does not export its usage, this reads the
+// statistics kept by the heap allocator of the instance; returns false
+// when the build could not find the allocator statistics or the
+// instance has no app heap
+bool wawaka_get_app_heap_info(
+    wasm_module_inst_t module_inst,
+    uint32 *total_size,
+    uint32 *free_size,
+    uint32 *highmark_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,747 @@
+/* Copyright 2022 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "error.h"
+#include "log.h"
+#include "pdo_error.h"
+#include "types.h"
+
+#include "WasmMeter.h"
+
+namespace pe = pdo::error;
+
+// section identifiers from the wasm binary format
+#define SECTION_CUSTOM      0
+#define SECTION_TYPE        1
+#define SECTION_IMPORT      2
+#define SECTION_FUNCTION    3
+#define SECTION_GLOBAL      6
+#define SECTION_EXPORT      7
+#define SECTION_DATACOUNT   12
+#define SECTION_CODE        10
+
+#define EXTERNAL_FUNCTION   0x00
+#define EXTERNAL_TABLE      0x01
+#define EXTERNAL_MEMORY     0x02
+#define EXTERNAL_GLOBAL     0x03
+
+#define TYPE_I64            0x7E
+#define TYPE_FUNC           0x60
+#define BLOCKTYPE_EMPTY     0x40
+
+/* ----------------------------------------------------------------- *
+ * Reader over a range of the module, all reads are bounds checked
+ * ----------------------------------------------------------------- */
+class WasmReader
+{
+public:
+    const uint8_t* data_;
+    size_t pos_;
+    size_t end_;
+
+    WasmReader(const uint8_t* data, size_t begin, size_t end) :
+        data_(data), pos_(begin), end_(end) {}
+
+    bool done(void) const { return pos_ >= end_; }
+
+    uint8_t peek(void) const
+    {
+        pe::ThrowIf<pe::ValueError>(pos_ >= end_, "wasm meter; unexpected end of module");
+        return data_[pos_];
+    }
+
+    uint8_t read_u8(void)
+    {
+        uint8_t value = peek();
+        pos_++;
+        return value;
+    }
+
+    uint64_t read_leb(size_t max_bits)
+    {
+        uint64_t value = 0;
+        size_t shift = 0;
+        uint8_t byte;
+        do {
+            pe::ThrowIf<pe::ValueError>(shift >= max_bits, "wasm meter; invalid integer encoding");
+            byte = read_u8();
+            value |= (uint64_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+
+        return value;
+    }
+
+    uint32_t read_u32(void)
+    {
+        return (uint32_t)read_leb(32);
+    }
+
+    // signed values are only skipped, the metering pass never needs them
+    void skip_leb(size_t max_bits)
+    {
+        read_leb(max_bits);
+    }
+
+    void skip(size_t count)
+    {
+        pe::ThrowIf<pe::ValueError>(end_ - pos_ < count, "wasm meter; unexpected end of module");
+        pos_ += count;
+    }
+
+    void skip_name(void)
+    {
+        skip(read_u32());
+    }
+
+    std::string read_name(void)
+    {
+        uint32_t length = read_u32();
+        skip(length);
+        return std::string((const char*)data_ + pos_ - length, length);
+    }
+
+    void skip_limits(void)
+    {
+        uint8_t flags = read_u8();
+        read_u32();
+        if (flags & 0x01)
+            read_u32();
+    }
+};
+
+/* ----------------------------------------------------------------- *
+ * Encoding helpers
+ * ----------------------------------------------------------------- */
+static void write_u32(ByteArray& out, uint32_t value)
+{
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if (value != 0)
+            byte |= 0x80;
+        out.push_back(byte);
+    } while (value != 0);
+}
+
+static void write_s64(ByteArray& out, int64_t value)
+{
+    bool more = true;
+    while (more)
+    {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if ((value == 0 && (byte & 0x40) == 0) || (value == -1 && (byte & 0x40) != 0))
+            more = false;
+        else
+            byte |= 0x80;
+        out.push_back(byte);
+    }
+}
+
+static void write_name(ByteArray& out, const char* name)
+{
+    size_t length = strlen(name);
+    write_u32(out, length);
+    out.insert(out.end(), name, name + length);
+}
+
+static void write_section(ByteArray& out, uint8_t id, const ByteArray& payload)
+{
+    out.push_back(id);
+    write_u32(out, payload.size());
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: emit_charge
+ *
+ * global.get g; i64.const cost; i64.sub; global.set g;
+ * global.get g; i64.const 0; i64.lt_s; if; unreachable; end
+ * ----------------------------------------------------------------- */
+static void emit_charge(ByteArray& out, uint32_t gas_global, uint64_t cost)
+{
+    out.push_back(0x23);
+    write_u32(out, gas_global);
+    out.push_back(0x42);
+    write_s64(out, (int64_t)cost);
+    out.push_back(0x7D);
+    out.push_back(0x24);
+    write_u32(out, gas_global);
+
+    out.push_back(0x23);
+    write_u32(out, gas_global);
+    out.push_back(0x42);
+    out.push_back(0x00);
+    out.push_back(0x53);
+    out.push_back(0x04);
+    out.push_back(BLOCKTYPE_EMPTY);
+    out.push_back(0x00);
+    out.push_back(0x0B);
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: skip_blocktype
+ * ----------------------------------------------------------------- */
+static void skip_blocktype(WasmReader& reader)
+{
+    uint8_t type = reader.peek();
+    switch (type)
+    {
+    case BLOCKTYPE_EMPTY:
+    case 0x7F: case 0x7E: case 0x7D: case 0x7C: case 0x7B:
+    case 0x70: case 0x6F:
+        reader.skip(1);
+        break;
+    default:
+        // multi-value blocks reference a type index as a signed 33 bit value
+        reader.skip_leb(33);
+        break;
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: skip_prefixed_instruction
+ *
+ * 0xFC prefix: saturating truncation, bulk memory and table operations
+ * ----------------------------------------------------------------- */
+static void skip_prefixed_instruction(WasmReader& reader)
+{
+    uint32_t op = reader.read_u32();
+    switch (op)
+    {
+    case 0: case 1: case 2: case 3: case 4: case 5: case 6: case 7:
+        break;
+    case 8:                     // memory.init
+        reader.read_u32();
+        reader.read_u8();
+        break;
+    case 9:                     // data.drop
+    case 13:                    // elem.drop
+    case 15:                    // table.grow
+    case 16:                    // table.size
+    case 17:                    // table.fill
+        reader.read_u32();
+        break;
+    case 10:                    // memory.copy
+        reader.read_u8();
+        reader.read_u8();
+        break;
+    case 11:                    // memory.fill
+        reader.read_u8();
+        break;
+    case 12:                    // table.init
+    case 14:                    // table.copy
+        reader.read_u32();
+        reader.read_u32();
+        break;
+    default:
+        pe::ThrowIf<pe::ValueError>(true, "wasm meter; unsupported instruction");
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: meter_function_body
+ *
+ * Split the body into straight-line segments, a segment ends after any
+ * instruction that starts a block or transfers control. The charge for
+ * the whole segment is inserted at its start; code skipped by an early
+ * exit from the segment is still charged, which keeps the count a
+ * function of the control flow alone.
+ * ----------------------------------------------------------------- */
+typedef struct
+{
+    size_t offset;
+    uint64_t cost;
+} segment_t;
+
+static void meter_function_body(
+    const uint8_t* data,
+    size_t begin,
+    size_t end,
+    uint32_t gas_global,
+    ByteArray& out)
+{
+    WasmReader reader(data, begin, end);
+
+    // local declarations are copied unchanged
+    uint32_t local_groups = reader.read_u32();
+    for (uint32_t i = 0; i < local_groups; i++)
+    {
+        reader.read_u32();
+        reader.read_u8();
+    }
+
+    size_t code_begin = reader.pos_;
+    out.insert(out.end(), data + begin, data + code_begin);
+
+    std::vector<segment_t> segments;
+    segment_t segment = { code_begin, 0 };
+    segments.push_back(segment);
+
+    size_t depth = 0;
+    bool complete = false;
+
+    while (! complete)
+    {
+        uint8_t op = reader.read_u8();
+        segments.back().cost++;
+
+        bool split = false;
+        switch (op)
+        {
+        case 0x00:              // unreachable
+        case 0x0F:              // return
+            split = true;
+            break;
+
+        case 0x01:              // nop
+        case 0x1A:              // drop
+        case 0x1B:              // select
+        case 0xD1:              // ref.is_null
+            break;
+
+        case 0x02:              // block
+        case 0x03:              // loop
+        case 0x04:              // if
+            skip_blocktype(reader);
+            depth++;
+            split = true;
+            break;
+
+        case 0x05:              // else
+            split = true;
+            break;
+
+        case 0x0B:              // end
+            if (depth == 0)
+            {
+                complete = true;
+                break;
+            }
+            depth--;
+            split = true;
+            break;
+
+        case 0x0C:              // br
+        case 0x0D:              // br_if
+        case 0x12:              // return_call
+            reader.read_u32();
+            split = true;
+            break;
+
+        case 0x0E:              // br_table
+        {
+            uint32_t count = reader.read_u32();
+            for (uint32_t i = 0; i <= count; i++)
+                reader.read_u32();
+            split = true;
+            break;
+        }
+
+        case 0x10:              // call
+        case 0x20: case 0x21: case 0x22: // local.get, local.set, local.tee
+        case 0x23: case 0x24:   // global.get, global.set
+        case 0x25: case 0x26:   // table.get, table.set
+        case 0xD2:              // ref.func
+            reader.read_u32();
+            break;
+
+        case 0x11:              // call_indirect
+            reader.read_u32();
+            reader.read_u32();
+            break;
+
+        case 0x13:              // return_call_indirect
+            reader.read_u32();
+            reader.read_u32();
+            split = true;
+            break;
+
+        case 0x1C:              // select with types
+        {
+            uint32_t count = reader.read_u32();
+            reader.skip(count);
+            break;
+        }
+
+        case 0x3F:              // memory.size
+        case 0x40:              // memory.grow
+        case 0xD0:              // ref.null
+            reader.read_u8();
+            break;
+
+        case 0x41:              // i32.const
+            reader.skip_leb(35);
+            break;
+
+        case 0x42:              // i64.const
+            reader.skip_leb(70);
+            break;
+
+        case 0x43:              // f32.const
+            reader.skip(4);
+            break;
+
+        case 0x44:              // f64.const
+            reader.skip(8);
+            break;
+
+        case 0xFC:
+            skip_prefixed_instruction(reader);
+            break;
+
+        default:
+            if (op >= 0x28 && op <= 0x3E)
+            {
+                // loads and stores, alignment and offset
+                reader.read_u32();
+                reader.read_u32();
+            }
+            else
+            {
+                // numeric instructions carry no immediates, anything
+                // else (simd, atomics) is not supported
+                pe::ThrowIf<pe::ValueError>(
+                    op < 0x45 || op > 0xC4, "wasm meter; unsupported instruction");
+            }
+            break;
+        }
+
+        if (split)
+        {
+            segment_t next = { reader.pos_, 0 };
+            segments.push_back(next);
+        }
+    }
+
+    pe::ThrowIf<pe::ValueError>(reader.pos_ != end, "wasm meter; malformed function body");
+
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        size_t segment_end = (i + 1 < segments.size() ? segments[i + 1].offset : end);
+        if (segments[i].cost > 0)
+            emit_charge(out, gas_global, segments[i].cost);
+        out.insert(out.end(), data + segments[i].offset, data + segment_end);
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * Section bookkeeping
+ * ----------------------------------------------------------------- */
+typedef struct
+{
+    uint8_t id;
+    size_t begin;               // payload
+    size_t end;
+} section_t;
+
+typedef struct
+{
+    uint32_t function_count;    // functions defined in the original module
+    uint32_t set_type;
+    uint32_t get_type;
+    uint32_t set_function;
+    uint32_t get_function;
+    uint32_t gas_global;
+} meter_indices_t;
+
+// position of known sections in the module, the data count section
+// sits between the element and code sections
+static int section_order(uint8_t id)
+{
+    if (id == SECTION_DATACOUNT)
+        return 2 * 9 + 1;
+    return 2 * id;
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: extend_section
+ *
+ * Append the metering entries to a section, the section is created
+ * when the module does not have one. Entries are appended so the
+ * indices of existing types, functions and globals do not change.
+ * ----------------------------------------------------------------- */
+static void extend_section(
+    uint8_t id,
+    const uint8_t* data,
+    const section_t* existing,
+    const meter_indices_t& indices,
+    ByteArray& payload)
+{
+    WasmReader reader(data, 0, 0);
+    uint32_t count = 0;
+    if (existing != NULL)
+    {
+        reader = WasmReader(data, existing->begin, existing->end);
+        count = reader.read_u32();
+    }
+
+    switch (id)
+    {
+    case SECTION_TYPE:
+        write_u32(payload, count + 2);
+        payload.insert(payload.end(), data + reader.pos_, data + reader.end_);
+
+        // (i64) -> ()
+        payload.push_back(TYPE_FUNC);
+        write_u32(payload, 1);
+        payload.push_back(TYPE_I64);
+        write_u32(payload, 0);
+
+        // () -> (i64)
+        payload.push_back(TYPE_FUNC);
+        write_u32(payload, 0);
+        write_u32(payload, 1);
+        payload.push_back(TYPE_I64);
+        break;
+
+    case SECTION_FUNCTION:
+        write_u32(payload, count + 2);
+        payload.insert(payload.end(), data + reader.pos_, data + reader.end_);
+        write_u32(payload, indices.set_type);
+        write_u32(payload, indices.get_type);
+        break;
+
+    case SECTION_GLOBAL:
+        // mutable i64, the budget is unlimited until it is set
+        write_u32(payload, count + 1);
+        payload.insert(payload.end(), data + reader.pos_, data + reader.end_);
+        payload.push_back(TYPE_I64);
+        payload.push_back(0x01);
+        payload.push_back(0x42);
+        write_s64(payload, INT64_MAX);
+        payload.push_back(0x0B);
+        break;
+
+    case SECTION_EXPORT:
+        write_u32(payload, count + 2);
+        payload.insert(payload.end(), data + reader.pos_, data + reader.end_);
+        write_name(payload, WASM_METER_SET_FUNCTION);
+        payload.push_back(EXTERNAL_FUNCTION);
+        write_u32(payload, indices.set_function);
+        write_name(payload, WASM_METER_GET_FUNCTION);
+        payload.push_back(EXTERNAL_FUNCTION);
+        write_u32(payload, indices.get_function);
+        break;
+
+    case SECTION_CODE:
+    {
+        pe::ThrowIf<pe::ValueError>(
+            count != indices.function_count, "wasm meter; function and code sections do not match");
+
+        write_u32(payload, count + 2);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint32_t size = reader.read_u32();
+            size_t begin = reader.pos_;
+            reader.skip(size);
+
+            ByteArray body;
+            meter_function_body(data, begin, reader.pos_, indices.gas_global, body);
+            write_u32(payload, body.size());
+            payload.insert(payload.end(), body.begin(), body.end());
+        }
+        pe::ThrowIf<pe::ValueError>(! reader.done(), "wasm meter; malformed code section");
+
+        // set: local.get 0; global.set g
+        ByteArray body;
+        write_u32(body, 0);
+        body.push_back(0x20);
+        write_u32(body, 0);
+        body.push_back(0x24);
+        write_u32(body, indices.gas_global);
+        body.push_back(0x0B);
+        write_u32(payload, body.size());
+        payload.insert(payload.end(), body.begin(), body.end());
+
+        // get: global.get g
+        body.clear();
+        write_u32(body, 0);
+        body.push_back(0x23);
+        write_u32(body, indices.gas_global);
+        body.push_back(0x0B);
+        write_u32(payload, body.size());
+        payload.insert(payload.end(), body.begin(), body.end());
+        break;
+    }
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: wasm_meter_module
+ * ----------------------------------------------------------------- */
+void wasm_meter_module(
+    const ByteArray& inModule,
+    ByteArray& outModule)
+{
+    static const uint8_t header[] = { 0x00, 0x61, 0x73, 0x6D, 0x01, 0x00, 0x00, 0x00 };
+
+    pe::ThrowIf<pe::ValueError>(
+        inModule.size() < sizeof(header) || memcmp(inModule.data(), header, sizeof(header)) != 0,
+        "wasm meter; invalid module header");
+
+    const uint8_t* data = inModule.data();
+    std::vector<section_t> sections;
+
+    uint32_t type_count = 0;
+    uint32_t imported_functions = 0;
+    uint32_t imported_globals = 0;
+    uint32_t function_count = 0;
+    uint32_t global_count = 0;
+
+    // first pass, find the sections and the size of the index spaces
+    WasmReader module(data, sizeof(header), inModule.size());
+    while (! module.done())
+    {
+        section_t section;
+        section.id = module.read_u8();
+        uint32_t size = module.read_u32();
+        section.begin = module.pos_;
+        module.skip(size);
+        section.end = module.pos_;
+        sections.push_back(section);
+
+        WasmReader reader(data, section.begin, section.end);
+        switch (section.id)
+        {
+        case SECTION_TYPE:
+            type_count = reader.read_u32();
+            break;
+
+        case SECTION_IMPORT:
+        {
+            uint32_t count = reader.read_u32();
+            for (uint32_t i = 0; i < count; i++)
+            {
+                reader.skip_name();
+                reader.skip_name();
+                switch (reader.read_u8())
+                {
+                case EXTERNAL_FUNCTION:
+                    reader.read_u32();
+                    imported_functions++;
+                    break;
+                case EXTERNAL_TABLE:
+                    reader.read_u8();
+                    reader.skip_limits();
+                    break;
+                case EXTERNAL_MEMORY:
+                    reader.skip_limits();
+                    break;
+                case EXTERNAL_GLOBAL:
+                    reader.read_u8();
+                    reader.read_u8();
+                    imported_globals++;
+                    break;
+                default:
+                    pe::ThrowIf<pe::ValueError>(true, "wasm meter; invalid import");
+                }
+            }
+            break;
+        }
+
+        case SECTION_FUNCTION:
+            function_count = reader.read_u32();
+            break;
+
+        case SECTION_GLOBAL:
+            global_count = reader.read_u32();
+            break;
+
+        case SECTION_EXPORT:
+        {
+            uint32_t count = reader.read_u32();
+            for (uint32_t i = 0; i < count; i++)
+            {
+                std::string name = reader.read_name();
+                pe::ThrowIf<pe::ValueError>(
+                    name == WASM_METER_SET_FUNCTION || name == WASM_METER_GET_FUNCTION,
+                    "wasm meter; module exports a reserved name");
+                reader.read_u8();
+                reader.read_u32();
+            }
+            break;
+        }
+        }
+    }
+
+    meter_indices_t indices;
+    indices.function_count = function_count;
+    indices.set_type = type_count;
+    indices.get_type = type_count + 1;
+    indices.set_function = imported_functions + function_count;
+    indices.get_function = indices.set_function + 1;
+    indices.gas_global = imported_globals + global_count;
+
+    // second pass, copy the module and extend the sections that change;
+    // a missing section is created before the first section that must
+    // follow it
+    static const uint8_t extended[] = {
+        SECTION_TYPE, SECTION_FUNCTION, SECTION_GLOBAL, SECTION_EXPORT, SECTION_CODE
+    };
+    bool present[sizeof(extended)] = { false };
+
+    outModule.clear();
+    outModule.reserve(inModule.size() + inModule.size() / 2);
+    outModule.insert(outModule.end(), header, header + sizeof(header));
+
+    for (size_t s = 0; s <= sections.size(); s++)
+    {
+        const section_t* section = (s < sections.size() ? &sections[s] : NULL);
+
+        for (size_t e = 0; e < sizeof(extended); e++)
+        {
+            if (present[e])
+                continue;
+
+            bool follows = (section == NULL) ||
+                (section->id != SECTION_CUSTOM && section_order(section->id) > section_order(extended[e]));
+            if (! follows)
+                continue;
+
+            ByteArray payload;
+            extend_section(extended[e], data, NULL, indices, payload);
+            write_section(outModule, extended[e], payload);
+            present[e] = true;
+        }
+
+        if (section == NULL)
+            break;
+
+        const uint8_t* e = (const uint8_t*)memchr(extended, section->id, sizeof(extended));
+        if (e != NULL)
+        {
+            ByteArray payload;
+            extend_section(section->id, data, section, indices, payload);
+            write_section(outModule, section->id, payload);
+            present[e - extended] = true;
+        }
+        else
+        {
+            outModule.push_back(section->id);
+            write_u32(outModule, section->end - section->begin);
+            outModule.insert(outModule.end(), data + section->begin, data + section->end);
+        }
+    }
+
+    SAFE_LOG(PDO_LOG_DEBUG, "metered module size %zu, original size %zu", outModule.size(), inModule.size());
+}
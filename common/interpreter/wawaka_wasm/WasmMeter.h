@@ -0,0 +1,34 @@
+/* Copyright 2022 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "types.h"
+
+// The metering pass rewrites a wasm module so that it counts the
+// instructions it executes. A mutable i64 global holds the remaining
+// budget; every straight-line segment of code subtracts its instruction
+// count from the budget before it runs and traps with unreachable when
+// the budget drops below zero. Two functions are added to the module
+// and exported to set and read the remaining budget.
+
+#define WASM_METER_SET_FUNCTION "__pdo_gas_set"
+#define WASM_METER_GET_FUNCTION "__pdo_gas_get"
+
+// throws ValueError if the module is malformed or uses instructions
+// that the metering pass does not understand
+extern void wasm_meter_module(
+    const ByteArray& inModule,
+    ByteArray& outModule);
@@ -75,6 +75,8 @@ extern "C" bool key_value_set_wrapper(
     const uint8_t* val_buffer,
     const int32 val_buffer_length) // size_t
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         pstate::Basic_KV_Plus* state = fetch_state_from_handle(module_inst, kv_store_handle);
@@ -114,6 +116,8 @@ extern "C" bool key_value_get_wrapper(
     int32 val_buffer_pointer_offset, // uint8_t**
     int32 val_length_pointer_offset) // size_t*
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         pstate::Basic_KV_Plus* state = fetch_state_from_handle(module_inst, kv_store_handle);
@@ -146,6 +150,91 @@ extern "C" bool key_value_get_wrapper(
     }
 }
 
+/* ----------------------------------------------------------------- *
+ * NAME: _key_value_get_into_wrapper
+ *
+ * Copy the value into a buffer provided by the contract rather than
+ * allocating a new one in the module heap. The size of the value is
+ * always written to the length pointer. A value that does not fit is
+ * copied into a new buffer in the module heap and returned through
+ * the buffer pointer, so the value is fetched from the state only
+ * once; when the buffer pointer is 0 nothing is copied and false is
+ * returned.
+ * ----------------------------------------------------------------- */
+extern "C" bool key_value_get_into_wrapper(
+    wasm_exec_env_t exec_env,
+    const int32 kv_store_handle,
+    const uint8_t* key_buffer,
+    const int32 key_buffer_length, // size_t
+    uint8_t* val_buffer,
+    const int32 val_buffer_length, // size_t
+    int32 val_buffer_pointer_offset, // uint8_t**
+    int32 val_length_pointer_offset) // size_t*
+{
+    count_native_call(exec_env);
+
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    try {
+        pstate::Basic_KV_Plus* state = fetch_state_from_handle(module_inst, kv_store_handle);
+        if (state == NULL)
+            return false;
+
+        if (key_buffer == NULL)
+            return false;
+
+        if (val_buffer == NULL && val_buffer_length > 0)
+            return false;
+
+        if (! wasm_runtime_validate_app_addr(module_inst, val_length_pointer_offset, sizeof(uint32_t)))
+        {
+            SAFE_LOG(PDO_LOG_INFO, "invalid address passed as length pointer");
+            return false;
+        }
+
+        int32* buffer_pointer = NULL;
+        if (val_buffer_pointer_offset != 0)
+        {
+            if (! wasm_runtime_validate_app_addr(module_inst, val_buffer_pointer_offset, sizeof(int32)))
+            {
+                SAFE_LOG(PDO_LOG_INFO, "invalid address passed as buffer pointer");
+                return false;
+            }
+
+            buffer_pointer = (int32*)wasm_runtime_addr_app_to_native(module_inst, val_buffer_pointer_offset);
+            (*buffer_pointer) = 0;
+        }
+
+        uint32_t* length_pointer = (uint32_t*)wasm_runtime_addr_app_to_native(module_inst, val_length_pointer_offset);
+        (*length_pointer) = 0;
+
+        ByteArray ba_key(key_buffer, key_buffer + key_buffer_length);
+        ByteArray ba_val = state->UnprivilegedGet(ba_key);
+
+        if (ba_val.size() == 0)
+            return false;
+
+        (*length_pointer) = ba_val.size();
+        if (ba_val.size() <= (size_t)val_buffer_length)
+        {
+            memcpy(val_buffer, ba_val.data(), ba_val.size());
+            return true;
+        }
+
+        if (buffer_pointer == NULL)
+            return false;
+
+        return save_buffer(module_inst, ba_val, val_buffer_pointer_offset, val_length_pointer_offset);
+    }
+    catch (pdo::error::Error& e) {
+        SAFE_LOG(PDO_LOG_ERROR, "failure in %s; %s", __FUNCTION__, e.what());
+        return false;
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return false;
+    }
+}
+
 /* ----------------------------------------------------------------- *
  * NAME: _privilege_key_value_get_wrapper
  * ----------------------------------------------------------------- */
@@ -156,6 +245,8 @@ extern "C" bool privileged_key_value_get_wrapper(
     int32 val_buffer_pointer_offset, // uint8_t**
     int32 val_length_pointer_offset) // size_t*
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         pstate::Basic_KV_Plus* state = fetch_state_from_handle(module_inst, 0);
@@ -196,6 +287,8 @@ extern "C" int32 key_value_create_wrapper(
     const uint8_t* aes_key_buffer,
     const int32 aes_key_buffer_length)
 {
+    count_native_call(exec_env);
+
     SAFE_LOG(PDO_LOG_ERROR, "using experimental feature for multiple key/value stores");
 
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
@@ -251,6 +344,8 @@ extern "C" int32 key_value_open_wrapper(
     const uint8_t* aes_key_buffer,
     const int32 aes_key_buffer_length)
 {
+    count_native_call(exec_env);
+
     SAFE_LOG(PDO_LOG_ERROR, "using experimental feature for multiple key/value stores");
 
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
@@ -310,6 +405,8 @@ extern "C" bool key_value_finalize_wrapper(
     int32 id_hash_buffer_pointer_offset,
     int32 id_hash_length_pointer_offset)
 {
+    count_native_call(exec_env);
+
     wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
     try {
         if (kv_store_handle == 0)
@@ -332,6 +429,11 @@ extern "C" bool key_value_finalize_wrapper(
             return false;
         }
 
+        // the work done by the store is charged to the invocation
+        pdo_resource_counters_t* counters = get_resource_counters(exec_env);
+        if (counters != NULL)
+            pdo::resource::Accumulate(*counters, state->ResourceCounters());
+
         // Clean up the memory used
         delete state;
 
@@ -0,0 +1,599 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+Native implementations of bulk memory and string operations. These run
+many times faster than the same loops interpreted as wasm bytecode.
+
+Every buffer is passed with its length so the runtime validates it
+against the module memory before the wrapper is called. Functions that
+produce output write into a buffer provided by the contract; the size
+of the result is always written to the length pointer so a contract
+can retry with a larger buffer when false is returned.
+*/
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "bh_platform.h"
+#include "wasm_export.h"
+#include "lib_export.h"
+
+#include "error.h"
+#include "log.h"
+#include "pdo_error.h"
+#include "types.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "WasmStringExtensions.h"
+#include "WasmUtil.h"
+
+namespace pe = pdo::error;
+
+/* ----------------------------------------------------------------- *
+ * NAME: get_length_pointer
+ * ----------------------------------------------------------------- */
+static uint32_t* get_length_pointer(
+    wasm_module_inst_t module_inst,
+    const int32 length_pointer_offset)
+{
+    if (! wasm_runtime_validate_app_addr(module_inst, length_pointer_offset, sizeof(uint32_t)))
+    {
+        SAFE_LOG(PDO_LOG_INFO, "invalid address passed as length pointer");
+        return NULL;
+    }
+
+    uint32_t* length_pointer = (uint32_t*)wasm_runtime_addr_app_to_native(module_inst, length_pointer_offset);
+    (*length_pointer) = 0;
+
+    return length_pointer;
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: save_result
+ *
+ * copy the result into the contract buffer if it fits, the size of
+ * the result is reported either way
+ * ----------------------------------------------------------------- */
+static bool save_result(
+    const uint8_t* result,
+    const size_t result_length,
+    uint8_t* dst_buffer,
+    const int32 dst_length,
+    uint32_t* length_pointer)
+{
+    (*length_pointer) = result_length;
+    if (result_length > (size_t)dst_length)
+        return false;
+
+    if (result_length > 0)
+        memcpy(dst_buffer, result, result_length);
+
+    return true;
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: _buffer_compare_wrapper
+ *
+ * lexicographic comparison, a buffer that is a prefix of the other
+ * sorts first; the result is -1, 0 or 1 and is written only when the
+ * comparison succeeds
+ * ----------------------------------------------------------------- */
+extern "C" bool buffer_compare_wrapper(
+    wasm_exec_env_t exec_env,
+    const uint8_t* buffer1,
+    const int32 buffer1_length, // size_t
+    const uint8_t* buffer2,
+    const int32 buffer2_length, // size_t
+    int32 result_pointer_offset) // int32_t*
+{
+    count_native_call(exec_env);
+
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    try {
+        if (! wasm_runtime_validate_app_addr(module_inst, result_pointer_offset, sizeof(int32_t)))
+        {
+            SAFE_LOG(PDO_LOG_INFO, "invalid address passed as result pointer");
+            return false;
+        }
+
+        if ((buffer1 == NULL && buffer1_length > 0) || (buffer2 == NULL && buffer2_length > 0))
+            return false;
+
+        int32_t result = 0;
+
+        const size_t length = std::min(buffer1_length, buffer2_length);
+        if (length > 0)
+            result = memcmp(buffer1, buffer2, length);
+
+        if (result == 0 && buffer1_length != buffer2_length)
+            result = buffer1_length - buffer2_length;
+
+        int32_t* result_pointer = (int32_t*)wasm_runtime_addr_app_to_native(module_inst, result_pointer_offset);
+        (*result_pointer) = (result < 0 ? -1 : (result > 0 ? 1 : 0));
+
+        return true;
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return false;
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: _buffer_find_wrapper
+ *
+ * returns the offset of the first occurrence of pattern in the buffer
+ * or -1 if there is none
+ * ----------------------------------------------------------------- */
+extern "C" int32 buffer_find_wrapper(
+    wasm_exec_env_t exec_env,
+    const uint8_t* buffer,
+    const int32 buffer_length, // size_t
+    const uint8_t* pattern,
+    const int32 pattern_length) // size_t
+{
+    count_native_call(exec_env);
+
+    try {
+        if (pattern_length == 0)
+            return 0;
+
+        if (buffer == NULL || pattern == NULL || pattern_length > buffer_length)
+            return -1;
+
+        const uint8_t* cursor = buffer;
+        const uint8_t* last = buffer + (buffer_length - pattern_length);
+        while (cursor <= last)
+        {
+            cursor = (const uint8_t*)memchr(cursor, pattern[0], last - cursor + 1);
+            if (cursor == NULL)
+                return -1;
+
+            if (memcmp(cursor, pattern, pattern_length) == 0)
+                return cursor - buffer;
+
+            cursor++;
+        }
+
+        return -1;
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return -1;
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: _buffer_move_wrapper
+ * ----------------------------------------------------------------- */
+extern "C" bool buffer_move_wrapper(
+    wasm_exec_env_t exec_env,
+    uint8_t* dst_buffer,
+    const int32 dst_length, // size_t
+    const uint8_t* src_buffer,
+    const int32 src_length) // size_t
+{
+    count_native_call(exec_env);
+
+    try {
+        if (src_length > dst_length)
+            return false;
+
+        if (src_length == 0)
+            return true;
+
+        if (dst_buffer == NULL || src_buffer == NULL)
+            return false;
+
+        memmove(dst_buffer, src_buffer, src_length);
+        return true;
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return false;
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: _sort_records_wrapper
+ *
+ * sort an array of fixed size records in place by the bytes of a key
+ * at a fixed offset in each record; the sort is stable so records
+ * with equal keys keep their order and the result does not depend on
+ * the host library
+ * ----------------------------------------------------------------- */
+extern "C" bool sort_records_wrapper(
+    wasm_exec_env_t exec_env,
+    uint8_t* buffer,
+    const int32 buffer_length, // size_t
+    const int32 record_size, // size_t
+    const int32 key_offset, // size_t
+    const int32 key_size) // size_t
+{
+    count_native_call(exec_env);
+
+    try {
+        if (record_size <= 0 || key_offset < 0 || key_size < 0)
+            return false;
+
+        if (key_size > record_size - key_offset)
+            return false;
+
+        if (buffer_length % record_size != 0)
+            return false;
+
+        const size_t count = buffer_length / record_size;
+        if (count < 2)
+            return true;
+
+        if (buffer == NULL)
+            return false;
+
+        std::vector<uint32_t> order(count);
+        for (size_t i = 0; i < count; i++)
+            order[i] = i;
+
+        const uint8_t* keys = buffer + key_offset;
+        std::stable_sort(order.begin(), order.end(),
+                         [keys, record_size, key_size](const uint32_t a, const uint32_t b) -> bool {
+                             return memcmp(keys + a * record_size, keys + b * record_size, key_size) < 0;
+                         });
+
+        ByteArray sorted(buffer_length);
+        for (size_t i = 0; i < count; i++)
+            memcpy(sorted.data() + i * record_size, buffer + order[i] * record_size, record_size);
+
+        memcpy(buffer, sorted.data(), buffer_length);
+        return true;
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return false;
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: digit_value
+ *
+ * value of a digit in bases up to 36, either case, -1 if c is not a
+ * digit in any base
+ * ----------------------------------------------------------------- */
+static int digit_value(const char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'Z')
+        return 10 + (c - 'A');
+    if (c >= 'a' && c <= 'z')
+        return 10 + (c - 'a');
+    return -1;
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: _parse_integer_wrapper
+ *
+ * the entire buffer must be a valid integer in the base: an optional
+ * minus sign followed by digits of the base; whitespace, a plus sign
+ * and a 0x prefix are rejected even though strtoll accepts them
+ * ----------------------------------------------------------------- */
+extern "C" bool parse_integer_wrapper(
+    wasm_exec_env_t exec_env,
+    const char* buffer,
+    const int32 buffer_length, // size_t
+    const int32 base,
+    int32 value_pointer_offset) // int64_t*
+{
+    count_native_call(exec_env);
+
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    try {
+        if (buffer == NULL || buffer_length == 0)
+            return false;
+
+        if (base < 2 || base > 36)
+            return false;
+
+        if (! wasm_runtime_validate_app_addr(module_inst, value_pointer_offset, sizeof(int64_t)))
+        {
+            SAFE_LOG(PDO_LOG_INFO, "invalid address passed as value pointer");
+            return false;
+        }
+
+        // strtoll also accepts forms that are not plain digits, check that
+        // every character after the sign is a digit of the base first
+        int32 start = (buffer[0] == '-' ? 1 : 0);
+        if (start == buffer_length)
+            return false;
+
+        for (int32 i = start; i < buffer_length; i++)
+        {
+            int digit = digit_value(buffer[i]);
+            if (digit < 0 || digit >= base)
+                return false;
+        }
+
+        // the contract buffer is not null terminated
+        std::string source(buffer, buffer_length);
+
+        char* end = NULL;
+        errno = 0;
+        long long value = strtoll(source.c_str(), &end, base);
+        if (errno != 0 || end != source.c_str() + source.size())
+            return false;
+
+        int64_t* value_pointer = (int64_t*)wasm_runtime_addr_app_to_native(module_inst, value_pointer_offset);
+        (*value_pointer) = value;
+
+        return true;
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return false;
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: _format_integer_wrapper
+ *
+ * the result is not null terminated
+ * ----------------------------------------------------------------- */
+extern "C" bool format_integer_wrapper(
+    wasm_exec_env_t exec_env,
+    const int64 value,
+    const int32 base,
+    char* buffer,
+    const int32 buffer_length, // size_t
+    int32 length_pointer_offset) // size_t*
+{
+    count_native_call(exec_env);
+
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    try {
+        uint32_t* length_pointer = get_length_pointer(module_inst, length_pointer_offset);
+        if (length_pointer == NULL)
+            return false;
+
+        if (base < 2 || base > 36)
+            return false;
+
+        if (buffer == NULL && buffer_length > 0)
+            return false;
+
+        static const char* digits = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+        // the magnitude is accumulated as unsigned so the minimum value does not overflow
+        uint64_t magnitude = (value < 0 ? 0 - (uint64_t)value : (uint64_t)value);
+
+        char result[66];
+        char* cursor = result + sizeof(result);
+        do {
+            *(--cursor) = digits[magnitude % base];
+            magnitude /= base;
+        } while (magnitude > 0);
+
+        if (value < 0)
+            *(--cursor) = '-';
+
+        return save_result((const uint8_t*)cursor, result + sizeof(result) - cursor,
+                           (uint8_t*)buffer, buffer_length, length_pointer);
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return false;
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: _hex_encode_wrapper
+ *
+ * upper case digits to match the encoding used elsewhere in PDO
+ * ----------------------------------------------------------------- */
+extern "C" bool hex_encode_wrapper(
+    wasm_exec_env_t exec_env,
+    const uint8_t* src_buffer,
+    const int32 src_length, // size_t
+    char* dst_buffer,
+    const int32 dst_length, // size_t
+    int32 length_pointer_offset) // size_t*
+{
+    count_native_call(exec_env);
+
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    try {
+        uint32_t* length_pointer = get_length_pointer(module_inst, length_pointer_offset);
+        if (length_pointer == NULL)
+            return false;
+
+        // computed as size_t, twice a large source does not fit in an int32
+        const size_t encoded_length = 2 * (size_t)src_length;
+        (*length_pointer) = encoded_length;
+        if (encoded_length > (size_t)dst_length)
+            return false;
+
+        if (src_length == 0)
+            return true;
+
+        if (src_buffer == NULL || dst_buffer == NULL)
+            return false;
+
+        static const char* digits = "0123456789ABCDEF";
+        for (size_t i = 0; i < (size_t)src_length; i++)
+        {
+            dst_buffer[2 * i] = digits[src_buffer[i] >> 4];
+            dst_buffer[2 * i + 1] = digits[src_buffer[i] & 0x0F];
+        }
+
+        return true;
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return false;
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: hex_digit_value
+ * ----------------------------------------------------------------- */
+static int hex_digit_value(const char c)
+{
+    int digit = digit_value(c);
+    return digit < 16 ? digit : -1;
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: _hex_decode_wrapper
+ *
+ * either case is accepted, the length of the source must be even
+ * ----------------------------------------------------------------- */
+extern "C" bool hex_decode_wrapper(
+    wasm_exec_env_t exec_env,
+    const char* src_buffer,
+    const int32 src_length, // size_t
+    uint8_t* dst_buffer,
+    const int32 dst_length, // size_t
+    int32 length_pointer_offset) // size_t*
+{
+    count_native_call(exec_env);
+
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    try {
+        uint32_t* length_pointer = get_length_pointer(module_inst, length_pointer_offset);
+        if (length_pointer == NULL)
+            return false;
+
+        if (src_length % 2 != 0)
+        {
+            SAFE_LOG(PDO_LOG_INFO, "hex string has odd length");
+            return false;
+        }
+
+        (*length_pointer) = src_length / 2;
+        if (src_length / 2 > dst_length)
+            return false;
+
+        if (src_length == 0)
+            return true;
+
+        if (src_buffer == NULL || dst_buffer == NULL)
+            return false;
+
+        for (int32 i = 0; i < src_length / 2; i++)
+        {
+            int high = hex_digit_value(src_buffer[2 * i]);
+            int low = hex_digit_value(src_buffer[2 * i + 1]);
+            if (high < 0 || low < 0)
+            {
+                SAFE_LOG(PDO_LOG_INFO, "invalid character in hex string");
+                (*length_pointer) = 0;
+                return false;
+            }
+
+            dst_buffer[i] = (uint8_t)((high << 4) | low);
+        }
+
+        return true;
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return false;
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: _b64_encode_into_wrapper
+ *
+ * same encoding as b64_encode without allocating the result in the
+ * module heap
+ * ----------------------------------------------------------------- */
+extern "C" bool b64_encode_into_wrapper(
+    wasm_exec_env_t exec_env,
+    const uint8_t* src_buffer,
+    const int32 src_length, // size_t
+    char* dst_buffer,
+    const int32 dst_length, // size_t
+    int32 length_pointer_offset) // size_t*
+{
+    count_native_call(exec_env);
+
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    try {
+        uint32_t* length_pointer = get_length_pointer(module_inst, length_pointer_offset);
+        if (length_pointer == NULL)
+            return false;
+
+        if (src_buffer == NULL && src_length > 0)
+            return false;
+
+        ByteArray src(src_buffer, src_buffer + src_length);
+        Base64EncodedString encoded = ByteArrayToBase64EncodedString(src);
+
+        return save_result((const uint8_t*)encoded.data(), encoded.size(),
+                           (uint8_t*)dst_buffer, dst_length, length_pointer);
+    }
+    catch (pdo::error::Error& e) {
+        SAFE_LOG(PDO_LOG_ERROR, "failure in %s; %s", __FUNCTION__, e.what());
+        return false;
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return false;
+    }
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: _b64_decode_into_wrapper
+ *
+ * same decoding as b64_decode without allocating the result in the
+ * module heap
+ * ----------------------------------------------------------------- */
+extern "C" bool b64_decode_into_wrapper(
+    wasm_exec_env_t exec_env,
+    const char* src_buffer,
+    const int32 src_length, // size_t
+    uint8_t* dst_buffer,
+    const int32 dst_length, // size_t
+    int32 length_pointer_offset) // size_t*
+{
+    count_native_call(exec_env);
+
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+    try {
+        uint32_t* length_pointer = get_length_pointer(module_inst, length_pointer_offset);
+        if (length_pointer == NULL)
+            return false;
+
+        if (src_buffer == NULL && src_length > 0)
+            return false;
+
+        Base64EncodedString src(src_buffer, src_length);
+        ByteArray decoded = Base64EncodedStringToByteArray(src);
+
+        return save_result(decoded.data(), decoded.size(), dst_buffer, dst_length, length_pointer);
+    }
+    catch (pdo::error::Error& e) {
+        SAFE_LOG(PDO_LOG_ERROR, "failure in %s; %s", __FUNCTION__, e.what());
+        return false;
+    }
+    catch (...) {
+        SAFE_LOG(PDO_LOG_ERROR, "unexpected failure in %s", __FUNCTION__);
+        return false;
+    }
+}
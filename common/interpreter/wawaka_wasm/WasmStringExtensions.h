@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2023 Intel Corporation.  All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bh_platform.h"
+#include "wasm_export.h"
+#include "lib_export.h"
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+extern "C" bool buffer_compare_wrapper(
+    wasm_exec_env_t exec_env,
+    const uint8_t* buffer1,
+    const int32 buffer1_length,
+    const uint8_t* buffer2,
+    const int32 buffer2_length,
+    int32 result_pointer_offset);
+
+extern "C" int32 buffer_find_wrapper(
+    wasm_exec_env_t exec_env,
+    const uint8_t* buffer,
+    const int32 buffer_length,
+    const uint8_t* pattern,
+    const int32 pattern_length);
+
+extern "C" bool buffer_move_wrapper(
+    wasm_exec_env_t exec_env,
+    uint8_t* dst_buffer,
+    const int32 dst_length,
+    const uint8_t* src_buffer,
+    const int32 src_length);
+
+extern "C" bool sort_records_wrapper(
+    wasm_exec_env_t exec_env,
+    uint8_t* buffer,
+    const int32 buffer_length,
+    const int32 record_size,
+    const int32 key_offset,
+    const int32 key_size);
+
+extern "C" bool parse_integer_wrapper(
+    wasm_exec_env_t exec_env,
+    const char* buffer,
+    const int32 buffer_length,
+    const int32 base,
+    int32 value_pointer_offset); /* int64_t* */
+
+extern "C" bool format_integer_wrapper(
+    wasm_exec_env_t exec_env,
+    const int64 value,
+    const int32 base,
+    char* buffer,
+    const int32 buffer_length,
+    int32 length_pointer_offset); /* size_t* */
+
+extern "C" bool hex_encode_wrapper(
+    wasm_exec_env_t exec_env,
+    const uint8_t* src_buffer,
+    const int32 src_length,
+    char* dst_buffer,
+    const int32 dst_length,
+    int32 length_pointer_offset); /* size_t* */
+
+extern "C" bool hex_decode_wrapper(
+    wasm_exec_env_t exec_env,
+    const char* src_buffer,
+    const int32 src_length,
+    uint8_t* dst_buffer,
+    const int32 dst_length,
+    int32 length_pointer_offset); /* size_t* */
+
+extern "C" bool b64_encode_into_wrapper(
+    wasm_exec_env_t exec_env,
+    const uint8_t* src_buffer,
+    const int32 src_length,
+    char* dst_buffer,
+    const int32 dst_length,
+    int32 length_pointer_offset); /* size_t* */
+
+extern "C" bool b64_decode_into_wrapper(
+    wasm_exec_env_t exec_env,
+    const char* src_buffer,
+    const int32 src_length,
+    uint8_t* dst_buffer,
+    const int32 dst_length,
+    int32 length_pointer_offset); /* size_t* */
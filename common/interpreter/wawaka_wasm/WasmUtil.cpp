@@ -113,3 +113,26 @@ bool save_buffer(
         source.c_str(), source.length(),
         buffer_pointer_offset, length_pointer_offset);
 }
+
+/* ----------------------------------------------------------------- *
+ * NAME: get_resource_counters
+ * ----------------------------------------------------------------- */
+pdo_resource_counters_t* get_resource_counters(
+    wasm_exec_env_t exec_env)
+{
+    if (exec_env == NULL)
+        return NULL;
+
+    return (pdo_resource_counters_t*)wasm_runtime_get_user_data(exec_env);
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: count_native_call
+ * ----------------------------------------------------------------- */
+void count_native_call(
+    wasm_exec_env_t exec_env)
+{
+    pdo_resource_counters_t* counters = get_resource_counters(exec_env);
+    if (counters != NULL)
+        counters->native_calls++;
+}
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "resource_counters.h"
 #include "types.h"
 
 #include "bh_platform.h"
@@ -43,3 +44,11 @@ extern bool save_buffer(
     const std::string& source,
     const int32 buffer_pointer_offset,
     const int32 length_pointer_offset);
+
+// the interpreter attaches its resource counters to the execution
+// environment, returns NULL when there are none
+extern pdo_resource_counters_t* get_resource_counters(
+    wasm_exec_env_t exec_env);
+
+extern void count_native_call(
+    wasm_exec_env_t exec_env);
@@ -31,6 +31,8 @@
 #include "types.h"
 
 #include "InvocationHelpers.h"
+#include "WasmHeapInfo.h"
+#include "WasmMeter.h"
 #include "WawakaInterpreter.h"
 
 namespace pc = pdo::contracts;
@@ -143,7 +145,19 @@ void WawakaInterpreter::load_contract_code(
     const std::string& code)
 {
     char error_buf[128];
-    binary_code_ = Base64EncodedStringToByteArray(code);
+
+    // the module is rewritten to count the instructions it executes; the
+    // rewrite is done once for each module, the loader may modify the
+    // code it is given so every load gets its own copy
+    if (code != metered_source_)
+    {
+        metered_source_.clear();
+
+        ByteArray contract_code = Base64EncodedStringToByteArray(code);
+        wasm_meter_module(contract_code, metered_code_);
+        metered_source_ = code;
+    }
+    binary_code_ = metered_code_;
 
     SAFE_LOG(PDO_LOG_DEBUG, "initialize the wasm interpreter");
     wasm_module = wasm_runtime_load((uint8*)binary_code_.data(), binary_code_.size(), error_buf, sizeof(error_buf));
@@ -164,6 +178,76 @@ void WawakaInterpreter::load_contract_code(
     // STACK_SIZE defined through gcc definitions
     wasm_exec_env = wasm_runtime_create_exec_env(wasm_module_inst, STACK_SIZE);
     pe::ThrowIfNull(wasm_exec_env, "failed to create the wasm execution environment");
+
+    gas_set_func = wasm_runtime_lookup_function(wasm_module_inst, WASM_METER_SET_FUNCTION, "(I)");
+    pe::ThrowIfNull(gas_set_func, "failed to locate the metering functions");
+
+    gas_get_func = wasm_runtime_lookup_function(wasm_module_inst, WASM_METER_GET_FUNCTION, "()I");
+    pe::ThrowIfNull(gas_get_func, "failed to locate the metering functions");
+
+    // the native functions find the counters through the execution environment
+    pdo::resource::Reset(counters_);
+    wasm_runtime_set_user_data(wasm_exec_env, (void*)&counters_);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void WawakaInterpreter::start_metering(void)
+{
+    current_budget_ = WAWAKA_EXECUTION_BUDGET;
+    if (0 < execution_budget_ && execution_budget_ < WAWAKA_EXECUTION_BUDGET)
+        current_budget_ = execution_budget_;
+
+    // i64 arguments occupy two cells
+    uint32 argv[2];
+    int64_t budget = (int64_t)current_budget_;
+    memcpy(argv, &budget, sizeof(budget));
+
+    pe::ThrowIf<pe::RuntimeError>(
+        ! wasm_runtime_call_wasm(wasm_exec_env, gas_set_func, 2, argv),
+        "failed to set the execution budget");
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void WawakaInterpreter::stop_metering(void)
+{
+    // the trap raised when the budget runs out is still pending and
+    // would fail the call that reads the budget
+    wasm_runtime_clear_exception(wasm_module_inst);
+
+    uint32 argv[2] = { 0, 0 };
+    pe::ThrowIf<pe::RuntimeError>(
+        ! wasm_runtime_call_wasm(wasm_exec_env, gas_get_func, 0, argv),
+        "failed to read the execution budget");
+
+    int64_t remaining;
+    memcpy(&remaining, argv, sizeof(remaining));
+
+    uint64_t consumed = (uint64_t)((int64_t)current_budget_ - remaining);
+    counters_.wasm_instructions += consumed;
+
+    if (remaining < 0)
+    {
+        std::string consumed_units = std::to_string(consumed) + " units consumed";
+        throw pc::ExecutionBudgetExceeded(
+            report_interpreter_error("execution budget exceeded", consumed_units.c_str()));
+    }
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// linear memory only grows so its current size is the peak for the
+// invocation; the module is instantiated for every invocation so the
+// high-water mark of its app heap covers just this invocation
+void WawakaInterpreter::record_memory_usage(void)
+{
+    uint32 memory_beg = 0, memory_end = 0;
+    if (wasm_runtime_get_app_addr_range(wasm_module_inst, 0, &memory_beg, &memory_end))
+        pdo::resource::UpdatePeak(counters_.wasm_memory_peak, memory_end - memory_beg);
+
+    uint32 heap_total = 0, heap_free = 0, heap_highmark = 0;
+    if (wawaka_get_app_heap_info(wasm_module_inst, &heap_total, &heap_free, &heap_highmark))
+        pdo::resource::UpdatePeak(counters_.wasm_heap_peak, heap_highmark);
+
+    pdo::resource::SampleHeap(counters_);
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -183,6 +267,8 @@ int32 WawakaInterpreter::initialize_contract(
 
     pe::ThrowIfNull(wasm_func, "Unable to locate the initialize function");
 
+    start_metering();
+
     uint32 argv[1], buf_offset = 0;
     try {
         // might need to add a null terminator
@@ -211,6 +297,9 @@ int32 WawakaInterpreter::initialize_contract(
 
     if (buf_offset)
         wasm_runtime_module_free(wasm_module_inst, buf_offset);
+
+    record_memory_usage();
+    stop_metering();
     return result;
 }
 
@@ -233,6 +322,8 @@ int32 WawakaInterpreter::evaluate_function(
 
     pe::ThrowIfNull(wasm_func, "Unable to locate the dispatch function");
 
+    start_metering();
+
     uint32 argv[2], buf_offset0 = 0, buf_offset1 = 0;
     try {
         // might need to add a null terminator
@@ -270,9 +361,24 @@ int32 WawakaInterpreter::evaluate_function(
         wasm_runtime_module_free(wasm_module_inst, buf_offset0);
     if (buf_offset1)
         wasm_runtime_module_free(wasm_module_inst, buf_offset1);
+
+    record_memory_usage();
+    stop_metering();
     return result;
 }
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+const pdo_resource_counters_t& WawakaInterpreter::ResourceCounters(void) const
+{
+    return counters_;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void WawakaInterpreter::SetExecutionBudget(uint64_t budget)
+{
+    execution_budget_ = budget;
+}
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 void WawakaInterpreter::Finalize(void)
 {
@@ -290,6 +396,8 @@ void WawakaInterpreter::Finalize(void)
     {
         wasm_runtime_deinstantiate(wasm_module_inst);
         wasm_module_inst = NULL;
+        gas_set_func = NULL;
+        gas_get_func = NULL;
     }
 
     if (wasm_module != NULL)
@@ -28,6 +28,12 @@ extern "C" {
 
 #define KV_STORE_POOL_MAX_SIZE 8
 
+// Maximum number of wasm instructions executed by an invocation, a
+// request may ask for a smaller budget
+#ifndef WAWAKA_EXECUTION_BUDGET
+#define WAWAKA_EXECUTION_BUDGET 10000000000ULL
+#endif
+
 namespace pc = pdo::contracts;
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -42,7 +48,19 @@ private:
     wasm_module_inst_t wasm_module_inst = NULL;
     wasm_exec_env_t wasm_exec_env = NULL;
     ByteArray binary_code_;
+
+    // the last module rewritten by the metering pass, keyed by its
+    // encoded source
+    std::string metered_source_;
+    ByteArray metered_code_;
     pdo::state::Basic_KV_Plus* kv_store_pool[KV_STORE_POOL_MAX_SIZE] = { 0 };
+    pdo_resource_counters_t counters_ = {};
+
+    // instruction metering, see WasmMeter.h
+    wasm_function_inst_t gas_set_func = NULL;
+    wasm_function_inst_t gas_get_func = NULL;
+    uint64_t execution_budget_ = 0;
+    uint64_t current_budget_ = 0;
 
     void parse_response_string(
         int32 response_app,
@@ -57,6 +75,10 @@ private:
     void load_contract_code(
         const std::string& code);
 
+    void start_metering(void);
+    void stop_metering(void);
+    void record_memory_usage(void);
+
     int32 initialize_contract(
         const std::string& env);
 
@@ -88,6 +110,9 @@ public:
         std::string& outMessageResult
         );
 
+    const pdo_resource_counters_t& ResourceCounters(void) const;
+    void SetExecutionBudget(uint64_t budget);
+
     void Finalize(void);
     void Initialize(void);
 
@@ -186,5 +186,25 @@ namespace pdo
             const ByteArray& inValue
             );
 
+        /**
+         * Puts a block into the block store only if the id is not already
+         * present; blocks are content addressed so an existing block is not
+         * written again, its expiration is extended instead.
+         * Primary expected use: python / untrusted side
+         *
+         * @param inId          id byte array
+         * @param inValue       block data to write
+         * @param outInserted   [output] true if the block was written
+         *
+         * @return
+         *  PDO_SUCCESS  block present in the store
+         *  else         failed, block store unchanged
+         */
+        pdo_err_t BlockStorePutIfAbsent(
+            const ByteArray& inId,
+            const ByteArray& inValue,
+            bool* outInserted
+            );
+
     } /* contract */
 } /* pdo */
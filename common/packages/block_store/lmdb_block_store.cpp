@@ -383,44 +383,64 @@ pdo_err_t pdo::block_store::BlockStoreGet(
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-pdo_err_t pdo::block_store::BlockStorePut(
+// Blocks are content addressed, a block that is already present holds
+// the same data so only its expiration is extended
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static pdo_err_t put_block(
     const uint8_t* inId,
     const size_t inIdSize,
     const uint8_t* inValue,
-    const size_t inValueSize
-)
+    const size_t inValueSize,
+    bool* outInserted)
 {
     pdo_err_t result;
 
-#if BLOCK_STORE_DEBUG
-    {
-        std::string idStr = BinaryToHexString(inId, inIdSize);
-        SAFE_LOG(PDO_LOG_DEBUG, "BlockStorePut: '%s'", idStr.c_str());
-    }
-#endif
+    *outInserted = false;
 
     SafeTransaction stxn(0);
 
     if (stxn.txn_ == NULL)
         return PDO_ERR_SYSTEM;
 
-    result = put_data(stxn.dbi_, stxn.txn_, inId, inIdSize, inValue, inValueSize);
-    if (result != PDO_SUCCESS)
-    {
-        SAFE_LOG(PDO_LOG_ERROR, "failed to write block data; %d", result);
-        return result;
-    }
-
-    // update the last access time
     struct timeval now;
     gettimeofday(&now, NULL);
 
+    uint64_t expiration_time = now.tv_sec + MINIMUM_EXPIRATION_TIME;
+
     pdo::block_store::BlockMetaData metadata;
+    result = get_metadata(stxn.meta_dbi_, stxn.txn_, inId, inIdSize, &metadata);
+    if (result == PDO_SUCCESS)
+    {
+        if (expiration_time <= metadata.expiration_time_)
+        {
+            stxn.commit();
+            return PDO_SUCCESS;
+        }
+
+        metadata.expiration_time_ = expiration_time;
+    }
+    else if (result == PDO_ERR_NOTFOUND)
+    {
+        result = put_data(stxn.dbi_, stxn.txn_, inId, inIdSize, inValue, inValueSize);
+        if (result != PDO_SUCCESS)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "failed to write block data; %d", result);
+            return result;
+        }
+
+        metadata.block_size_ = inValueSize;
+        metadata.create_time_ = now.tv_sec;
+        metadata.expiration_time_ = expiration_time;
+        metadata.tag_ = 0;
+
+        *outInserted = true;
+    }
+    else
+    {
+        SAFE_LOG(PDO_LOG_ERROR, "failed to retrieve block meta data; %d", result);
+        return result;
+    }
 
-    metadata.block_size_ = inValueSize;
-    metadata.create_time_ = now.tv_sec;
-    metadata.expiration_time_ = now.tv_sec + MINIMUM_EXPIRATION_TIME;
-    metadata.tag_ = 0;
     result = put_metadata(stxn.meta_dbi_, stxn.txn_, inId, inIdSize, &metadata);
     if (result != PDO_SUCCESS)
     {
@@ -431,8 +451,7 @@ pdo_err_t pdo::block_store::BlockStorePut(
 #if BLOCK_STORE_DEBUG
     {
         std::string idStr = BinaryToHexString(inId, inIdSize);
-        std::string valueStr = BinaryToHexString((uint8_t*)inValue, inValueSize);
-        SAFE_LOG(PDO_LOG_DEBUG, "Block store wrote id: '%s' -> '%s'", idStr.c_str(), valueStr.c_str());
+        SAFE_LOG(PDO_LOG_DEBUG, "Block store %s id: '%s'", (*outInserted ? "wrote" : "found"), idStr.c_str());
     }
 #endif
 
@@ -440,6 +459,25 @@ pdo_err_t pdo::block_store::BlockStorePut(
     return PDO_SUCCESS;
 }
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+pdo_err_t pdo::block_store::BlockStorePut(
+    const uint8_t* inId,
+    const size_t inIdSize,
+    const uint8_t* inValue,
+    const size_t inValueSize
+)
+{
+#if BLOCK_STORE_DEBUG
+    {
+        std::string idStr = BinaryToHexString(inId, inIdSize);
+        SAFE_LOG(PDO_LOG_DEBUG, "BlockStorePut: '%s'", idStr.c_str());
+    }
+#endif
+
+    bool inserted;
+    return put_block(inId, inIdSize, inValue, inValueSize, &inserted);
+}
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 pdo_err_t pdo::block_store::BlockStoreHead(
     const ByteArray& inId,
@@ -502,3 +540,13 @@ pdo_err_t pdo::block_store::BlockStorePut(
 {
     return BlockStorePut(inId.data(), inId.size(), inValue.data(), inValue.size());
 }
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+pdo_err_t pdo::block_store::BlockStorePutIfAbsent(
+    const ByteArray& inId,
+    const ByteArray& inValue,
+    bool* outInserted
+)
+{
+    return put_block(inId.data(), inId.size(), inValue.data(), inValue.size(), outInserted);
+}
@@ -0,0 +1,32 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "log.h"
+#include "resource_counters.h"
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// usmblks is the largest space the allocator has handed out since the
+// enclave started, the allocator has no high-water mark that can be
+// reset for each request so the peak covers every earlier request as
+// well. glibc leaves usmblks at zero, untrusted builds fall back to the
+// space in use (uordblks) when the sample is taken
+void pdo::resource::SampleHeap(pdo_resource_counters_t& counters)
+{
+    struct mallinfo mi = MALLINFO_F();
+    if (mi.usmblks > 0)
+        UpdatePeak(counters.heap_peak, (uint64_t)mi.usmblks);
+    else if (mi.uordblks > 0)
+        UpdatePeak(counters.heap_peak, (uint64_t)mi.uordblks);
+}
@@ -0,0 +1,93 @@
+/* Copyright 2022 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Resource counters measure the work done on behalf of a single contract
+// invocation. The state counters are kept by each key value store, the
+// interpreter keeps the counters for the code it runs; the two sets are
+// added together when the invocation completes. Peaks are high-water
+// marks sampled during the invocation, they are merged by taking the
+// larger of the two values rather than the sum.
+
+// The list of counters, the name is used in the serialized form
+#define PDO_RESOURCE_COUNTER_LIST(COUNTER)                        \
+    COUNTER(trie_nodes, "TrieNodes")                              \
+    COUNTER(data_node_fetches, "DataNodeFetches")                 \
+    COUNTER(cache_hits, "CacheHits")                              \
+    COUNTER(cache_misses, "CacheMisses")                          \
+    COUNTER(bytes_read, "BytesRead")                              \
+    COUNTER(bytes_written, "BytesWritten")                        \
+    COUNTER(blocks_evicted, "BlocksEvicted")                      \
+    COUNTER(wasm_instructions, "WasmInstructions")                \
+    COUNTER(native_calls, "NativeCalls")
+
+// The list of peaks, sizes are in bytes except for the cache which is
+// measured in blocks. The heap peak is the high-water mark of the
+// enclave heap since the enclave started, it is sampled when the
+// contract returns and when the response is built. The wasm heap peak
+// is the high-water mark of the app heap that serves malloc in the
+// contract.
+#define PDO_RESOURCE_PEAK_LIST(COUNTER)                           \
+    COUNTER(heap_peak, "HeapPeak")                                \
+    COUNTER(wasm_memory_peak, "WasmMemoryPeak")                   \
+    COUNTER(wasm_heap_peak, "WasmHeapPeak")                       \
+    COUNTER(cache_blocks_peak, "CacheBlocksPeak")
+
+// counters cross the enclave boundary as a flat buffer
+#define PDO_RESOURCE_COUNTER_FIELD(field, name) uint64_t field;
+typedef struct
+{
+    PDO_RESOURCE_COUNTER_LIST(PDO_RESOURCE_COUNTER_FIELD)
+    PDO_RESOURCE_PEAK_LIST(PDO_RESOURCE_COUNTER_FIELD)
+} pdo_resource_counters_t;
+#undef PDO_RESOURCE_COUNTER_FIELD
+
+namespace pdo
+{
+    namespace resource
+    {
+        inline void Reset(pdo_resource_counters_t& counters)
+        {
+#define PDO_RESOURCE_COUNTER_RESET(field, name) counters.field = 0;
+            PDO_RESOURCE_COUNTER_LIST(PDO_RESOURCE_COUNTER_RESET)
+            PDO_RESOURCE_PEAK_LIST(PDO_RESOURCE_COUNTER_RESET)
+#undef PDO_RESOURCE_COUNTER_RESET
+        }
+
+        inline void UpdatePeak(uint64_t& peak, const uint64_t value)
+        {
+            if (peak < value)
+                peak = value;
+        }
+
+        inline void Accumulate(pdo_resource_counters_t& total, const pdo_resource_counters_t& counters)
+        {
+#define PDO_RESOURCE_COUNTER_ADD(field, name) total.field += counters.field;
+            PDO_RESOURCE_COUNTER_LIST(PDO_RESOURCE_COUNTER_ADD)
+#undef PDO_RESOURCE_COUNTER_ADD
+
+#define PDO_RESOURCE_PEAK_MERGE(field, name) UpdatePeak(total.field, counters.field);
+            PDO_RESOURCE_PEAK_LIST(PDO_RESOURCE_PEAK_MERGE)
+#undef PDO_RESOURCE_PEAK_MERGE
+        }
+
+        // record the high-water mark of the enclave heap as the heap peak;
+        // the allocator walks the heap so it is not for hot paths
+        void SampleHeap(pdo_resource_counters_t& counters);
+    }
+}
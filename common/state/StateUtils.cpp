@@ -18,6 +18,10 @@
 
 namespace pstate = pdo::state;
 
+pdo::state::StateNode::StateNode() : layout_(default_state_layout)
+{
+}
+
 pstate::StateBlockId& pdo::state::StateNode::GetBlockId()
 {
     return blockId_;
@@ -81,13 +85,12 @@ void pdo::state::StateNode::BlockifyChildren(const ByteArray& state_encryption_k
         pdo::error::ThrowIfNull(j_block_ids_array, "failed to serialize the block id array");
 
         ByteArray cumulative_block_ids_hash;
+        pdo::crypto::Hasher hasher;
 
         // insert in the array the IDs of all blocks in the list
         for (unsigned int i = 0; i < ChildrenArray_.size(); i++)
         {
-            cumulative_block_ids_hash.insert(cumulative_block_ids_hash.end(),
-                ChildrenArray_[i].begin(), ChildrenArray_[i].end());
-            cumulative_block_ids_hash = pdo::crypto::ComputeMessageHash(cumulative_block_ids_hash);
+            hasher.Update(cumulative_block_ids_hash).Update(ChildrenArray_[i]).Final(cumulative_block_ids_hash);
 
             jret = json_array_append_string(
                 j_block_ids_array, ByteArrayToBase64EncodedString(ChildrenArray_[i]).c_str());
@@ -97,6 +100,23 @@ void pdo::state::StateNode::BlockifyChildren(const ByteArray& state_encryption_k
         ChildrenArray_.resize(0);
         ChildrenArray_.shrink_to_fit();
 
+        //the layout is recorded only when it differs from the default, so
+        //that states with the default layout keep the original format
+        ByteArray serialized_layout = SerializeLayout();
+        if (! serialized_layout.empty())
+        {
+            hasher.Update(cumulative_block_ids_hash).Update(serialized_layout).Final(cumulative_block_ids_hash);
+
+            if (layout_.data_node_size_ != default_state_layout.data_node_size_)
+                jret = json_object_dotset_number(j_root_block_object, "DataNodeSize", layout_.data_node_size_);
+            if (jret == JSONSuccess && layout_.extent_threshold_ != default_state_layout.extent_threshold_)
+                jret = json_object_dotset_number(j_root_block_object, "ExtentThreshold", layout_.extent_threshold_);
+            if (jret == JSONSuccess && extentCount_ > 0)
+                jret = json_object_dotset_number(j_root_block_object, "ExtentCount", extentCount_);
+            pdo::error::ThrowIf<pdo::error::RuntimeError>(
+                jret != JSONSuccess, "failed to serialize the state layout");
+        }
+
         //serialize authenticator
         ByteArray block_ids_hmac = pdo::crypto::ComputeMessageHMAC(state_encryption_key, cumulative_block_ids_hash);
         jret = json_object_dotset_string(j_root_block_object,
@@ -145,6 +165,7 @@ void pdo::state::StateNode::UnBlockifyChildren(const ByteArray& state_encryption
     int block_ids_count = json_array_get_count(j_block_ids_array);
 
     ByteArray cumulative_block_ids_hash;
+    pdo::crypto::Hasher hasher;
 
     for (int i = 0; i < block_ids_count; i++)
     {
@@ -159,11 +180,28 @@ void pdo::state::StateNode::UnBlockifyChildren(const ByteArray& state_encryption
             throw;
         }
 
-        cumulative_block_ids_hash.insert(
-                    cumulative_block_ids_hash.end(), ChildrenArray_[i].begin(), ChildrenArray_[i].end());
-        cumulative_block_ids_hash = pdo::crypto::ComputeMessageHash(cumulative_block_ids_hash);
+        hasher.Update(cumulative_block_ids_hash).Update(ChildrenArray_[i]).Final(cumulative_block_ids_hash);
     }
 
+    //deserialize layout, missing fields have the default value
+    layout_ = default_state_layout;
+    extentCount_ = 0;
+    if (json_object_get_value(j_root_block_object, "DataNodeSize") != NULL)
+        layout_.data_node_size_ = (unsigned int)json_object_get_number(j_root_block_object, "DataNodeSize");
+    if (json_object_get_value(j_root_block_object, "ExtentThreshold") != NULL)
+        layout_.extent_threshold_ = (size_t)json_object_get_number(j_root_block_object, "ExtentThreshold");
+    if (json_object_get_value(j_root_block_object, "ExtentCount") != NULL)
+        extentCount_ = (size_t)json_object_get_number(j_root_block_object, "ExtentCount");
+
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        ! valid_state_layout(layout_), "invalid state layout");
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        extentCount_ > ChildrenArray_.size(), "invalid extent count");
+
+    ByteArray serialized_layout = SerializeLayout();
+    if (! serialized_layout.empty())
+        hasher.Update(cumulative_block_ids_hash).Update(serialized_layout).Final(cumulative_block_ids_hash);
+
     //deserialize authenticator
     const char *b64_auth = json_object_dotget_string(j_root_block_object, "BlockIdsAuth");
     pdo::error::ThrowIfNull(b64_auth, "Failed to get BlockIdsAuth");
@@ -183,3 +221,43 @@ void pdo::state::StateNode::ClearChildren()
 {
     ChildrenArray_.clear();
 }
+
+const pstate::state_layout_t& pdo::state::StateNode::GetLayout() const
+{
+    return layout_;
+}
+
+void pdo::state::StateNode::SetLayout(const state_layout_t& layout)
+{
+    layout_ = layout;
+}
+
+size_t pdo::state::StateNode::GetExtentCount() const
+{
+    return extentCount_;
+}
+
+void pdo::state::StateNode::SetExtentCount(size_t count)
+{
+    extentCount_ = count;
+}
+
+/*
+    The layout is covered by the block-ids authenticator; it is empty for
+    the default layout, which keeps the authenticator of such states unchanged.
+*/
+ByteArray pdo::state::StateNode::SerializeLayout() const
+{
+    ByteArray serialized;
+    if (layout_.data_node_size_ == default_state_layout.data_node_size_ &&
+        layout_.extent_threshold_ == default_state_layout.extent_threshold_ &&
+        extentCount_ == 0)
+        return serialized;
+
+    uint64_t fields[3] = { layout_.data_node_size_, layout_.extent_threshold_, extentCount_ };
+    for (size_t f = 0; f < 3; f++)
+        for (size_t b = 0; b < sizeof(uint64_t); b++)
+            serialized.push_back((uint8_t)(fields[f] >> (8 * b)));
+
+    return serialized;
+}
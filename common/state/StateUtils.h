@@ -22,6 +22,14 @@ namespace pdo
 {
 namespace state
 {
+    // The layout of a state is chosen when the state is created and is
+    // recorded in the root block
+    typedef struct
+    {
+        unsigned int data_node_size_;   // bytes in each data node
+        size_t extent_threshold_;       // values this large are stored in extents, 0 for none
+    } state_layout_t;
+
     class StateNode
     {
     protected:
@@ -30,7 +38,15 @@ namespace state
         pdo::state::StateBlockIdArray ChildrenArray_ = {};
         bool hasParent_ = false;
 
+        // the last extentCount_ children are extents rather than data nodes
+        state_layout_t layout_;
+        size_t extentCount_ = 0;
+
+        ByteArray SerializeLayout() const;
+
     public:
+        StateNode();
+
         pdo::state::StateBlockId& GetBlockId();
         pdo::state::StateBlock& GetBlock();
 
@@ -41,6 +57,11 @@ namespace state
         void UnBlockifyChildren(const ByteArray& state_encryption_key);
         pdo::state::StateBlockIdArray GetChildrenBlocks();
         void ClearChildren();
+
+        const state_layout_t& GetLayout() const;
+        void SetLayout(const state_layout_t& layout);
+        size_t GetExtentCount() const;
+        void SetExtentCount(size_t count);
     };
 
     typedef pdo::state::StateNode State;
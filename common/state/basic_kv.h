@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include "resource_counters.h"
 #include "types.h"
 
 namespace pdo
@@ -32,6 +33,9 @@ namespace state
         virtual ByteArray Get(const ByteArray& key) const = 0;
         virtual void Put(const ByteArray& key, const ByteArray& value) = 0;
         virtual void Delete(const ByteArray& key) = 0;
+
+        // work done by the store since it was created or opened
+        virtual const pdo_resource_counters_t& ResourceCounters(void) const = 0;
     };
 
     class Basic_KV_Plus : public Basic_KV
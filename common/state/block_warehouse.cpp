@@ -13,10 +13,20 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <set>
+
 #include "state.h"
 
 namespace pstate = pdo::state;
 
+void pdo::state::block_warehouse::set_layout(const state_layout_t& layout)
+{
+    pdo::error::ThrowIf<pdo::error::ValueError>(!valid_state_layout(layout), "invalid state layout");
+    layout_ = layout;
+}
+
+// CONVENTION: the extent ids follow the data block ids in the root block
 void pdo::state::block_warehouse::serialize_block_ids(pdo::state::StateNode& node)
 {
     node.ClearChildren();
@@ -24,13 +34,24 @@ void pdo::state::block_warehouse::serialize_block_ids(pdo::state::StateNode& nod
     {
         node.AppendChildId(blockIds_[i]);
     }
+    for (unsigned int i = 0; i < extentIds_.size(); i++)
+    {
+        node.AppendChildId(extentIds_[i]);
+    }
+    node.SetLayout(layout_);
+    node.SetExtentCount(extentIds_.size());
     node.BlockifyChildren(state_encryption_key_);
 }
 
 void pdo::state::block_warehouse::deserialize_block_ids(pdo::state::StateNode& node)
 {
     node.UnBlockifyChildren(state_encryption_key_);
-    blockIds_ = node.GetChildrenBlocks();
+    originalBlockIds_ = node.GetChildrenBlocks();
+    layout_ = node.GetLayout();
+
+    size_t data_block_count = originalBlockIds_.size() - node.GetExtentCount();
+    blockIds_.assign(originalBlockIds_.begin(), originalBlockIds_.begin() + data_block_count);
+    extentIds_.assign(originalBlockIds_.begin() + data_block_count, originalBlockIds_.end());
 }
 
 void pdo::state::block_warehouse::update_datablock_id(
@@ -99,3 +120,43 @@ unsigned int pdo::state::block_warehouse::get_last_block_num()
     return blockIds_.size() - 1;
 }
 
+void pdo::state::block_warehouse::add_extent_id(const pstate::StateBlockId& id)
+{
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        id.size() != STATE_BLOCK_ID_LENGTH, "bad extent id");
+    extentIds_.push_back(id);
+}
+
+void pdo::state::block_warehouse::remove_extent_id(const pstate::StateBlockId& id)
+{
+    // the same extent may be referenced more than once, remove one reference
+    auto it = std::find(extentIds_.begin(), extentIds_.end(), id);
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(it == extentIds_.end(), "unknown extent id");
+    extentIds_.erase(it);
+}
+
+void pdo::state::block_warehouse::get_change_set(
+    pdo::state::StateBlockIdArray& outNewBlockIds,
+    pdo::state::StateBlockIdArray& outSupersededBlockIds)
+{
+    // the same block id may appear more than once in a state (for example,
+    // two identical data nodes), so a block is superseded only when no
+    // reference to it remains
+    std::set<StateBlockId> original(originalBlockIds_.begin(), originalBlockIds_.end());
+    std::set<StateBlockId> current(blockIds_.begin(), blockIds_.end());
+    current.insert(extentIds_.begin(), extentIds_.end());
+
+    outNewBlockIds.clear();
+    for (auto it = current.begin(); it != current.end(); ++it)
+    {
+        if (original.count(*it) == 0)
+            outNewBlockIds.push_back(*it);
+    }
+
+    outSupersededBlockIds.clear();
+    for (auto it = original.begin(); it != original.end(); ++it)
+    {
+        if (current.count(*it) == 0)
+            outSupersededBlockIds.push_back(*it);
+    }
+}
@@ -24,14 +24,26 @@ namespace state
     private:
         pdo::state::StateBlockIdArray blockIds_ = {};
 
+        // blocks that each hold a single large value, referenced from the trie
+        pdo::state::StateBlockIdArray extentIds_ = {};
+
+        // block ids when the state was opened, used to compute the change set
+        pdo::state::StateBlockIdArray originalBlockIds_ = {};
+
+        state_layout_t layout_;
+
     public:
         const ByteArray state_encryption_key_;
 
         block_warehouse(const ByteArray& state_encryption_key)
-            : state_encryption_key_(state_encryption_key)
+            : layout_(default_state_layout), state_encryption_key_(state_encryption_key)
         {
         }
 
+        const state_layout_t& get_layout() const { return layout_; }
+        void set_layout(const state_layout_t& layout);
+        unsigned int get_data_node_size() const { return layout_.data_node_size_; }
+
         void serialize_block_ids(pdo::state::StateNode& node);
         void deserialize_block_ids(pdo::state::StateNode& node);
 
@@ -46,6 +58,15 @@ namespace state
             unsigned int data_block_num, pdo::state::StateBlockId& outId);
         unsigned int get_root_block_num();
         unsigned int get_last_block_num();
+
+        void add_extent_id(const pdo::state::StateBlockId& id);
+        void remove_extent_id(const pdo::state::StateBlockId& id);
+
+        // the data block and extent ids added to and removed from the state
+        // since it was opened, each list is sorted and without duplicates
+        void get_change_set(
+            pdo::state::StateBlockIdArray& outNewBlockIds,
+            pdo::state::StateBlockIdArray& outSupersededBlockIds);
     };
 }
 }
@@ -17,14 +17,16 @@
 
 namespace pstate = pdo::state;
 
-#define BLOCK_CACHE_MAX_ITEMS (CACHE_SIZE / FIXED_DATA_NODE_BYTE_SIZE)
-
-#if (FIXED_DATA_NODE_BYTE_SIZE < (1 << 11) || CACHE_SIZE < (1 << 15))
-#error "use at least 2KB data node size and 32KB cache size"
+#if (MAX_DATA_NODE_BYTE_SIZE < (1 << 11) || CACHE_SIZE < 16 * MAX_DATA_NODE_BYTE_SIZE)
+#error "use at least 2KB data node size and a cache that holds 16 of the largest data nodes"
 #endif
 
-pstate::cache_slots::cache_slots() : data_nodes_(BLOCK_CACHE_MAX_ITEMS, data_node(0))
+void pstate::cache_slots::initialize(unsigned int node_size)
 {
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        !data_nodes_.empty(), "cache_slots already initialized");
+
+    data_nodes_.assign(CACHE_SIZE / node_size, data_node(0, node_size));
     for (unsigned int i = 0; i < data_nodes_.size(); i++)
     {
         try
@@ -71,6 +73,16 @@ unsigned int pstate::cache_slots::available_slots()
     return dn_queue_.size();
 }
 
+unsigned int pstate::cache_slots::total_slots()
+{
+    return data_nodes_.size();
+}
+
+void pstate::Cache::initialize()
+{
+    slots_.initialize(block_warehouse_.get_data_node_size());
+}
+
 void pstate::Cache::replacement_policy_MRU()
 {
     int index_to_remove = -1;
@@ -96,9 +108,9 @@ void pstate::Cache::replacement_policy_MRU()
 void pstate::Cache::replacement_policy()
 {
     pdo::error::ThrowIf<pdo::error::RuntimeError>(
-            block_cache_.size() + slots_.available_slots() != BLOCK_CACHE_MAX_ITEMS, "cache replacement, invariant not satisfied");
+            block_cache_.size() + slots_.available_slots() != slots_.total_slots(), "cache replacement, invariant not satisfied");
 
-    while (block_cache_.size() >= BLOCK_CACHE_MAX_ITEMS)
+    while (block_cache_.size() >= slots_.total_slots())
     {
         replacement_policy_MRU();
     }
@@ -131,11 +143,9 @@ void pstate::Cache::flush_entry(unsigned int block_num)
 
 void pstate::Cache::flush()
 {
-    while (!block_cache_.empty())
-    {
-        auto it = block_cache_.begin();
-        flush_entry(it->first);
-    }
+    // sync all the modified entries in one batch, then drop them all
+    sync();
+    drop();
 }
 
 void pstate::Cache::sync_entry(unsigned int block_num)
@@ -156,14 +166,96 @@ void pstate::Cache::sync_entry(unsigned int block_num)
         bce.modified = false;
 
         synced_entries_ ++;
+        counters_.blocks_evicted++;
     }
 }
 
 void pstate::Cache::sync()
 {
+    // serialize and encrypt all modified entries, then evict them together
+    // so that the block ids can be computed in a single batch
+    std::vector<unsigned int> block_nums;
+    std::vector<StateBlock> encrypted_blocks;
     for (auto it = block_cache_.begin(); it != block_cache_.end(); ++it)
     {
-        sync_entry(it->first);
+        block_cache_entry_t& bce = it->second;
+        if (bce.modified)
+        {
+            block_nums.push_back(it->first);
+            encrypted_blocks.push_back(StateBlock());
+            bce.dn->serialize_and_encrypt_data(
+                block_warehouse_.state_encryption_key_, encrypted_blocks.back());
+        }
+    }
+
+    if (block_nums.empty())
+        return;
+
+    std::vector<StateBlockId> new_data_node_ids;
+    state_status_t ret = sebio_evict_batch(encrypted_blocks, SEBIO_NO_CRYPTO, new_data_node_ids);
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        ret != STATE_SUCCESS, "cache sync, sebio returned an error");
+
+    for (size_t i = 0; i < block_nums.size(); i++)
+    {
+        block_cache_entry_t& bce = block_cache_[block_nums[i]];
+        bce.dn->deserialize_original_encrypted_data_id(new_data_node_ids[i]);
+        block_warehouse_.update_datablock_id(block_nums[i], new_data_node_ids[i]);
+
+        // sync done
+        bce.modified = false;
+
+        synced_entries_ ++;
+    }
+
+    counters_.blocks_evicted += block_nums.size();
+}
+
+void pstate::Cache::prefetch(unsigned int first_block_num, unsigned int last_block_num)
+{
+    // load the blocks in the range that are not cached yet, using only a
+    // fraction of the free slots; prefetching never evicts cached entries
+    // and leaves room for the blocks that are read through retrieve
+    std::vector<unsigned int> block_nums;
+    std::vector<StateBlockId> data_node_ids;
+    unsigned int prefetch_slots = slots_.available_slots() / CACHE_PREFETCH_FRACTION;
+    for (unsigned int block_num = first_block_num;
+         block_num <= last_block_num && block_nums.size() < prefetch_slots;
+         block_num++)
+    {
+        if (block_cache_.count(block_num) != 0)
+            continue;
+
+        block_nums.push_back(block_num);
+        data_node_ids.push_back(StateBlockId());
+        block_warehouse_.get_datablock_id_from_datablock_num(block_num, data_node_ids.back());
+    }
+
+    // a single block is not worth a batch, retrieve will load it
+    if (block_nums.size() < 2)
+        return;
+
+    std::vector<StateBlock> encrypted_blocks;
+    state_status_t ret = sebio_fetch_batch(data_node_ids, SEBIO_NO_CRYPTO, encrypted_blocks);
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        ret != STATE_SUCCESS, "cache prefetch, sebio returned an error");
+
+    counters_.data_node_fetches += block_nums.size();
+
+    for (size_t i = 0; i < block_nums.size(); i++)
+    {
+        data_node* dn = slots_.allocate();
+        pdo::error::ThrowIf<pdo::error::RuntimeError>(!dn, "slot allocate, null pointer");
+        dn->deserialize_original_encrypted_data_id(data_node_ids[i]);
+        dn->load_from_encrypted_data(encrypted_blocks[i], block_warehouse_.state_encryption_key_);
+        put(block_nums[i], dn);
+
+        // the replacement evicts the most recently used entry first, a
+        // prefetched block gets the oldest clock until it is read so it
+        // is not the first to be evicted
+        block_cache_entry_t& bce = block_cache_[block_nums[i]];
+        bce.prefetched = true;
+        bce.clock = 0;
     }
 }
 
@@ -181,14 +273,20 @@ void pstate::Cache::put(unsigned int block_num, data_node* dn)
     bce.references = 0;
     bce.modified = false;
     bce.pinned = false;
+    bce.prefetched = false;
     bce.clock = (cache_clock_++);
     block_cache_[block_num] = bce;
+
+    pdo::resource::UpdatePeak(counters_.cache_blocks_peak, block_cache_.size());
 }
 
 pstate::data_node& pstate::Cache::retrieve(unsigned int block_num, bool pinned)
 {
     if (block_cache_.count(block_num) == 0)
     {  // not in cache
+        counters_.cache_misses++;
+        counters_.data_node_fetches++;
+
         replacement_policy();
 
         StateBlockId data_node_id;
@@ -206,10 +304,21 @@ pstate::data_node& pstate::Cache::retrieve(unsigned int block_num, bool pinned)
         if (pinned)
             pin(block_num);
     }
+    else
+    {
+        counters_.cache_hits++;
+    }
 
     // now it is in cache, grab it
     block_cache_entry_t& bce = block_cache_[block_num];
     bce.references++;
+
+    // a prefetched block is promoted when it is first read
+    if (bce.prefetched)
+    {
+        bce.prefetched = false;
+        bce.clock = (cache_clock_++);
+    }
     return *bce.dn;
 }
 
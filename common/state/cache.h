@@ -20,6 +20,9 @@
 
 #define CACHE_SIZE (1 << 22)                 // 4 MB
 
+// a prefetch uses at most this fraction (1/n) of the free slots
+#define CACHE_PREFETCH_FRACTION 2
+
 namespace pdo
 {
 namespace state
@@ -27,10 +30,12 @@ namespace state
     class cache_slots
     {
     public:
-        cache_slots();
+        // the slots are allocated once the data node size of the state is known
+        void initialize(unsigned int node_size);
         data_node* allocate();
         void release(data_node** dn);
         unsigned int available_slots();
+        unsigned int total_slots();
 
     private:
         // the data nodes constitute the cache slots
@@ -45,6 +50,8 @@ namespace state
     private:
         // the block_warehouse_ reference is related to the block_warehouse member of dn_io
         block_warehouse& block_warehouse_;
+        // the counters are owned by the kv that owns the cache
+        pdo_resource_counters_t& counters_;
         unsigned int synced_entries_;
 
         void replacement_policy_MRU();
@@ -55,16 +62,20 @@ namespace state
             bool pinned;
             unsigned int references;
             bool modified;
+            // loaded by a prefetch and not read yet
+            bool prefetched;
             uint64_t clock;
             data_node* dn;
         };
 
-        Cache(block_warehouse& bw): block_warehouse_(bw), synced_entries_(0) {}
+        Cache(block_warehouse& bw, pdo_resource_counters_t& counters) :
+            block_warehouse_(bw), counters_(counters), synced_entries_(0) {}
 
         std::map<unsigned int, block_cache_entry_t> block_cache_;
         cache_slots slots_;
         uint64_t cache_clock_ = 0;
 
+        void initialize();
         void replacement_policy();
         void drop_entry(unsigned int block_num);
         void drop();
@@ -72,6 +83,7 @@ namespace state
         void flush();
         void sync_entry(unsigned int block_num);
         void sync();
+        void prefetch(unsigned int first_block_num, unsigned int last_block_num);
         void put(unsigned int block_num, data_node* dn);
         data_node& retrieve(unsigned int block_num, bool pinned);
         void done(unsigned int block_num, bool modified);
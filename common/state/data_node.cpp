@@ -34,10 +34,16 @@ ByteArray pstate::data_node::make_offset(unsigned int block_num, unsigned int by
     }
 }
 
-pstate::data_node::data_node(unsigned int block_num) : data_(FIXED_DATA_NODE_BYTE_SIZE)
+bool pstate::valid_state_layout(const state_layout_t& layout)
+{
+    unsigned int size = layout.data_node_size_;
+    return size >= MIN_DATA_NODE_BYTE_SIZE && size <= MAX_DATA_NODE_BYTE_SIZE && (size & (size - 1)) == 0;
+}
+
+pstate::data_node::data_node(unsigned int block_num, unsigned int node_size) : data_(node_size)
 {
     block_num_ = block_num;
-    data_.resize(data_end_index());
+    node_size_ = node_size;
     free_bytes_ = data_end_index() - data_begin_index();
 }
 
@@ -46,9 +52,9 @@ unsigned int pstate::data_node::data_begin_index()
     return sizeof(unsigned int) + sizeof(unsigned int);
 }
 
-unsigned int pstate::data_node::data_end_index()
+unsigned int pstate::data_node::data_end_index() const
 {
-    return FIXED_DATA_NODE_BYTE_SIZE;
+    return node_size_;
 }
 
 unsigned int pstate::data_node::get_block_num()
@@ -71,7 +77,8 @@ void pstate::data_node::serialize_data_header()
 void pstate::data_node::decrypt_and_deserialize_data(
     const ByteArray& inEncryptedData, const ByteArray& state_encryption_key)
 {
-    data_ = pdo::crypto::skenc::DecryptMessage(state_encryption_key, inEncryptedData);
+    ByteArray encoded_data = pdo::crypto::skenc::DecryptMessage(state_encryption_key, inEncryptedData);
+    sebio_decode_block(encoded_data, node_size_, data_);
     block_num_ = block_offset::serialized_offset_to_block_num(data_);
     free_bytes_ = block_offset::serialized_offset_to_bytes(data_);
 }
@@ -93,9 +100,9 @@ void pstate::data_node::consume_free_space(unsigned int length)
     free_bytes_ -= length;
 }
 
-void pstate::data_node::advance_block_offset(block_offset_t& bo, unsigned int length)
+void pstate::data_node::advance_block_offset(block_offset_t& bo, unsigned int length, unsigned int node_size)
 {
-    unsigned int block_data_len = pstate::data_node::data_end_index() - pstate::data_node::data_begin_index();
+    unsigned int block_data_len = node_size - pstate::data_node::data_begin_index();
     //advance as many blocks a possible
     unsigned int blocks_to_add = length / block_data_len;
     bo.block_num += blocks_to_add;
@@ -103,10 +110,10 @@ void pstate::data_node::advance_block_offset(block_offset_t& bo, unsigned int le
     //advance the bytes field
     bo.bytes += length;
     //correct the bo in case of overflow
-    if(bo.bytes >= pstate::data_node::data_end_index()) //if equal, there is no overflow, but need switch to next block
+    if(bo.bytes >= node_size) //if equal, there is no overflow, but need switch to next block
     {
         bo.block_num +=1;
-        bo.bytes = pstate::data_node::data_begin_index() + (bo.bytes - pstate::data_node::data_end_index());
+        bo.bytes = pstate::data_node::data_begin_index() + (bo.bytes - node_size);
     }
 }
 
@@ -173,8 +180,8 @@ void pstate::data_node::load(const ByteArray& state_encryption_key)
 void pstate::data_node::unload(
     const ByteArray& state_encryption_key, StateBlockId& outEncryptedDataNodeId)
 {
-    serialize_data_header();
-    ByteArray baEncryptedData = pdo::crypto::skenc::EncryptMessage(state_encryption_key, data_);
+    ByteArray baEncryptedData;
+    serialize_and_encrypt_data(state_encryption_key, baEncryptedData);
     state_status_t ret =
         sebio_evict(baEncryptedData, SEBIO_NO_CRYPTO, originalEncryptedDataNodeId_);
     pdo::error::ThrowIf<pdo::error::ValueError>(
@@ -182,3 +189,20 @@ void pstate::data_node::unload(
     // return new id
     outEncryptedDataNodeId = originalEncryptedDataNodeId_;
 }
+
+void pstate::data_node::load_from_encrypted_data(
+    const ByteArray& inEncryptedData, const ByteArray& state_encryption_key)
+{
+    decrypt_and_deserialize_data(inEncryptedData, state_encryption_key);
+}
+
+void pstate::data_node::serialize_and_encrypt_data(
+    const ByteArray& state_encryption_key, ByteArray& outEncryptedData)
+{
+    serialize_data_header();
+
+    // compress before encrypting, the ciphertext does not compress
+    ByteArray encoded_data;
+    sebio_encode_block(data_, encoded_data);
+    outEncryptedData = pdo::crypto::skenc::EncryptMessage(state_encryption_key, encoded_data);
+}
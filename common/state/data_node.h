@@ -15,12 +15,19 @@
 
 #pragma once
 
-#define FIXED_DATA_NODE_BYTE_SIZE (1 << 13)  // 8 KB
+#define FIXED_DATA_NODE_BYTE_SIZE (1 << 13)  // 8 KB, the default data node size
+#define MIN_DATA_NODE_BYTE_SIZE (1 << 11)    // 2 KB
+#define MAX_DATA_NODE_BYTE_SIZE (1 << 16)    // 64 KB
 
 namespace pdo
 {
 namespace state
 {
+    const state_layout_t default_state_layout = {FIXED_DATA_NODE_BYTE_SIZE, 0};
+
+    // the data node size must be a power of two between the limits
+    bool valid_state_layout(const state_layout_t& layout);
+
     class data_node
     {
     private:
@@ -28,26 +35,30 @@ namespace state
         StateBlockId originalEncryptedDataNodeId_;
         unsigned block_num_;
         unsigned int free_bytes_;
+        unsigned int node_size_;
 
         void decrypt_and_deserialize_data(
             const ByteArray& inEncryptedData, const ByteArray& state_encryption_key);
 
     public:
         ByteArray make_offset(unsigned int block_num, unsigned int bytes_off);
-        data_node(unsigned int block_num);
+        data_node(unsigned int block_num, unsigned int node_size = FIXED_DATA_NODE_BYTE_SIZE);
         static unsigned int data_begin_index();
-        static unsigned int data_end_index();
+        unsigned int data_end_index() const;
         unsigned int get_block_num();
         void cursor(block_offset_t& out_bo);
         void serialize_data_header();
         void deserialize_original_encrypted_data_id(StateBlockId& id);
         unsigned int free_bytes();
         void consume_free_space(unsigned int length);
-        static void advance_block_offset(block_offset_t& bo, unsigned int length);
+        static void advance_block_offset(block_offset_t& bo, unsigned int length, unsigned int node_size);
         unsigned int write_at(const ByteArray& buffer, unsigned int write_from, const block_offset_t& bo_at);
         unsigned int read_at(const block_offset_t& bo_at, unsigned int bytes, ByteArray& outBuffer);
         void load(const ByteArray& state_encryption_key);
         void unload(const ByteArray& state_encryption_key, StateBlockId& outEncryptedDataNodeId);
+        // split load/unload, used by the cache to fetch and evict several data nodes in one batch
+        void load_from_encrypted_data(const ByteArray& inEncryptedData, const ByteArray& state_encryption_key);
+        void serialize_and_encrypt_data(const ByteArray& state_encryption_key, ByteArray& outEncryptedData);
     };
 }
 }
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include "state.h"
 
 namespace pstate = pdo::state;
@@ -24,9 +26,20 @@ void pstate::data_node_io::block_offset_for_appending(block_offset_t& out_bo)
 
 void pstate::data_node_io::initialize(pdo::state::StateNode& node)
 {
-    // deserialize blocks ids in root block
+    initialize_read_only(node);
+    initialize_for_write();
+}
+
+void pstate::data_node_io::initialize_read_only(pdo::state::StateNode& node)
+{
+    // deserialize blocks ids in root block, data nodes are fetched on demand
     block_warehouse_.deserialize_block_ids(node);
+    cache_.initialize();
+    append_dn_ = NULL;
+}
 
+void pstate::data_node_io::initialize_for_write()
+{
     //deserialize free space allocator, and remove last data node
     {
         //get the data node of the free space collection
@@ -59,7 +72,7 @@ void pstate::data_node_io::init_append_data_node()
 
 void pstate::data_node_io::add_and_init_append_data_node()
 {
-    pdo::error::ThrowIf<pdo::error::RuntimeError>(append_dn_->free_bytes() == data_node::data_end_index() - data_node::data_begin_index(),
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(append_dn_->free_bytes() == append_dn_->data_end_index() - data_node::data_begin_index(),
         "appending new data node after empty one");
 
     unsigned int append_data_node_block_num = block_warehouse_.get_last_block_num();
@@ -72,7 +85,7 @@ void pstate::data_node_io::add_and_init_append_data_node()
     append_data_node_block_num ++;
     append_dn_ = cache_.slots_.allocate();
     pdo::error::ThrowIf<pdo::error::RuntimeError>(!append_dn_, "slot allocate, null pointer");
-    *append_dn_ = data_node(append_data_node_block_num);
+    *append_dn_ = data_node(append_data_node_block_num, block_warehouse_.get_data_node_size());
 
     // put and pin it in cache
     cache_.put(append_data_node_block_num, append_dn_);
@@ -128,8 +141,10 @@ void pstate::data_node_io::write_across_data_nodes(const ByteArray& buffer, unsi
 
         //increment written bytes and advance block offset
         total_bytes_written += bytes_written;
-        data_node::advance_block_offset(bo, bytes_written);
+        data_node::advance_block_offset(bo, bytes_written, block_warehouse_.get_data_node_size());
     }
+
+    counters_.bytes_written += total_bytes_written;
 }
 
 void pstate::data_node_io::read_across_data_nodes(const block_offset_t& bo_at, unsigned int length, ByteArray& out_buffer)
@@ -138,6 +153,16 @@ void pstate::data_node_io::read_across_data_nodes(const block_offset_t& bo_at, u
 
     unsigned int bytes_read, total_bytes_read = 0;
 
+    // when the value spans several data nodes, load the missing ones in one batch
+    if (length > 1)
+    {
+        block_offset_t bo_last = bo_at;
+        data_node::advance_block_offset(bo_last, length - 1, block_warehouse_.get_data_node_size());
+        unsigned int last_block_num = std::min(bo_last.block_num, block_warehouse_.get_last_block_num());
+        if (last_block_num > bo_at.block_num)
+            cache_.prefetch(bo_at.block_num, last_block_num);
+    }
+
     // start reading value
     while(total_bytes_read < length)
     {
@@ -156,6 +181,52 @@ void pstate::data_node_io::read_across_data_nodes(const block_offset_t& bo_at, u
 
         //increment read bytes and advance block offset
         total_bytes_read += bytes_read;
-        data_node::advance_block_offset(bo, bytes_read);
+        data_node::advance_block_offset(bo, bytes_read, block_warehouse_.get_data_node_size());
     }
+
+    counters_.bytes_read += total_bytes_read;
+}
+
+void pstate::data_node_io::write_extent(const ByteArray& value, StateBlockId& out_id)
+{
+    ByteArray encoded_value;
+    sebio_encode_block(value, encoded_value);
+    ByteArray encrypted_value =
+        pdo::crypto::skenc::EncryptMessage(block_warehouse_.state_encryption_key_, encoded_value);
+
+    state_status_t ret = sebio_evict(encrypted_value, SEBIO_NO_CRYPTO, out_id);
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        ret != STATE_SUCCESS, "write extent, sebio returned an error");
+
+    block_warehouse_.add_extent_id(out_id);
+
+    counters_.blocks_evicted++;
+    counters_.bytes_written += value.size();
+}
+
+void pstate::data_node_io::read_extent(const StateBlockId& id, size_t value_size, ByteArray& out_value)
+{
+    StateBlock encrypted_value;
+    state_status_t ret = sebio_fetch(id, SEBIO_NO_CRYPTO, encrypted_value);
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        ret != STATE_SUCCESS, "read extent, sebio returned an error");
+
+    ByteArray encoded_value =
+        pdo::crypto::skenc::DecryptMessage(block_warehouse_.state_encryption_key_, encrypted_value);
+    ByteArray value;
+    sebio_decode_block(encoded_value, value_size, value);
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        value.size() != value_size, "read extent, unexpected value size");
+
+    out_value.insert(out_value.end(), value.begin(), value.end());
+
+    counters_.data_node_fetches++;
+    counters_.bytes_read += value_size;
+}
+
+void pstate::data_node_io::delete_extent(const StateBlockId& id)
+{
+    // the block stays in the block store until it is collected, it is
+    // simply no longer listed in the root block
+    block_warehouse_.remove_extent_id(id);
 }
@@ -27,10 +27,17 @@ namespace state
         // append_dn points to a data note pinned in cache
         data_node* append_dn_;
         Cache cache_;
+        pdo_resource_counters_t& counters_;
 
-        data_node_io(const ByteArray& key) : block_warehouse_(key), cache_(block_warehouse_) {}
+        data_node_io(const ByteArray& key, pdo_resource_counters_t& counters) :
+            block_warehouse_(key), free_space_collector_(block_warehouse_), cache_(block_warehouse_, counters), counters_(counters) {}
         void initialize(pdo::state::StateNode& node);
 
+        // opening a state is split in two steps so that the free space
+        // collection and the append node are set up only for updates
+        void initialize_read_only(pdo::state::StateNode& node);
+        void initialize_for_write();
+
         void init_append_data_node();
         void add_and_init_append_data_node();
         void add_and_init_append_data_node_cond(bool cond);
@@ -40,6 +47,11 @@ namespace state
 
         void write_across_data_nodes(const ByteArray& buffer, unsigned int write_from, const block_offset_t& bo_at);
         void read_across_data_nodes(const block_offset_t& bo_at, unsigned int length, ByteArray& outBuffer);
+
+        // an extent is a block that holds a single value, it bypasses the cache
+        void write_extent(const ByteArray& value, StateBlockId& out_id);
+        void read_extent(const StateBlockId& id, size_t value_size, ByteArray& out_value);
+        void delete_extent(const StateBlockId& id);
     };
 }
 }
@@ -23,7 +23,7 @@ bool pstate::free_space_collector::are_adjacent(const block_offset_t& bo1, const
         (bo1.block_num == bo2.block_num && bo1.bytes > bo2.bytes),
         "free space collector, adjancency error");
     block_offset_t bo = bo1;
-    data_node::advance_block_offset(bo, length1);
+    data_node::advance_block_offset(bo, length1, block_warehouse_.get_data_node_size());
     return (bo == bo2);
 }
 
@@ -126,7 +126,7 @@ bool pstate::free_space_collector::allocate(const unsigned int& length, block_of
             else
             {
                 //item has more space than necessary, so update it
-                data_node::advance_block_offset(it->bo, length);
+                data_node::advance_block_offset(it->bo, length, block_warehouse_.get_data_node_size());
                 it->length -= length;
             }
 
@@ -154,7 +154,7 @@ void pstate::free_space_collector::serialize_in_data_node(data_node &out_dn)
 
     //out_dn must be a dedicated data node, so let us check it is completely free
     pdo::error::ThrowIf<pdo::error::RuntimeError>(
-        out_dn.free_bytes() != data_node::data_end_index() - data_node::data_begin_index(),
+        out_dn.free_bytes() != out_dn.data_end_index() - data_node::data_begin_index(),
     "serialize free space collector, data node not dedicated");
 
     unsigned int items=0;
@@ -168,7 +168,7 @@ void pstate::free_space_collector::serialize_in_data_node(data_node &out_dn)
         }
         ByteArray ba_free_space_item((uint8_t*)&(*it), (uint8_t*)&(*it) + sizeof(free_space_item_t));
         out_dn.write_at(ba_free_space_item, 0, bo);
-        data_node::advance_block_offset(bo, sizeof(free_space_item_t));
+        data_node::advance_block_offset(bo, sizeof(free_space_item_t), block_warehouse_.get_data_node_size());
         items++;
     }
 }
@@ -176,7 +176,7 @@ void pstate::free_space_collector::serialize_in_data_node(data_node &out_dn)
 void pstate::free_space_collector::deserialize_from_data_node(data_node &in_dn)
 {
     //ASSUMPTION: the data node is dedicated to contain the free space collection vector
-    unsigned int bytes_to_read = data_node::data_end_index() - data_node::data_begin_index() - in_dn.free_bytes();
+    unsigned int bytes_to_read = in_dn.data_end_index() - data_node::data_begin_index() - in_dn.free_bytes();
     pdo::error::ThrowIf<pdo::error::RuntimeError>(
         bytes_to_read % sizeof(free_space_item_t) != 0,
         "deserialize free space collector, readable bytes not a multiple of item size");
@@ -185,7 +185,7 @@ void pstate::free_space_collector::deserialize_from_data_node(data_node &in_dn)
     while(bytes_to_read)
     {
         in_dn.read_at(bo, sizeof(free_space_item_t), ba_free_space_item);
-        data_node::advance_block_offset(bo, sizeof(free_space_item_t));
+        data_node::advance_block_offset(bo, sizeof(free_space_item_t), block_warehouse_.get_data_node_size());
         bytes_to_read -= sizeof(free_space_item_t);
 
         free_space_collection.push_back(*((free_space_item_t*)ba_free_space_item.data()));
@@ -27,6 +27,9 @@ namespace state
         } free_space_item_t;
 
     private:
+        // the block_warehouse_ reference is related to the block_warehouse member of dn_io
+        block_warehouse& block_warehouse_;
+
         bool is_collection_modified = false;
         bool is_fsi_deferred = false;
         free_space_item_t deferred_fsi;
@@ -40,6 +43,8 @@ namespace state
     public:
         StateBlockId original_block_id_of_collection;
 
+        free_space_collector(block_warehouse& bw) : block_warehouse_(bw) {}
+
         void collect(const block_offset_t& bo, const unsigned int& length);
         bool allocate(const unsigned int& length, block_offset_t& out_bo);
         bool collection_modified();
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include "interpreter_kv.h"
 #include "crypto.h"
 #include "log.h"
@@ -37,6 +39,14 @@ static ByteArray to_unprivileged_key(const ByteArray& key)
     return unprivileged_key;
 }
 
+static void hash_key_set(const std::set<ByteArray>& keys, std::vector<ByteArray>& hashes)
+{
+    hashes.clear();
+    for (auto it = keys.begin(); it != keys.end(); ++it)
+        hashes.push_back(pdo::crypto::ComputeMessageHash(*it));
+    std::sort(hashes.begin(), hashes.end());
+}
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 // Class: Interpreter_KV
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -45,28 +55,54 @@ pdo::state::Interpreter_KV::Interpreter_KV(const ByteArray& id, const ByteArray&
 {
 }
 
+pdo::state::Interpreter_KV::Interpreter_KV(
+    const ByteArray& id, const ByteArray& encryption_key, bool read_only)
+    : kv_(id, encryption_key, read_only)
+{
+}
+
 pdo::state::Interpreter_KV::Interpreter_KV(const ByteArray& encryption_key)
     : kv_(encryption_key)
 {
 }
 
+pdo::state::Interpreter_KV::Interpreter_KV(
+    const ByteArray& encryption_key, const state_layout_t& layout)
+    : kv_(encryption_key, layout)
+{
+}
+
 void pdo::state::Interpreter_KV::Finalize(ByteArray& id)
 {
     kv_.Finalize(id);
 }
 
+void pdo::state::Interpreter_KV::Finalize(
+    ByteArray& id,
+    StateBlockIdArray& newBlockIds,
+    StateBlockIdArray& supersededBlockIds)
+{
+    kv_.Finalize(id, newBlockIds, supersededBlockIds);
+}
+
 ByteArray pdo::state::Interpreter_KV::Get(const ByteArray& key) const
 {
+    if (track_access_)
+        read_keys_.insert(key);
     return kv_.Get(key);
 }
 
 void pdo::state::Interpreter_KV::Put(const ByteArray& key, const ByteArray& value)
 {
+    if (track_access_)
+        write_keys_.insert(key);
     kv_.Put(key, value);
 }
 
 void pdo::state::Interpreter_KV::Delete(const ByteArray& key)
 {
+    if (track_access_)
+        write_keys_.insert(key);
     kv_.Delete(key);
 }
 
@@ -108,3 +144,22 @@ void pdo::state::Interpreter_KV::UnprivilegedDelete(const ByteArray& key)
     ByteArray unprivileged_key = to_unprivileged_key(key);
     Delete(unprivileged_key);
 }
+
+const pdo_resource_counters_t& pdo::state::Interpreter_KV::ResourceCounters(void) const
+{
+    return kv_.ResourceCounters();
+}
+
+void pdo::state::Interpreter_KV::TrackAccess(bool enable)
+{
+    track_access_ = enable;
+    read_keys_.clear();
+    write_keys_.clear();
+}
+
+void pdo::state::Interpreter_KV::GetAccessSets(
+    std::vector<ByteArray>& readSet, std::vector<ByteArray>& writeSet) const
+{
+    hash_key_set(read_keys_, readSet);
+    hash_key_set(write_keys_, writeSet);
+}
@@ -15,6 +15,9 @@
 
 #pragma once
 
+#include <set>
+#include <vector>
+
 #include "state.h"
 #include "types.h"
 
@@ -27,15 +30,26 @@ namespace state
     protected:
         State_KV kv_;
 
+        // keys read and written while access tracking is enabled
+        bool track_access_ = false;
+        mutable std::set<ByteArray> read_keys_;
+        std::set<ByteArray> write_keys_;
+
         ByteArray Get(const ByteArray& key) const;
         void Put(const ByteArray& key, const ByteArray& value);
         void Delete(const ByteArray& key);
 
     public:
         Interpreter_KV(const StateBlockId& id, const ByteArray& encryption_key);
+        Interpreter_KV(const StateBlockId& id, const ByteArray& encryption_key, bool read_only);
         Interpreter_KV(const ByteArray& encryption_key);
+        Interpreter_KV(const ByteArray& encryption_key, const state_layout_t& layout);
 
         void Finalize(ByteArray& id);
+        void Finalize(
+            ByteArray& id,
+            StateBlockIdArray& newBlockIds,
+            StateBlockIdArray& supersededBlockIds);
 
         void PrivilegedPut(const ByteArray& key, const ByteArray& value);
         ByteArray PrivilegedGet(const ByteArray& key) const;
@@ -44,6 +58,13 @@ namespace state
         void UnprivilegedPut(const ByteArray& key, const ByteArray& value);
         ByteArray UnprivilegedGet(const ByteArray& key);
         void UnprivilegedDelete(const ByteArray& key);
+
+        const pdo_resource_counters_t& ResourceCounters(void) const;
+
+        // record the keys accessed from now on, enabling clears the sets;
+        // the sets are reported as sorted hashes of the stored keys
+        void TrackAccess(bool enable);
+        void GetAccessSets(std::vector<ByteArray>& readSet, std::vector<ByteArray>& writeSet) const;
     };
 }
 }
@@ -13,6 +13,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include "sebio.h"
 #include "c11_support.h"
 #include "crypto.h"
@@ -159,3 +161,325 @@ state_status_t sebio_evict_to_block_store(
     }
     return STATE_SUCCESS;
 }
+
+/*
+    Batched fetch. With the default block store context, all blocks are
+    loaded first and their hashes are checked together; a custom context
+    is invoked once per block.
+*/
+state_status_t sebio_fetch_batch(const std::vector<pstate::StateBlockId>& block_ids,
+    sebio_crypto_algo_e crypto_algo,
+    std::vector<pstate::StateBlock>& blocks)
+{
+    blocks.resize(block_ids.size());
+
+    if (sebio_ctx.f_sebio_fetch != &sebio_fetch_from_block_store)
+    {
+        for (size_t i = 0; i < block_ids.size(); i++)
+        {
+            state_status_t ret = sebio_ctx.f_sebio_fetch(block_ids[i], crypto_algo, blocks[i]);
+            if (ret != STATE_SUCCESS)
+                return ret;
+        }
+        return STATE_SUCCESS;
+    }
+
+    if (crypto_algo != SEBIO_NO_CRYPTO && crypto_algo != SEBIO_AES_GCM)
+        return STATE_ERR_UNIMPLEMENTED;
+
+    // load the data
+    pdo::crypto::ByteArrayRefArray block_refs;
+    block_refs.reserve(block_ids.size());
+    for (size_t i = 0; i < block_ids.size(); i++)
+    {
+        pdo_err_t ret = pdo::block_store::BlockStoreGet(block_ids[i], blocks[i]);
+        if (ret != PDO_SUCCESS)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "sebio error, BlockStoreGet returned %d\n", ret);
+            return STATE_ERR_NOT_FOUND;
+        }
+        block_refs.push_back(&blocks[i]);
+    }
+
+    // check block hash == block id
+    std::vector<ByteArray> computedIds;
+    pdo::crypto::ComputeMessageHashes(block_refs, computedIds);
+    for (size_t i = 0; i < block_ids.size(); i++)
+    {
+        if (block_ids[i] != computedIds[i])
+            return STATE_ERR_BLOCK_AUTHENTICATION;
+    }
+
+    // decrypt if necessary
+    if (crypto_algo == SEBIO_AES_GCM)
+    {
+        pdo::error::ThrowIf<pdo::error::RuntimeError>(
+            sebio_ctx.crypto_algo != crypto_algo, "sebio_fetch, crypto-algo does not match");
+        for (size_t i = 0; i < blocks.size(); i++)
+            blocks[i] = pdo::crypto::skenc::DecryptMessage(sebio_ctx.key, blocks[i]);
+    }
+
+    return STATE_SUCCESS;
+}
+
+/*
+    Batched evict. With the default block store context, the blocks are
+    encrypted if requested, their ids are computed together, and then
+    they are put into the block store; a custom context is invoked once
+    per block.
+*/
+state_status_t sebio_evict_batch(const std::vector<pstate::StateBlock>& blocks,
+    sebio_crypto_algo_e crypto_algo,
+    std::vector<ByteArray>& idsOnEviction)
+{
+    idsOnEviction.resize(blocks.size());
+
+    if (sebio_ctx.f_sebio_evict != &sebio_evict_to_block_store)
+    {
+        for (size_t i = 0; i < blocks.size(); i++)
+        {
+            state_status_t ret = sebio_ctx.f_sebio_evict(blocks[i], crypto_algo, idsOnEviction[i]);
+            if (ret != STATE_SUCCESS)
+                return ret;
+        }
+        return STATE_SUCCESS;
+    }
+
+    std::vector<ByteArray> baEncryptedBlocks;
+    pdo::crypto::ByteArrayRefArray block_refs;
+    block_refs.reserve(blocks.size());
+
+    switch (crypto_algo)
+    {
+        case SEBIO_NO_CRYPTO:
+        {
+            for (size_t i = 0; i < blocks.size(); i++)
+                block_refs.push_back(&blocks[i]);
+            break;
+        }
+        case SEBIO_AES_GCM:
+        {
+            // check initialization
+            pdo::error::ThrowIf<pdo::error::RuntimeError>(
+                sebio_ctx.crypto_algo != crypto_algo, "sebio_evict, crypto-algo does not match");
+            baEncryptedBlocks.resize(blocks.size());
+            for (size_t i = 0; i < blocks.size(); i++)
+            {
+                baEncryptedBlocks[i] = pdo::crypto::skenc::EncryptMessage(sebio_ctx.key, blocks[i]);
+                block_refs.push_back(&baEncryptedBlocks[i]);
+            }
+            break;
+        }
+        default:
+            return STATE_ERR_UNIMPLEMENTED;
+    }
+
+    // compute the block ids before the blocks are evicted
+    pdo::crypto::ComputeMessageHashes(block_refs, idsOnEviction);
+
+    for (size_t i = 0; i < block_refs.size(); i++)
+    {
+        int ret = pdo::block_store::BlockStorePut(idsOnEviction[i], *block_refs[i]);
+        if (ret != 0)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "sebio error, block store put returned %d\n", ret);
+            return STATE_ERR_UNKNOWN;
+        }
+    }
+    return STATE_SUCCESS;
+}
+
+//########### block compression ###########################################
+/*
+    The run length codec suits the sparse data nodes: zero padding after
+    the consumed space, trie nodes and short values. A control byte with
+    the high bit set is followed by one byte repeated (control & 0x7f) + 3
+    times; otherwise it is followed by (control + 1) literal bytes.
+*/
+#define SEBIO_CODEC_HEADER_SIZE 5
+#define SEBIO_RLE_MIN_RUN 3
+#define SEBIO_RLE_MAX_RUN (0x7f + SEBIO_RLE_MIN_RUN)
+#define SEBIO_RLE_MAX_LITERAL 0x80
+
+#if _UNTRUSTED_
+
+#include <pthread.h>
+
+#define MUTEX_LOCK pthread_mutex_lock
+#define MUTEX_UNLOCK pthread_mutex_unlock
+
+static pthread_mutex_t sebio_codec_stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+#else // _UNTRUSTED_
+
+#include "sgx_thread.h"
+
+#define MUTEX_LOCK sgx_thread_mutex_lock
+#define MUTEX_UNLOCK sgx_thread_mutex_unlock
+
+static sgx_thread_mutex_t sebio_codec_stats_mutex = SGX_THREAD_MUTEX_INITIALIZER;
+
+#endif // _UNTRUSTED_
+
+static sebio_codec_e sebio_codec = SEBIO_DEFAULT_CODEC;
+static sebio_codec_stats_t sebio_codec_stats = {0, 0, 0, 0};
+
+static void sebio_update_codec_stats(size_t raw_bytes, size_t encoded_bytes, bool compressed)
+{
+    MUTEX_LOCK(&sebio_codec_stats_mutex);
+    sebio_codec_stats.blocks_encoded_++;
+    sebio_codec_stats.raw_bytes_ += raw_bytes;
+    sebio_codec_stats.encoded_bytes_ += encoded_bytes;
+    if (compressed)
+        sebio_codec_stats.blocks_compressed_++;
+    MUTEX_UNLOCK(&sebio_codec_stats_mutex);
+}
+
+state_status_t sebio_set_codec(sebio_codec_e codec)
+{
+    if (codec != SEBIO_CODEC_NONE && codec != SEBIO_CODEC_RLE)
+        return STATE_ERR_UNIMPLEMENTED;
+
+    sebio_codec = codec;
+    return STATE_SUCCESS;
+}
+
+sebio_codec_e sebio_get_codec(void)
+{
+    return sebio_codec;
+}
+
+void sebio_get_codec_stats(sebio_codec_stats_t& stats)
+{
+    MUTEX_LOCK(&sebio_codec_stats_mutex);
+    stats = sebio_codec_stats;
+    MUTEX_UNLOCK(&sebio_codec_stats_mutex);
+}
+
+void sebio_reset_codec_stats(void)
+{
+    MUTEX_LOCK(&sebio_codec_stats_mutex);
+    sebio_codec_stats = {0, 0, 0, 0};
+    MUTEX_UNLOCK(&sebio_codec_stats_mutex);
+}
+
+static void rle_encode(const ByteArray& inBlock, ByteArray& outBlock)
+{
+    const size_t size = inBlock.size();
+    size_t literal = 0;     // start of the pending literal bytes
+    size_t i = 0;
+
+    while (i < size)
+    {
+        size_t run = 1;
+        while (i + run < size && run < SEBIO_RLE_MAX_RUN && inBlock[i + run] == inBlock[i])
+            run++;
+
+        if (run < SEBIO_RLE_MIN_RUN)
+        {
+            i += run;
+            continue;
+        }
+
+        while (literal < i)
+        {
+            size_t count = std::min(i - literal, (size_t)SEBIO_RLE_MAX_LITERAL);
+            outBlock.push_back((uint8_t)(count - 1));
+            outBlock.insert(outBlock.end(), inBlock.begin() + literal, inBlock.begin() + literal + count);
+            literal += count;
+        }
+
+        outBlock.push_back((uint8_t)(0x80 | (run - SEBIO_RLE_MIN_RUN)));
+        outBlock.push_back(inBlock[i]);
+        i += run;
+        literal = i;
+    }
+
+    while (literal < size)
+    {
+        size_t count = std::min(size - literal, (size_t)SEBIO_RLE_MAX_LITERAL);
+        outBlock.push_back((uint8_t)(count - 1));
+        outBlock.insert(outBlock.end(), inBlock.begin() + literal, inBlock.begin() + literal + count);
+        literal += count;
+    }
+}
+
+static void rle_decode(const ByteArray& inBlock, size_t inOffset, size_t inPlainSize, ByteArray& outBlock)
+{
+    outBlock.clear();
+    outBlock.reserve(inPlainSize);
+
+    size_t i = inOffset;
+    while (i < inBlock.size())
+    {
+        uint8_t control = inBlock[i++];
+        if (control & 0x80)
+        {
+            size_t run = (control & 0x7f) + SEBIO_RLE_MIN_RUN;
+            pdo::error::ThrowIf<pdo::error::ValueError>(
+                i >= inBlock.size() || outBlock.size() + run > inPlainSize, "sebio decode, malformed block");
+            outBlock.insert(outBlock.end(), run, inBlock[i++]);
+        }
+        else
+        {
+            size_t count = (size_t)control + 1;
+            pdo::error::ThrowIf<pdo::error::ValueError>(
+                i + count > inBlock.size() || outBlock.size() + count > inPlainSize, "sebio decode, malformed block");
+            outBlock.insert(outBlock.end(), inBlock.begin() + i, inBlock.begin() + i + count);
+            i += count;
+        }
+    }
+
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        outBlock.size() != inPlainSize, "sebio decode, wrong block size");
+}
+
+void sebio_encode_block(const ByteArray& inBlock, ByteArray& outBlock)
+{
+    if (sebio_codec == SEBIO_CODEC_RLE)
+    {
+        uint32_t plain_size = inBlock.size();
+
+        outBlock.clear();
+        outBlock.push_back((uint8_t)SEBIO_CODEC_RLE);
+        for (size_t b = 0; b < sizeof(plain_size); b++)
+            outBlock.push_back((uint8_t)(plain_size >> (8 * b)));
+        rle_encode(inBlock, outBlock);
+
+        if (outBlock.size() < inBlock.size())
+        {
+            sebio_update_codec_stats(inBlock.size(), outBlock.size(), true);
+            return;
+        }
+    }
+
+    outBlock = inBlock;
+    sebio_update_codec_stats(inBlock.size(), outBlock.size(), false);
+}
+
+void sebio_decode_block(const ByteArray& inBlock, size_t inPlainSize, ByteArray& outBlock)
+{
+    if (inBlock.size() == inPlainSize)
+    {
+        outBlock = inBlock;
+        return;
+    }
+
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        inBlock.size() < SEBIO_CODEC_HEADER_SIZE, "sebio decode, missing codec header");
+
+    uint32_t plain_size = 0;
+    for (size_t b = 0; b < sizeof(plain_size); b++)
+        plain_size |= (uint32_t)inBlock[1 + b] << (8 * b);
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        plain_size != inPlainSize, "sebio decode, unexpected block size");
+
+    switch (inBlock[0])
+    {
+        case SEBIO_CODEC_RLE:
+            rle_decode(inBlock, SEBIO_CODEC_HEADER_SIZE, inPlainSize, outBlock);
+            break;
+        default:
+            throw pdo::error::ValueError("sebio decode, unknown codec");
+    }
+}
@@ -20,6 +20,14 @@
 
 typedef enum { SEBIO_NO_CRYPTO, SEBIO_AES_GCM } sebio_crypto_algo_e;
 
+// Codecs for compressing blocks before they are encrypted; the value is
+// the tag written in the header of an encoded block
+typedef enum { SEBIO_CODEC_NONE = 0, SEBIO_CODEC_RLE = 1 } sebio_codec_e;
+
+#ifndef SEBIO_DEFAULT_CODEC
+#define SEBIO_DEFAULT_CODEC SEBIO_CODEC_NONE
+#endif
+
 typedef struct
 {
     ByteArray key;
@@ -44,3 +52,48 @@ state_status_t sebio_fetch(const pdo::state::StateBlockId& block_id,
 
 state_status_t sebio_evict(
     const pdo::state::StateBlock& block, sebio_crypto_algo_e crypto_algo, ByteArray& idOnEviction);
+
+// Batched variants of fetch and evict. With the default block store
+// functions the block hashes are computed together, which lets the
+// multi-buffer hash engine process several blocks at once; with custom
+// functions each block is passed to the context functions in turn.
+state_status_t sebio_fetch_batch(const std::vector<pdo::state::StateBlockId>& block_ids,
+    sebio_crypto_algo_e crypto_algo,
+    std::vector<pdo::state::StateBlock>& blocks);
+
+state_status_t sebio_evict_batch(const std::vector<pdo::state::StateBlock>& blocks,
+    sebio_crypto_algo_e crypto_algo,
+    std::vector<ByteArray>& idsOnEviction);
+
+// Compression of plaintext blocks, applied by the callers before the
+// block is encrypted and after it is decrypted. A block that does not
+// get smaller is kept as is, without a header; an encoded block starts
+// with the codec tag and the size of the plaintext. Since the size of
+// a plain block is known to the caller, the two cannot be confused and
+// blocks written before compression was enabled are still readable.
+//
+// Compression happens before encryption, so the length of an encrypted
+// block in the untrusted block store reveals how well its plaintext
+// compressed, and through that something about the content. Encoded
+// blocks are not padded since that would give back most of the space
+// saved; the codec is off by default and should only be enabled for
+// contracts where this leak is acceptable.
+//
+// The statistics are shared by all threads in the enclave and are
+// updated under a lock.
+typedef struct
+{
+    uint64_t blocks_encoded_;   // blocks passed to sebio_encode_block
+    uint64_t blocks_compressed_;
+    uint64_t raw_bytes_;
+    uint64_t encoded_bytes_;
+} sebio_codec_stats_t;
+
+state_status_t sebio_set_codec(sebio_codec_e codec);
+sebio_codec_e sebio_get_codec(void);
+
+void sebio_get_codec_stats(sebio_codec_stats_t& stats);
+void sebio_reset_codec_stats(void);
+
+void sebio_encode_block(const ByteArray& inBlock, ByteArray& outBlock);
+void sebio_decode_block(const ByteArray& inBlock, size_t inPlainSize, ByteArray& outBlock);
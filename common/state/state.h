@@ -21,6 +21,7 @@
 #include "log.h"
 #include "packages/base64/base64.h"
 #include "pdo_error.h"
+#include "resource_counters.h"
 #include "types.h"
 
 #include "state_status.h"
@@ -29,8 +30,8 @@
 #include "sebio.h"
 #include "basic_kv.h"
 #include "block_offset.h"
-#include "block_warehouse.h"
 #include "data_node.h"
+#include "block_warehouse.h"
 #include "free_space_collector.h"
 #include "cache.h"
 #include "data_node_io.h"
@@ -0,0 +1,109 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "crypto.h"
+#include "zero.h"
+
+#include "state_key_cache.h"
+
+namespace pstate = pdo::state;
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+pstate::StateKeyCache::StateKeyCache(size_t capacity) : capacity_(capacity), clock_(0)
+{
+}
+
+pstate::StateKeyCache::~StateKeyCache(void)
+{
+    clear();
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+ByteArray pstate::StateKeyCache::index(const std::string& contract_id, const std::string& sealed_key)
+{
+    // the length of the id keeps the concatenation unambiguous
+    uint64_t id_size = contract_id.size();
+
+    pdo::crypto::Hasher hasher;
+    hasher.Update((const uint8_t*)&id_size, sizeof(id_size));
+    hasher.Update(contract_id);
+    hasher.Update(sealed_key);
+    return hasher.Final();
+}
+
+void pstate::StateKeyCache::erase(entry_map_t::iterator it)
+{
+    ZeroV(it->second.key);
+    entries_.erase(it);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+bool pstate::StateKeyCache::find(
+    const std::string& contract_id, const std::string& sealed_key, ByteArray& key)
+{
+    entry_map_t::iterator it = entries_.find(index(contract_id, sealed_key));
+    if (it == entries_.end())
+        return false;
+
+    it->second.last_use = ++clock_;
+    key = it->second.key;
+    return true;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pstate::StateKeyCache::insert(
+    const std::string& contract_id, const std::string& sealed_key, const ByteArray& key)
+{
+    ByteArray entry_index = index(contract_id, sealed_key);
+    if (entries_.find(entry_index) != entries_.end())
+        return;
+
+    if (capacity_ == 0)
+        return;
+
+    if (entries_.size() >= capacity_)
+    {
+        entry_map_t::iterator oldest = entries_.begin();
+        for (entry_map_t::iterator it = entries_.begin(); it != entries_.end(); it++)
+            if (it->second.last_use < oldest->second.last_use)
+                oldest = it;
+
+        erase(oldest);
+    }
+
+    entry_t& entry = entries_[entry_index];
+    entry.contract_id = contract_id;
+    entry.key = key;
+    entry.last_use = ++clock_;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pstate::StateKeyCache::invalidate(const std::string& contract_id)
+{
+    entry_map_t::iterator it = entries_.begin();
+    while (it != entries_.end())
+    {
+        entry_map_t::iterator current = it++;
+        if (current->second.contract_id == contract_id)
+            erase(current);
+    }
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pstate::StateKeyCache::clear(void)
+{
+    while (! entries_.empty())
+        erase(entries_.begin());
+}
@@ -0,0 +1,66 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "types.h"
+
+namespace pdo
+{
+namespace state
+{
+    // Bounded cache of state encryption keys. Entries are indexed by the
+    // contract id and the sealed key they were derived from so a
+    // different sealed key for the same contract never hits the cache.
+    // The least recently used entry is evicted when the cache is full
+    // and keys are zeroed whenever an entry is removed. The cache does
+    // no locking, the caller serializes access.
+    class StateKeyCache
+    {
+    public:
+        StateKeyCache(size_t capacity);
+        ~StateKeyCache(void);
+
+        bool find(const std::string& contract_id, const std::string& sealed_key, ByteArray& key);
+        void insert(const std::string& contract_id, const std::string& sealed_key, const ByteArray& key);
+
+        // remove every key for the contract
+        void invalidate(const std::string& contract_id);
+        void clear(void);
+
+        size_t size(void) const { return entries_.size(); }
+
+    private:
+        struct entry_t
+        {
+            std::string contract_id;
+            ByteArray key;
+            uint64_t last_use;
+        };
+
+        typedef std::map<ByteArray, entry_t> entry_map_t;
+
+        static ByteArray index(const std::string& contract_id, const std::string& sealed_key);
+        void erase(entry_map_t::iterator it);
+
+        size_t capacity_;
+        uint64_t clock_;
+        entry_map_t entries_;
+    };
+}
+}
@@ -18,12 +18,20 @@
 namespace pstate = pdo::state;
 
 pdo::state::State_KV::State_KV(const ByteArray& key)
-    : state_encryption_key_(key), dn_io_(data_node_io(key))
+    : State_KV(key, default_state_layout)
+{
+}
+
+pdo::state::State_KV::State_KV(const ByteArray& key, const state_layout_t& layout)
+    : state_encryption_key_(key), counters_(), dn_io_(data_node_io(key, counters_))
 {
     try
     {
+        dn_io_.block_warehouse_.set_layout(layout);
+        dn_io_.cache_.initialize();
+
         // initialize first data node
-        data_node dn(dn_io_.block_warehouse_.get_root_block_num());
+        data_node dn(dn_io_.block_warehouse_.get_root_block_num(), layout.data_node_size_);
         StateBlockId dn_id;
         dn.unload(state_encryption_key_, dn_id);
         dn_io_.block_warehouse_.add_block_id(dn_id);
@@ -47,7 +55,12 @@ pdo::state::State_KV::State_KV(const ByteArray& key)
 }
 
 pdo::state::State_KV::State_KV(const StateBlockId& id, const ByteArray& key)
-    : state_encryption_key_(key), dn_io_(data_node_io(key))
+    : State_KV(id, key, false)
+{
+}
+
+pdo::state::State_KV::State_KV(const StateBlockId& id, const ByteArray& key, bool read_only)
+    : state_encryption_key_(key), counters_(), dn_io_(data_node_io(key, counters_))
 {
     try
     {
@@ -58,7 +71,7 @@ pdo::state::State_KV::State_KV(const StateBlockId& id, const ByteArray& key)
         pdo::error::ThrowIf<pdo::error::ValueError>(
             ret != STATE_SUCCESS, "statekv::init, sebio returned an error");
 
-        dn_io_.initialize(rootNode_);
+        dn_io_.initialize_read_only(rootNode_);
     }
     catch(const std::exception& e)
     {
@@ -66,7 +79,19 @@ pdo::state::State_KV::State_KV(const StateBlockId& id, const ByteArray& key)
         throw;
     }
 
-    kv_start_mode = KV_OPEN;
+    kv_start_mode = (read_only ? KV_OPEN_READ_ONLY : KV_OPEN);
+}
+
+void pdo::state::State_KV::PrepareForWrite()
+{
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        kv_start_mode == KV_OPEN_READ_ONLY, "attempt to update read-only state");
+
+    if (write_ready_ || kv_start_mode != KV_OPEN)
+        return;
+
+    dn_io_.initialize_for_write();
+    write_ready_ = true;
 }
 
 void pdo::state::State_KV::Finalize(ByteArray& outId)
@@ -74,6 +99,15 @@ void pdo::state::State_KV::Finalize(ByteArray& outId)
     pdo::error::ThrowIf<pdo::error::RuntimeError>(
         kv_start_mode == KV_UNINITIALIZED, "attempt to finalize uninitialized state");
 
+    // without updates the data nodes are unchanged, nothing is written
+    // and the root block id is the input id
+    if (kv_start_mode != KV_CREATE && ! write_ready_)
+    {
+        dn_io_.cache_.drop();
+        outId = rootNode_.GetBlockId();
+        return;
+    }
+
     try
     {
         //store the free space collection table IF the kv has been create OR the table has been modified
@@ -103,6 +137,8 @@ void pdo::state::State_KV::Finalize(ByteArray& outId)
             state_status_t ret = sebio_evict(baBlock, SEBIO_NO_CRYPTO, rootNode_.GetBlockId());
             pdo::error::ThrowIf<pdo::error::ValueError>(
                 ret != STATE_SUCCESS, "kv root node unload, sebio returned an error");
+
+            counters_.blocks_evicted++;
         }
 
         // output the root id
@@ -115,6 +151,33 @@ void pdo::state::State_KV::Finalize(ByteArray& outId)
     }
 }
 
+void pdo::state::State_KV::Finalize(
+    ByteArray& outId,
+    StateBlockIdArray& outNewBlockIds,
+    StateBlockIdArray& outSupersededBlockIds)
+{
+    // the root block id is empty for a new state
+    StateBlockId input_id = rootNode_.GetBlockId();
+
+    Finalize(outId);
+
+    outNewBlockIds.clear();
+    outSupersededBlockIds.clear();
+
+    // without synced entries neither the data blocks nor the root changed
+    if (dn_io_.cache_.synced_entries() == 0)
+        return;
+
+    dn_io_.block_warehouse_.get_change_set(outNewBlockIds, outSupersededBlockIds);
+
+    if (outId != input_id)
+    {
+        outNewBlockIds.push_back(outId);
+        if (! input_id.empty())
+            outSupersededBlockIds.push_back(input_id);
+    }
+}
+
 ByteArray pstate::State_KV::Get(const ByteArray& key) const
 {
     // perform operation
@@ -138,6 +201,7 @@ void pstate::State_KV::Put(const ByteArray& key, const ByteArray& value)
     // perform operation
     const ByteArray& kvkey = key;
     ByteArray v;
+    PrepareForWrite();
     try
     {
         trie_node::operate_trie_non_recursive(dn_io_, PUT_OP, kvkey, value, v);
@@ -155,6 +219,7 @@ void pstate::State_KV::Delete(const ByteArray& key)
     const ByteArray in_value;
     ByteArray value;
     const ByteArray& kvkey = key;
+    PrepareForWrite();
     try
     {
         trie_node::operate_trie_non_recursive(dn_io_, DEL_OP, kvkey, in_value, value);
@@ -165,3 +230,8 @@ void pstate::State_KV::Delete(const ByteArray& key)
         throw;
     }
 }
+
+const pdo_resource_counters_t& pstate::State_KV::ResourceCounters(void) const
+{
+    return counters_;
+}
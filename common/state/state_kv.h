@@ -27,24 +27,48 @@ namespace state
         {
             KV_UNINITIALIZED,
             KV_CREATE,
-            KV_OPEN
+            KV_OPEN,
+            KV_OPEN_READ_ONLY
         } kv_start_mode_e;
 
     protected:
         pdo::state::StateNode rootNode_;
         const ByteArray state_encryption_key_;
+        // declared before dn_io_, which keeps a reference to it
+        pdo_resource_counters_t counters_;
         mutable data_node_io dn_io_;
         kv_start_mode_e kv_start_mode = KV_UNINITIALIZED;
 
+        // an opened state sets up the free space collection and the append
+        // node on the first update, until then it is read like a snapshot
+        bool write_ready_ = false;
+        void PrepareForWrite();
+
     public:
         State_KV(const ByteArray& key);
+
+        // create a state with the given data node size and extent threshold,
+        // the layout is recorded in the root block when the state is finalized
+        State_KV(const ByteArray& key, const state_layout_t& layout);
         State_KV(const StateBlockId& id, const ByteArray& key);
 
+        // a read-only state rejects updates, Finalize returns the input id
+        State_KV(const StateBlockId& id, const ByteArray& key, bool read_only);
+
         void Finalize(ByteArray& id);
 
+        // finalize and report the blocks added to and removed from the state,
+        // the root block is included in the lists when it changes
+        void Finalize(
+            ByteArray& id,
+            StateBlockIdArray& newBlockIds,
+            StateBlockIdArray& supersededBlockIds);
+
         ByteArray Get(const ByteArray& key) const;
         void Put(const ByteArray& key, const ByteArray& value);
         void Delete(const ByteArray& key);
+
+        const pdo_resource_counters_t& ResourceCounters(void) const;
     };
 }
 }
@@ -61,7 +61,15 @@ void pstate::trie_node::do_write_value(data_node_io& dn_io,
         }
     }
 
-    unsigned int space_required = sizeof(trie_node_header_t) + sizeof(size_t) + value.size();
+    // large values are stored in an extent, the data nodes hold only its id
+    size_t extent_threshold = dn_io.block_warehouse_.get_layout().extent_threshold_;
+    bool is_extent = (extent_threshold > 0 && value.size() >= extent_threshold);
+    ByteArray stored_value;
+    if (is_extent)
+        dn_io.write_extent(value, stored_value);
+    const ByteArray& record_value = (is_extent ? stored_value : value);
+
+    unsigned int space_required = sizeof(trie_node_header_t) + sizeof(size_t) + record_value.size();
 
     //grab the offset where data is going to be written
     if(! dn_io.free_space_collector_.allocate(space_required, node.node.child_offset))
@@ -81,8 +89,9 @@ void pstate::trie_node::do_write_value(data_node_io& dn_io,
     trie_node_header_t* h = (trie_node_header_t*)ba_trie_node.data();
     *h = empty_trie_header;
     h->isValue = 1;
+    h->hasChild = (is_extent ? 1 : 0);
     dn_io.write_across_data_nodes(ba_trie_node, 0, bo);
-    data_node::advance_block_offset(bo, ba_trie_node.size());
+    data_node::advance_block_offset(bo, ba_trie_node.size(), dn_io.block_warehouse_.get_data_node_size());
     space_required -= ba_trie_node.size();
 
     // write buffer size second
@@ -90,12 +99,12 @@ void pstate::trie_node::do_write_value(data_node_io& dn_io,
     ByteArray ba_value_size(
         (uint8_t*)&value_size, (uint8_t*)&value_size + sizeof(size_t));
     dn_io.write_across_data_nodes(ba_value_size, 0, bo);
-    data_node::advance_block_offset(bo, ba_value_size.size());
+    data_node::advance_block_offset(bo, ba_value_size.size(), dn_io.block_warehouse_.get_data_node_size());
     space_required -= ba_value_size.size();
 
-    // write value
-    dn_io.write_across_data_nodes(value, 0, bo);
-    space_required -= value.size();
+    // write value, or the id of the extent that holds it
+    dn_io.write_across_data_nodes(record_value, 0, bo);
+    space_required -= record_value.size();
     pdo::error::ThrowIf<pdo::error::RuntimeError>(
         space_required != 0, "space estimated does not match space written");
 }
@@ -105,7 +114,7 @@ void pstate::trie_node::do_read_value_info(data_node_io& dn_io,
 {
     //read trie node header
     dn_io.read_across_data_nodes(bo_at, sizeof(trie_node_header_t), ba_header);
-    data_node::advance_block_offset(bo_at, sizeof(trie_node_header_t));
+    data_node::advance_block_offset(bo_at, sizeof(trie_node_header_t), dn_io.block_warehouse_.get_data_node_size());
     //check header
     trie_node_header_t* h = (trie_node_header_t*)ba_header.data();
     pdo::error::ThrowIf<pdo::error::RuntimeError>(
@@ -114,7 +123,7 @@ void pstate::trie_node::do_read_value_info(data_node_io& dn_io,
     //read value size
     ByteArray ba_value_size;
     dn_io.read_across_data_nodes(bo_at, sizeof(size_t), ba_value_size);
-    data_node::advance_block_offset(bo_at, sizeof(size_t));
+    data_node::advance_block_offset(bo_at, sizeof(size_t), dn_io.block_warehouse_.get_data_node_size());
     value_size = *((size_t*)ba_value_size.data());
 }
 
@@ -132,6 +141,15 @@ void pstate::trie_node::do_read_value(
     //read value info
     do_read_value_info(dn_io, bo, ba_header, value_size);
 
+    trie_node_header_t* h = (trie_node_header_t*)ba_header.data();
+    if (h->hasChild)
+    {
+        ByteArray extent_id;
+        dn_io.read_across_data_nodes(bo, STATE_BLOCK_ID_LENGTH, extent_id);
+        dn_io.read_extent(extent_id, value_size, value);
+        return;
+    }
+
     // read value
     unsigned int vs = value_size;
     try
@@ -155,15 +173,26 @@ void pstate::trie_node::do_delete_value(data_node_io& dn_io, trie_node& node)
     //read value info
     do_read_value_info(dn_io, bo, ba_header, value_size);
 
-    // mark trie node header (1 byte) as deleted
     trie_node_header_t* h = (trie_node_header_t*)(ba_header.data());
+
+    //release the extent, if any
+    size_t stored_size = value_size;
+    if (h->hasChild)
+    {
+        ByteArray extent_id;
+        dn_io.read_across_data_nodes(bo, STATE_BLOCK_ID_LENGTH, extent_id);
+        dn_io.delete_extent(extent_id);
+        stored_size = STATE_BLOCK_ID_LENGTH;
+    }
+
+    // mark trie node header (1 byte) as deleted
     h->isDeleted = 1;
 
     //overwrite stored header
     dn_io.write_across_data_nodes(ba_header, 0, bo);
 
     //recover space
-    unsigned int freed_bytes = ba_header.size() + sizeof(value_size) + value_size;
+    unsigned int freed_bytes = ba_header.size() + sizeof(value_size) + stored_size;
     dn_io.free_space_collector_.collect(node.node.child_offset, freed_bytes);
 
     //delete value from trie
@@ -236,6 +265,8 @@ void pstate::trie_node::read_trie_node(data_node_io& dn_io, block_offset_t& in_b
     out_trie_node.location.block_offset_ = in_block_offset;
     out_trie_node.modified = false;
     out_trie_node.initialized = true;
+
+    dn_io.counters_.trie_nodes++;
 }
 
 void pstate::trie_node::write_trie_node(data_node_io& dn_io, trie_node& in_trie_node)
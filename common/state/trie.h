@@ -30,6 +30,12 @@ namespace state
 // (SEE trie_node_header_t struct below)
 #define MAX_KEY_CHUNK_BYTE_SIZE 15
 
+    // The same header starts both trie nodes and the value records they
+    // point to. In a value record (isValue set) no child exists, so
+    // hasChild is reused: when set, the record holds the id of the extent
+    // block that contains the value rather than the value itself; the
+    // size that follows is always the size of the value. Value records
+    // written before extents existed always have hasChild clear.
     struct __attribute__((packed)) trie_node_header_t
     {
         uint8_t isDeleted : 1;
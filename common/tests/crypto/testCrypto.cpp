@@ -397,6 +397,112 @@ int pcrypto::testCrypto()
     SAFE_LOG(PDO_LOG_DEBUG, "testCrypto: ComputeMessageHash test passed!\n\n");
     // End Test ComputMessageHash
 
+    // Test incremental and scatter-gather hashing
+    try
+    {
+        std::string part1Str("Proof of ");
+        std::string part2Str("Elapsed Time");
+        ByteArray part1(part1Str.begin(), part1Str.end());
+        ByteArray part2(part2Str.begin(), part2Str.end());
+
+        pcrypto::Hasher hasher;
+        ByteArray streamed;
+        hasher.Update(part1).Update(part2Str).Final(streamed);
+        if (ByteArrayToBase64EncodedString(streamed).compare(msg_SHA256_B64) != 0)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "testCrypto: Hasher test failed, SHA256 digest mismatch.\n");
+            return -1;
+        }
+
+        // the hasher must be reusable after Final
+        hasher.Update(msg);
+        if (hasher.Final() != hash)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "testCrypto: Hasher test failed, context not reset.\n");
+            return -1;
+        }
+
+        pcrypto::ByteArrayRefArray parts = { &part1, &part2 };
+        if (ComputeMessageHash(parts) != hash)
+        {
+            SAFE_LOG(PDO_LOG_ERROR,
+                     "testCrypto: scatter-gather ComputeMessageHash test failed, SHA256 digest "
+                     "mismatch.\n");
+            return -1;
+        }
+
+        ByteArray hash384, gathered384;
+        pcrypto::SHA384Hash(msg, hash384);
+        pcrypto::SHA384Hash(parts, gathered384);
+        pcrypto::Hasher hasher384(EVP_sha384);
+        if (gathered384 != hash384 || hasher384.Update(msg).Final() != hash384)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "testCrypto: SHA384 incremental hash test failed.\n");
+            return -1;
+        }
+    }
+    catch (const Error::RuntimeError& e)
+    {
+        SAFE_LOG(PDO_LOG_ERROR, "testCrypto: incremental hash test failed.\n%s\n", e.what());
+        return -1;
+    }
+    SAFE_LOG(PDO_LOG_DEBUG, "testCrypto: incremental hash test passed!\n\n");
+
+    // Test multi-buffer hashing against the single buffer hash, with
+    // lengths around the padding boundaries and a few data node sized blocks
+    try
+    {
+        std::vector<ByteArray> messages;
+        for (size_t length = 0; length < 300; length += 7)
+            messages.push_back(ByteArray(length, (uint8_t)length));
+        messages.push_back(ByteArray(55, 0x55));
+        messages.push_back(ByteArray(56, 0x56));
+        messages.push_back(ByteArray(64, 0x64));
+        for (int i = 0; i < 9; i++)
+            messages.push_back(ByteArray(8192 + i, (uint8_t)i));
+
+        pcrypto::ByteArrayRefArray refs;
+        for (size_t i = 0; i < messages.size(); i++)
+            refs.push_back(&messages[i]);
+
+        // each implementation is run explicitly, the default selection
+        // would use the scalar path on processors with the SHA extensions
+        std::vector<ByteArray> default_hashes = pcrypto::ComputeMessageHashes(messages);
+        std::vector<ByteArray> scalar_hashes;
+        pcrypto::ComputeMessageHashesScalar(refs, scalar_hashes);
+        std::vector<ByteArray> vector_hashes;
+        bool vector_available = pcrypto::ComputeMessageHashesVector(refs, vector_hashes);
+        if (! vector_available)
+            SAFE_LOG(PDO_LOG_INFO, "testCrypto: vector hash engine not available, skipped.\n");
+
+        for (size_t i = 0; i < messages.size(); i++)
+        {
+            ByteArray expected = ComputeMessageHash(messages[i]);
+            if (default_hashes[i] != expected || scalar_hashes[i] != expected ||
+                (vector_available && vector_hashes[i] != expected))
+            {
+                SAFE_LOG(PDO_LOG_ERROR,
+                         "testCrypto: ComputeMessageHashes test failed, digest mismatch at %zu.\n", i);
+                return -1;
+            }
+        }
+
+        // a partial group of lanes
+        std::vector<ByteArray> single_hash;
+        if (pcrypto::ComputeMessageHashesVector(pcrypto::ByteArrayRefArray(1, &messages.back()), single_hash) &&
+            single_hash[0] != ComputeMessageHash(messages.back()))
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "testCrypto: ComputeMessageHashes single lane test failed.\n");
+            return -1;
+        }
+    }
+    catch (const Error::RuntimeError& e)
+    {
+        SAFE_LOG(PDO_LOG_ERROR, "testCrypto: multi-buffer hash test failed.\n%s\n", e.what());
+        return -1;
+    }
+    SAFE_LOG(PDO_LOG_DEBUG, "testCrypto: multi-buffer hash test passed!\n\n");
+
     // Test ComputeMessageHMAC
 
     {  // test expected hmac
@@ -559,6 +665,26 @@ int pcrypto::testCrypto()
         return -1;
     }
 
+    // Test SignDigest, the signature must verify against the original message
+    try
+    {
+        pcrypto::Hasher hasher(privateKey1.GetHashFunction());
+        ByteArray digest_sig = privateKey1.SignDigest(hasher.Update(msg).Final());
+        if (publicKey1.VerifySignature(msg, digest_sig) != 1)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "testCrypto: SignDigest test failed, invalid signature.\n");
+            return -1;
+        }
+    }
+    catch (const Error::RuntimeError& e)
+    {
+        SAFE_LOG(PDO_LOG_ERROR,
+                 "testCrypto: SignDigest test failed, signature not computed.\n%s\n",
+                 e.what());
+        return -1;
+    }
+    SAFE_LOG(PDO_LOG_DEBUG, "testCrypto: SignDigest test passed!\n\n");
+
     std::string msgStr2("Proof of Work");
     ByteArray sig2;
     ByteArray msg2;
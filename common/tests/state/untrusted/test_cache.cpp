@@ -46,6 +46,16 @@ state_status_t custom_evict(
     return sebio_evict_to_block_store(block, crypto_algo, idOnEviction);
 }
 
+// exposes the cache of a state to check how prefetched blocks are kept
+class CacheTestKV : public pstate::State_KV
+{
+public:
+    CacheTestKV(const pstate::StateBlockId& id, const ByteArray& key) : State_KV(id, key) {}
+
+    pstate::Cache& cache() { return dn_io_.cache_; }
+    unsigned int last_block_num() { return dn_io_.block_warehouse_.get_last_block_num(); }
+};
+
 void init_test_cache()
 {
     sebio_set({{}, SEBIO_NO_CRYPTO, &custom_fetch, &custom_evict});
@@ -65,6 +75,7 @@ void test_cache()
         std::string value("a");
         _kv_put(key, value);
         unsigned int old_fetch_calls = fetch_calls;
+        pdo_resource_counters_t old_counters = skv.ResourceCounters();
         //read/write of a (small) key/value pair must not result in additional block fetches
         _kv_get(key, value);
         if(old_fetch_calls != fetch_calls)
@@ -72,6 +83,17 @@ void test_cache()
             SAFE_LOG(PDO_LOG_ERROR, "kv get resulted in block fetch\n");
             throw;
         }
+        //the counters must agree: the get is served from the cache
+        const pdo_resource_counters_t& counters = skv.ResourceCounters();
+        if(counters.cache_misses != old_counters.cache_misses ||
+           counters.data_node_fetches != old_counters.data_node_fetches ||
+           counters.cache_hits == old_counters.cache_hits ||
+           counters.trie_nodes == old_counters.trie_nodes ||
+           counters.bytes_read == old_counters.bytes_read)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "kv get resource counters are inconsistent\n");
+            throw;
+        }
         _kv_put(key, value);
         if(old_fetch_calls != fetch_calls)
         {
@@ -109,6 +131,17 @@ void test_cache()
         }
         _kv_get(base_string, value);
         kv_->Finalize(id);
+
+        //the values do not fit in the cache, so blocks were evicted and fetched again
+        const pdo_resource_counters_t& counters = skv.ResourceCounters();
+        if(counters.blocks_evicted == 0 || counters.cache_misses == 0 ||
+           counters.bytes_written < value_size ||
+           counters.cache_blocks_peak == 0 ||
+           counters.cache_blocks_peak > CACHE_SIZE / FIXED_DATA_NODE_BYTE_SIZE)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "cache exaustion resource counters are inconsistent\n");
+            throw;
+        }
     }
     catch (...)
     {
@@ -116,5 +149,71 @@ void test_cache()
         throw;
     }
 
+//################## TEST CACHE PREFETCH ##############################################################################
+    try
+    {
+        SAFE_LOG(PDO_LOG_INFO, "start test cache prefetch\n");
+        {
+            pstate::State_KV skv(state_encryption_key_);
+            kv_ = &skv;
+            //the state holds more blocks than the cache has slots
+            std::string value(FIXED_DATA_NODE_BYTE_SIZE / 2, 'p');
+            for (unsigned int i = 0; i < 3 * (CACHE_SIZE / FIXED_DATA_NODE_BYTE_SIZE); i++)
+                _kv_put(std::string("prefetch") + std::to_string(i), value);
+            kv_->Finalize(id);
+        }
+
+        CacheTestKV skv(id, state_encryption_key_);
+        pstate::Cache& cache = skv.cache();
+
+        unsigned int cached_entries = cache.block_cache_.size();
+        unsigned int available_slots = cache.slots_.available_slots();
+        if (skv.last_block_num() < available_slots)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "prefetch test state is too small\n");
+            throw pdo::error::RuntimeError("prefetch test state is too small");
+        }
+
+        // a prefetch takes no more than its share of the free slots
+        cache.prefetch(0, skv.last_block_num());
+        unsigned int prefetched = cache.block_cache_.size() - cached_entries;
+        if (prefetched < 2 || prefetched > available_slots / CACHE_PREFETCH_FRACTION)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "prefetch used %u of %u free slots\n", prefetched, available_slots);
+            throw pdo::error::RuntimeError("prefetch did not respect its share of the free slots");
+        }
+
+        // prefetched blocks are the least recently used until they are read
+        unsigned int block_num = 0;
+        uint64_t newest_clock = 0;
+        for (auto it = cache.block_cache_.begin(); it != cache.block_cache_.end(); ++it)
+        {
+            if (it->second.prefetched)
+            {
+                block_num = it->first;
+                if (it->second.clock != 0)
+                    throw pdo::error::RuntimeError("prefetched block is not the least recently used");
+            }
+            else if (it->second.clock > newest_clock)
+                newest_clock = it->second.clock;
+        }
+
+        uint64_t old_hits = skv.ResourceCounters().cache_hits;
+        cache.retrieve(block_num, false);
+        cache.done(block_num, false);
+
+        const pstate::Cache::block_cache_entry_t& bce = cache.block_cache_[block_num];
+        if (bce.prefetched || bce.clock <= newest_clock || skv.ResourceCounters().cache_hits != old_hits + 1)
+        {
+            SAFE_LOG(PDO_LOG_ERROR, "prefetched block was not promoted when it was read\n");
+            throw pdo::error::RuntimeError("prefetched block was not promoted when it was read");
+        }
+    }
+    catch (...)
+    {
+        SAFE_LOG(PDO_LOG_ERROR, "error testing KVS cache prefetch\n");
+        throw;
+    }
+
     SAFE_LOG(PDO_LOG_INFO, "cache tests successful\n");
 }
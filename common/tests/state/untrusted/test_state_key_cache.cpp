@@ -0,0 +1,103 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+
+#include "error.h"
+#include "log.h"
+#include "types.h"
+
+#include "state_key_cache.h"
+#include "test_state_key_cache.h"
+
+namespace pstate = pdo::state;
+
+// stands in for unsealing in the enclave, the key is derived from the
+// contract and the sealed key and every derivation is counted
+static unsigned int derive_calls = 0;
+static ByteArray derive_key(const std::string& contract_id, const std::string& sealed_key)
+{
+    derive_calls++;
+    std::string material = contract_id + "/" + sealed_key;
+    return ByteArray(material.begin(), material.end());
+}
+
+// the lookup the enclave does for every request
+static ByteArray get_key(
+    pstate::StateKeyCache& cache, const std::string& contract_id, const std::string& sealed_key)
+{
+    ByteArray key;
+    if (cache.find(contract_id, sealed_key, key))
+        return key;
+
+    key = derive_key(contract_id, sealed_key);
+    cache.insert(contract_id, sealed_key, key);
+    return key;
+}
+
+static void check_key(
+    pstate::StateKeyCache& cache, const std::string& contract_id, const std::string& sealed_key,
+    unsigned int expected_derivations, const char* message)
+{
+    unsigned int old_derive_calls = derive_calls;
+    ByteArray key = get_key(cache, contract_id, sealed_key);
+    unsigned int derivations = derive_calls - old_derive_calls;
+
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        key != derive_key(contract_id, sealed_key), "state key cache returned the wrong key");
+
+    if (derivations != expected_derivations)
+    {
+        SAFE_LOG(PDO_LOG_ERROR, "%s\n", message);
+        throw pdo::error::RuntimeError(message);
+    }
+}
+
+void test_state_key_cache()
+{
+    SAFE_LOG(PDO_LOG_INFO, "start test state key cache\n");
+    pstate::StateKeyCache cache(3);
+
+    // a cached key is reused
+    check_key(cache, "contract1", "sealed1", 1, "first use of a key was not derived");
+    check_key(cache, "contract1", "sealed1", 0, "cached key was derived again");
+
+    // a different sealed key or contract is a different entry
+    check_key(cache, "contract1", "sealed2", 1, "different sealed key hit the cache");
+    check_key(cache, "contract2", "sealed1", 1, "different contract hit the cache");
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(cache.size() != 3, "unexpected state key cache size");
+
+    // invalidation drops every key of the contract and forces a re-derivation
+    cache.invalidate("contract1");
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(cache.size() != 1, "invalidation left keys in the cache");
+    check_key(cache, "contract1", "sealed1", 1, "invalidated key was not derived again");
+    check_key(cache, "contract1", "sealed1", 0, "re-derived key was not cached");
+    check_key(cache, "contract2", "sealed1", 0, "invalidation dropped the key of another contract");
+
+    // the least recently used entry is evicted when the cache is full;
+    // contract2 is now the oldest entry
+    check_key(cache, "contract1", "sealed1", 0, "cached key was derived again");
+    check_key(cache, "contract3", "sealed1", 1, "first use of a key was not derived");
+    check_key(cache, "contract4", "sealed1", 1, "first use of a key was not derived");
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(cache.size() != 3, "state key cache exceeded its capacity");
+    check_key(cache, "contract1", "sealed1", 0, "recently used key was evicted");
+    check_key(cache, "contract2", "sealed1", 1, "least recently used key was not evicted");
+
+    cache.clear();
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(cache.size() != 0, "clear left keys in the cache");
+    check_key(cache, "contract1", "sealed1", 1, "cleared key was not derived again");
+
+    SAFE_LOG(PDO_LOG_INFO, "test state key cache successful\n");
+}
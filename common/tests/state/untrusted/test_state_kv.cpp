@@ -13,10 +13,13 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <string>
 #include "test_state_kv.h"
 #include "_kv_gen.h"
 #include "test_cache.h"
+#include "test_state_key_cache.h"
+#include "interpreter_kv.h"
 
 namespace pstate = pdo::state;
 
@@ -436,8 +439,319 @@ void test_state_kv() {
         throw;
     }
 
+//################## TEST CHANGE SET ##################################################################################
+    try
+    {
+        SAFE_LOG(PDO_LOG_INFO, "start test change set\n");
+        pstate::StateBlockIdArray new_ids, superseded_ids;
+
+        pstate::State_KV skv(state_encryption_key_);
+        kv_ = &skv;
+        for (int i = 0; i < 256; i++)
+            _kv_put(std::to_string(i), std::string(1024, 'a' + (i % 26)));
+        skv.Finalize(id, new_ids, superseded_ids);
+
+        // every block of a new state is new
+        if (new_ids.empty() || !superseded_ids.empty() || new_ids.back() != id)
+            throw pdo::error::RuntimeError("unexpected change set for new state");
+
+        // a read-only update has an empty change set
+        ByteArray id_new;
+        pstate::State_KV skv_read(id, state_encryption_key_);
+        kv_ = &skv_read;
+        _kv_get("0", std::string(1024, 'a'));
+        skv_read.Finalize(id_new, new_ids, superseded_ids);
+        if (id_new != id || !new_ids.empty() || !superseded_ids.empty())
+            throw pdo::error::RuntimeError("unexpected change set for unmodified state");
+
+        // a small update replaces a few blocks and the root
+        pstate::State_KV skv_update(id, state_encryption_key_);
+        kv_ = &skv_update;
+        _kv_put("0", std::string(1024, 'z'));
+        skv_update.Finalize(id_new, new_ids, superseded_ids);
+        if (new_ids.empty() || superseded_ids.empty())
+            throw pdo::error::RuntimeError("empty change set for modified state");
+        if (new_ids.back() != id_new || superseded_ids.back() != id)
+            throw pdo::error::RuntimeError("root block missing from change set");
+        for (size_t i = 0; i < new_ids.size(); i++)
+            for (size_t j = 0; j < superseded_ids.size(); j++)
+                if (new_ids[i] == superseded_ids[j])
+                    throw pdo::error::RuntimeError("block both new and superseded");
+        kv_ = NULL;
+    }
+    catch (...)
+    {
+        SAFE_LOG(PDO_LOG_ERROR, "error testing change set\n");
+        throw;
+    }
+
+//################## TEST COMPRESSION #################################################################################
+    try
+    {
+        SAFE_LOG(PDO_LOG_INFO, "start test compression\n");
+        ByteArray plain_id;
+
+        // a state written without compression
+        {
+            pstate::State_KV skv(state_encryption_key_);
+            kv_ = &skv;
+            for (int i = 0; i < 256; i++)
+                _kv_put(std::to_string(i), std::string(100 + i, 'a' + (i % 26)));
+            kv_->Finalize(plain_id);
+        }
+
+        sebio_codec_stats_t stats;
+        sebio_set_codec(SEBIO_CODEC_RLE);
+        sebio_reset_codec_stats();
+
+        // a compressed state, old blocks must remain readable
+        {
+            pstate::State_KV skv(plain_id, state_encryption_key_);
+            kv_ = &skv;
+            _kv_get("0", std::string(100, 'a'));
+            for (int i = 256; i < 512; i++)
+                _kv_put(std::to_string(i), std::string(100 + i, 'a' + (i % 26)));
+            kv_->Finalize(id);
+        }
+
+        sebio_get_codec_stats(stats);
+        if (stats.blocks_compressed_ == 0 || stats.encoded_bytes_ >= stats.raw_bytes_)
+            throw pdo::error::RuntimeError("state blocks were not compressed");
+
+        SAFE_LOG(PDO_LOG_INFO, "compression: %lu of %lu blocks, %lu of %lu bytes, ratio %.2f\n",
+            (unsigned long)stats.blocks_compressed_, (unsigned long)stats.blocks_encoded_,
+            (unsigned long)stats.encoded_bytes_, (unsigned long)stats.raw_bytes_,
+            (double)stats.raw_bytes_ / (stats.encoded_bytes_ ? stats.encoded_bytes_ : 1));
+
+        // compressed blocks are readable with compression turned off
+        sebio_set_codec(SEBIO_CODEC_NONE);
+        {
+            pstate::State_KV skv(id, state_encryption_key_);
+            kv_ = &skv;
+            for (int i = 0; i < 512; i += 17)
+                _kv_get(std::to_string(i), std::string(100 + i, 'a' + (i % 26)));
+            kv_->Finalize(id);
+        }
+        kv_ = NULL;
+    }
+    catch (...)
+    {
+        sebio_set_codec(SEBIO_CODEC_NONE);
+        SAFE_LOG(PDO_LOG_ERROR, "error testing compression\n");
+        throw;
+    }
+
+//################## TEST LAYOUT AND EXTENTS ##########################################################################
+    try
+    {
+        SAFE_LOG(PDO_LOG_INFO, "start test layout and extents\n");
+        pstate::state_layout_t layout = {1 << 14, 1 << 12};
+        pstate::StateBlockIdArray new_ids, superseded_ids;
+        std::string big_value(1 << 18, 'x');
+        big_value[0] = 'a';
+
+        // read the layout and the extent ids back from a root block
+        auto root_extents = [&](const ByteArray& root_id, pstate::state_layout_t& out_layout) -> pstate::StateBlockIdArray {
+            pstate::StateNode root;
+            sebio_fetch(root_id, SEBIO_NO_CRYPTO, root.GetBlock());
+            root.UnBlockifyChildren(state_encryption_key_);
+            out_layout = root.GetLayout();
+            pstate::StateBlockIdArray children = root.GetChildrenBlocks();
+            return pstate::StateBlockIdArray(children.end() - root.GetExtentCount(), children.end());
+        };
+
+        // an invalid data node size is rejected
+        bool failed = false;
+        try
+        {
+            pstate::state_layout_t bad_layout = {3000, 0};
+            pstate::State_KV skv(state_encryption_key_, bad_layout);
+        }
+        catch (const pdo::error::ValueError& e)
+        {
+            failed = true;
+        }
+        if (!failed)
+            throw pdo::error::RuntimeError("invalid layout accepted");
+
+        // values above the threshold go to extents, smaller ones to data nodes
+        {
+            pstate::State_KV skv(state_encryption_key_, layout);
+            kv_ = &skv;
+            for (int i = 0; i < 64; i++)
+                _kv_put(std::to_string(i), std::string(100 + i, 'a' + (i % 26)));
+            _kv_put("big", big_value);
+            _kv_put("big2", big_value);
+            skv.Finalize(id, new_ids, superseded_ids);
+        }
+
+        pstate::state_layout_t stored_layout;
+        pstate::StateBlockIdArray extents = root_extents(id, stored_layout);
+        if (stored_layout.data_node_size_ != layout.data_node_size_ ||
+            stored_layout.extent_threshold_ != layout.extent_threshold_)
+            throw pdo::error::RuntimeError("layout not recorded in the root block");
+        if (extents.size() != 2)
+            throw pdo::error::RuntimeError("unexpected number of extents");
+        for (size_t i = 0; i < extents.size(); i++)
+            if (std::find(new_ids.begin(), new_ids.end(), extents[i]) == new_ids.end())
+                throw pdo::error::RuntimeError("extent missing from change set");
+
+        // the layout is read back from the root block, a large value is one fetch
+        {
+            pstate::State_KV skv(id, state_encryption_key_);
+            kv_ = &skv;
+            _kv_get("big", big_value);
+            SAFE_LOG(PDO_LOG_INFO, "extents: %lu fetches to read a %zu byte value\n",
+                (unsigned long)skv.ResourceCounters().data_node_fetches, big_value.size());
+            _kv_get("63", std::string(163, 'a' + (63 % 26)));
+
+            _kv_delete("big");
+            _kv_put("small", std::string(10, 's'));
+            skv.Finalize(id, new_ids, superseded_ids);
+        }
+
+        pstate::StateBlockIdArray remaining = root_extents(id, stored_layout);
+        if (remaining.size() != 1 || superseded_ids.size() < 2)
+            throw pdo::error::RuntimeError("deleted extent still in the state");
+        for (size_t i = 0; i < extents.size(); i++)
+            if (extents[i] != remaining[0] &&
+                std::find(superseded_ids.begin(), superseded_ids.end(), extents[i]) == superseded_ids.end())
+                throw pdo::error::RuntimeError("deleted extent missing from change set");
+
+        {
+            pstate::State_KV skv(id, state_encryption_key_);
+            kv_ = &skv;
+            _kv_get("big2", big_value);
+            _kv_get("small", std::string(10, 's'));
+            _kv_get("big", "");
+            kv_->Finalize(id);
+        }
+        kv_ = NULL;
+    }
+    catch (...)
+    {
+        SAFE_LOG(PDO_LOG_ERROR, "error testing layout and extents\n");
+        throw;
+    }
+
+//################## TEST READ-ONLY OPEN ##############################################################################
+    try
+    {
+        SAFE_LOG(PDO_LOG_INFO, "start test read-only open\n");
+        pstate::StateBlockIdArray new_ids, superseded_ids;
+        {
+            pstate::State_KV skv(state_encryption_key_);
+            kv_ = &skv;
+            for (int i = 0; i < 256; i++)
+                _kv_put(std::to_string(i), std::string(1024, 'a' + (i % 26)));
+            kv_->Finalize(id);
+        }
+
+        // a read-only open fetches only the data nodes on the lookup path
+        ByteArray id_new;
+        uint64_t read_only_fetches;
+        {
+            pstate::State_KV skv(id, state_encryption_key_, true);
+            kv_ = &skv;
+            _kv_get("7", std::string(1024, 'a' + 7));
+
+            bool failed = false;
+            try
+            {
+                _kv_put("7", "not allowed");
+            }
+            catch (const pdo::error::RuntimeError& e)
+            {
+                failed = true;
+            }
+            if (!failed)
+                throw pdo::error::RuntimeError("update of read-only state succeeded");
+
+            skv.Finalize(id_new, new_ids, superseded_ids);
+            if (id_new != id || !new_ids.empty() || !superseded_ids.empty())
+                throw pdo::error::RuntimeError("read-only finalize changed the state");
+            read_only_fetches = skv.ResourceCounters().data_node_fetches;
+        }
+
+        // a writable open that is only read has the same cost
+        {
+            pstate::State_KV skv(id, state_encryption_key_);
+            kv_ = &skv;
+            _kv_get("7", std::string(1024, 'a' + 7));
+            skv.Finalize(id_new);
+            if (id_new != id || skv.ResourceCounters().data_node_fetches != read_only_fetches)
+                throw pdo::error::RuntimeError("unexpected cost for unmodified state");
+        }
+
+        // the first update sets up the free space collection and append node
+        {
+            pstate::State_KV skv(id, state_encryption_key_);
+            kv_ = &skv;
+            _kv_get("7", std::string(1024, 'a' + 7));
+            _kv_delete("8");
+            _kv_put("7", std::string(2048, 'q'));
+            _kv_put("new", std::string(10, 'n'));
+            skv.Finalize(id_new);
+        }
+        {
+            pstate::State_KV skv(id_new, state_encryption_key_, true);
+            kv_ = &skv;
+            _kv_get("7", std::string(2048, 'q'));
+            _kv_get("new", std::string(10, 'n'));
+            _kv_get("9", std::string(1024, 'a' + 9));
+            skv.Finalize(id_new);
+        }
+        SAFE_LOG(PDO_LOG_INFO, "read-only open: %lu fetches for one lookup\n", (unsigned long)read_only_fetches);
+        kv_ = NULL;
+    }
+    catch (...)
+    {
+        SAFE_LOG(PDO_LOG_ERROR, "error testing read-only open\n");
+        throw;
+    }
+
+//################## TEST ACCESS SETS #################################################################################
+    try
+    {
+        SAFE_LOG(PDO_LOG_INFO, "start test access sets\n");
+        auto ba = [](const std::string& s) { return ByteArray(s.begin(), s.end()); };
+        pstate::Interpreter_KV ikv(state_encryption_key_);
+        ikv.PrivilegedPut(ba("owner"), ba("alice"));
+
+        ikv.TrackAccess(true);
+        ikv.PrivilegedGet(ba("owner"));
+        ikv.UnprivilegedGet(ba("missing"));
+        ikv.UnprivilegedPut(ba("a"), ba("1"));
+        ikv.UnprivilegedPut(ba("a"), ba("2"));
+        ikv.UnprivilegedDelete(ba("b"));
+
+        std::vector<ByteArray> read_set, write_set;
+        ikv.GetAccessSets(read_set, write_set);
+        if (read_set.size() != 2 || write_set.size() != 2)
+            throw pdo::error::RuntimeError("unexpected access set size");
+        if (!std::is_sorted(read_set.begin(), read_set.end()) ||
+            !std::is_sorted(write_set.begin(), write_set.end()))
+            throw pdo::error::RuntimeError("access sets are not sorted");
+
+        ikv.TrackAccess(false);
+        ikv.PrivilegedGet(ba("owner"));
+        ikv.GetAccessSets(read_set, write_set);
+        if (!read_set.empty() || !write_set.empty())
+            throw pdo::error::RuntimeError("access recorded while tracking is off");
+
+        ByteArray ikv_id;
+        ikv.Finalize(ikv_id);
+    }
+    catch (...)
+    {
+        SAFE_LOG(PDO_LOG_ERROR, "error testing access sets\n");
+        throw;
+    }
+
 //################## TEST CACHE #######################################################################################
     test_cache();
 
+    test_state_key_cache();
+
     SAFE_LOG(PDO_LOG_INFO, "Test success.\n");
 }
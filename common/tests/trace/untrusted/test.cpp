@@ -0,0 +1,169 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include <string>
+
+#include "jsonvalue.h"
+#include "log.h"
+#include "packages/parson/parson.h"
+#include "trace.h"
+
+#define TRACE_RECORDS 300
+
+// the clock advances by ten microseconds on every reading
+static uint64_t g_TestTime = 1000;
+static uint64_t TestClock(void)
+{
+    g_TestTime += 10;
+    return g_TestTime;
+}
+
+#define CHECK(condition, message)                                       \
+    do {                                                                \
+        if (! (condition))                                              \
+        {                                                               \
+            SAFE_LOG(PDO_LOG_ERROR, "Test Trace: %s\n", message);       \
+            return -1;                                                  \
+        }                                                               \
+    } while (0)
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// record spans, export them and check the exported events
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static int test_round_trip(void)
+{
+    pdo::trace::ClearCollected();
+    pdo::trace::Enable(true);
+    g_TestTime = 1000;
+
+    {
+        PDO_TRACE_SPAN(PDO_TRACE_ENCLAVE_REQUEST);
+        pdo::trace::Span decrypt_span(PDO_TRACE_REQUEST_DECRYPT);
+        decrypt_span.End();
+    }
+    pdo::trace::Flush();
+
+    std::string trace;
+    pdo::trace::ExportChromeTrace(trace, true);
+
+    JsonValue parsed(json_parse_string(trace.c_str()));
+    CHECK(parsed.value != NULL, "exported trace is not valid json");
+
+    JSON_Array* events = json_object_get_array(json_value_get_object(parsed), "traceEvents");
+    CHECK(events != NULL, "exported trace has no events");
+
+    // two process name events then the spans in the order they ended
+    CHECK(json_array_get_count(events) == 4, "wrong number of events");
+
+    JSON_Object* decrypt = json_array_get_object(events, 2);
+    CHECK(strcmp(json_object_get_string(decrypt, "name"), "request_decrypt") == 0, "wrong span name");
+    CHECK(strcmp(json_object_get_string(decrypt, "ph"), "X") == 0, "wrong event phase");
+    CHECK(json_object_get_number(decrypt, "pid") == PDO_TRACE_SOURCE_HOST, "wrong event source");
+    CHECK(json_object_get_number(decrypt, "ts") == 1020, "wrong span start");
+    CHECK(json_object_get_number(decrypt, "dur") == 10, "wrong span duration");
+
+    JSON_Object* request = json_array_get_object(events, 3);
+    CHECK(strcmp(json_object_get_string(request, "name"), "enclave_request") == 0, "wrong span name");
+    CHECK(json_object_get_number(request, "ts") == 1010, "wrong span start");
+    CHECK(json_object_get_number(request, "dur") == 30, "wrong span duration");
+    CHECK(json_object_get_number(request, "tid") == json_object_get_number(decrypt, "tid"),
+          "spans of one thread have different thread ids");
+
+    // the export cleared the collector
+    pdo::trace::ExportChromeTrace(trace, true);
+    JsonValue empty(json_parse_string(trace.c_str()));
+    events = json_object_get_array(json_value_get_object(empty), "traceEvents");
+    CHECK(events != NULL && json_array_get_count(events) == 2, "export did not clear the collector");
+
+    return 0;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// more records than fit in the thread buffer are all collected
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static int test_buffer_flush(void)
+{
+    pdo::trace::ClearCollected();
+    pdo::trace::Enable(true);
+
+    for (int i = 0; i < TRACE_RECORDS; i++)
+        pdo::trace::Record(PDO_TRACE_STATE_OPEN, i, i + 1);
+    pdo::trace::Flush();
+
+    std::string trace;
+    pdo::trace::ExportChromeTrace(trace, true);
+
+    JsonValue parsed(json_parse_string(trace.c_str()));
+    JSON_Array* events = json_object_get_array(json_value_get_object(parsed), "traceEvents");
+    CHECK(events != NULL, "exported trace has no events");
+    CHECK(json_array_get_count(events) == TRACE_RECORDS + 2, "records were lost when the buffer filled");
+
+    for (int i = 0; i < TRACE_RECORDS; i++)
+    {
+        JSON_Object* event = json_array_get_object(events, i + 2);
+        CHECK(json_object_get_number(event, "ts") == i, "records are out of order");
+    }
+
+    return 0;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// nothing is recorded or collected while tracing is disabled
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static int test_disabled(void)
+{
+    pdo::trace::ClearCollected();
+    pdo::trace::Enable(false);
+
+    uint64_t time = g_TestTime;
+    {
+        PDO_TRACE_SPAN(PDO_TRACE_INTERPRETER_RUN);
+    }
+    pdo::trace::Flush();
+    CHECK(time == g_TestTime, "disabled span read the clock");
+
+    pdo::trace::Enable(true);
+    std::string trace;
+    pdo::trace::ExportChromeTrace(trace, true);
+
+    JsonValue parsed(json_parse_string(trace.c_str()));
+    JSON_Array* events = json_object_get_array(json_value_get_object(parsed), "traceEvents");
+    CHECK(events != NULL && json_array_get_count(events) == 2, "disabled span was collected");
+
+    return 0;
+}
+
+/* Application entry */
+int main(int argc, char* argv[])
+{
+    pdo::trace::SetClockFunction(TestClock);
+
+    int ret = 0;
+    if (ret == 0)
+        ret = test_round_trip();
+    if (ret == 0)
+        ret = test_buffer_flush();
+    if (ret == 0)
+        ret = test_disabled();
+
+    pdo::trace::Enable(false);
+
+    if (ret == 0)
+        SAFE_LOG(PDO_LOG_DEBUG, "Test Trace: SUCCESSFUL!\n");
+
+    return ret;
+}
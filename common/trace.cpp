@@ -0,0 +1,323 @@
+/* Copyright 2022 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <new>
+#include <string>
+#include <vector>
+
+#include "trace.h"
+
+#define TRACE_BUFFER_RECORDS 256
+
+#define PDO_TRACE_SPAN_NAME(id, name) name,
+static const char* g_SpanNames[] = { PDO_TRACE_SPAN_LIST(PDO_TRACE_SPAN_NAME) "unknown" };
+#undef PDO_TRACE_SPAN_NAME
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Per-thread ring of records, only the owning thread touches it
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+typedef struct
+{
+    uint32_t thread;
+    size_t first;
+    size_t count;
+    pdo_trace_record_t records[TRACE_BUFFER_RECORDS];
+} trace_buffer_t;
+
+static uint32_t g_NextThread = 0;
+static volatile bool g_Enabled = false;
+
+#if _UNTRUSTED_
+
+#include <pthread.h>
+#include <chrono>
+
+#define MUTEX_LOCK pthread_mutex_lock
+#define MUTEX_UNLOCK pthread_mutex_unlock
+
+#define TRACE_SOURCE PDO_TRACE_SOURCE_HOST
+#define TRACE_COLLECTOR_MAX_RECORDS (1 << 20)
+
+static uint64_t SteadyClock(void)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+} // SteadyClock
+
+static pdo::trace::pdo_trace_clock_t g_ClockFunction = SteadyClock;
+static pdo::trace::pdo_trace_flush_t g_FlushFunction = pdo::trace::Collect;
+
+// the collector is only used in untrusted space, flushes from all
+// threads and from the enclave end up here
+static pthread_mutex_t collector_mutex = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<pdo_trace_record_t> g_Collected;
+
+// buffers of threads that exit are flushed and released
+static pthread_key_t buffer_key;
+static pthread_once_t buffer_key_once = PTHREAD_ONCE_INIT;
+
+static void ReleaseBuffer(void* buffer);
+
+static void CreateBufferKey(void)
+{
+    pthread_key_create(&buffer_key, ReleaseBuffer);
+}
+
+#else // _UNTRUSTED_
+
+#define TRACE_SOURCE PDO_TRACE_SOURCE_ENCLAVE
+
+// the enclave has no clock of its own, every span takes two ocalls for
+// its timestamps; spans are recorded only when the trusted library is
+// built with ENCLAVE_TRACE
+#if PDO_ENCLAVE_TRACE
+#define TRACE_ENCLAVE_SPANS 1
+#else
+#define TRACE_ENCLAVE_SPANS 0
+#endif
+
+static uint64_t NullClock(void)
+{
+    return 0;
+}
+
+// the enclave provides a clock and a flush function, usually ocalls
+static pdo::trace::pdo_trace_clock_t g_ClockFunction = NullClock;
+static pdo::trace::pdo_trace_flush_t g_FlushFunction = NULL;
+
+#endif // _UNTRUSTED_
+
+static __thread trace_buffer_t* t_buffer = NULL;
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static trace_buffer_t* GetBuffer(void)
+{
+    if (t_buffer == NULL)
+    {
+        t_buffer = new (std::nothrow) trace_buffer_t;
+        if (t_buffer == NULL)
+            return NULL;
+
+        t_buffer->thread = __sync_fetch_and_add(&g_NextThread, 1);
+        t_buffer->first = 0;
+        t_buffer->count = 0;
+
+#if _UNTRUSTED_
+        pthread_once(&buffer_key_once, CreateBufferKey);
+        pthread_setspecific(buffer_key, t_buffer);
+#endif
+    }
+
+    return t_buffer;
+} // GetBuffer
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static void FlushBuffer(trace_buffer_t* buffer)
+{
+    if (buffer->count == 0)
+        return;
+
+    if (g_FlushFunction)
+    {
+        // the ring may wrap, send the two segments oldest first
+        size_t head = TRACE_BUFFER_RECORDS - buffer->first;
+        if (buffer->count <= head)
+        {
+            g_FlushFunction(&buffer->records[buffer->first], buffer->count);
+        }
+        else
+        {
+            g_FlushFunction(&buffer->records[buffer->first], head);
+            g_FlushFunction(&buffer->records[0], buffer->count - head);
+        }
+    }
+
+    buffer->first = 0;
+    buffer->count = 0;
+} // FlushBuffer
+
+#if _UNTRUSTED_
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static void ReleaseBuffer(void* buffer)
+{
+    trace_buffer_t* tb = (trace_buffer_t*)buffer;
+    FlushBuffer(tb);
+    delete tb;
+    t_buffer = NULL;
+} // ReleaseBuffer
+#endif
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// XX External interface                                     XX
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pdo::trace::SetClockFunction(
+    pdo_trace_clock_t clockFunction
+    )
+{
+    if (clockFunction)
+    {
+        g_ClockFunction = clockFunction;
+    }
+} // SetClockFunction
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pdo::trace::SetFlushFunction(
+    pdo_trace_flush_t flushFunction
+    )
+{
+    g_FlushFunction = flushFunction;
+} // SetFlushFunction
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pdo::trace::Enable(bool enabled)
+{
+#if ! _UNTRUSTED_ && ! TRACE_ENCLAVE_SPANS
+    enabled = false;
+#endif
+    g_Enabled = enabled;
+} // Enable
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+bool pdo::trace::Enabled(void)
+{
+    return g_Enabled;
+} // Enabled
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+const char* pdo::trace::SpanName(pdo_trace_span_t span)
+{
+    if (span < 0 || span >= PDO_TRACE_SPAN_COUNT)
+        return g_SpanNames[PDO_TRACE_SPAN_COUNT];
+    return g_SpanNames[span];
+} // SpanName
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+uint64_t pdo::trace::Now(void)
+{
+    return g_ClockFunction();
+} // Now
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pdo::trace::Record(pdo_trace_span_t span, uint64_t start, uint64_t end)
+{
+    trace_buffer_t* buffer = GetBuffer();
+    if (buffer == NULL)
+        return;
+
+    // without a flush function the oldest record is overwritten
+    if (buffer->count == TRACE_BUFFER_RECORDS)
+    {
+        if (g_FlushFunction)
+        {
+            FlushBuffer(buffer);
+        }
+        else
+        {
+            buffer->first = (buffer->first + 1) % TRACE_BUFFER_RECORDS;
+            buffer->count--;
+        }
+    }
+
+    pdo_trace_record_t& record =
+        buffer->records[(buffer->first + buffer->count) % TRACE_BUFFER_RECORDS];
+    record.span = (uint16_t)span;
+    record.source = TRACE_SOURCE;
+    record.thread = buffer->thread;
+    record.start = start;
+    record.duration = (end > start ? end - start : 0);
+    buffer->count++;
+} // Record
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pdo::trace::Flush(void)
+{
+#if ! _UNTRUSTED_ && ! TRACE_ENCLAVE_SPANS
+    // nothing is ever recorded, skip the ocall
+    return;
+#endif
+
+    if (t_buffer != NULL && t_buffer->count > 0)
+    {
+        FlushBuffer(t_buffer);
+        return;
+    }
+
+    // the flush function is invoked even without records, the enclave
+    // uses the call to learn whether tracing is enabled on the host
+    if (g_FlushFunction)
+        g_FlushFunction(NULL, 0);
+} // Flush
+
+#if _UNTRUSTED_
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pdo::trace::Collect(const pdo_trace_record_t* records, size_t count)
+{
+    if (! g_Enabled || records == NULL)
+        return;
+
+    MUTEX_LOCK(&collector_mutex);
+    if (g_Collected.size() + count <= TRACE_COLLECTOR_MAX_RECORDS)
+        g_Collected.insert(g_Collected.end(), records, records + count);
+    MUTEX_UNLOCK(&collector_mutex);
+} // Collect
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pdo::trace::ClearCollected(void)
+{
+    MUTEX_LOCK(&collector_mutex);
+    g_Collected.clear();
+    MUTEX_UNLOCK(&collector_mutex);
+} // ClearCollected
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void pdo::trace::ExportChromeTrace(std::string& outTrace, bool clear)
+{
+    std::vector<pdo_trace_record_t> records;
+
+    MUTEX_LOCK(&collector_mutex);
+    if (clear)
+        records.swap(g_Collected);
+    else
+        records = g_Collected;
+    MUTEX_UNLOCK(&collector_mutex);
+
+    // the host and the enclave appear as two processes
+    outTrace = "{\"traceEvents\":[";
+    outTrace += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"host\"}},";
+    outTrace += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"enclave\"}}";
+
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const pdo_trace_record_t& r = records[i];
+        outTrace += ",{\"name\":\"";
+        outTrace += SpanName((pdo_trace_span_t)r.span);
+        outTrace += "\",\"cat\":\"pdo\",\"ph\":\"X\",\"pid\":";
+        outTrace += std::to_string(r.source);
+        outTrace += ",\"tid\":";
+        outTrace += std::to_string(r.thread);
+        outTrace += ",\"ts\":";
+        outTrace += std::to_string(r.start);
+        outTrace += ",\"dur\":";
+        outTrace += std::to_string(r.duration);
+        outTrace += "}";
+    }
+
+    outTrace += "],\"displayTimeUnit\":\"ms\"}";
+} // ExportChromeTrace
+
+#endif // _UNTRUSTED_
@@ -0,0 +1,129 @@
+/* Copyright 2022 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+// Tracing records the start time and duration of a fixed set of spans.
+// Records are appended to a buffer owned by the recording thread, so
+// recording takes no lock; the buffer is handed to the flush function
+// when it fills up or when Flush is called. In the enclave the flush
+// function is a single ocall that carries all the buffered records.
+// Enclave spans take their timestamps through ocalls, they are compiled
+// out unless the trusted library is built with ENCLAVE_TRACE.
+
+// The list of spans, the name is used by the exporters
+#define PDO_TRACE_SPAN_LIST(SPAN)                                 \
+    SPAN(PDO_TRACE_REQUEST_DECRYPT, "request_decrypt")            \
+    SPAN(PDO_TRACE_STATE_OPEN, "state_open")                      \
+    SPAN(PDO_TRACE_INTERPRETER_RUN, "interpreter_run")            \
+    SPAN(PDO_TRACE_STATE_FINALIZE, "state_finalize")              \
+    SPAN(PDO_TRACE_RESPONSE_SIGN, "response_sign")                \
+    SPAN(PDO_TRACE_ENCLAVE_REQUEST, "enclave_request")
+
+#define PDO_TRACE_SPAN_ENUM(id, name) id,
+typedef enum
+{
+    PDO_TRACE_SPAN_LIST(PDO_TRACE_SPAN_ENUM)
+    PDO_TRACE_SPAN_COUNT
+} pdo_trace_span_t;
+#undef PDO_TRACE_SPAN_ENUM
+
+typedef enum
+{
+    PDO_TRACE_SOURCE_HOST = 0,
+    PDO_TRACE_SOURCE_ENCLAVE = 1
+} pdo_trace_source_t;
+
+// records cross the enclave boundary as a flat buffer
+typedef struct
+{
+    uint16_t span;
+    uint16_t source;
+    uint32_t thread;
+    uint64_t start;             // microseconds
+    uint64_t duration;          // microseconds
+} pdo_trace_record_t;
+
+namespace pdo
+{
+    namespace trace
+    {
+        typedef uint64_t (*pdo_trace_clock_t)(void);
+        typedef void (*pdo_trace_flush_t)(const pdo_trace_record_t* records, size_t count);
+
+        void SetClockFunction(pdo_trace_clock_t clockFunction);
+        void SetFlushFunction(pdo_trace_flush_t flushFunction);
+
+        void Enable(bool enabled);
+        bool Enabled(void);
+
+        const char* SpanName(pdo_trace_span_t span);
+        uint64_t Now(void);
+
+        void Record(pdo_trace_span_t span, uint64_t start, uint64_t end);
+
+        // send the records buffered by the calling thread to the flush
+        // function, which is called even when there are no records
+        void Flush(void);
+
+        // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+        // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+        class Span
+        {
+        private:
+            pdo_trace_span_t span_;
+            uint64_t start_time_;
+            bool active_;
+
+        public:
+            Span(pdo_trace_span_t span) : span_(span), start_time_(0), active_(Enabled())
+            {
+                if (active_)
+                    start_time_ = Now();
+            };
+
+            ~Span(void)
+            {
+                End();
+            };
+
+            // close the span before the end of the scope
+            void End(void)
+            {
+                if (active_)
+                    Record(span_, start_time_, Now());
+                active_ = false;
+            };
+        };
+
+#if _UNTRUSTED_
+        // the collector holds the records flushed by all threads, including
+        // the records flushed from the enclave, until they are exported
+        void Collect(const pdo_trace_record_t* records, size_t count);
+        void ClearCollected(void);
+
+        // export the collected records in the chrome trace event format
+        void ExportChromeTrace(std::string& outTrace, bool clear = true);
+#endif
+    }
+}
+
+#define __PDO_TRACE_CONCAT__(a, b) a##b
+#define __PDO_TRACE_NAME__(a, b) __PDO_TRACE_CONCAT__(a, b)
+#define PDO_TRACE_SPAN(ID) pdo::trace::Span __PDO_TRACE_NAME__(__pdo_trace_span_, __LINE__)(ID)
@@ -0,0 +1,320 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <malloc.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "Dispatch.h"
+
+#include "Environment.h"
+#include "Message.h"
+#include "Response.h"
+#include "Types.h"
+#include "Util.h"
+#include "Value.h"
+#include "WasmExtensions.h"
+
+// Each method runs the same workload either with the native functions
+// from Util.h or with the equivalent code compiled into the contract,
+// selected by the "native" parameter. Both return the same result.
+
+#define RECORD_SIZE 16
+#define RECORD_KEY_OFFSET 4
+#define RECORD_KEY_SIZE 8
+
+static void fill_buffer(ww::types::ByteArray& buffer, const size_t size)
+{
+    buffer.resize(size);
+    for (size_t i = 0; i < size; i++)
+        buffer[i] = (uint8_t)((i * 31 + 7) & 0xFF);
+}
+
+// -----------------------------------------------------------------
+// In-contract implementations
+// -----------------------------------------------------------------
+static void wasm_hex_encode(const ww::types::ByteArray& source, std::string& encoded)
+{
+    static const char* digits = "0123456789ABCDEF";
+
+    encoded.resize(2 * source.size());
+    for (size_t i = 0; i < source.size(); i++)
+    {
+        encoded[2 * i] = digits[source[i] >> 4];
+        encoded[2 * i + 1] = digits[source[i] & 0x0F];
+    }
+}
+
+static int wasm_hex_value(const char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return 10 + (c - 'A');
+    if (c >= 'a' && c <= 'f')
+        return 10 + (c - 'a');
+    return -1;
+}
+
+static bool wasm_hex_decode(const std::string& encoded, ww::types::ByteArray& decoded)
+{
+    if (encoded.size() % 2 != 0)
+        return false;
+
+    decoded.resize(encoded.size() / 2);
+    for (size_t i = 0; i < decoded.size(); i++)
+    {
+        int high = wasm_hex_value(encoded[2 * i]);
+        int low = wasm_hex_value(encoded[2 * i + 1]);
+        if (high < 0 || low < 0)
+            return false;
+        decoded[i] = (uint8_t)((high << 4) | low);
+    }
+
+    return true;
+}
+
+static bool wasm_find(const ww::types::ByteArray& buffer, const ww::types::ByteArray& pattern, size_t& offset)
+{
+    if (pattern.size() > buffer.size())
+        return false;
+
+    for (size_t i = 0; i <= buffer.size() - pattern.size(); i++)
+    {
+        if (memcmp(buffer.data() + i, pattern.data(), pattern.size()) == 0)
+        {
+            offset = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void wasm_sort_records(ww::types::ByteArray& records)
+{
+    const size_t count = records.size() / RECORD_SIZE;
+
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; i++)
+        order[i] = i;
+
+    const uint8_t* keys = records.data() + RECORD_KEY_OFFSET;
+    std::stable_sort(order.begin(), order.end(),
+                     [keys](const uint32_t a, const uint32_t b) -> bool {
+                         return memcmp(keys + a * RECORD_SIZE, keys + b * RECORD_SIZE, RECORD_KEY_SIZE) < 0;
+                     });
+
+    ww::types::ByteArray sorted(records.size());
+    for (size_t i = 0; i < count; i++)
+        memcpy(sorted.data() + i * RECORD_SIZE, records.data() + order[i] * RECORD_SIZE, RECORD_SIZE);
+
+    records.swap(sorted);
+}
+
+// -----------------------------------------------------------------
+// NAME: initialize_contract
+// -----------------------------------------------------------------
+bool initialize_contract(const Environment& env, Response& rsp)
+{
+    return rsp.success(false);
+}
+
+// -----------------------------------------------------------------
+// NAME: hex_test
+//
+// encode and decode a buffer of the given size as hex, returns the
+// number of bytes that survived the round trip
+// -----------------------------------------------------------------
+bool hex_test(const Message& msg, const Environment& env, Response& rsp)
+{
+    const size_t size = (size_t)msg.get_number("size");
+    const bool native = msg.get_boolean("native");
+
+    ww::types::ByteArray source;
+    fill_buffer(source, size);
+
+    std::string encoded;
+    ww::types::ByteArray decoded;
+    if (native)
+    {
+        ASSERT_SUCCESS(rsp, ww::util::hex_encode(source, encoded), "failed to encode");
+        ASSERT_SUCCESS(rsp, ww::util::hex_decode(encoded, decoded), "failed to decode");
+    }
+    else
+    {
+        wasm_hex_encode(source, encoded);
+        ASSERT_SUCCESS(rsp, wasm_hex_decode(encoded, decoded), "failed to decode");
+    }
+
+    ASSERT_SUCCESS(rsp, decoded == source, "round trip failed");
+
+    ww::value::Number v((double)decoded.size());
+    return rsp.value(v, false);
+}
+
+// -----------------------------------------------------------------
+// NAME: search_test
+//
+// find a pattern at the end of a buffer that nearly matches it
+// everywhere, returns the offset of the pattern
+// -----------------------------------------------------------------
+bool search_test(const Message& msg, const Environment& env, Response& rsp)
+{
+    const size_t size = (size_t)msg.get_number("size");
+    const bool native = msg.get_boolean("native");
+
+    const std::string pattern_string("aaaaaaaaaaaaaaab");
+    ww::types::ByteArray pattern(pattern_string.begin(), pattern_string.end());
+
+    ASSERT_SUCCESS(rsp, size >= pattern.size(), "size is too small");
+
+    ww::types::ByteArray buffer(size, (uint8_t)'a');
+    std::copy(pattern.begin(), pattern.end(), buffer.end() - pattern.size());
+
+    size_t offset = 0;
+    if (native)
+        ASSERT_SUCCESS(rsp, ww::util::find(buffer, pattern, offset), "pattern not found");
+    else
+        ASSERT_SUCCESS(rsp, wasm_find(buffer, pattern, offset), "pattern not found");
+
+    ww::value::Number v((double)offset);
+    return rsp.value(v, false);
+}
+
+// -----------------------------------------------------------------
+// NAME: compare_test
+//
+// compare two buffers that differ only in the last byte a hundred
+// times, returns the sum of the results
+// -----------------------------------------------------------------
+bool compare_test(const Message& msg, const Environment& env, Response& rsp)
+{
+    const size_t size = (size_t)msg.get_number("size");
+    const bool native = msg.get_boolean("native");
+
+    ASSERT_SUCCESS(rsp, size > 0, "size is too small");
+
+    ww::types::ByteArray buffer1, buffer2;
+    fill_buffer(buffer1, size);
+    fill_buffer(buffer2, size);
+    buffer2[size - 1]++;
+
+    int sum = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        int result = 0;
+        if (native)
+            ASSERT_SUCCESS(rsp, ww::util::compare(buffer1, buffer2, result), "failed to compare");
+        else
+            result = memcmp(buffer1.data(), buffer2.data(), size);
+        sum += (result < 0 ? -1 : (result > 0 ? 1 : 0));
+    }
+
+    ww::value::Number v((double)sum);
+    return rsp.value(v, false);
+}
+
+// -----------------------------------------------------------------
+// NAME: integer_test
+//
+// format and parse the given number of integers, returns the number
+// that survived the round trip
+// -----------------------------------------------------------------
+bool integer_test(const Message& msg, const Environment& env, Response& rsp)
+{
+    const int64_t count = (int64_t)msg.get_number("size");
+    const bool native = msg.get_boolean("native");
+
+    int64_t matched = 0;
+    for (int64_t i = 0; i < count; i++)
+    {
+        const int64_t value = i * 7919 - count * 1000;
+        int64_t parsed = 0;
+
+        if (native)
+        {
+            std::string formatted;
+            ASSERT_SUCCESS(rsp, ww::util::format_integer(value, formatted), "failed to format");
+            ASSERT_SUCCESS(rsp, ww::util::parse_integer(formatted, parsed), "failed to parse");
+        }
+        else
+        {
+            char formatted[32];
+            snprintf(formatted, sizeof(formatted), "%lld", (long long)value);
+            parsed = strtoll(formatted, NULL, 10);
+        }
+
+        if (parsed == value)
+            matched++;
+    }
+
+    ww::value::Number v((double)matched);
+    return rsp.value(v, false);
+}
+
+// -----------------------------------------------------------------
+// NAME: sort_test
+//
+// sort the given number of records with pseudo random keys, returns
+// the number of records in order
+// -----------------------------------------------------------------
+bool sort_test(const Message& msg, const Environment& env, Response& rsp)
+{
+    const size_t count = (size_t)msg.get_number("size");
+    const bool native = msg.get_boolean("native");
+
+    ww::types::ByteArray records(count * RECORD_SIZE);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        records[i] = (uint8_t)(seed >> 16);
+    }
+
+    if (native)
+        ASSERT_SUCCESS(rsp, ww::util::sort_records(records, RECORD_SIZE, RECORD_KEY_OFFSET, RECORD_KEY_SIZE),
+                       "failed to sort records");
+    else
+        wasm_sort_records(records);
+
+    size_t ordered = (count > 0 ? 1 : 0);
+    for (size_t i = 1; i < count; i++)
+    {
+        const uint8_t* previous = records.data() + (i - 1) * RECORD_SIZE + RECORD_KEY_OFFSET;
+        const uint8_t* current = records.data() + i * RECORD_SIZE + RECORD_KEY_OFFSET;
+        if (memcmp(previous, current, RECORD_KEY_SIZE) <= 0)
+            ordered++;
+    }
+
+    ww::value::Number v((double)ordered);
+    return rsp.value(v, false);
+}
+
+contract_method_reference_t contract_method_dispatch_table[] = {
+    CONTRACT_METHOD(hex_test),
+    CONTRACT_METHOD(search_test),
+    CONTRACT_METHOD(compare_test),
+    CONTRACT_METHOD(integer_test),
+    CONTRACT_METHOD(sort_test),
+    { NULL, NULL }
+};
@@ -0,0 +1,154 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arena.h"
+
+// chunks are allocated with malloc and chained together, requests
+// larger than the default chunk size get a chunk of their own
+#define ARENA_CHUNK_SIZE (64 * 1024)
+#define ARENA_ALIGNMENT 8
+
+typedef struct arena_chunk
+{
+    struct arena_chunk* next;
+    size_t size;
+    size_t used;
+} arena_chunk_t;
+
+#define ARENA_HEADER_SIZE \
+    ((sizeof(arena_chunk_t) + ARENA_ALIGNMENT - 1) & ~((size_t)ARENA_ALIGNMENT - 1))
+
+static arena_chunk_t* arena_head = NULL;
+static size_t arena_allocated = 0;
+static size_t arena_reserved = 0;
+
+// the state of the arena when preserve was called
+static arena_chunk_t* arena_base = NULL;
+static size_t arena_base_used = 0;
+static size_t arena_base_allocated = 0;
+
+// -----------------------------------------------------------------
+static arena_chunk_t* allocate_chunk(const size_t size)
+{
+    arena_chunk_t* chunk = (arena_chunk_t*)malloc(ARENA_HEADER_SIZE + size);
+    if (chunk == NULL)
+        return NULL;
+
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+
+    arena_reserved += size;
+    return chunk;
+}
+
+// -----------------------------------------------------------------
+void* ww::arena::allocate(const size_t size)
+{
+    const size_t aligned_size = (size + ARENA_ALIGNMENT - 1) & ~((size_t)ARENA_ALIGNMENT - 1);
+
+    if (arena_head == NULL || arena_head->size - arena_head->used < aligned_size)
+    {
+        const size_t chunk_size = (aligned_size > ARENA_CHUNK_SIZE ? aligned_size : ARENA_CHUNK_SIZE);
+        arena_chunk_t* chunk = allocate_chunk(chunk_size);
+        if (chunk == NULL)
+            return NULL;
+
+        chunk->next = arena_head;
+        arena_head = chunk;
+    }
+
+    void* result = (uint8_t*)arena_head + ARENA_HEADER_SIZE + arena_head->used;
+    arena_head->used += aligned_size;
+    arena_allocated += aligned_size;
+
+    return result;
+}
+
+// -----------------------------------------------------------------
+char* ww::arena::duplicate(const char* source, const size_t length)
+{
+    char* result = (char*)allocate(length + 1);
+    if (result == NULL)
+        return NULL;
+
+    memcpy(result, source, length);
+    result[length] = '\0';
+
+    return result;
+}
+
+// -----------------------------------------------------------------
+void ww::arena::preserve(void)
+{
+    arena_base = arena_head;
+    arena_base_used = (arena_head == NULL ? 0 : arena_head->used);
+    arena_base_allocated = arena_allocated;
+}
+
+// -----------------------------------------------------------------
+// chunks are pushed on the front of the list so everything allocated
+// after the mark is in front of the marked chunk
+static void release_to(arena_chunk_t* mark, const size_t mark_used, const size_t mark_allocated)
+{
+    while (arena_head != NULL && arena_head != mark)
+    {
+        arena_chunk_t* next = arena_head->next;
+        arena_reserved -= arena_head->size;
+        free(arena_head);
+        arena_head = next;
+    }
+
+    if (arena_head != NULL)
+        arena_head->used = mark_used;
+
+    arena_allocated = mark_allocated;
+}
+
+// -----------------------------------------------------------------
+void ww::arena::reset(void)
+{
+    release_to(arena_base, arena_base_used, arena_base_allocated);
+}
+
+// -----------------------------------------------------------------
+ww::arena::Scope::Scope(void)
+{
+    head_ = arena_head;
+    used_ = (arena_head == NULL ? 0 : arena_head->used);
+    allocated_ = arena_allocated;
+}
+
+// -----------------------------------------------------------------
+ww::arena::Scope::~Scope(void)
+{
+    release_to((arena_chunk_t*)head_, used_, allocated_);
+}
+
+// -----------------------------------------------------------------
+size_t ww::arena::bytes_allocated(void)
+{
+    return arena_allocated;
+}
+
+// -----------------------------------------------------------------
+size_t ww::arena::bytes_reserved(void)
+{
+    return arena_reserved;
+}
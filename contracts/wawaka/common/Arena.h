@@ -0,0 +1,60 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+// the arena is a bump allocator for storage whose lifetime is a single
+// invocation of the contract; allocations are never freed individually,
+// all of the storage is released when the arena is reset at the start
+// of the next dispatch. preserve keeps everything allocated so far (the
+// storage for global values) across later resets
+//
+// a method that creates values in a loop, for example deserializing
+// every value in a key value store, can exhaust the module heap before
+// the invocation ends; a Scope releases everything allocated while it
+// was open when it is destroyed. nothing allocated inside the scope,
+// including values copied from or stored into values created outside
+// it, may be used after the scope closes
+namespace ww
+{
+namespace arena
+{
+    void* allocate(const size_t size);
+    char* duplicate(const char* source, const size_t length);
+
+    void preserve(void);
+    void reset(void);
+
+    class Scope
+    {
+    protected:
+        void* head_;
+        size_t used_;
+        size_t allocated_;
+
+    public:
+        Scope(void);
+        ~Scope(void);
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    size_t bytes_allocated(void);
+    size_t bytes_reserved(void);
+};
+}
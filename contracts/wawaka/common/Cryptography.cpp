@@ -50,45 +50,39 @@ bool ww::crypto::b64_encode(
     const ww::types::ByteArray& message,
     std::string& encoded_message)
 {
-    uint8_t* data_pointer = NULL;
     size_t data_size = 0;
 
-    if (! ::b64_encode(message.data(), message.size(), (char**)&data_pointer, &data_size))
-        return false;
-
-    if (data_pointer == NULL)
+    // four characters for every three bytes including padding
+    encoded_message.resize(4 * ((message.size() + 2) / 3));
+    if (! ::b64_encode_into(message.data(), message.size(), &encoded_message[0], encoded_message.size(), &data_size))
     {
-        CONTRACT_SAFE_LOG(3, "invalid pointer from extension function b64_encode");
+        CONTRACT_SAFE_LOG(3, "failed to encode message");
         return false;
     }
 
-    encoded_message.clear();
-    std::transform(data_pointer, data_pointer + data_size, std::back_inserter(encoded_message),
-                   [](unsigned char c) -> char { return (char)c; });
-
+    encoded_message.resize(data_size);
     return true;
 }
 
 /* ----------------------------------------------------------------- *
- * NAME: ww::crypto::
+ * NAME: ww::crypto::b64_decode
  * ----------------------------------------------------------------- */
 bool ww::crypto::b64_decode(
     const std::string& encoded_message,
     ww::types::ByteArray& message)
 {
-    uint8_t *data_pointer = NULL;
     size_t data_size = 0;
 
-    if (! ::b64_decode(encoded_message.c_str(), encoded_message.size(), &data_pointer, &data_size))
-        return false;
-
-    if (data_pointer == NULL)
+    // three bytes for every four characters, rounded up for unpadded input
+    message.resize(3 * ((encoded_message.size() + 3) / 4));
+    if (! ::b64_decode_into(encoded_message.data(), encoded_message.size(), message.data(), message.size(), &data_size))
     {
-        CONTRACT_SAFE_LOG(3, "invalid pointer from extension function b64_decode");
+        CONTRACT_SAFE_LOG(3, "failed to decode message");
         return false;
     }
 
-    return copy_internal_pointer(message, data_pointer, data_size);
+    message.resize(data_size);
+    return true;
 }
 
 /* ----------------------------------------------------------------- *
@@ -13,12 +13,10 @@
  * limitations under the License.
  */
 
-#include "jsonvalue.h"
-#include "parson.h"
-
 #include <stdint.h>
 #include <string.h>
 
+#include "Arena.h"
 #include "Environment.h"
 #include "Message.h"
 #include "Response.h"
@@ -27,6 +25,29 @@
 
 #include "Dispatch.h"
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// each invocation runs in a new instance so an index built here would
+// cost as much as the scan; comparing the precomputed hashes leaves a
+// single strcmp to confirm the match
+static contract_method_t find_method(const char *method_name)
+{
+    const uint32_t hash = ww::dispatch::method_hash(method_name);
+
+    contract_method_reference_t* mptr = contract_method_dispatch_table;
+    while (mptr->method_name)
+    {
+        if (mptr->method_hash == 0)
+            mptr->method_hash = ww::dispatch::method_hash(mptr->method_name);
+
+        if (mptr->method_hash == hash && strcmp(method_name, mptr->method_name) == 0)
+            return mptr->method_code;
+
+        mptr++;
+    }
+
+    return NULL;
+}
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 static char *dispatch_wrapper(const char *message, const char *environment)
 {
@@ -49,6 +70,16 @@ static char *dispatch_wrapper(const char *message, const char *environment)
         return rsp.serialize();
     }
 
+    // resolve the method before the parameters are extracted so an
+    // unknown method does no further work
+    contract_method_t method_code = find_method(method_name);
+    if (method_code == NULL)
+    {
+        rsp.error(method_name);
+        return rsp.serialize();
+    }
+
+    // the parameters share the storage of the parsed message
     ww::value::Object kparams;
     if (! msg.get_value("KeywordParameters", kparams))
     {
@@ -65,18 +96,7 @@ static char *dispatch_wrapper(const char *message, const char *environment)
 
     //CONTRACT_SAFE_LOG(3, "method: %s", method_name);
 
-    contract_method_reference_t* mptr = contract_method_dispatch_table;
-    while (mptr->method_name)
-    {
-        if (strcmp(method_name, mptr->method_name) == 0)
-        {
-            (void) (*mptr->method_code)(kparams, env, rsp);
-            return rsp.serialize();
-        }
-        mptr++;
-    }
-
-    rsp.error(method_name);
+    (void) (*method_code)(kparams, env, rsp);
     return rsp.serialize();
 }
 
@@ -110,15 +130,34 @@ extern void __wasm_call_ctors(void);
 // semantically interesting computation in the destructor of
 // a global variable (which seems like an incredibly bad idea)
 
-char *ww_dispatch(const char *message, const char *environment)
+// the constructors run once per instance, arena storage allocated by
+// them is preserved across invocations; everything else in the arena is
+// released at the start of the next invocation. the serialized response
+// is allocated with malloc and is not affected
+static bool contract_constructed = false;
+
+static void begin_invocation(void)
 {
+    if (contract_constructed)
+    {
+        ww::arena::reset();
+        return;
+    }
+
     __wasm_call_ctors();
+    ww::arena::preserve();
+    contract_constructed = true;
+}
+
+char *ww_dispatch(const char *message, const char *environment)
+{
+    begin_invocation();
     return dispatch_wrapper(message, environment);
 }
 
 char *ww_initialize(const char *environment)
 {
-    __wasm_call_ctors();
+    begin_invocation();
     return initialize_wrapper(environment);
 }
 
@@ -15,20 +15,42 @@
 
 #pragma once
 
+#include <stdint.h>
+
 #include "Environment.h"
 #include "Message.h"
 #include "Response.h"
 
 typedef bool (*contract_method_t)(const Message& m, const Environment& e, Response& r);
 
+// method_hash is computed at compile time by the CONTRACT_METHOD macros,
+// entries initialized without it are hashed when the method is looked up
 typedef struct
 {
     const char* method_name;
     contract_method_t method_code;
+    uint32_t method_hash;
 } contract_method_reference_t;
 
 extern bool initialize_contract(const Environment& env, Response& rsp);
 extern contract_method_reference_t contract_method_dispatch_table[];
 
-#define CONTRACT_METHOD(m) { #m, m }
-#define CONTRACT_METHOD2(n, m) { #n, m }
+namespace ww
+{
+namespace dispatch
+{
+    // FNV-1a, never zero so that zero can mark an entry without a hash
+    constexpr uint32_t fnv1a(const char* name, const uint32_t hash)
+    {
+        return *name == '\0' ? hash : fnv1a(name + 1, (hash ^ (uint8_t)*name) * 16777619u);
+    }
+
+    constexpr uint32_t method_hash(const char* name)
+    {
+        return fnv1a(name, 2166136261u) == 0 ? 1 : fnv1a(name, 2166136261u);
+    }
+};
+}
+
+#define CONTRACT_METHOD(m) { #m, m, ww::dispatch::method_hash(#m) }
+#define CONTRACT_METHOD2(n, m) { #n, m, ww::dispatch::method_hash(#n) }
@@ -16,21 +16,15 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "jsonvalue.h"
-#include "parson.h"
-
 #include "Environment.h"
+#include "Value.h"
 
 #define SAFE_GET_STRING(o, k, v)                                \
-    const char* __ ## v = json_object_dotget_string(o, k);      \
+    const char* __ ## v = o.get_string(k);                      \
     if (__ ## v == NULL)                                        \
         return false;                                           \
     v.assign(__ ## v)
 
-#define SAFE_FREE_STRING(v) \
-    if (v != NULL)              \
-        free(v);
-
 Environment::Environment(void)
 {
     // nothing for now
@@ -45,12 +39,8 @@ bool Environment::deserialize(
     )
 {
     // Parse the contract request
-    JsonValue parsed(json_parse_string(contract_environment));
-    if (parsed == NULL)
-        return false;
-
-    JSON_Object* parsed_object = json_value_get_object(parsed);
-    if (parsed_object == NULL)
+    ww::value::Object parsed_object;
+    if (! parsed_object.deserialize(contract_environment))
         return false;
 
     SAFE_GET_STRING(parsed_object, "ContractID", contract_id_);
@@ -27,19 +27,28 @@
 // CLASS: KeyValueStore
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
+// the initial size of the buffer used to read byte array values, the
+// host returns larger values in a buffer it allocates
+#define KV_VALUE_BUFFER_SIZE 256
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-bool KeyValueStore::make_key(const ww::types::ByteArray& key, ww::types::ByteArray& prefixed_key) const
+KeyValueStore::KeyValueStore(const std::string& prefix, size_t handle)
+    : handle_(handle), key_(prefix.begin(), prefix.end())
 {
-    prefixed_key.clear();
-    if (prefix_.size() > 0)
-    {
-        prefixed_key.insert(prefixed_key.end(), prefix_.begin(), prefix_.end());
-        prefixed_key.push_back((uint8_t)'#');
-    }
+    if (key_.size() > 0)
+        key_.push_back((uint8_t)'#');
 
-    prefixed_key.insert(prefixed_key.end(), key.begin(), key.end());
+    prefix_length_ = key_.size();
+}
 
-    return true;
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// the returned key is only valid until the next operation on the store
+const ww::types::ByteArray& KeyValueStore::make_key(const uint8_t* key, const size_t key_length) const
+{
+    key_.resize(prefix_length_);
+    key_.insert(key_.end(), key, key + key_length);
+
+    return key_;
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -73,81 +82,75 @@ bool KeyValueStore::finalize(const int kv_store_handle, ww::types::ByteArray& bl
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-bool KeyValueStore::get(const ww::types::ByteArray& key, uint32_t& val) const
+bool KeyValueStore::get_value(
+    const uint8_t* key,
+    const size_t key_length,
+    uint8_t* val,
+    const size_t val_length) const
 {
-    ww::types::ByteArray prefixed_key;
-    if (! make_key(key, prefixed_key))
-        return false;
-
-    uint8_t* datap;
-    size_t size;
+    const ww::types::ByteArray& prefixed_key = make_key(key, key_length);
 
-    if (! key_value_get(handle_, prefixed_key.data(), prefixed_key.size(), &datap, &size))
-        return false;
-
-    if (datap == NULL)
+    size_t size = 0;
+    if (! key_value_get_into(handle_, prefixed_key.data(), prefixed_key.size(), val, val_length, NULL, &size))
     {
-        CONTRACT_SAFE_LOG(3, "data allocation failed");
+        if (size > 0)
+            CONTRACT_SAFE_LOG(3, "wrong size for value:%lu", size);
         return false;
     }
 
-    if (size != sizeof(uint32_t))
+    if (size != val_length)
     {
-        CONTRACT_SAFE_LOG(3, "wrong size for integer:%lu", size);
-
-        free(datap);
+        CONTRACT_SAFE_LOG(3, "wrong size for value:%lu", size);
         return false;
     }
 
-    uint32_t* valp = (uint32_t*)datap;
-
-    val = (*valp);
-    free(datap);
-
     return true;
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-bool KeyValueStore::set(const ww::types::ByteArray& key, const uint32_t val) const
+bool KeyValueStore::set_value(
+    const uint8_t* key,
+    const size_t key_length,
+    const uint8_t* val,
+    const size_t val_length) const
 {
-    ww::types::ByteArray prefixed_key;
-    if (! make_key(key, prefixed_key))
-        return false;
-
-    return key_value_set(handle_, prefixed_key.data(), prefixed_key.size(), (uint8_t*)&val, sizeof(val));
+    const ww::types::ByteArray& prefixed_key = make_key(key, key_length);
+    return key_value_set(handle_, prefixed_key.data(), prefixed_key.size(), val, val_length);
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-bool KeyValueStore::get(const ww::types::ByteArray& key, ww::types::ByteArray& val) const
+bool KeyValueStore::get_bytes(
+    const uint8_t* key,
+    const size_t key_length,
+    ww::types::ByteArray& val) const
 {
-    ww::types::ByteArray prefixed_key;
-    if (! make_key(key, prefixed_key))
-        return false;
-
-    uint8_t* datap;
-    size_t size;
-
-    if (! key_value_get(handle_, prefixed_key.data(), prefixed_key.size(), &datap, &size))
+    const ww::types::ByteArray& prefixed_key = make_key(key, key_length);
+
+    // read into the storage the result already has, a value that does
+    // not fit comes back in a buffer the host allocates so the value is
+    // fetched from the state only once
+    if (val.capacity() < KV_VALUE_BUFFER_SIZE)
+        val.reserve(KV_VALUE_BUFFER_SIZE);
+    val.resize(val.capacity());
+
+    uint8_t* datap = NULL;
+    size_t size = 0;
+    if (! key_value_get_into(handle_, prefixed_key.data(), prefixed_key.size(), val.data(), val.size(), &datap, &size))
+    {
+        val.clear();
         return false;
+    }
 
-    // this should not happen if the result was true
     if (datap == NULL)
     {
-        CONTRACT_SAFE_LOG(3, "invalid pointer from extension function key_value_get")
-        return false;
+        val.resize(size);
+        return true;
     }
 
-    return copy_internal_pointer(val, datap, size);
-}
-
-// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-bool KeyValueStore::set(const ww::types::ByteArray& key, const ww::types::ByteArray& val) const
-{
-    ww::types::ByteArray prefixed_key;
-    if (! make_key(key, prefixed_key))
-        return false;
+    bool result = copy_internal_pointer(val, datap, size);
+    free(datap);
 
-    return key_value_set(handle_, prefixed_key.data(), prefixed_key.size(), val.data(), val.size());
+    return result;
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -166,7 +169,10 @@ bool KeyValueStore::privileged_get(const ww::types::ByteArray& key, ww::types::B
         return false;
     }
 
-    return copy_internal_pointer(val, datap, size);
+    bool result = copy_internal_pointer(val, datap, size);
+    free(datap);
+
+    return result;
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -16,15 +16,39 @@
 #pragma once
 
 #include <stdint.h>
+#include <string.h>
+#include <type_traits>
 
 // pick up types from pdo common
 #include "Types.h"
 
+// The store prefix (plus the '#' separator) is interned in the key
+// buffer when the store is constructed; each operation appends the key
+// to the prefix in place so no new key array is built per access.
+//
+// Values of trivially copyable types (integers, fixed size structures)
+// are stored as their native byte representation and read back with
+// key_value_get_into directly into the variable, no buffer is allocated
+// in the contract heap. Keys may be passed as a pointer and length to
+// avoid constructing a string or byte array.
 class KeyValueStore
 {
+    // arrays and pointers are excluded so that string literals and
+    // character pointers are never stored as raw bytes
+    template<typename T>
+    struct is_native : std::integral_constant<bool,
+        std::is_trivially_copyable<T>::value && ! std::is_array<T>::value && ! std::is_pointer<T>::value> {};
+
     size_t handle_;
-    const ww::types::ByteArray prefix_;
-    bool make_key(const ww::types::ByteArray& key, ww::types::ByteArray& prefixed_key) const;
+    size_t prefix_length_;
+    mutable ww::types::ByteArray key_;
+
+    const ww::types::ByteArray& make_key(const uint8_t* key, const size_t key_length) const;
+
+    bool get_value(const uint8_t* key, const size_t key_length, uint8_t* val, const size_t val_length) const;
+    bool set_value(const uint8_t* key, const size_t key_length, const uint8_t* val, const size_t val_length) const;
+
+    bool get_bytes(const uint8_t* key, const size_t key_length, ww::types::ByteArray& val) const;
 
 public:
     static bool privileged_get(const ww::types::ByteArray& key, ww::types::ByteArray& val);
@@ -51,57 +75,119 @@ public:
         return true;
     };
 
-    KeyValueStore(const std::string& prefix, size_t handle = 0)
-        : handle_(handle), prefix_(prefix.begin(), prefix.end()) {};
+    KeyValueStore(const std::string& prefix, size_t handle = 0);
 
     static int create(const ww::types::ByteArray& key);
     static int open(const ww::types::ByteArray& block_hash, const ww::types::ByteArray& key);
     static bool finalize(const int kv_store_handle, ww::types::ByteArray& block_hash);
 
-    bool get(const ww::types::ByteArray& key, uint32_t& val) const;
-    bool get(const std::string& key, uint32_t& val) const
+    // ---------- typed values ----------
+    template<typename T>
+    typename std::enable_if<is_native<T>::value, bool>::type
+    get(const char* key, const size_t key_length, T& val) const
     {
-        ww::types::ByteArray bkey(key.begin(), key.end());
-        return get(bkey, val);
+        // the host may write the buffer before the size is checked, read
+        // into a temporary so that a failed get leaves val unchanged
+        uint8_t buffer[sizeof(T)];
+        if (! get_value((const uint8_t*)key, key_length, buffer, sizeof(T)))
+            return false;
+
+        memcpy((void*)&val, buffer, sizeof(T));
+        return true;
     };
 
-    bool set(const ww::types::ByteArray& key, const uint32_t val) const;
-    bool set(const std::string& key, const uint32_t val) const
+    template<typename T>
+    typename std::enable_if<is_native<T>::value, bool>::type
+    set(const char* key, const size_t key_length, const T& val) const
     {
-        ww::types::ByteArray bkey(key.begin(), key.end());
-        return set(bkey, val);
+        return set_value((const uint8_t*)key, key_length, (const uint8_t*)&val, sizeof(T));
+    };
+
+    template<typename T>
+    typename std::enable_if<is_native<T>::value, bool>::type
+    get(const char* key, T& val) const
+    {
+        return get(key, strlen(key), val);
+    };
+
+    template<typename T>
+    typename std::enable_if<is_native<T>::value, bool>::type
+    set(const char* key, const T& val) const
+    {
+        return set(key, strlen(key), val);
+    };
+
+    template<typename T>
+    typename std::enable_if<is_native<T>::value, bool>::type
+    get(const std::string& key, T& val) const
+    {
+        return get(key.data(), key.size(), val);
+    };
+
+    template<typename T>
+    typename std::enable_if<is_native<T>::value, bool>::type
+    set(const std::string& key, const T& val) const
+    {
+        return set(key.data(), key.size(), val);
+    };
+
+    template<typename T>
+    typename std::enable_if<is_native<T>::value, bool>::type
+    get(const ww::types::ByteArray& key, T& val) const
+    {
+        return get((const char*)key.data(), key.size(), val);
+    };
+
+    template<typename T>
+    typename std::enable_if<is_native<T>::value, bool>::type
+    set(const ww::types::ByteArray& key, const T& val) const
+    {
+        return set((const char*)key.data(), key.size(), val);
+    };
+
+    // ---------- byte array values ----------
+    bool get(const char* key, const size_t key_length, ww::types::ByteArray& val) const
+    {
+        return get_bytes((const uint8_t*)key, key_length, val);
+    };
+
+    bool set(const char* key, const size_t key_length, const ww::types::ByteArray& val) const
+    {
+        return set_value((const uint8_t*)key, key_length, val.data(), val.size());
     };
 
+    bool get(const ww::types::ByteArray& key, ww::types::ByteArray& val) const
+    {
+        return get((const char*)key.data(), key.size(), val);
+    };
+
+    bool set(const ww::types::ByteArray& key, const ww::types::ByteArray& val) const
+    {
+        return set((const char*)key.data(), key.size(), val);
+    };
 
-    bool get(const ww::types::ByteArray& key, ww::types::ByteArray& val) const;
     bool get(const std::string& key, ww::types::ByteArray& val) const
     {
-        ww::types::ByteArray bkey(key.begin(), key.end());
-        return get(bkey, val);
+        return get(key.data(), key.size(), val);
     };
 
-    bool set(const ww::types::ByteArray& key, const ww::types::ByteArray& val) const;
     bool set(const std::string& key, const ww::types::ByteArray& val) const
     {
-        ww::types::ByteArray bkey(key.begin(), key.end());
-        return set(bkey, val);
+        return set(key.data(), key.size(), val);
     };
 
+    // ---------- string values ----------
     bool get(const std::string& key, std::string& val) const
     {
-        ww::types::ByteArray bkey(key.begin(), key.end());
         ww::types::ByteArray bval;
-        if (! get(bkey, bval))
+        if (! get(key.data(), key.size(), bval))
             return false;
-        val = ww::types::ByteArrayToString(bval);
+        val.assign(bval.begin(), bval.end());
         return true;
     };
 
     bool set(const std::string& key, const std::string& val) const
     {
-        ww::types::ByteArray bkey(key.begin(), key.end());
-        ww::types::ByteArray bval(val.begin(), val.end());
-
-        return set(bkey, bval);
+        return set_value((const uint8_t*)key.data(), key.size(), (const uint8_t*)val.data(), val.size());
     };
 };
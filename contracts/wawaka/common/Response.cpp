@@ -16,17 +16,13 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "jsonvalue.h"
-#include "parson.h"
-
+#include "Arena.h"
 #include "Response.h"
+#include "ValueNode.h"
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 Response::Response(void)
 {
-    value_ = json_value_init_object();
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
-
     ww::value::Boolean status(true);
     ww::value::Boolean response(true);
     ww::value::Boolean state_changed(false);
@@ -39,16 +35,26 @@ Response::Response(void)
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// the response is serialized straight into the arena and the string
+// node refers to that buffer, avoiding a malloc and a copy
 bool Response::set_response(const ww::value::Value& response)
 {
-    char* serialized_response = response.serialize();
+    const ww::value::Node* response_value = response.get();
+    if (response_value == NULL)
+        return false;
+
+    size_t length = ww::value::node::serialize(response_value, NULL);
+    char* serialized_response = (char*)ww::arena::allocate(length + 1);
     if (serialized_response == NULL)
         return false;
 
-    ww::value::String v(serialized_response);
-    free(serialized_response);
+    ww::value::node::serialize(response_value, serialized_response);
+
+    ww::value::Node* v = ww::value::node::string_value_no_copy(serialized_response, length);
+    if (v == NULL)
+        return false;
 
-    return set_value("Response", v);
+    return ww::value::node::dotset_member(value_, "Response", v);
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -18,6 +18,7 @@
 
 #include "Types.h"
 #include "Util.h"
+#include "WasmExtensions.h"
 
 #ifdef USE_WASI_SDK
 #include <new>
@@ -57,3 +58,130 @@ bool copy_internal_pointer(
     result.assign(pointer,pointer+size);
     return true;
 }
+
+/* ----------------------------------------------------------------- *
+ * NAME: ww::util::compare
+ * ----------------------------------------------------------------- */
+bool ww::util::compare(
+    const ww::types::ByteArray& buffer1,
+    const ww::types::ByteArray& buffer2,
+    int& result)
+{
+    return ::buffer_compare(buffer1.data(), buffer1.size(), buffer2.data(), buffer2.size(), &result);
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: ww::util::find
+ * ----------------------------------------------------------------- */
+bool ww::util::find(
+    const ww::types::ByteArray& buffer,
+    const ww::types::ByteArray& pattern,
+    size_t& offset)
+{
+    int result = ::buffer_find(buffer.data(), buffer.size(), pattern.data(), pattern.size());
+    if (result < 0)
+        return false;
+
+    offset = result;
+    return true;
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: ww::util::find
+ * ----------------------------------------------------------------- */
+bool ww::util::find(
+    const std::string& buffer,
+    const std::string& pattern,
+    size_t& offset)
+{
+    int result = ::buffer_find(
+        (const uint8_t*)buffer.data(), buffer.size(),
+        (const uint8_t*)pattern.data(), pattern.size());
+    if (result < 0)
+        return false;
+
+    offset = result;
+    return true;
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: ww::util::sort_records
+ * ----------------------------------------------------------------- */
+bool ww::util::sort_records(
+    ww::types::ByteArray& records,
+    const size_t record_size,
+    const size_t key_offset,
+    const size_t key_size)
+{
+    if (! ::sort_records(records.data(), records.size(), record_size, key_offset, key_size))
+    {
+        CONTRACT_SAFE_LOG(3, "invalid record layout");
+        return false;
+    }
+
+    return true;
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: ww::util::parse_integer
+ * ----------------------------------------------------------------- */
+bool ww::util::parse_integer(
+    const std::string& source,
+    int64_t& value,
+    const int base)
+{
+    return ::parse_integer(source.data(), source.size(), base, &value);
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: ww::util::format_integer
+ * ----------------------------------------------------------------- */
+bool ww::util::format_integer(
+    const int64_t value,
+    std::string& result,
+    const int base)
+{
+    // large enough for a 64 bit value in base 2 and a sign
+    char buffer[66];
+    size_t length = 0;
+
+    if (! ::format_integer(value, base, buffer, sizeof(buffer), &length))
+        return false;
+
+    result.assign(buffer, length);
+    return true;
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: ww::util::hex_encode
+ * ----------------------------------------------------------------- */
+bool ww::util::hex_encode(
+    const ww::types::ByteArray& source,
+    std::string& encoded)
+{
+    size_t length = 0;
+
+    encoded.resize(2 * source.size());
+    if (! ::hex_encode(source.data(), source.size(), &encoded[0], encoded.size(), &length))
+        return false;
+
+    encoded.resize(length);
+    return true;
+}
+
+/* ----------------------------------------------------------------- *
+ * NAME: ww::util::hex_decode
+ * ----------------------------------------------------------------- */
+bool ww::util::hex_decode(
+    const std::string& encoded,
+    ww::types::ByteArray& decoded)
+{
+    size_t length = 0;
+
+    decoded.resize(encoded.size() / 2);
+    if (! ::hex_decode(encoded.data(), encoded.size(), decoded.data(), decoded.size(), &length))
+        return false;
+
+    decoded.resize(length);
+    return true;
+}
@@ -42,3 +42,55 @@ bool copy_internal_pointer(
     ww::types::ByteArray& result,
     const uint8_t* pointer,
     const uint32_t size);
+
+// these are implemented by native functions in the interpreter and are
+// much faster than the equivalent loops compiled into the contract
+namespace ww
+{
+namespace util
+{
+    // lexicographic order, a prefix sorts before the longer buffer;
+    // result is set to -1, 0 or 1 like the sign of memcmp
+    bool compare(
+        const ww::types::ByteArray& buffer1,
+        const ww::types::ByteArray& buffer2,
+        int& result);
+
+    bool find(
+        const ww::types::ByteArray& buffer,
+        const ww::types::ByteArray& pattern,
+        size_t& offset);
+
+    bool find(
+        const std::string& buffer,
+        const std::string& pattern,
+        size_t& offset);
+
+    // stable sort of fixed size records by the bytes at key_offset
+    bool sort_records(
+        ww::types::ByteArray& records,
+        const size_t record_size,
+        const size_t key_offset,
+        const size_t key_size);
+
+    // the whole string must be an integer in the base, an optional minus
+    // sign followed by digits; whitespace, '+' and '0x' are rejected
+    bool parse_integer(
+        const std::string& source,
+        int64_t& value,
+        const int base = 10);
+
+    bool format_integer(
+        const int64_t value,
+        std::string& result,
+        const int base = 10);
+
+    bool hex_encode(
+        const ww::types::ByteArray& source,
+        std::string& encoded);
+
+    bool hex_decode(
+        const std::string& encoded,
+        ww::types::ByteArray& decoded);
+};
+}
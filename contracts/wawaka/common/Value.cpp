@@ -14,12 +14,41 @@
  */
 
 #include <stdlib.h>
-
-#include "parson.h"
+#include <string.h>
 
 #include "Value.h"
+#include "ValueNode.h"
 #include "WasmExtensions.h"
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Typed accessors for nodes, the results for missing values or values
+// of the wrong type match the parson accessors they replace
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+// -----------------------------------------------------------------
+static const char* node_string(const ww::value::Node* value)
+{
+    return (value != NULL && value->type == JSONString) ? value->string.data : NULL;
+}
+
+// -----------------------------------------------------------------
+static double node_number(const ww::value::Node* value)
+{
+    return (value != NULL && value->type == JSONNumber) ? value->number : 0.0;
+}
+
+// -----------------------------------------------------------------
+static int node_boolean(const ww::value::Node* value)
+{
+    return (value != NULL && value->type == JSONBoolean) ? (int)value->boolean : -1;
+}
+
+// -----------------------------------------------------------------
+static JSON_Value_Type node_type(const ww::value::Node* value)
+{
+    return (value == NULL ? JSONError : value->type);
+}
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 // Class: pdo.Value.Value
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -27,8 +56,27 @@
 // -----------------------------------------------------------------
 ww::value::Value::Value(void)
 {
-    value_ = json_value_init_null();
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
+    value_ = ww::value::node::null_value();
+    expected_value_type_ = node_type(value_);
+}
+
+// -----------------------------------------------------------------
+ww::value::Value::Value(const ww::value::Value& source)
+{
+    value_ = shared_node(source);
+    expected_value_type_ = source.expected_value_type_;
+}
+
+// -----------------------------------------------------------------
+ww::value::Value& ww::value::Value::operator=(const ww::value::Value& source)
+{
+    if (this != &source)
+    {
+        value_ = shared_node(source);
+        expected_value_type_ = source.expected_value_type_;
+    }
+
+    return *this;
 }
 
 // -----------------------------------------------------------------
@@ -38,13 +86,16 @@ ww::value::Value::~Value(void)
 }
 
 // -----------------------------------------------------------------
+// the storage belongs to the arena, there is nothing to free
 void ww::value::Value::clear_value(void)
 {
-    if (value_ != NULL)
-    {
-        json_value_free(value_);
-        value_ = NULL;
-    }
+    value_ = NULL;
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::Value::shared_node(const ww::value::Value& value)
+{
+    return ww::value::node::share(value.value_);
 }
 
 // -----------------------------------------------------------------
@@ -54,29 +105,25 @@ JSON_Value_Type ww::value::Value::get_type(void) const
 }
 
 // -----------------------------------------------------------------
-const JSON_Value* ww::value::Value::get(void) const
+const ww::value::Node* ww::value::Value::get(void) const
 {
     return value_;
 }
 
 // -----------------------------------------------------------------
-const JSON_Value* ww::value::Value::set(const JSON_Value *value)
+const ww::value::Node* ww::value::Value::set(ww::value::Node* value)
 {
-    clear_value();
-
-    if (value == NULL) {
-        value_ = json_value_init_null();
-        expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
-    } else {
-        value_ = json_value_deep_copy(value);
-        expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
-    }
+    if (value == NULL)
+        value_ = ww::value::node::null_value();
+    else
+        value_ = ww::value::node::share(value);
 
+    expected_value_type_ = node_type(value_);
     return value_;
 }
 
 // -----------------------------------------------------------------
-const JSON_Value* ww::value::Value::set(const ww::value::Value& value)
+const ww::value::Node* ww::value::Value::set(const ww::value::Value& value)
 {
     return set(value.value_);
 }
@@ -87,8 +134,8 @@ bool ww::value::Value::deserialize(const char* value)
     if (value == NULL)
         return false;
 
-    JSON_Value* json_value = json_parse_string(value);
-    if (json_value == NULL)
+    ww::value::Node* parsed_value = ww::value::node::parse(value);
+    if (parsed_value == NULL)
     {
         CONTRACT_SAFE_LOG(3, "value deserialize; failed to parse json string; %s", value);
         return false;
@@ -96,22 +143,20 @@ bool ww::value::Value::deserialize(const char* value)
 
     // this forces a bit of correctness checking on JSON lookups in that
     // the incoming value object has to match the one in the object
-    if (json_value_get_type(json_value) != expected_value_type_)
+    if (parsed_value->type != expected_value_type_)
     {
         CONTRACT_SAFE_LOG(3, "value deserialize; type mismatch on objects");
-        json_value_free(json_value);
         return false;
     }
 
-    clear_value();
-
-    value_ = json_value;
-    expected_value_type_ = json_value_get_type(value_);
+    value_ = parsed_value;
+    expected_value_type_ = parsed_value->type;
 
     return true;
 }
 
 // -----------------------------------------------------------------
+// serialize directly into the string, no intermediate buffer
 bool ww::value::Value::serialize(std::string& result) const
 {
     if (value_ == NULL)
@@ -120,22 +165,15 @@ bool ww::value::Value::serialize(std::string& result) const
         return false;
     }
 
-    char *serialized_response = (char *)serialize();
-    if (serialized_response == NULL)
-        return false;
-
-    // as we understand the stability of allocation more
-    // fully we can avoid the copy by using take rather
-    // than assign
-    // bool success = result.take(serialized_reponse);
-
-    result = serialized_response;
-    free(serialized_response);
+    size_t length = ww::value::node::serialize(value_, NULL);
+    result.resize(length);
+    ww::value::node::serialize(value_, &result[0]);
 
     return true;
 }
 
 // -----------------------------------------------------------------
+// the result is allocated with malloc and must be free'd by the caller
 char* ww::value::Value::serialize(void) const
 {
     if (value_ == NULL)
@@ -144,7 +182,16 @@ char* ww::value::Value::serialize(void) const
         return NULL;
     }
 
-    return json_serialize_to_string(value_);
+    size_t length = ww::value::node::serialize(value_, NULL);
+    char* result = (char*)malloc(length + 1);
+    if (result == NULL)
+    {
+        CONTRACT_SAFE_LOG(1, "failed serialization; allocation failed");
+        return NULL;
+    }
+
+    ww::value::node::serialize(value_, result);
+    return result;
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -154,27 +201,23 @@ char* ww::value::Value::serialize(void) const
 // -----------------------------------------------------------------
 ww::value::Boolean::Boolean(const bool value)
 {
-    clear_value();
-
-    value_ = json_value_init_boolean(value);
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
+    value_ = ww::value::node::boolean_value(value);
+    expected_value_type_ = node_type(value_);
 }
 
 // -----------------------------------------------------------------
 bool ww::value::Boolean::get(void) const
 {
-    return json_boolean(value_);
+    return node_boolean(value_);
 }
 
 // -----------------------------------------------------------------
 bool ww::value::Boolean::set(bool value)
 {
-    clear_value();
+    value_ = ww::value::node::boolean_value(value);
+    expected_value_type_ = node_type(value_);
 
-    value_ = json_value_init_boolean(value);
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
-
-    return json_boolean(value_);
+    return node_boolean(value_);
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -184,27 +227,23 @@ bool ww::value::Boolean::set(bool value)
 // -----------------------------------------------------------------
 ww::value::String::String(const char* value)
 {
-    clear_value();
-
-    value_ = json_value_init_string(value);
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
+    value_ = ww::value::node::string_value(value);
+    expected_value_type_ = node_type(value_);
 }
 
 // -----------------------------------------------------------------
 const char* ww::value::String::get(void) const
 {
-    return json_string(value_);
+    return node_string(value_);
 }
 
 // -----------------------------------------------------------------
 const char* ww::value::String::set(const char* value)
 {
-    clear_value();
-
-    value_ = json_value_init_string(value);
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
+    value_ = ww::value::node::string_value(value);
+    expected_value_type_ = node_type(value_);
 
-    return json_string(value_);
+    return node_string(value_);
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -214,27 +253,23 @@ const char* ww::value::String::set(const char* value)
 // -----------------------------------------------------------------
 ww::value::Number::Number(const double value)
 {
-    clear_value();
-
-    value_ = json_value_init_number(value);
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
+    value_ = ww::value::node::number_value(value);
+    expected_value_type_ = node_type(value_);
 }
 
 // -----------------------------------------------------------------
 double ww::value::Number::get(void) const
 {
-    return json_number(value_);
+    return node_number(value_);
 }
 
 // -----------------------------------------------------------------
 double ww::value::Number::set(double value)
 {
-    clear_value();
+    value_ = ww::value::node::number_value(value);
+    expected_value_type_ = node_type(value_);
 
-    value_ = json_value_init_number(value);
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
-
-    return json_number(value_);
+    return node_number(value_);
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -244,36 +279,31 @@ double ww::value::Number::set(double value)
 // -----------------------------------------------------------------
 ww::value::Object::Object(void)
 {
-    clear_value();
-
-    value_ = json_value_init_object();
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
+    value_ = ww::value::node::object_value();
+    expected_value_type_ = node_type(value_);
 }
 
-ww::value::Object::Object(const ww::value::Object& source)
+// the copy shares the storage of the source until either is modified
+ww::value::Object::Object(const ww::value::Object& source) : ww::value::Value(source)
 {
-    clear_value();
-
-    value_ = json_value_deep_copy(source.value_);
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
 }
 
 // -----------------------------------------------------------------
 const char* ww::value::Object::get_string(const char* key) const
 {
-     return json_object_dotget_string(json_object(value_), key);
+    return node_string(ww::value::node::dotget_member(value_, key));
 }
 
 // -----------------------------------------------------------------
 double ww::value::Object::get_number(const char* key) const
 {
-    return json_object_dotget_number(json_object(value_), key);
+    return node_number(ww::value::node::dotget_member(value_, key));
 }
 
 // -----------------------------------------------------------------
 int ww::value::Object::get_boolean(const char* key) const
 {
-    return json_object_dotget_boolean(json_object(value_), key);
+    return node_boolean(ww::value::node::dotget_member(value_, key));
 }
 
 // -----------------------------------------------------------------
@@ -300,16 +330,16 @@ bool ww::value::Object::set_boolean(const char* key, const bool value)
 // -----------------------------------------------------------------
 bool ww::value::Object::get_value(const char* name, ww::value::Value& value) const
 {
-    const JSON_Value *json_value = json_object_dotget_value(json_object(value_), name);
-    if (json_value == NULL)
+    ww::value::Node *node = ww::value::node::dotget_member(value_, name);
+    if (node == NULL)
         return false;
 
     // this forces a bit of correctness checking on JSON lookups in that
     // the incoming value object has to match the one in the object
-    if (json_value_get_type(json_value) != value.get_type())
+    if (node->type != value.get_type())
         return false;
 
-    value.set(json_value);
+    value.set(node);
     return true;
 }
 
@@ -319,24 +349,15 @@ bool ww::value::Object::set_value(const char* name, const ww::value::Value& valu
     if (name == NULL)
         return false;
 
-    const JSON_Value *old_json_value = value.get();
-    if (old_json_value == NULL)
+    if (value.get() == NULL)
     {
         CONTRACT_SAFE_LOG(1, "unable to set value for NULL object");
         return false;
     }
 
-    JSON_Value *new_json_value = json_value_deep_copy(old_json_value);
-    if (new_json_value == NULL)
-    {
-        CONTRACT_SAFE_LOG(1, "object set value; allocation failed");
-        return false;
-    }
-
-    if (json_object_dotset_value(json_object(value_), name, new_json_value) != JSONSuccess)
+    if (! ww::value::node::dotset_member(value_, name, shared_node(value)))
     {
         CONTRACT_SAFE_LOG(1, "object set value; failed to save property %s", name);
-        json_value_free(new_json_value);
         return false;
     }
 
@@ -346,8 +367,7 @@ bool ww::value::Object::set_value(const char* name, const ww::value::Value& valu
 // -----------------------------------------------------------------
 bool ww::value::Object::validate_schema(const ww::value::Value& schema) const
 {
-    JSON_Status result = json_validate(schema.get(), value_);
-    return result == JSONSuccess;
+    return ww::value::node::validate(schema.get(), value_);
 }
 
 // -----------------------------------------------------------------
@@ -383,8 +403,8 @@ bool ww::value::Structure::set_value(const char* name, const ww::value::Value& v
 {
     // for a structure, the value we are assignment must already exist in the
     // object and the type must match
-    const JSON_Value *json_value = json_object_dotget_value(json_object(value_), name);
-    if (json_value == NULL)
+    const ww::value::Node *node = ww::value::node::dotget_member(value_, name);
+    if (node == NULL)
     {
         CONTRACT_SAFE_LOG(4, "key %s does not exist in the structure", name);
         return false;
@@ -392,10 +412,10 @@ bool ww::value::Structure::set_value(const char* name, const ww::value::Value& v
 
     // this forces a bit of correctness checking on JSON lookups in that
     // the incoming value object has to match the one in the object
-    if (json_value_get_type(json_value) != value.get_type())
+    if (node->type != value.get_type())
     {
         CONTRACT_SAFE_LOG(4, "value type mismatch in structure, %d != %d",
-                          json_value_get_type(json_value), value.get_type());
+                          node->type, value.get_type());
         return false;
     }
 
@@ -410,34 +430,35 @@ bool ww::value::Structure::set_value(const char* name, const ww::value::Value& v
 // -----------------------------------------------------------------
 ww::value::Array::Array(void)
 {
-    clear_value();
-
-    value_ = json_value_init_array();
-    expected_value_type_ = (value_ == NULL ? JSONError : json_value_get_type(value_));
+    value_ = ww::value::node::array_value();
+    expected_value_type_ = node_type(value_);
 }
 
 // -----------------------------------------------------------------
 size_t ww::value::Array::get_count(void) const
 {
-    return json_array_get_count(json_array(value_));
+    if (value_ == NULL || value_->type != JSONArray)
+        return 0;
+
+    return value_->container.count;
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 const char* ww::value::Array::get_string(size_t index) const
 {
-     return json_array_get_string(json_array(value_), index);
+    return node_string(ww::value::node::get_item(value_, index));
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 double ww::value::Array::get_number(size_t index) const
 {
-    return json_array_get_number(json_array(value_), index);
+    return node_number(ww::value::node::get_item(value_, index));
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 int ww::value::Array::get_boolean(size_t index) const
 {
-    return json_array_get_boolean(json_array(value_), index);
+    return node_boolean(ww::value::node::get_item(value_, index));
 }
 
 // -----------------------------------------------------------------
@@ -485,47 +506,33 @@ bool ww::value::Array::append_boolean(const bool value)
 /// -----------------------------------------------------------------
 bool ww::value::Array::get_value(const size_t index, ww::value::Value& value) const
 {
-    const JSON_Value *json_value = json_array_get_value(json_array(value_), index);
-    if (json_value == NULL)
+    ww::value::Node *node = ww::value::node::get_item(value_, index);
+    if (node == NULL)
         return false;
 
     // this forces a bit of correctness checking on JSON lookups in that
     // the incoming value object has to match the one in the object
-    if (json_value_get_type(json_value) != value.get_type())
+    if (node->type != value.get_type())
         return false;
 
-    value.set(json_value);
+    value.set(node);
     return true;
 }
 
 // -----------------------------------------------------------------
 bool ww::value::Array::set_value(const size_t index, const ww::value::Value& value)
 {
-    JSON_Value *json_value = json_value_deep_copy(value.get());
-    if (json_value == NULL)
+    if (value.get() == NULL)
         return false;
 
-    if (json_array_replace_value(json_array(value_), index, json_value) != JSONSuccess)
-    {
-        json_value_free(json_value);
-        return false;
-    }
-
-    return true;
+    return ww::value::node::replace_item(value_, index, shared_node(value));
 }
 
 // -----------------------------------------------------------------
 bool ww::value::Array::append_value(const ww::value::Value& value)
 {
-    JSON_Value *json_value = json_value_deep_copy(value.get());
-    if (json_value == NULL)
+    if (value.get() == NULL)
         return false;
 
-    if (json_array_append_value(json_array(value_), json_value) != JSONSuccess)
-    {
-        json_value_free(json_value);
-        return false;
-    }
-
-    return true;
+    return ww::value::node::append_item(value_, shared_node(value));
 }
@@ -19,22 +19,35 @@
 
 #include "parson.h"
 #include "Types.h"
+#include "ValueNode.h"
 
 namespace ww
 {
 namespace value
 {
+    // the storage for a value lives in the invocation arena, see
+    // ValueNode.h; copying a value or storing it in an object or an
+    // array shares the storage, it is copied only when modified.
+    //
+    // destroying a value does not release its storage, the arena is
+    // reset only when the invocation ends. every value created during
+    // the invocation counts against the module heap (HEAP_SIZE, 512KB
+    // for small memory configurations); methods that create values in
+    // a loop should open a ww::arena::Scope inside the loop body, see
+    // Arena.h
     class Value
     {
-        // storage associated value_ is owned by this value and must be free'd
     protected:
         void clear_value(void);
+        static Node* shared_node(const Value& value);
 
         JSON_Value_Type expected_value_type_;
-        JSON_Value *value_;
+        Node *value_;
 
     public:
         Value(void);
+        Value(const Value& source);
+        Value& operator=(const Value& source);
         ~Value(void);
 
         char *serialize(void) const;
@@ -42,9 +55,9 @@ namespace value
         bool deserialize(const char *message);
 
         JSON_Value_Type get_type(void) const;
-        const JSON_Value* get(void) const;
-        const JSON_Value* set(const JSON_Value *value);
-        const JSON_Value* set(const ww::value::Value& value);
+        const Node* get(void) const;
+        const Node* set(Node *value);
+        const Node* set(const ww::value::Value& value);
 
         bool is_null(void) const { return value_ == NULL; };
     };
@@ -0,0 +1,863 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arena.h"
+#include "ValueNode.h"
+#include "WasmExtensions.h"
+
+// the parser and serializer follow the conventions of the parson
+// library they replace so that messages produced by existing contracts
+// do not change: no \u escapes, nesting limited to 19 levels, duplicate
+// keys rejected, integers in int range written with %d and all other
+// numbers with %f
+#define MAX_NESTING 19
+#define STARTING_CAPACITY 8
+#define INDEX_THRESHOLD 16
+#define NUMBER_BUFFER_SIZE 512
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Node construction
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+// the null node is never modified so a single instance can be shared
+static ww::value::Node null_node = { JSONNull, true };
+
+// -----------------------------------------------------------------
+static ww::value::Node* allocate_node(JSON_Value_Type type)
+{
+    ww::value::Node* value = (ww::value::Node*)ww::arena::allocate(sizeof(ww::value::Node));
+    if (value == NULL)
+        return NULL;
+
+    memset(value, 0, sizeof(ww::value::Node));
+    value->type = type;
+    value->shared = false;
+
+    return value;
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::null_value(void)
+{
+    return &null_node;
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::boolean_value(const bool boolean)
+{
+    ww::value::Node* value = allocate_node(JSONBoolean);
+    if (value != NULL)
+        value->boolean = boolean;
+    return value;
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::number_value(const double number)
+{
+    ww::value::Node* value = allocate_node(JSONNumber);
+    if (value != NULL)
+        value->number = number;
+    return value;
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::string_value(const char* string)
+{
+    if (string == NULL)
+        return NULL;
+
+    const size_t length = strlen(string);
+    char* copy = ww::arena::duplicate(string, length);
+    if (copy == NULL)
+        return NULL;
+
+    return string_value_no_copy(copy, length);
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::string_value_no_copy(const char* string, const size_t length)
+{
+    ww::value::Node* value = allocate_node(JSONString);
+    if (value != NULL)
+    {
+        value->string.data = string;
+        value->string.length = length;
+    }
+    return value;
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::object_value(void)
+{
+    return allocate_node(JSONObject);
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::array_value(void)
+{
+    return allocate_node(JSONArray);
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::share(ww::value::Node* value)
+{
+    if (value != NULL)
+        value->shared = true;
+    return value;
+}
+
+// -----------------------------------------------------------------
+// FNV-1a, only used to find member names
+static uint32_t hash_name(const char* name, const size_t name_length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < name_length; i++)
+    {
+        hash ^= (uint8_t)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// -----------------------------------------------------------------
+static void index_insert(ww::value::Node* object, const size_t position)
+{
+    const size_t mask = object->container.index_size - 1;
+    size_t slot = object->container.members[position].name_hash & mask;
+    while (object->container.index[slot] != 0)
+        slot = (slot + 1) & mask;
+    object->container.index[slot] = (uint32_t)(position + 1);
+}
+
+// -----------------------------------------------------------------
+// the index is kept at most half full, it is rebuilt when it fills up;
+// failure to allocate just leaves the object without an index
+static void build_index(ww::value::Node* object)
+{
+    size_t index_size = 2 * INDEX_THRESHOLD;
+    while (index_size < 2 * object->container.capacity)
+        index_size *= 2;
+
+    uint32_t* index = (uint32_t*)ww::arena::allocate(index_size * sizeof(uint32_t));
+    if (index == NULL)
+    {
+        object->container.index = NULL;
+        object->container.index_size = 0;
+        return;
+    }
+
+    memset(index, 0, index_size * sizeof(uint32_t));
+    object->container.index = index;
+    object->container.index_size = index_size;
+
+    for (size_t i = 0; i < object->container.count; i++)
+        index_insert(object, i);
+}
+
+// -----------------------------------------------------------------
+// members of the copy are referenced from both containers so they are
+// marked shared, the copy itself belongs to the caller
+ww::value::Node* ww::value::node::make_mutable(ww::value::Node* value)
+{
+    if (value == NULL || ! value->shared)
+        return value;
+
+    ww::value::Node* copy = allocate_node(value->type);
+    if (copy == NULL)
+        return NULL;
+
+    if (value->type != JSONObject && value->type != JSONArray)
+    {
+        memcpy(copy, value, sizeof(ww::value::Node));
+        copy->shared = false;
+        return copy;
+    }
+
+    const size_t count = value->container.count;
+    if (count > 0)
+    {
+        copy->container.members = (ww::value::Member*)ww::arena::allocate(count * sizeof(ww::value::Member));
+        if (copy->container.members == NULL)
+            return NULL;
+
+        memcpy(copy->container.members, value->container.members, count * sizeof(ww::value::Member));
+        for (size_t i = 0; i < count; i++)
+            share(copy->container.members[i].value);
+    }
+
+    copy->container.count = count;
+    copy->container.capacity = count;
+
+    if (copy->type == JSONObject && count >= INDEX_THRESHOLD)
+        build_index(copy);
+
+    return copy;
+}
+
+// -----------------------------------------------------------------
+static bool append_member(
+    ww::value::Node* container,
+    const char* name,
+    const size_t name_length,
+    ww::value::Node* value)
+{
+    if (container->container.count == container->container.capacity)
+    {
+        size_t capacity = container->container.capacity * 2;
+        if (capacity < STARTING_CAPACITY)
+            capacity = STARTING_CAPACITY;
+
+        ww::value::Member* members = (ww::value::Member*)ww::arena::allocate(capacity * sizeof(ww::value::Member));
+        if (members == NULL)
+            return false;
+
+        if (container->container.count > 0)
+            memcpy(members, container->container.members, container->container.count * sizeof(ww::value::Member));
+
+        container->container.members = members;
+        container->container.capacity = capacity;
+    }
+
+    const size_t position = container->container.count++;
+    ww::value::Member* member = &container->container.members[position];
+    member->name = name;
+    member->name_length = name_length;
+    member->name_hash = (name == NULL ? 0 : hash_name(name, name_length));
+    member->value = value;
+
+    if (container->type == JSONObject && container->container.count >= INDEX_THRESHOLD)
+    {
+        if (container->container.index == NULL || 2 * container->container.count > container->container.index_size)
+            build_index(container);
+        else
+            index_insert(container, position);
+    }
+
+    return true;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Objects
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+// -----------------------------------------------------------------
+static ww::value::Member* find_member(const ww::value::Node* object, const char* name, const size_t name_length)
+{
+    if (object == NULL || object->type != JSONObject || name == NULL)
+        return NULL;
+
+    const uint32_t name_hash = hash_name(name, name_length);
+
+    if (object->container.index != NULL)
+    {
+        const size_t mask = object->container.index_size - 1;
+        for (size_t slot = name_hash & mask; object->container.index[slot] != 0; slot = (slot + 1) & mask)
+        {
+            ww::value::Member* member = &object->container.members[object->container.index[slot] - 1];
+            if (member->name_hash == name_hash && member->name_length == name_length &&
+                memcmp(member->name, name, name_length) == 0)
+                return member;
+        }
+        return NULL;
+    }
+
+    for (size_t i = 0; i < object->container.count; i++)
+    {
+        ww::value::Member* member = &object->container.members[i];
+        if (member->name_hash == name_hash && member->name_length == name_length &&
+            memcmp(member->name, name, name_length) == 0)
+            return member;
+    }
+
+    return NULL;
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::get_member(const ww::value::Node* object, const char* name, const size_t name_length)
+{
+    ww::value::Member* member = find_member(object, name, name_length);
+    return (member == NULL ? NULL : member->value);
+}
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::dotget_member(const ww::value::Node* object, const char* name)
+{
+    if (name == NULL)
+        return NULL;
+
+    const char* dot_position;
+    while ((dot_position = strchr(name, '.')) != NULL)
+    {
+        object = get_member(object, name, dot_position - name);
+        name = dot_position + 1;
+    }
+
+    return get_member(object, name, strlen(name));
+}
+
+// -----------------------------------------------------------------
+// the object must not be shared, the name must remain valid for the
+// life of the invocation
+bool ww::value::node::set_member(
+    ww::value::Node* object,
+    const char* name,
+    const size_t name_length,
+    ww::value::Node* value)
+{
+    if (object == NULL || object->type != JSONObject || object->shared || name == NULL || value == NULL)
+        return false;
+
+    ww::value::Member* member = find_member(object, name, name_length);
+    if (member != NULL)
+    {
+        member->value = value;
+        return true;
+    }
+
+    return append_member(object, name, name_length, value);
+}
+
+// -----------------------------------------------------------------
+// intermediate objects are created when they do not exist and copied
+// when they are shared; the object pointer is updated if the top level
+// object had to be copied
+bool ww::value::node::dotset_member(ww::value::Node*& object, const char* name, ww::value::Node* value)
+{
+    if (object == NULL || object->type != JSONObject || name == NULL || value == NULL)
+        return false;
+
+    ww::value::Node* current = make_mutable(object);
+    if (current == NULL)
+        return false;
+    object = current;
+
+    const char* dot_position;
+    while ((dot_position = strchr(name, '.')) != NULL)
+    {
+        const size_t name_length = dot_position - name;
+
+        ww::value::Member* member = find_member(current, name, name_length);
+        if (member == NULL)
+        {
+            ww::value::Node* child = object_value();
+            const char* child_name = ww::arena::duplicate(name, name_length);
+            if (child == NULL || child_name == NULL)
+                return false;
+            if (! append_member(current, child_name, name_length, child))
+                return false;
+            current = child;
+        }
+        else
+        {
+            if (member->value->type != JSONObject)
+                return false;
+
+            ww::value::Node* child = make_mutable(member->value);
+            if (child == NULL)
+                return false;
+            member->value = child;
+            current = child;
+        }
+
+        name = dot_position + 1;
+    }
+
+    const size_t name_length = strlen(name);
+    if (find_member(current, name, name_length) == NULL)
+    {
+        name = ww::arena::duplicate(name, name_length);
+        if (name == NULL)
+            return false;
+    }
+
+    return set_member(current, name, name_length, value);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Arrays
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+// -----------------------------------------------------------------
+ww::value::Node* ww::value::node::get_item(const ww::value::Node* array, const size_t index)
+{
+    if (array == NULL || array->type != JSONArray || index >= array->container.count)
+        return NULL;
+
+    return array->container.members[index].value;
+}
+
+// -----------------------------------------------------------------
+bool ww::value::node::replace_item(ww::value::Node*& array, const size_t index, ww::value::Node* value)
+{
+    if (array == NULL || array->type != JSONArray || index >= array->container.count || value == NULL)
+        return false;
+
+    ww::value::Node* current = make_mutable(array);
+    if (current == NULL)
+        return false;
+    array = current;
+
+    current->container.members[index].value = value;
+    return true;
+}
+
+// -----------------------------------------------------------------
+bool ww::value::node::append_item(ww::value::Node*& array, ww::value::Node* value)
+{
+    if (array == NULL || array->type != JSONArray || value == NULL)
+        return false;
+
+    ww::value::Node* current = make_mutable(array);
+    if (current == NULL)
+        return false;
+    array = current;
+
+    return append_member(current, NULL, 0, value);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Parser
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+static ww::value::Node* parse_value(char** cursor, size_t nesting);
+
+#define SKIP_WHITESPACES(c) while (isspace((unsigned char)**(c))) { (*(c))++; }
+
+// -----------------------------------------------------------------
+// decode the string in place; the decoded form is never longer than the
+// encoded form so the closing quote can be overwritten with the null
+static bool parse_string(char** cursor, const char** string, size_t* length)
+{
+    char* input = *cursor + 1;
+    char* output = input;
+    const char* start = input;
+
+    while (*input != '\"')
+    {
+        unsigned char c = (unsigned char)*input;
+        if (c == '\0')
+            return false;
+
+        if (c == '\\')
+        {
+            input++;
+            switch (*input)
+            {
+            case '\"': *output = '\"'; break;
+            case '\\': *output = '\\'; break;
+            case '/':  *output = '/';  break;
+            case 'b':  *output = '\b'; break;
+            case 'f':  *output = '\f'; break;
+            case 'n':  *output = '\n'; break;
+            case 'r':  *output = '\r'; break;
+            case 't':  *output = '\t'; break;
+            default:
+                return false;
+            }
+        }
+        else if (c < 0x20)
+        {
+            return false;
+        }
+        else
+        {
+            *output = *input;
+        }
+
+        output++;
+        input++;
+    }
+
+    *output = '\0';
+    *cursor = input + 1;
+
+    *string = start;
+    *length = output - start;
+    return true;
+}
+
+// -----------------------------------------------------------------
+static bool is_decimal(const char *string, size_t length)
+{
+    if (length > 1 && string[0] == '0' && string[1] != '.')
+        return false;
+    if (length > 2 && strncmp(string, "-0", 2) == 0 && string[2] != '.')
+        return false;
+    while (length--)
+        if (string[length] == 'x' || string[length] == 'X')
+            return false;
+    return true;
+}
+
+// -----------------------------------------------------------------
+static ww::value::Node* parse_number(char** cursor)
+{
+    char* end;
+    double number = strtod(*cursor, &end);
+    if (end == *cursor || ! is_decimal(*cursor, end - *cursor))
+        return NULL;
+
+    *cursor = end;
+    return ww::value::node::number_value(number);
+}
+
+// -----------------------------------------------------------------
+static bool parse_token(char** cursor, const char* token)
+{
+    const size_t length = strlen(token);
+    if (strncmp(*cursor, token, length) != 0)
+        return false;
+
+    *cursor += length;
+    return true;
+}
+
+// -----------------------------------------------------------------
+static ww::value::Node* parse_object(char** cursor, size_t nesting)
+{
+    ww::value::Node* object = ww::value::node::object_value();
+    if (object == NULL)
+        return NULL;
+
+    (*cursor)++;
+    SKIP_WHITESPACES(cursor);
+    if (**cursor == '}')
+    {
+        (*cursor)++;
+        return object;
+    }
+
+    while (**cursor != '\0')
+    {
+        const char* name;
+        size_t name_length;
+
+        if (**cursor != '\"' || ! parse_string(cursor, &name, &name_length))
+            return NULL;
+
+        SKIP_WHITESPACES(cursor);
+        if (**cursor != ':')
+            return NULL;
+        (*cursor)++;
+
+        ww::value::Node* value = parse_value(cursor, nesting);
+        if (value == NULL)
+            return NULL;
+
+        if (find_member(object, name, name_length) != NULL)
+            return NULL;
+        if (! append_member(object, name, name_length, value))
+            return NULL;
+
+        SKIP_WHITESPACES(cursor);
+        if (**cursor != ',')
+            break;
+        (*cursor)++;
+        SKIP_WHITESPACES(cursor);
+    }
+
+    SKIP_WHITESPACES(cursor);
+    if (**cursor != '}')
+        return NULL;
+    (*cursor)++;
+
+    return object;
+}
+
+// -----------------------------------------------------------------
+static ww::value::Node* parse_array(char** cursor, size_t nesting)
+{
+    ww::value::Node* array = ww::value::node::array_value();
+    if (array == NULL)
+        return NULL;
+
+    (*cursor)++;
+    SKIP_WHITESPACES(cursor);
+    if (**cursor == ']')
+    {
+        (*cursor)++;
+        return array;
+    }
+
+    while (**cursor != '\0')
+    {
+        ww::value::Node* value = parse_value(cursor, nesting);
+        if (value == NULL)
+            return NULL;
+
+        if (! append_member(array, NULL, 0, value))
+            return NULL;
+
+        SKIP_WHITESPACES(cursor);
+        if (**cursor != ',')
+            break;
+        (*cursor)++;
+        SKIP_WHITESPACES(cursor);
+    }
+
+    SKIP_WHITESPACES(cursor);
+    if (**cursor != ']')
+        return NULL;
+    (*cursor)++;
+
+    return array;
+}
+
+// -----------------------------------------------------------------
+static ww::value::Node* parse_value(char** cursor, size_t nesting)
+{
+    if (nesting > MAX_NESTING)
+        return NULL;
+
+    SKIP_WHITESPACES(cursor);
+    switch (**cursor)
+    {
+    case '{':
+        return parse_object(cursor, nesting + 1);
+
+    case '[':
+        return parse_array(cursor, nesting + 1);
+
+    case '\"':
+    {
+        const char* string;
+        size_t length;
+        if (! parse_string(cursor, &string, &length))
+            return NULL;
+        return ww::value::node::string_value_no_copy(string, length);
+    }
+
+    case 't':
+        return parse_token(cursor, "true") ? ww::value::node::boolean_value(true) : NULL;
+
+    case 'f':
+        return parse_token(cursor, "false") ? ww::value::node::boolean_value(false) : NULL;
+
+    case 'n':
+        return parse_token(cursor, "null") ? ww::value::node::null_value() : NULL;
+
+    case '-':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        return parse_number(cursor);
+
+    default:
+        return NULL;
+    }
+}
+
+// -----------------------------------------------------------------
+// the source is copied into the arena once, strings in the result point
+// into the copy so the caller may release the source immediately
+ww::value::Node* ww::value::node::parse(const char* source)
+{
+    if (source == NULL)
+        return NULL;
+
+    char* cursor = ww::arena::duplicate(source, strlen(source));
+    if (cursor == NULL)
+        return NULL;
+
+    return parse_value(&cursor, 0);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Serializer
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+// -----------------------------------------------------------------
+static void append(char** buffer, size_t* written, const char* data, const size_t length)
+{
+    if (*buffer != NULL)
+    {
+        memcpy(*buffer, data, length);
+        *buffer += length;
+    }
+    *written += length;
+}
+
+// -----------------------------------------------------------------
+static void serialize_string(char** buffer, size_t* written, const char* string, const size_t length)
+{
+    append(buffer, written, "\"", 1);
+
+    // copy runs of characters that need no escape in one step
+    size_t run = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        const char* escape = NULL;
+        switch (string[i])
+        {
+        case '\"': escape = "\\\""; break;
+        case '\\': escape = "\\\\"; break;
+        case '\b': escape = "\\b"; break;
+        case '\f': escape = "\\f"; break;
+        case '\n': escape = "\\n"; break;
+        case '\r': escape = "\\r"; break;
+        case '\t': escape = "\\t"; break;
+        default:
+            continue;
+        }
+
+        append(buffer, written, string + run, i - run);
+        append(buffer, written, escape, 2);
+        run = i + 1;
+    }
+    append(buffer, written, string + run, length - run);
+
+    append(buffer, written, "\"", 1);
+}
+
+// -----------------------------------------------------------------
+static void serialize_number(char** buffer, size_t* written, const double number)
+{
+    char number_buffer[NUMBER_BUFFER_SIZE];
+    int length;
+
+    if (number >= (double)INT_MIN && number <= (double)INT_MAX && number == (double)(int)number)
+        length = snprintf(number_buffer, sizeof(number_buffer), "%d", (int)number);
+    else
+        length = snprintf(number_buffer, sizeof(number_buffer), "%f", number);
+
+    if (length < 0)
+        length = 0;
+    if ((size_t)length >= sizeof(number_buffer))
+        length = sizeof(number_buffer) - 1;
+
+    append(buffer, written, number_buffer, length);
+}
+
+// -----------------------------------------------------------------
+static void serialize_value(const ww::value::Node* value, char** buffer, size_t* written)
+{
+    switch (value->type)
+    {
+    case JSONObject:
+        append(buffer, written, "{", 1);
+        for (size_t i = 0; i < value->container.count; i++)
+        {
+            const ww::value::Member* member = &value->container.members[i];
+            if (i > 0)
+                append(buffer, written, ",", 1);
+            serialize_string(buffer, written, member->name, member->name_length);
+            append(buffer, written, ":", 1);
+            serialize_value(member->value, buffer, written);
+        }
+        append(buffer, written, "}", 1);
+        break;
+
+    case JSONArray:
+        append(buffer, written, "[", 1);
+        for (size_t i = 0; i < value->container.count; i++)
+        {
+            if (i > 0)
+                append(buffer, written, ",", 1);
+            serialize_value(value->container.members[i].value, buffer, written);
+        }
+        append(buffer, written, "]", 1);
+        break;
+
+    case JSONString:
+        serialize_string(buffer, written, value->string.data, value->string.length);
+        break;
+
+    case JSONNumber:
+        serialize_number(buffer, written, value->number);
+        break;
+
+    case JSONBoolean:
+        if (value->boolean)
+            append(buffer, written, "true", 4);
+        else
+            append(buffer, written, "false", 5);
+        break;
+
+    default:
+        append(buffer, written, "null", 4);
+        break;
+    }
+}
+
+// -----------------------------------------------------------------
+size_t ww::value::node::serialize(const ww::value::Node* value, char* buffer)
+{
+    if (value == NULL)
+        return 0;
+
+    size_t written = 0;
+    serialize_value(value, &buffer, &written);
+    if (buffer != NULL)
+        *buffer = '\0';
+
+    return written;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Schema validation
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+// -----------------------------------------------------------------
+// same rules as json_validate: null in the schema matches any value, an
+// empty array or object matches any array or object, the first item of
+// a schema array applies to every item of the value and every key of a
+// schema object must be present in the value
+bool ww::value::node::validate(const ww::value::Node* schema, const ww::value::Node* value)
+{
+    if (schema == NULL || value == NULL)
+        return false;
+
+    if (schema->type != value->type && schema->type != JSONNull)
+        return false;
+
+    switch (schema->type)
+    {
+    case JSONArray:
+        if (schema->container.count == 0)
+            return true;
+        for (size_t i = 0; i < value->container.count; i++)
+            if (! validate(schema->container.members[0].value, value->container.members[i].value))
+                return false;
+        return true;
+
+    case JSONObject:
+        if (schema->container.count == 0)
+            return true;
+        if (value->container.count < schema->container.count)
+            return false;
+        for (size_t i = 0; i < schema->container.count; i++)
+        {
+            const ww::value::Member* member = &schema->container.members[i];
+            const ww::value::Node* v = get_member(value, member->name, member->name_length);
+            if (v == NULL || ! validate(member->value, v))
+                return false;
+        }
+        return true;
+
+    case JSONString:
+    case JSONNumber:
+    case JSONBoolean:
+    case JSONNull:
+        return true;
+
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,108 @@
+/* Copyright 2023 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "parson.h"
+
+// Nodes are the storage behind ww::value::Value. All nodes and strings
+// live in the invocation arena so nothing is ever freed explicitly.
+// Parsing copies the input once into the arena and decodes strings in
+// place, string nodes point into that copy.
+//
+// Objects with more than a few members keep a hash index of their
+// member names so lookups and duplicate checks stay constant time.
+//
+// Nodes may be referenced from several values or containers. A node is
+// marked shared the first time a second reference is handed out and a
+// shared container is copied (shallow) before it is modified; scalar
+// nodes are never modified.
+namespace ww
+{
+namespace value
+{
+    struct Node;
+
+    struct Member
+    {
+        const char* name;       // NULL for array items
+        size_t name_length;
+        uint32_t name_hash;
+        Node* value;
+    };
+
+    struct Node
+    {
+        JSON_Value_Type type;
+        bool shared;
+
+        union
+        {
+            bool boolean;
+            double number;
+            struct
+            {
+                const char* data;
+                size_t length;
+            } string;
+            struct
+            {
+                Member* members;
+                size_t count;
+                size_t capacity;
+                uint32_t* index;        // object member positions + 1, NULL for small objects
+                size_t index_size;      // power of two
+            } container;
+        };
+    };
+
+namespace node
+{
+    Node* null_value(void);
+    Node* boolean_value(const bool value);
+    Node* number_value(const double value);
+    Node* string_value(const char* value);
+    Node* string_value_no_copy(const char* value, const size_t length);
+    Node* object_value(void);
+    Node* array_value(void);
+
+    // returns a node that is not shared, copying the members of a shared container
+    Node* make_mutable(Node* value);
+    Node* share(Node* value);
+
+    Node* parse(const char* source);
+
+    // returns the number of bytes in the serialized value not including the
+    // terminating null, the buffer may be NULL to compute the size
+    size_t serialize(const Node* value, char* buffer);
+
+    bool validate(const Node* schema, const Node* value);
+
+    // objects
+    Node* get_member(const Node* object, const char* name, const size_t name_length);
+    Node* dotget_member(const Node* object, const char* name);
+    bool set_member(Node* object, const char* name, const size_t name_length, Node* value);
+    bool dotset_member(Node*& object, const char* name, Node* value);
+
+    // arrays
+    Node* get_item(const Node* array, const size_t index);
+    bool replace_item(Node*& array, const size_t index, Node* value);
+    bool append_item(Node*& array, Node* value);
+};
+};
+}
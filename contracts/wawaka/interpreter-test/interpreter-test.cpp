@@ -15,15 +15,19 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "Types.h"
 #include "Dispatch.h"
 
+#include "Arena.h"
 #include "Cryptography.h"
 #include "Environment.h"
 #include "KeyValue.h"
 #include "Message.h"
 #include "Response.h"
+#include "Util.h"
 #include "Value.h"
 #include "WasmExtensions.h"
 
@@ -406,6 +410,236 @@ bool privileged_test_get(const Message& msg, const Environment& env, Response& r
     return rsp.success(false);
 }
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// NAME: loop_test
+//
+// iterate a linear congruential generator, the work grows with the
+// number of iterations and cannot be folded away by the compiler
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+bool loop_test(const Message& msg, const Environment& env, Response& rsp)
+{
+    const uint32_t iterations = (uint32_t)msg.get_number("iterations");
+
+    uint32_t value = 1;
+    for (uint32_t i = 0; i < iterations; i++)
+        value = value * 1103515245 + 12345;
+
+    ww::value::Number v((double)value);
+    return rsp.value(v, false);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// NAME: string_test
+//
+// test the native memory and string operations from Util.h
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+bool string_test(const Message& msg, const Environment& env, Response& rsp)
+{
+    const ww::types::ByteArray abc{'a', 'b', 'c'};
+    const ww::types::ByteArray abd{'a', 'b', 'd'};
+    const ww::types::ByteArray ab{'a', 'b'};
+    const ww::types::ByteArray empty;
+
+    // compare
+    int result;
+    ASSERT_SUCCESS(rsp, ww::util::compare(abc, abd, result) && result == -1, "failed to order buffers");
+    ASSERT_SUCCESS(rsp, ww::util::compare(abd, abc, result) && result == 1, "failed to order buffers");
+    ASSERT_SUCCESS(rsp, ww::util::compare(ab, abc, result) && result == -1, "failed to order a prefix");
+    ASSERT_SUCCESS(rsp, ww::util::compare(abc, abc, result) && result == 0, "failed to match buffers");
+    ASSERT_SUCCESS(rsp, ww::util::compare(empty, empty, result) && result == 0, "failed to match empty buffers");
+
+    // find
+    size_t offset;
+    const std::string haystack("one two three two");
+    ASSERT_SUCCESS(rsp, ww::util::find(haystack, std::string("two"), offset) && offset == 4, "failed to find pattern");
+    ASSERT_SUCCESS(rsp, ! ww::util::find(haystack, std::string("four"), offset), "found missing pattern");
+
+    // sort records of two bytes by the second byte
+    ww::types::ByteArray records{'a', 3, 'b', 1, 'c', 3, 'd', 2};
+    const ww::types::ByteArray sorted{'b', 1, 'd', 2, 'a', 3, 'c', 3};
+    ASSERT_SUCCESS(rsp, ww::util::sort_records(records, 2, 1, 1), "failed to sort records");
+    ASSERT_SUCCESS(rsp, records == sorted, "records sorted in the wrong order");
+    ASSERT_SUCCESS(rsp, ! ww::util::sort_records(records, 3, 1, 1), "sorted a partial record");
+
+    // parse and format integers
+    int64_t value;
+    ASSERT_SUCCESS(rsp, ww::util::parse_integer("-1234", value) && value == -1234, "failed to parse integer");
+    ASSERT_SUCCESS(rsp, ww::util::parse_integer("7fFF", value, 16) && value == 0x7fff, "failed to parse hex integer");
+    ASSERT_SUCCESS(rsp, ! ww::util::parse_integer("", value), "parsed an empty string");
+    ASSERT_SUCCESS(rsp, ! ww::util::parse_integer("-", value), "parsed a sign without digits");
+    ASSERT_SUCCESS(rsp, ! ww::util::parse_integer(" 12", value), "parsed leading whitespace");
+    ASSERT_SUCCESS(rsp, ! ww::util::parse_integer("12 ", value), "parsed trailing whitespace");
+    ASSERT_SUCCESS(rsp, ! ww::util::parse_integer("+12", value), "parsed a plus sign");
+    ASSERT_SUCCESS(rsp, ! ww::util::parse_integer("0x12", value, 16), "parsed a hex prefix");
+    ASSERT_SUCCESS(rsp, ! ww::util::parse_integer("19", value, 8), "parsed a digit outside the base");
+    ASSERT_SUCCESS(rsp, ! ww::util::parse_integer("9223372036854775808", value), "parsed an overflow");
+
+    std::string formatted;
+    ASSERT_SUCCESS(rsp, ww::util::format_integer(-255, formatted, 16) && formatted == "-ff", "failed to format integer");
+    ASSERT_SUCCESS(rsp, ww::util::format_integer(INT64_MIN, formatted), "failed to format minimum");
+    ASSERT_SUCCESS(rsp, ww::util::parse_integer(formatted, value) && value == INT64_MIN, "failed to parse minimum");
+
+    // hex and base64 encoding
+    std::string encoded;
+    ww::types::ByteArray decoded;
+    const ww::types::ByteArray binary{0x00, 0x7f, 0x80, 0xff};
+    ASSERT_SUCCESS(rsp, ww::util::hex_encode(binary, encoded) && encoded == "007F80FF", "failed to hex encode");
+    ASSERT_SUCCESS(rsp, ww::util::hex_decode("007f80FF", decoded) && decoded == binary, "failed to hex decode");
+    ASSERT_SUCCESS(rsp, ! ww::util::hex_decode("007", decoded), "decoded odd length hex");
+    ASSERT_SUCCESS(rsp, ! ww::util::hex_decode("0g", decoded), "decoded invalid hex");
+
+    ASSERT_SUCCESS(rsp, ww::crypto::b64_encode(binary, encoded) && encoded == "AH+A/w==", "failed to b64 encode");
+    ASSERT_SUCCESS(rsp, ww::crypto::b64_decode(encoded, decoded) && decoded == binary, "failed to b64 decode");
+
+    return rsp.success(true);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// NAME: value_test
+//
+// test the json parser, serializer and containers behind ww::value;
+// the expected results are the ones parson produced
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static bool nested_arrays(const size_t depth, std::string& result)
+{
+    result = std::string(depth, '[') + std::string(depth, ']');
+
+    ww::value::Array parsed;
+    return parsed.deserialize(result.c_str());
+}
+
+bool value_test(const Message& msg, const Environment& env, Response& rsp)
+{
+    std::string serialized;
+
+    // string escapes round trip, \u escapes are not supported
+    {
+        ww::value::Object object;
+        ASSERT_SUCCESS(rsp, object.set_string("s", "q\"b\\s/n\nt\tr\rb\bf\f"), "failed to set string");
+        ASSERT_SUCCESS(rsp, object.serialize(serialized), "failed to serialize escapes");
+        ASSERT_SUCCESS(rsp, serialized == "{\"s\":\"q\\\"b\\\\s/n\\nt\\tr\\rb\\bf\\f\"}", "wrong escapes");
+
+        ww::value::Object parsed;
+        ASSERT_SUCCESS(rsp, parsed.deserialize("{\"s\":\"q\\\"b\\\\s\\/n\\nt\\tr\\rb\\bf\\f\"}"), "failed to parse escapes");
+        ASSERT_SUCCESS(rsp, strcmp(parsed.get_string("s"), object.get_string("s")) == 0, "wrong unescaped string");
+
+        ASSERT_SUCCESS(rsp, ! parsed.deserialize("{\"s\":\"\\u0041\"}"), "parsed a unicode escape");
+        ASSERT_SUCCESS(rsp, ! parsed.deserialize("{\"s\":\"\\x\"}"), "parsed an invalid escape");
+        ASSERT_SUCCESS(rsp, ! parsed.deserialize("{\"s\":\"a\tb\"}"), "parsed a control character");
+    }
+
+    // duplicate keys are rejected
+    {
+        ww::value::Object parsed;
+        ASSERT_SUCCESS(rsp, ! parsed.deserialize("{\"a\":1,\"a\":2}"), "parsed a duplicate key");
+        ASSERT_SUCCESS(rsp, parsed.deserialize("{\"a\":{\"a\":1},\"b\":[{\"a\":2}]}"), "failed to parse nested keys");
+    }
+
+    // containers nest at most 20 deep
+    ASSERT_SUCCESS(rsp, nested_arrays(20, serialized), "failed to parse 20 nested arrays");
+    ASSERT_SUCCESS(rsp, ! nested_arrays(21, serialized), "parsed 21 nested arrays");
+
+    // integers in int range use %d, every other number %f
+    {
+        ww::value::Array array;
+        array.append_number(42);
+        array.append_number(-2147483648.0);
+        array.append_number(2147483648.0);
+        array.append_number(1.5);
+        array.append_number(-0.25);
+        ASSERT_SUCCESS(rsp, array.serialize(serialized), "failed to serialize numbers");
+        ASSERT_SUCCESS(rsp, serialized == "[42,-2147483648,2147483648.000000,1.500000,-0.250000]", "wrong number format");
+
+        ww::value::Array parsed;
+        ASSERT_SUCCESS(rsp, parsed.deserialize("[1e3,-0.5,0.25]"), "failed to parse numbers");
+        ASSERT_SUCCESS(rsp, parsed.get_number(0) == 1000 && parsed.get_number(1) == -0.5, "wrong parsed numbers");
+        ASSERT_SUCCESS(rsp, ! parsed.deserialize("[01]"), "parsed a leading zero");
+        ASSERT_SUCCESS(rsp, ! parsed.deserialize("[0x10]"), "parsed a hex number");
+    }
+
+    // modifying a copy or a nested object does not change the original
+    {
+        ww::value::Object original;
+        ASSERT_SUCCESS(rsp, original.deserialize("{\"a\":{\"b\":{\"c\":1}},\"d\":[1]}"), "failed to parse object");
+
+        ww::value::Object copy(original);
+        ASSERT_SUCCESS(rsp, copy.set_number("a.b.c", 2), "failed to set nested value");
+        ASSERT_SUCCESS(rsp, copy.set_number("a.e.f", 3), "failed to create nested value");
+        ASSERT_SUCCESS(rsp, original.get_number("a.b.c") == 1, "modified the original object");
+        ASSERT_SUCCESS(rsp, copy.get_number("a.b.c") == 2 && copy.get_number("a.e.f") == 3, "wrong copied values");
+
+        ww::value::Object nested;
+        ASSERT_SUCCESS(rsp, original.get_value("a", nested), "failed to get nested object");
+        ASSERT_SUCCESS(rsp, nested.set_number("b.c", 4), "failed to set shared value");
+        ASSERT_SUCCESS(rsp, original.get_number("a.b.c") == 1, "modified a shared object");
+
+        ww::value::Array items;
+        ASSERT_SUCCESS(rsp, original.get_value("d", items), "failed to get nested array");
+        ASSERT_SUCCESS(rsp, items.append_number(2) && items.get_count() == 2, "failed to append item");
+        ASSERT_SUCCESS(rsp, original.serialize(serialized), "failed to serialize original");
+        ASSERT_SUCCESS(rsp, serialized == "{\"a\":{\"b\":{\"c\":1}},\"d\":[1]}", "modified a shared array");
+
+        ASSERT_SUCCESS(rsp, ! copy.set_number("d.x", 1), "set a member of an array");
+    }
+
+    // large objects are indexed, member order is preserved
+    {
+        ww::value::Object object;
+        std::string expected("{");
+        char name[16];
+        for (int i = 0; i < 40; i++)
+        {
+            snprintf(name, sizeof(name), "k%d", i);
+            ASSERT_SUCCESS(rsp, object.set_number(name, i), "failed to set member");
+            expected += (i > 0 ? ",\"" : "\"") + std::string(name) + "\":" + std::to_string(i);
+        }
+        expected += "}";
+
+        ASSERT_SUCCESS(rsp, object.set_number("k7", 70), "failed to replace member");
+        ASSERT_SUCCESS(rsp, object.get_number("k7") == 70 && object.get_number("k39") == 39, "wrong member values");
+        ASSERT_SUCCESS(rsp, object.set_number("k7", 7), "failed to restore member");
+        ASSERT_SUCCESS(rsp, object.serialize(serialized) && serialized == expected, "wrong member order");
+
+        ww::value::Object parsed;
+        ASSERT_SUCCESS(rsp, parsed.deserialize(expected.c_str()), "failed to parse large object");
+        ASSERT_SUCCESS(rsp, parsed.get_number("k33") == 33, "wrong parsed member");
+        ww::value::Number missing;
+        ASSERT_SUCCESS(rsp, ! parsed.get_value("k40", missing), "found a missing member");
+
+        std::string duplicate = expected.substr(0, expected.size() - 1) + ",\"k20\":0}";
+        ASSERT_SUCCESS(rsp, ! parsed.deserialize(duplicate.c_str()), "parsed a duplicate key in a large object");
+
+        ww::value::Object copy(parsed);
+        ASSERT_SUCCESS(rsp, copy.set_number("k41", 41), "failed to extend a shared large object");
+        ASSERT_SUCCESS(rsp, copy.get_number("k41") == 41 && parsed.get_number("k41") == 0, "modified the original large object");
+    }
+
+    // schemas
+    {
+        ww::value::Object object;
+        ASSERT_SUCCESS(rsp, object.deserialize("{\"a\":1,\"b\":[\"x\",\"y\"],\"c\":{}}"), "failed to parse object");
+        ASSERT_SUCCESS(rsp, object.validate_schema("{\"a\":0,\"b\":[\"\"]}"), "failed to validate schema");
+        ASSERT_SUCCESS(rsp, object.validate_schema("{\"c\":null}"), "failed to validate null schema");
+        ASSERT_SUCCESS(rsp, ! object.validate_schema("{\"a\":\"\"}"), "validated the wrong type");
+        ASSERT_SUCCESS(rsp, ! object.validate_schema("{\"b\":[0]}"), "validated the wrong item type");
+        ASSERT_SUCCESS(rsp, ! object.validate_schema("{\"z\":0}"), "validated a missing member");
+    }
+
+    // storage allocated inside a scope is released when the scope closes
+    {
+        const size_t allocated = ww::arena::bytes_allocated();
+        for (int i = 0; i < 1000; i++)
+        {
+            ww::arena::Scope scope;
+            ww::value::Object parsed;
+            ASSERT_SUCCESS(rsp, parsed.deserialize("{\"a\":[1,2,3],\"b\":\"value\"}"), "failed to parse in a scope");
+        }
+        ASSERT_SUCCESS(rsp, ww::arena::bytes_allocated() == allocated, "scope did not release storage");
+    }
+
+    return rsp.success(true);
+}
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 contract_method_reference_t contract_method_dispatch_table[] = {
@@ -416,5 +650,8 @@ contract_method_reference_t contract_method_dispatch_table[] = {
     CONTRACT_METHOD(kv_test_set),
     CONTRACT_METHOD(kv_test_get),
     CONTRACT_METHOD(privileged_test_get),
+    CONTRACT_METHOD(loop_test),
+    CONTRACT_METHOD(string_test),
+    CONTRACT_METHOD(value_test),
     { NULL, NULL }
 };
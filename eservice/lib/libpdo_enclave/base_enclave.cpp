@@ -48,6 +48,11 @@ pdo_err_t ecall_Initialize()
     // since it can break confidentiality of contract execution
     SAFE_LOG(PDO_LOG_CRITICAL, "enclave initialized with debugging turned on");
 
+    // tracing stays off until the first flush reports that the host collects
+    // traces; without ENCLAVE_TRACE it never turns on
+    pdo::trace::SetClockFunction(trusted_wrapper_ocall_GetTraceTimestamp);
+    pdo::trace::SetFlushFunction(trusted_wrapper_ocall_TraceFlush);
+
     return result;
 }  // ecall_Initialize
 
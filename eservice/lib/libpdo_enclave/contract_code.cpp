@@ -159,19 +159,13 @@ void ContractCode::ComputeHash(ByteArray& final_hash) const
     // to use the nonce plus the registered code hash to verify
     // the actual hash of the code. that means a contract can
     // check the code hash of the other end of a secure connection
-    ByteArray code_message;
-    code_message.reserve(code_.length() + name_.length());
-    std::copy(code_.begin(), code_.end(), std::back_inserter(code_message));
-    std::copy(name_.begin(), name_.end(), std::back_inserter(code_message));
-    ByteArray code_hash = pdo::crypto::ComputeMessageHash(code_message);
+    pdo::crypto::Hasher hasher;
 
-    ByteArray nonce_message(nonce_.begin(), nonce_.end());
-    ByteArray nonce_hash = pdo::crypto::ComputeMessageHash(nonce_message);
+    ByteArray code_hash;
+    hasher.Update(code_).Update(name_).Final(code_hash);
 
-    ByteArray message;
-    message.reserve(code_hash.size() + nonce_hash.size());
-    std::copy(code_hash.begin(), code_hash.end(), std::back_inserter(message));
-    std::copy(nonce_hash.begin(), nonce_hash.end(), std::back_inserter(message));
+    ByteArray nonce_hash;
+    hasher.Update(nonce_).Final(nonce_hash);
 
-    final_hash = pdo::crypto::ComputeMessageHash(message);
+    hasher.Update(code_hash).Update(nonce_hash).Final(final_hash);
 }
@@ -26,6 +26,7 @@
 #include "error.h"
 #include "packages/base64/base64.h"
 #include "pdo_error.h"
+#include "resource_counters.h"
 #include "timer.h"
 #include "types.h"
 #include "zero.h"
@@ -43,6 +44,11 @@
 #include "contract_secrets.h"
 
 ByteArray last_result;
+
+// the contract id is public, the counters for the last request are
+// released to the host for per contract accounting
+std::string last_usage_contract_id;
+pdo_resource_counters_t last_usage = {};
 ContractWorker *worker = NULL;
 static bool worker_initialized = false;
 static bool shutdown_worker = false;
@@ -96,6 +102,8 @@ pdo_err_t ecall_ShutdownContractWorker(){
         worker->MarkInterpreterDone();
     }
 
+    ClearStateEncryptionKeyCache();
+
     return result;
 }
 
@@ -201,6 +209,10 @@ pdo_err_t ecall_VerifySecrets(const uint8_t* inSealedSignupData,
         memcpy_s(outEncryptedContractKeySignature, inEncryptedContractKeySignatureMaxLength,
             signature.data(), signature.size());
         *outEncryptedContractKeySignatureActualLength=signature.size();
+
+        // the contract is provisioned with a new sealed key, keys cached
+        // for earlier sealed keys of the contract are dropped
+        InvalidateStateEncryptionKey(contractId);
     }
     catch (pdo::error::Error& e)
     {
@@ -241,6 +253,8 @@ pdo_err_t ecall_HandleContractRequest(
         // Unseal the enclave persistent data
         EnclaveData enclaveData(inSealedSignupData);
 
+        pdo::trace::Span decrypt_span(PDO_TRACE_REQUEST_DECRYPT);
+
         ByteArray encrypted_key(
             inEncryptedSessionKey, inEncryptedSessionKey + inEncryptedSessionKeySize);
         ByteArray session_key = enclaveData.decrypt_message(encrypted_key);
@@ -249,6 +263,10 @@ pdo_err_t ecall_HandleContractRequest(
             inSerializedRequest, inSerializedRequest + inSerializedRequestSize);
         UpdateStateRequest request(session_key, encrypted_request, worker);
 
+        decrypt_span.End();
+
+        pdo::trace::Span state_open_span(PDO_TRACE_STATE_OPEN);
+
         ContractState contract_state(
             request.state_encryption_key_,
             request.input_state_hash_,
@@ -257,7 +275,26 @@ pdo_err_t ecall_HandleContractRequest(
         // IN PROGRESS: this is the one change
         request.contract_code_.FetchFromState(contract_state, request.code_hash_);
 
+        state_open_span.End();
+
+        // only the accesses made by the contract are tracked, reads of the
+        // contract metadata and code are common to every invocation
+        contract_state.state_.TrackAccess(request.report_access_sets_);
+
         std::shared_ptr<ContractResponse> response(request.process_request(contract_state));
+
+        if (request.report_access_sets_)
+            contract_state.state_.GetAccessSets(response->read_set_, response->write_set_);
+
+        // the state counters include the work done to open and finalize the state
+        pdo::resource::Accumulate(response->resource_counters_, contract_state.state_.ResourceCounters());
+
+        // the interpreter sampled the heap when the contract returned, the
+        // state and the response are still held at this point
+        pdo::resource::SampleHeap(response->resource_counters_);
+        last_usage_contract_id = request.contract_id_;
+        last_usage = response->resource_counters_;
+
         last_result = response->SerializeAndEncrypt(session_key, enclaveData);
 
         // save the response and return the size of the buffer required for it
@@ -277,6 +314,9 @@ pdo_err_t ecall_HandleContractRequest(
         result = PDO_ERR_UNKNOWN;
     }
 
+    // all the spans recorded for the request leave the enclave in one ocall
+    pdo::trace::Flush();
+
     return result;
 }
 
@@ -303,6 +343,8 @@ pdo_err_t ecall_InitializeContractState(
         // Unseal the enclave persistent data
         EnclaveData enclaveData(inSealedSignupData);
 
+        pdo::trace::Span decrypt_span(PDO_TRACE_REQUEST_DECRYPT);
+
         ByteArray encrypted_key(
             inEncryptedSessionKey, inEncryptedSessionKey + inEncryptedSessionKeySize);
         ByteArray session_key = enclaveData.decrypt_message(encrypted_key);
@@ -311,14 +353,31 @@ pdo_err_t ecall_InitializeContractState(
             inSerializedRequest, inSerializedRequest + inSerializedRequestSize);
         InitializeStateRequest request(session_key, encrypted_request, worker);
 
+        decrypt_span.End();
+
+        pdo::trace::Span state_open_span(PDO_TRACE_STATE_OPEN);
+
         ContractState contract_state(
             request.state_encryption_key_,
-            request.contract_id_hash_);
+            request.contract_id_hash_,
+            request.state_layout_);
 
         // IN PROGRESS: this is the one change
         request.contract_code_.SaveToState(contract_state);
 
+        state_open_span.End();
+
         std::shared_ptr<ContractResponse> response(request.process_request(contract_state));
+
+        // the state counters include the work done to open and finalize the state
+        pdo::resource::Accumulate(response->resource_counters_, contract_state.state_.ResourceCounters());
+
+        // the interpreter sampled the heap when the contract returned, the
+        // state and the response are still held at this point
+        pdo::resource::SampleHeap(response->resource_counters_);
+        last_usage_contract_id = request.contract_id_;
+        last_usage = response->resource_counters_;
+
         last_result = response->SerializeAndEncrypt(session_key, enclaveData);
 
         // save the response and return the size of the buffer required for it
@@ -338,6 +397,9 @@ pdo_err_t ecall_InitializeContractState(
         result = PDO_ERR_UNKNOWN;
     }
 
+    // all the spans recorded for the request leave the enclave in one ocall
+    pdo::trace::Flush();
+
     return result;
 }
 
@@ -378,3 +440,43 @@ pdo_err_t ecall_GetSerializedResponse(const uint8_t* inSealedSignupData,
 
     return result;
 }
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+pdo_err_t ecall_GetResourceUsage(
+    char* outContractId,
+    size_t inContractIdSize,
+    uint8_t* outResourceCounters,
+    size_t inResourceCountersSize)
+{
+    pdo_err_t result = PDO_SUCCESS;
+
+    try
+    {
+        pdo::error::ThrowIfNull(outContractId, "Contract ID pointer is NULL");
+        pdo::error::ThrowIfNull(outResourceCounters, "Resource counters pointer is NULL");
+        pdo::error::ThrowIf<pdo::error::ValueError>(
+            inContractIdSize < last_usage_contract_id.size() + 1, "Not enough space for the contract id");
+        pdo::error::ThrowIf<pdo::error::ValueError>(
+            inResourceCountersSize != sizeof(pdo_resource_counters_t), "Invalid size for the resource counters");
+
+        Zero(outContractId, inContractIdSize);
+        memcpy_s(outContractId, inContractIdSize,
+            last_usage_contract_id.c_str(), last_usage_contract_id.size());
+        memcpy_s(outResourceCounters, inResourceCountersSize, &last_usage, sizeof(last_usage));
+    }
+    catch (pdo::error::Error& e)
+    {
+        SAFE_LOG(PDO_LOG_ERROR,
+            "Error in contract enclave(ecall_GetResourceUsage): %04X -- %s", e.error_code(),
+            e.what());
+        ocall_SetErrorMessage(e.what());
+        result = e.error_code();
+    }
+    catch (...)
+    {
+        SAFE_LOG(PDO_LOG_ERROR, "Unknown error in contract enclave (ecall_GetResourceUsage)");
+        result = PDO_ERR_UNKNOWN;
+    }
+
+    return result;
+}
@@ -62,3 +62,9 @@ extern pdo_err_t ecall_GetSerializedResponse(const uint8_t* inSealedSignupData,
     size_t inSealedSignupDataSize,
     char* outSerializedResponse,
     size_t inSerializedResponseSize);
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+extern pdo_err_t ecall_GetResourceUsage(char* outContractId,
+    size_t inContractIdSize,
+    uint8_t* outResourceCounters,
+    size_t inResourceCountersSize);
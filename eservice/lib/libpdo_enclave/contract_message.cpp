@@ -83,7 +83,6 @@ void ContractMessage::Unpack(const JSON_Object* object)
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 void ContractMessage::ComputeHash(ByteArray& message_hash) const
 {
-    std::string serialized = expression_ + nonce_;
-    ByteArray message(serialized.begin(), serialized.end());
-    message_hash = pdo::crypto::ComputeMessageHash(message);
+    pdo::crypto::Hasher hasher;
+    hasher.Update(expression_).Update(nonce_).Final(message_hash);
 }
@@ -40,6 +40,29 @@
 // See ${PDO_SOURCE_ROOT}/eservice/docs/contract.json for format
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Adds the interpreter counters to the request when the scope exits so
+// that failed invocations are accounted for as well; it must be declared
+// after the InitializedInterpreter so it runs before the interpreter is
+// released
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+class InterpreterResourceCollector
+{
+public:
+    const pdo::contracts::ContractInterpreter* interpreter_;
+    pdo_resource_counters_t& counters_;
+
+    InterpreterResourceCollector(
+        const pdo::contracts::ContractInterpreter* interpreter,
+        pdo_resource_counters_t& counters) :
+        interpreter_(interpreter), counters_(counters) {}
+
+    ~InterpreterResourceCollector(void)
+    {
+        pdo::resource::Accumulate(counters_, interpreter_->ResourceCounters());
+    }
+};
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 ContractRequest::ContractRequest(
     ContractWorker* worker)
@@ -78,6 +101,18 @@ void ContractRequest::parse_common_properties(const JSON_Object* request_object)
     pdo::error::ThrowIf<pdo::error::ValueError>(
         !pvalue, "invalid request; failed to retrieve ContractMessage");
     contract_message_.Unpack(ovalue);
+
+    // optional flag, the counters are not reported unless requested
+    report_resource_usage_ = (json_object_dotget_boolean(request_object, "ReportResourceUsage") == 1);
+
+    // optional flag, used by clients that evaluate invocations speculatively
+    report_access_sets_ = (json_object_dotget_boolean(request_object, "ReportAccessSets") == 1);
+
+    // optional budget, the interpreter caps it at its own maximum
+    double budget = json_object_dotget_number(request_object, "ExecutionBudget");
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        budget < 0, "invalid request; invalid ExecutionBudget");
+    execution_budget_ = (uint64_t)budget;
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -113,7 +148,10 @@ std::shared_ptr<ContractResponse> UpdateStateRequest::process_request(ContractSt
         // Push this into a block to ensure that the interpreter is deallocated
         // and frees its memory before finalizing the state update
         {
+            PDO_TRACE_SPAN(PDO_TRACE_INTERPRETER_RUN);
             InitializedInterpreter interpreter(worker_);
+            InterpreterResourceCollector collector(interpreter.interpreter_, resource_counters_);
+            interpreter.interpreter_->SetExecutionBudget(execution_budget_);
 
             SAFE_LOG(PDO_LOG_DEBUG, "KV id before interpreter: %s\n",
                      ByteArrayToHexEncodedString(contract_state.input_block_id_).c_str());
@@ -138,6 +176,8 @@ std::shared_ptr<ContractResponse> UpdateStateRequest::process_request(ContractSt
                 *this,
                 contract_state.input_block_id_,
                 contract_state.output_block_id_,
+                contract_state.new_block_ids_,
+                contract_state.superseded_block_ids_,
                 dependencies,
                 result);
         }
@@ -147,6 +187,20 @@ std::shared_ptr<ContractResponse> UpdateStateRequest::process_request(ContractSt
             return std::make_shared<UpdateStateResponse>(*this, contract_state.input_block_id_, result);
         }
     }
+    catch (pdo::contracts::ExecutionBudgetExceeded& e)
+    {
+        SAFE_LOG(PDO_LOG_WARNING,
+                 "execution budget exceeded while updating contract %s with message %s: %s",
+                 contract_code_.name_.c_str(),
+                 contract_message_.expression_.c_str(),
+                 e.what());
+
+        contract_state.Finalize();
+
+        std::shared_ptr<ContractResponse> response = std::make_shared<ContractResponse>(*this, false, e.what());
+        response->execution_budget_exceeded_ = true;
+        return response;
+    }
     catch (pdo::error::ValueError& e)
     {
         SAFE_LOG(PDO_LOG_ERROR,
@@ -242,8 +296,12 @@ std::shared_ptr<ContractResponse> InitializeStateRequest::process_request(Contra
         // Push this into a block to ensure that the interpreter is deallocated
         // and frees its memory before finalizing the state update
         {
+            PDO_TRACE_SPAN(PDO_TRACE_INTERPRETER_RUN);
+
             // this class ensures that the interpreter is released on exit
             InitializedInterpreter interpreter(worker_);
+            InterpreterResourceCollector collector(interpreter.interpreter_, resource_counters_);
+            interpreter.interpreter_->SetExecutionBudget(execution_budget_);
 
             SAFE_LOG(PDO_LOG_DEBUG, "KV id before interpreter: %s\n",
                      ByteArrayToHexEncodedString(contract_state.input_block_id_).c_str());
@@ -260,6 +318,17 @@ std::shared_ptr<ContractResponse> InitializeStateRequest::process_request(Contra
             contract_state.metadata_hash_,
             "true");
     }
+    catch (pdo::contracts::ExecutionBudgetExceeded& e)
+    {
+        SAFE_LOG(PDO_LOG_WARNING,
+                 "execution budget exceeded during initialization of contract %s: %s",
+                 contract_code_.name_.c_str(),
+                 e.what());
+
+        std::shared_ptr<ContractResponse> response = std::make_shared<ContractResponse>(*this, false, e.what());
+        response->execution_budget_exceeded_ = true;
+        return response;
+    }
     catch (pdo::error::ValueError& e)
     {
         SAFE_LOG(PDO_LOG_ERROR,
@@ -317,4 +386,28 @@ InitializeStateRequest::InitializeStateRequest(
     pdo::error::ThrowIf<pdo::error::ValueError>(
         !ovalue, "invalid request; failed to retrieve ContractCode");
     contract_code_.Unpack(ovalue);
+
+    // optional state layout, fields that are not present keep the default
+    ovalue = json_object_dotget_object(request_object, "StateLayout");
+    if (ovalue)
+    {
+        if (json_object_get_value(ovalue, "DataNodeSize"))
+        {
+            double size = json_object_get_number(ovalue, "DataNodeSize");
+            pdo::error::ThrowIf<pdo::error::ValueError>(
+                size <= 0 || size > MAX_DATA_NODE_BYTE_SIZE, "invalid request; invalid DataNodeSize");
+            state_layout_.data_node_size_ = (unsigned int)size;
+        }
+
+        if (json_object_get_value(ovalue, "ExtentThreshold"))
+        {
+            double threshold = json_object_get_number(ovalue, "ExtentThreshold");
+            pdo::error::ThrowIf<pdo::error::ValueError>(
+                threshold < 0, "invalid request; invalid ExtentThreshold");
+            state_layout_.extent_threshold_ = (size_t)threshold;
+        }
+
+        pdo::error::ThrowIf<pdo::error::ValueError>(
+            ! pdo::state::valid_state_layout(state_layout_), "invalid request; invalid StateLayout");
+    }
 }
@@ -20,6 +20,7 @@
 
 #include "crypto.h"
 #include "parson.h"
+#include "resource_counters.h"
 
 #include "contract_code.h"
 #include "contract_message.h"
@@ -46,6 +47,16 @@ public:
 
     ContractWorker *worker_ = NULL;
 
+    // when set, the response carries the resources used by the invocation
+    bool report_resource_usage_ = false;
+    pdo_resource_counters_t resource_counters_ = {};
+
+    // when set, the response carries hashes of the keys read and written
+    bool report_access_sets_ = false;
+
+    // limit on the work done by the invocation, zero for the default
+    uint64_t execution_budget_ = 0;
+
     ContractRequest(ContractWorker* worker);
 
     virtual std::shared_ptr<ContractResponse> process_request(ContractState& contract_state) = 0;
@@ -54,6 +65,9 @@ public:
 class InitializeStateRequest : public ContractRequest
 {
 public:
+    // layout of the new state, the default unless the request sets StateLayout
+    pdo::state::state_layout_t state_layout_ = pdo::state::default_state_layout;
+
     InitializeStateRequest(
         const ByteArray& session_key,
         const ByteArray& encrypted_request,
@@ -37,6 +37,30 @@
 // See ${PDO_SOURCE_ROOT}/eservice/docs/contract.json for format
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// serialize a list of hashes or block ids as an array of base64 strings
+static void SerializeEncodedArray(
+    JSON_Object* parent_object,
+    const char* name,
+    const std::vector<ByteArray>& values)
+{
+    JSON_Status jret;
+
+    jret = json_object_set_value(parent_object, name, json_value_init_array());
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        jret != JSONSuccess, "failed to serialize encoded array");
+
+    JSON_Array* value_array = json_object_get_array(parent_object, name);
+    pdo::error::ThrowIfNull(value_array, "failed to serialize encoded array");
+
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        jret = json_array_append_string(value_array, base64_encode(values[i]).c_str());
+        pdo::error::ThrowIf<pdo::error::RuntimeError>(
+            jret != JSONSuccess, "failed to add value to encoded array");
+    }
+}
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 ContractResponse::ContractResponse(
     const ContractRequest& request,
@@ -49,39 +73,78 @@ ContractResponse::ContractResponse(
     channel_verifying_key_ = request.contract_message_.channel_verifying_key_;
     contract_code_hash_ = request.contract_code_.code_hash_;
     contract_message_hash_ = request.contract_message_.message_hash_;
+
+    report_resource_usage_ = request.report_resource_usage_;
+    resource_counters_ = request.resource_counters_;
+
+    report_access_sets_ = request.report_access_sets_;
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 ByteArray ContractResponse::ComputeSignature(const EnclaveData& enclave_data) const
 {
-    ByteArray serialized;
-    SerializeForSigning(serialized);
+    PDO_TRACE_SPAN(PDO_TRACE_RESPONSE_SIGN);
+
+    // the fields are streamed directly into the hash rather than
+    // concatenated into a temporary buffer first
+    pdo::crypto::Hasher hasher(enclave_data.signing_hash_function());
+    SerializeForSigning(hasher);
+
+    return enclave_data.sign_digest(hasher.Final());
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void ContractResponse::SerializeForSigning(pdo::crypto::Hasher& hasher) const
+{
+    hasher.Update(channel_verifying_key_);
+    hasher.Update(contract_id_);
+    hasher.Update(contract_code_hash_);
+    hasher.Update(contract_message_hash_);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void ContractResponse::SerializeResourceUsage(JSON_Object* contract_response_object) const
+{
+    if (! report_resource_usage_)
+        return;
+
+    JSON_Status jret;
+
+    jret = json_object_set_value(contract_response_object, "ResourceUsage", json_value_init_object());
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        jret != JSONSuccess, "failed to serialize the resource usage");
 
-    return enclave_data.sign_message(serialized);
+    JSON_Object* usage_object = json_object_get_object(contract_response_object, "ResourceUsage");
+    pdo::error::ThrowIfNull(usage_object, "failed to serialize the resource usage");
+
+    // counters are serialized as numbers, which is exact up to 2^53
+#define PDO_RESOURCE_COUNTER_SERIALIZE(field, name)                     \
+    jret = json_object_set_number(usage_object, name, (double)resource_counters_.field); \
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(                      \
+        jret != JSONSuccess, "failed to serialize resource counter " name);
+
+    PDO_RESOURCE_COUNTER_LIST(PDO_RESOURCE_COUNTER_SERIALIZE)
+    PDO_RESOURCE_PEAK_LIST(PDO_RESOURCE_COUNTER_SERIALIZE)
+#undef PDO_RESOURCE_COUNTER_SERIALIZE
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-void ContractResponse::SerializeForSigning(ByteArray& serialized) const
+void ContractResponse::SerializeAccessSets(JSON_Object* contract_response_object) const
 {
-    std::copy(
-        channel_verifying_key_.begin(),
-        channel_verifying_key_.end(),
-        std::back_inserter(serialized));
-
-    std::copy(
-        contract_id_.begin(),
-        contract_id_.end(),
-        std::back_inserter(serialized));
-
-    std::copy(
-        contract_code_hash_.begin(),
-        contract_code_hash_.end(),
-        std::back_inserter(serialized));
-
-    std::copy(
-        contract_message_hash_.begin(),
-        contract_message_hash_.end(),
-        std::back_inserter(serialized));
+    if (! report_access_sets_)
+        return;
+
+    JSON_Status jret;
+
+    jret = json_object_set_value(contract_response_object, "AccessSets", json_value_init_object());
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        jret != JSONSuccess, "failed to serialize the access sets");
+
+    JSON_Object* access_object = json_object_get_object(contract_response_object, "AccessSets");
+    pdo::error::ThrowIfNull(access_object, "failed to serialize the access sets");
+
+    SerializeEncodedArray(access_object, "ReadSet", read_set_);
+    SerializeEncodedArray(access_object, "WriteSet", write_set_);
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -111,6 +174,20 @@ ByteArray ContractResponse::SerializeAndEncrypt(
     pdo::error::ThrowIf<pdo::error::RuntimeError>(
         jret != JSONSuccess, "failed to serialize the result");
 
+    // --------------- budget ---------------
+    if (execution_budget_exceeded_)
+    {
+        jret = json_object_dotset_boolean(contract_response_object, "ExecutionBudgetExceeded", true);
+        pdo::error::ThrowIf<pdo::error::RuntimeError>(
+            jret != JSONSuccess, "failed to serialize the budget status");
+    }
+
+    // --------------- resource usage ---------------
+    SerializeResourceUsage(contract_response_object);
+
+    // --------------- access sets ---------------
+    SerializeAccessSets(contract_response_object);
+
     // serialize the resulting json
     size_t serializedSize = json_serialization_size(contract_response_value);
     ByteArray serialized_response;
@@ -144,24 +221,13 @@ InitializeStateResponse::InitializeStateResponse(
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 void InitializeStateResponse::SerializeForSigning(
-    ByteArray& serialized) const
+    pdo::crypto::Hasher& hasher) const
 {
-    ContractResponse::SerializeForSigning(serialized);
-
-    std::copy(
-        creator_id_.begin(),
-        creator_id_.end(),
-        std::back_inserter(serialized));
-
-    std::copy(
-        contract_metadata_hash_.begin(),
-        contract_metadata_hash_.end(),
-        std::back_inserter(serialized));
-
-    std::copy(
-        output_block_id_.begin(),
-        output_block_id_.end(),
-        std::back_inserter(serialized));
+    ContractResponse::SerializeForSigning(hasher);
+
+    hasher.Update(creator_id_);
+    hasher.Update(contract_metadata_hash_);
+    hasher.Update(output_block_id_);
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -233,13 +299,17 @@ UpdateStateResponse::UpdateStateResponse(
     const UpdateStateRequest& request,
     const pdo::state::StateBlockId& input_block_id,
     const pdo::state::StateBlockId& output_block_id,
+    const pdo::state::StateBlockIdArray& new_block_ids,
+    const pdo::state::StateBlockIdArray& superseded_block_ids,
     const std::map<std::string, std::string>& dependencies,
     const std::string& result) :
     ContractResponse(request, true, result),
     state_changed_(true),
+    dependencies_(dependencies),
     input_block_id_(input_block_id),
     output_block_id_(output_block_id),
-    dependencies_(dependencies)
+    new_block_ids_(new_block_ids),
+    superseded_block_ids_(superseded_block_ids)
 {
     SAFE_LOG(PDO_LOG_DEBUG,
              "input state hash: %s",
@@ -263,25 +333,18 @@ UpdateStateResponse::UpdateStateResponse(
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 void UpdateStateResponse::SerializeForSigning(
-    ByteArray& serialized) const
+    pdo::crypto::Hasher& hasher) const
 {
-    ContractResponse::SerializeForSigning(serialized);
-
-    std::copy(
-        input_block_id_.begin(),
-        input_block_id_.end(),
-        std::back_inserter(serialized));
+    ContractResponse::SerializeForSigning(hasher);
 
-    std::copy(
-        output_block_id_.begin(),
-        output_block_id_.end(),
-        std::back_inserter(serialized));
+    hasher.Update(input_block_id_);
+    hasher.Update(output_block_id_);
 
     std::map<std::string, std::string>::const_iterator iter;
     for (iter = dependencies_.begin(); iter != dependencies_.end(); iter++)
     {
-        std::copy(iter->first.begin(), iter->first.end(), std::back_inserter(serialized));
-        std::copy(iter->second.begin(), iter->second.end(), std::back_inserter(serialized));
+        hasher.Update(iter->first);
+        hasher.Update(iter->second);
     }
 
 #if PDO_DEBUG_BUILD
@@ -299,14 +362,23 @@ void UpdateStateResponse::SerializeForSigning(
 
     std::string debug_state_hash = ByteArrayToBase64EncodedString(output_block_id_);
     SAFE_LOG(PDO_LOG_DEBUG, "new state hash: %s", debug_state_hash.c_str());
+#endif
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void UpdateStateResponse::SerializeChangeSet(JSON_Object* contract_response_object) const
+{
+    JSON_Status jret;
+
+    jret = json_object_set_value(contract_response_object, "ChangeSet", json_value_init_object());
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        jret != JSONSuccess, "failed to serialize the change set");
 
-    std::string debug_xxx = ByteArrayToBase64EncodedString(serialized);
-    SAFE_LOG(PDO_LOG_DEBUG, "serialized contract response message: %s", debug_xxx.c_str());
+    JSON_Object* change_set_object = json_object_get_object(contract_response_object, "ChangeSet");
+    pdo::error::ThrowIfNull(change_set_object, "failed to serialize the change set");
 
-    std::string debug_mhash = ByteArrayToBase64EncodedString(pdo::crypto::ComputeMessageHash(serialized));
-    SAFE_LOG(PDO_LOG_DEBUG, "serialized contract response message has length %d and hash %s",
-        serialized.size(), debug_mhash.c_str());
-#endif
+    SerializeEncodedArray(change_set_object, "NewBlockIds", new_block_ids_);
+    SerializeEncodedArray(change_set_object, "SupersededBlockIds", superseded_block_ids_);
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -341,6 +413,12 @@ ByteArray UpdateStateResponse::SerializeAndEncrypt(
     pdo::error::ThrowIf<pdo::error::RuntimeError>(
         jret != JSONSuccess, "failed to serialize the result");
 
+    // --------------- resource usage ---------------
+    SerializeResourceUsage(contract_response_object);
+
+    // --------------- access sets ---------------
+    SerializeAccessSets(contract_response_object);
+
     if (operation_succeeded_ && state_changed_) {
         // --------------- signature ---------------
         ByteArray signature = ComputeSignature(enclave_data);
@@ -356,6 +434,9 @@ ByteArray UpdateStateResponse::SerializeAndEncrypt(
         pdo::error::ThrowIf<pdo::error::RuntimeError>(
             jret != JSONSuccess, "failed to serialize the state hash");
 
+        // --------------- change set ---------------
+        SerializeChangeSet(contract_response_object);
+
         // --------------- dependencies ---------------
         jret = json_object_set_value(contract_response_object, "Dependencies", json_value_init_array());
         pdo::error::ThrowIf<pdo::error::RuntimeError>(
@@ -19,6 +19,8 @@
 #include <string>
 
 #include "crypto.h"
+#include "parson.h"
+#include "resource_counters.h"
 
 #include "contract_request.h"
 #include "contract_state.h"
@@ -39,13 +41,32 @@ public:
     std::string result_;
     bool operation_succeeded_ = false;
 
+    bool report_resource_usage_ = false;
+    pdo_resource_counters_t resource_counters_ = {};
+
+    // set when the invocation was aborted because it ran out of budget
+    bool execution_budget_exceeded_ = false;
+
+    // hashes of the state keys read and written by the invocation
+    bool report_access_sets_ = false;
+    std::vector<ByteArray> read_set_;
+    std::vector<ByteArray> write_set_;
+
     ContractResponse(
         const ContractRequest& request,
         const bool operation_succeeded,
         const std::string& result);
 
     virtual void SerializeForSigning(
-        ByteArray& serialized) const;
+        pdo::crypto::Hasher& hasher) const;
+
+    // the counters are informational and are not covered by the signature
+    void SerializeResourceUsage(
+        JSON_Object* contract_response_object) const;
+
+    // the access sets are informational and are not covered by the signature
+    void SerializeAccessSets(
+        JSON_Object* contract_response_object) const;
 
     ByteArray ComputeSignature(
         const EnclaveData& enclave_data) const;
@@ -68,7 +89,7 @@ public:
         const std::string& result);
 
     void SerializeForSigning(
-        ByteArray& serialized) const;
+        pdo::crypto::Hasher& hasher) const;
 
     ByteArray SerializeAndEncrypt(
         const ByteArray& session_key, const EnclaveData& enclave_data) const;
@@ -82,10 +103,17 @@ public:
     pdo::state::StateBlockId input_block_id_;
     pdo::state::StateBlockId output_block_id_;
 
+    // the change set lets replication and garbage collection work on the
+    // blocks that changed rather than on all of the blocks in the state
+    pdo::state::StateBlockIdArray new_block_ids_;
+    pdo::state::StateBlockIdArray superseded_block_ids_;
+
     UpdateStateResponse(
         const UpdateStateRequest& request,
         const pdo::state::StateBlockId& input_block_id,
         const pdo::state::StateBlockId& output_block_id,
+        const pdo::state::StateBlockIdArray& new_block_ids,
+        const pdo::state::StateBlockIdArray& superseded_block_ids,
         const std::map<std::string, std::string>& dependencies,
         const std::string& result);
 
@@ -95,7 +123,11 @@ public:
         const std::string& result);
 
     void SerializeForSigning(
-        ByteArray& serialized) const;
+        pdo::crypto::Hasher& hasher) const;
+
+    // the change set is informational and is not covered by the signature
+    void SerializeChangeSet(
+        JSON_Object* contract_response_object) const;
 
     ByteArray SerializeAndEncrypt(
         const ByteArray& session_key, const EnclaveData& enclave_data) const;
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "sgx_tcrypto.h"
+#include "sgx_thread.h"
 #include "sgx_utils.h"
 
 #include "error.h"
@@ -31,6 +32,7 @@
 #include "zero.h"
 
 #include "hex_string.h"
+#include "state_key_cache.h"
 
 #include "contract_secrets.h"
 #include "enclave_utils.h"
@@ -219,9 +221,58 @@ ByteArray DecryptStateEncryptionKey(
   return decryptedStateEncryptionKey;
 }
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// cache of unsealed state encryption keys
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+// every request carries the sealed key for its contract, the cache
+// saves unsealing the same key over and over
+#define STATE_KEY_CACHE_SIZE 64
+
+static sgx_thread_mutex_t state_key_cache_mutex = SGX_THREAD_MUTEX_INITIALIZER;
+static pdo::state::StateKeyCache g_StateKeyCache(STATE_KEY_CACHE_SIZE);
+
+class StateKeyCacheLock
+{
+public:
+    StateKeyCacheLock(void) { sgx_thread_mutex_lock(&state_key_cache_mutex); }
+    ~StateKeyCacheLock(void) { sgx_thread_mutex_unlock(&state_key_cache_mutex); }
+};
+
 ByteArray DecodeAndDecryptStateEncryptionKey(const std::string& inContractId,
     const Base64EncodedString& inEncodedEncryptedStateEncryptionKey)
 {
+    ByteArray state_encryption_key;
+
+    {
+        StateKeyCacheLock lock;
+        if (g_StateKeyCache.find(inContractId, inEncodedEncryptedStateEncryptionKey, state_encryption_key))
+            return state_encryption_key;
+    }
+
+    // unseal outside the lock, concurrent misses for the same key
+    // both unseal and the second insert is dropped
     ByteArray encrypted_state_encryption_key = base64_decode(inEncodedEncryptedStateEncryptionKey);
-    return DecryptStateEncryptionKey(inContractId, encrypted_state_encryption_key);
+    state_encryption_key = DecryptStateEncryptionKey(inContractId, encrypted_state_encryption_key);
+
+    {
+        StateKeyCacheLock lock;
+        g_StateKeyCache.insert(inContractId, inEncodedEncryptedStateEncryptionKey, state_encryption_key);
+    }
+
+    return state_encryption_key;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void InvalidateStateEncryptionKey(const std::string& inContractId)
+{
+    StateKeyCacheLock lock;
+    g_StateKeyCache.invalidate(inContractId);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void ClearStateEncryptionKeyCache(void)
+{
+    StateKeyCacheLock lock;
+    g_StateKeyCache.clear();
 }
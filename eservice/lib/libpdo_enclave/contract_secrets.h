@@ -46,5 +46,10 @@ Base64EncodedString EncryptAndEncodeStateEncryptionKey(
 ByteArray DecryptStateEncryptionKey(
     const std::string& inContractId, const ByteArray& inEncryptedStateEncryptionKey);
 
+// unsealed keys are cached in the enclave, keyed by the contract id
+// and the sealed key; entries are zeroed when they are removed
 ByteArray DecodeAndDecryptStateEncryptionKey(const std::string& inContractId,
     const Base64EncodedString& inEncodedEncryptedStateEncryptionKey);
+
+void InvalidateStateEncryptionKey(const std::string& inContractId);
+void ClearStateEncryptionKeyCache(void);
@@ -70,11 +70,12 @@ ContractState::ContractState(
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 ContractState::ContractState(
     const ByteArray& state_encryption_key,
-    const ByteArray& id_hash)
+    const ByteArray& id_hash,
+    const pdo::state::state_layout_t& layout)
     :
     input_block_id_(STATE_BLOCK_ID_LENGTH, 0),
     output_block_id_(STATE_BLOCK_ID_LENGTH, 0),
-    state_(pdo::state::Interpreter_KV(state_encryption_key))
+    state_(pdo::state::Interpreter_KV(state_encryption_key, layout))
 {
     Initialize(state_encryption_key, id_hash);
 }
@@ -82,7 +83,8 @@ ContractState::ContractState(
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 void ContractState::Finalize(void)
 {
-    state_.Finalize(output_block_id_);
+    PDO_TRACE_SPAN(PDO_TRACE_STATE_FINALIZE);
+    state_.Finalize(output_block_id_, new_block_ids_, superseded_block_ids_);
 }
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -136,7 +138,9 @@ void ContractState::Initialize(
     {
         SAFE_LOG(PDO_LOG_DEBUG, "Initialize new state");
 
-        ByteArray metadata;
+        // the metadata hash covers the contract id and the public keys,
+        // these are streamed into the hash as they are generated
+        pdo::crypto::Hasher metadata_hasher;
 
         // add the contract id into the state so that we can verify
         // that this state belongs to this contract
@@ -145,7 +149,7 @@ void ContractState::Initialize(
             ByteArray k(str.begin(), str.end());
             state_.PrivilegedPut(k, id_hash);
 
-            std::copy(id_hash.begin(), id_hash.end(), std::back_inserter(metadata));
+            metadata_hasher.Update(id_hash);
         }
 
         {
@@ -170,7 +174,7 @@ void ContractState::Initialize(
                 state_.PrivilegedPut(k, v);
             }
 
-            std::copy(encpub.begin(), encpub.end(), std::back_inserter(metadata));
+            metadata_hasher.Update(encpub);
         }
 
         {
@@ -195,11 +199,11 @@ void ContractState::Initialize(
                 state_.PrivilegedPut(k, v);
             }
 
-            std::copy(encpub.begin(), encpub.end(), std::back_inserter(metadata));
+            metadata_hasher.Update(encpub);
         }
 
         {
-            metadata_hash_ = pdo::crypto::ComputeMessageHash(metadata);
+            metadata_hash_ = metadata_hasher.Final();
 
             {
                 std::string str("Metadata.Hash");
@@ -34,6 +34,10 @@ public:
     pdo::state::StateBlockId input_block_id_;
     pdo::state::StateBlockId output_block_id_;
     pstate::Interpreter_KV state_;
+
+    // blocks added to and removed from the state by Finalize
+    pdo::state::StateBlockIdArray new_block_ids_;
+    pdo::state::StateBlockIdArray superseded_block_ids_;
     ByteArray metadata_hash_;
 
     ContractState(
@@ -41,9 +45,11 @@ public:
         const ByteArray& input_block_id,
         const ByteArray& id_hash);
 
+    // create a new state with the given layout
     ContractState(
         const ByteArray& state_encryption_key,
-        const ByteArray& id_hash);
+        const ByteArray& id_hash,
+        const pdo::state::state_layout_t& layout);
 
     void Finalize(void);
 
@@ -86,6 +86,17 @@ public:
         return private_signing_key_.SignMessage(message);
     };
 
+    // hash function that must be used to compute the digest for sign_digest
+    pdo::crypto::HashFunction signing_hash_function(void) const
+    {
+        return private_signing_key_.GetHashFunction();
+    };
+
+    ByteArray sign_digest(const ByteArray& digest) const
+    {
+        return private_signing_key_.SignDigest(digest);
+    };
+
     unsigned int max_sig_size(bool encoded) const
     {
         if(encoded)
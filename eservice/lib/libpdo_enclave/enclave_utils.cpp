@@ -15,6 +15,8 @@
 
 #include "enclave_t.h"
 
+#include "enclave_utils.h"
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 /*
     the trusted_wrapper_ocall_Log function is required in, and used by,
@@ -38,3 +40,24 @@ uint64_t GetTimer(void)
 
     return value;
 } // GetTimer
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+/*
+    the trace clock and flush functions are registered with the trusted
+    common library when the enclave is initialized; all records buffered
+    by a thread leave the enclave in a single ocall, and the ocall returns
+    whether the host collects traces at all
+*/
+uint64_t trusted_wrapper_ocall_GetTraceTimestamp(void)
+{
+    uint64_t value = 0;
+    ocall_GetTraceTimestamp(&value);
+    return value;
+} // trusted_wrapper_ocall_GetTraceTimestamp
+
+void trusted_wrapper_ocall_TraceFlush(const pdo_trace_record_t* records, size_t count)
+{
+    int enabled = 0;
+    ocall_TraceFlush((const uint8_t*)records, count * sizeof(pdo_trace_record_t), &enabled);
+    pdo::trace::Enable(enabled != 0);
+} // trusted_wrapper_ocall_TraceFlush
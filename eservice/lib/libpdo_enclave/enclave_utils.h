@@ -16,6 +16,7 @@
 #pragma once
 
 #include "log.h"
+#include "trace.h"
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 #if defined(SGX_SIMULATOR)
@@ -23,3 +24,7 @@ const bool IS_SGX_SIMULATOR = true;
 #else
 const bool IS_SGX_SIMULATOR = false;
 #endif
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+uint64_t trusted_wrapper_ocall_GetTraceTimestamp(void);
+void trusted_wrapper_ocall_TraceFlush(const pdo_trace_record_t* records, size_t count);
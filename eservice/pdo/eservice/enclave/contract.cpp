@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
 #include <stdlib.h>
 #include <string>
 #include <map>
@@ -22,9 +23,13 @@
 #include <inttypes.h>
 
 #include "error.h"
+#include "jsonvalue.h"
 #include "log.h"
+#include "packages/parson/parson.h"
 #include "pdo_error.h"
+#include "resource_counters.h"
 #include "swig_utils.h"
+#include "trace.h"
 #include "types.h"
 
 #include "contract.h"
@@ -32,6 +37,50 @@
 #include "enclave/base.h"
 #include "enclave/contract.h"
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// Resources used by the requests processed by the enclaves, aggregated
+// by contract
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+typedef struct
+{
+    uint64_t requests;
+    pdo_resource_counters_t counters;
+} contract_usage_t;
+
+static pthread_mutex_t usage_mutex = PTHREAD_MUTEX_INITIALIZER;
+static std::map<std::string, contract_usage_t> g_ContractUsage;
+
+// only the peaks are kept, they are never cleared
+static contract_usage_t g_MemoryUsage = {};
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static void AccumulateResourceUsage(int enclaveIndex)
+{
+    std::string contract_id;
+    pdo_resource_counters_t counters;
+
+    // accounting failures are logged, they never fail the request
+    pdo_err_t presult = pdo::enclave_api::contract::GetResourceUsage(contract_id, counters, enclaveIndex);
+    if (presult != PDO_SUCCESS)
+    {
+        SAFE_LOG(PDO_LOG_WARNING, "failed to retrieve resource usage; %d", presult);
+        return;
+    }
+
+    pthread_mutex_lock(&usage_mutex);
+    contract_usage_t& usage = g_ContractUsage[contract_id];
+    usage.requests++;
+    pdo::resource::Accumulate(usage.counters, counters);
+
+    g_MemoryUsage.requests++;
+#define PDO_RESOURCE_PEAK_MERGE(field, name)                            \
+    pdo::resource::UpdatePeak(g_MemoryUsage.counters.field, counters.field);
+
+    PDO_RESOURCE_PEAK_LIST(PDO_RESOURCE_PEAK_MERGE)
+#undef PDO_RESOURCE_PEAK_MERGE
+    pthread_mutex_unlock(&usage_mutex);
+}
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 std::map<std::string, std::string> contract_verify_secrets(
     const std::string& sealed_signup_data,
@@ -97,6 +146,8 @@ std::vector<uint8_t> contract_handle_contract_request(
 
     pdo::enclave_queue::ReadyEnclave readyEnclave = pdo::enclave_api::base::GetReadyEnclave();
 
+    pdo::trace::Span request_span(PDO_TRACE_ENCLAVE_REQUEST);
+
     presult = pdo::enclave_api::contract::HandleContractRequest(
         sealed_signup_data,
         encrypted_session_key,
@@ -115,6 +166,11 @@ std::vector<uint8_t> contract_handle_contract_request(
         readyEnclave.getIndex());
     ThrowPDOError(presult);
 
+    AccumulateResourceUsage(readyEnclave.getIndex());
+
+    request_span.End();
+    pdo::trace::Flush();
+
     SAFE_LOG(PDO_LOG_DEBUG, "end request [%" PRIu64 "]; elapsed time %" PRIu64, request_identifier, GetTimer() - start_time);
 
     return response;
@@ -140,6 +196,8 @@ std::vector<uint8_t> initialize_contract_state(
 
     pdo::enclave_queue::ReadyEnclave readyEnclave = pdo::enclave_api::base::GetReadyEnclave();
 
+    pdo::trace::Span request_span(PDO_TRACE_ENCLAVE_REQUEST);
+
     presult = pdo::enclave_api::contract::InitializeContractState(
         sealed_signup_data,
         encrypted_session_key,
@@ -158,7 +216,118 @@ std::vector<uint8_t> initialize_contract_state(
         readyEnclave.getIndex());
     ThrowPDOError(presult);
 
+    AccumulateResourceUsage(readyEnclave.getIndex());
+
+    request_span.End();
+    pdo::trace::Flush();
+
     SAFE_LOG(PDO_LOG_DEBUG, "end request [%" PRIu64 "]; elapsed time %" PRIu64, request_identifier, GetTimer() - start_time);
 
     return response;
 }
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+void contract_trace_enable(bool enabled)
+{
+    pdo::trace::Enable(enabled);
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+std::string contract_trace_export(bool clear)
+{
+    pdo::trace::Flush();
+
+    std::string trace;
+    pdo::trace::ExportChromeTrace(trace, clear);
+    return trace;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+std::string contract_resource_usage_export(bool clear)
+{
+    std::map<std::string, contract_usage_t> usage;
+
+    pthread_mutex_lock(&usage_mutex);
+    if (clear)
+        usage.swap(g_ContractUsage);
+    else
+        usage = g_ContractUsage;
+    pthread_mutex_unlock(&usage_mutex);
+
+    JsonValue result_value(json_value_init_object());
+    JSON_Object* result_object = json_value_get_object(result_value);
+    pdo::error::ThrowIfNull(result_object, "failed to create the resource usage");
+
+    JSON_Status jret;
+    std::map<std::string, contract_usage_t>::const_iterator it;
+    for (it = usage.begin(); it != usage.end(); it++)
+    {
+        jret = json_object_set_value(result_object, it->first.c_str(), json_value_init_object());
+        pdo::error::ThrowIf<pdo::error::RuntimeError>(
+            jret != JSONSuccess, "failed to serialize the resource usage");
+
+        JSON_Object* usage_object = json_object_get_object(result_object, it->first.c_str());
+        pdo::error::ThrowIfNull(usage_object, "failed to serialize the resource usage");
+
+        jret = json_object_set_number(usage_object, "Requests", (double)it->second.requests);
+        pdo::error::ThrowIf<pdo::error::RuntimeError>(
+            jret != JSONSuccess, "failed to serialize the request count");
+
+        // counters are serialized as numbers, which is exact up to 2^53
+#define PDO_RESOURCE_COUNTER_EXPORT(field, name)                        \
+        jret = json_object_set_number(usage_object, name, (double)it->second.counters.field); \
+        pdo::error::ThrowIf<pdo::error::RuntimeError>(                  \
+            jret != JSONSuccess, "failed to serialize resource counter " name);
+
+        PDO_RESOURCE_COUNTER_LIST(PDO_RESOURCE_COUNTER_EXPORT)
+        PDO_RESOURCE_PEAK_LIST(PDO_RESOURCE_COUNTER_EXPORT)
+#undef PDO_RESOURCE_COUNTER_EXPORT
+    }
+
+    size_t serialized_size = json_serialization_size(result_value);
+    std::vector<char> serialized(serialized_size);
+
+    jret = json_serialize_to_buffer(result_value, serialized.data(), serialized.size());
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        jret != JSONSuccess, "resource usage serialization failed");
+
+    std::string result(serialized.data());
+    return result;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+std::string contract_memory_usage_export(void)
+{
+    contract_usage_t usage;
+
+    pthread_mutex_lock(&usage_mutex);
+    usage = g_MemoryUsage;
+    pthread_mutex_unlock(&usage_mutex);
+
+    JsonValue result_value(json_value_init_object());
+    JSON_Object* result_object = json_value_get_object(result_value);
+    pdo::error::ThrowIfNull(result_object, "failed to create the memory usage");
+
+    JSON_Status jret;
+    jret = json_object_set_number(result_object, "Requests", (double)usage.requests);
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        jret != JSONSuccess, "failed to serialize the request count");
+
+#define PDO_RESOURCE_PEAK_EXPORT(field, name)                           \
+    jret = json_object_set_number(result_object, name, (double)usage.counters.field); \
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(                      \
+        jret != JSONSuccess, "failed to serialize resource peak " name);
+
+    PDO_RESOURCE_PEAK_LIST(PDO_RESOURCE_PEAK_EXPORT)
+#undef PDO_RESOURCE_PEAK_EXPORT
+
+    size_t serialized_size = json_serialization_size(result_value);
+    std::vector<char> serialized(serialized_size);
+
+    jret = json_serialize_to_buffer(result_value, serialized.data(), serialized.size());
+    pdo::error::ThrowIf<pdo::error::RuntimeError>(
+        jret != JSONSuccess, "memory usage serialization failed");
+
+    std::string result(serialized.data());
+    return result;
+}
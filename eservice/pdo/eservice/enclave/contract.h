@@ -44,3 +44,21 @@ std::vector<uint8_t> initialize_contract_state(
     const std::vector<uint8_t>& encryptedSessionKey,
     const std::vector<uint8_t>& serializedRequest
     );
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// tracing is collected in the host process; the enclave picks up a
+// change in the setting at the end of its next request
+void contract_trace_enable(bool enabled);
+
+// returns the collected spans in the chrome trace event format
+std::string contract_trace_export(bool clear = true);
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// returns a json object that maps contract ids to the number of requests
+// and the resources used by the requests since the last clear
+std::string contract_resource_usage_export(bool clear = false);
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// returns a json object with the largest memory peaks reported by any
+// request since the enclaves were started
+std::string contract_memory_usage_export(void);
@@ -21,7 +21,7 @@
 #include "error.h"
 #include "pdo_error.h"
 #include "types.h"
-#include "enclave/enclave_queue.h"
+#include "untrusted/enclave_queue.h"
 
 namespace pdo
 {
@@ -15,9 +15,13 @@
 
 #include "enclave_u.h"
 
+#include <string>
+#include <vector>
+
 #include "pdo_error.h"
 #include "error.h"
 #include "log.h"
+#include "resource_counters.h"
 #include "types.h"
 #include "zero.h"
 
@@ -365,3 +369,68 @@ pdo_err_t pdo::enclave_api::contract::GetSerializedResponse(
 
     return result;
 }
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+pdo_err_t pdo::enclave_api::contract::GetResourceUsage(
+    std::string& outContractId,
+    pdo_resource_counters_t& outResourceCounters,
+    int enclaveIndex
+    )
+{
+    pdo_err_t result = PDO_SUCCESS;
+
+    try
+    {
+        // contract ids are base64 encoded sha256 hashes, leave room for more
+        std::vector<char> contract_id(256);
+
+        // xxxxx call the enclave
+
+        /// get the enclave id for passing into the ecall
+        sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
+        pdo::logger::LogV(PDO_LOG_DEBUG, "GetResourceUsage[%ld] %u ", (long)enclaveid, enclaveIndex);
+
+        pdo_err_t presult = PDO_SUCCESS;
+        sgx_status_t sresult =
+            g_Enclave[enclaveIndex].CallSgx(
+                [
+                    enclaveid,
+                    &presult,
+                    &contract_id,
+                    &outResourceCounters
+                ]
+                ()
+                {
+                    sgx_status_t sresult_inner = ecall_GetResourceUsage(
+                        enclaveid,
+                        &presult,
+                        contract_id.data(),
+                        contract_id.size(),
+                        (uint8_t*)&outResourceCounters,
+                        sizeof(pdo_resource_counters_t));
+                    return pdo::error::ConvertErrorStatus(sresult_inner, presult);
+                }
+                );
+        pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (GetResourceUsage)");
+        g_Enclave[enclaveIndex].ThrowPDOError(presult);
+
+        outContractId.assign(contract_id.data());
+    }
+    catch (pdo::error::Error& e)
+    {
+        pdo::enclave_api::base::SetLastError(e.what());
+        result = e.error_code();
+    }
+    catch (std::exception& e)
+    {
+        pdo::enclave_api::base::SetLastError(e.what());
+        result = PDO_ERR_UNKNOWN;
+    }
+    catch (...)
+    {
+        pdo::enclave_api::base::SetLastError("Unexpected exception");
+        result = PDO_ERR_UNKNOWN;
+    }
+
+    return result;
+}
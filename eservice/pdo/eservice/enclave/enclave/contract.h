@@ -16,6 +16,7 @@
 #pragma once
 
 #include "pdo_error.h"
+#include "resource_counters.h"
 #include "types.h"
 
 #include <string>
@@ -74,6 +75,14 @@ namespace pdo
                 int enclaveIndex
                 );
 
+            // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+            // resources used by the last request processed by the enclave
+            pdo_err_t GetResourceUsage(
+                std::string& outContractId,
+                pdo_resource_counters_t& outResourceCounters,
+                int enclaveIndex
+                );
+
         } /* contract */
     }     /* enclave_api */
 }         /* pdo */
@@ -21,6 +21,7 @@
 #include "log.h"
 #include "packages/block_store/block_store.h"
 #include "timer.h"
+#include "trace.h"
 
 std::string g_enclaveError;
 
@@ -39,6 +40,23 @@ extern "C" {
         (*value) = GetTimer();
     }
 
+    void ocall_GetTraceTimestamp(uint64_t* value)
+    {
+        (*value) = pdo::trace::Now();
+    }
+
+    void ocall_TraceFlush(
+        const uint8_t* inRecords,
+        size_t inRecordsSize,
+        int* outEnabled
+        )
+    {
+        if (inRecords != NULL)
+            pdo::trace::Collect(
+                (const pdo_trace_record_t*)inRecords, inRecordsSize / sizeof(pdo_trace_record_t));
+        (*outEnabled) = pdo::trace::Enabled() ? 1 : 0;
+    } // ocall_TraceFlush
+
     void ocall_SetErrorMessage(
         const char* message
         )
@@ -44,6 +44,10 @@ __all__ = [
     'verify_secrets',
     'initialize_contract_state',
     'send_to_contract',
+    'trace_enable',
+    'trace_export',
+    'resource_usage_export',
+    'memory_usage_export',
     'shutdown'
 ]
 
@@ -51,6 +55,10 @@ verify_secrets = enclave.contract_verify_secrets
 get_enclave_public_info = enclave.unseal_enclave_data
 block_store_open = enclave.block_store_open
 block_store_close = enclave.block_store_close
+trace_enable = enclave.contract_trace_enable
+trace_export = enclave.contract_trace_export
+resource_usage_export = enclave.contract_resource_usage_export
+memory_usage_export = enclave.contract_memory_usage_export
 
 # -----------------------------------------------------------------
 # -----------------------------------------------------------------
@@ -40,7 +40,7 @@ from pdo.submitter.create import create_submitter
 import logging
 logger = logging.getLogger(__name__)
 
-__all__ = [ "Enclave", "initialize_enclave", "shutdown_enclave" ]
+__all__ = [ "Enclave", "initialize_enclave", "shutdown_enclave", "enable_tracing", "save_trace" ]
 
 # -----------------------------------------------------------------
 # -----------------------------------------------------------------
@@ -78,6 +78,27 @@ def shutdown_enclave() :
     except Exception as e :
         logger.error('block store shutdown failed; %s', str(e))
 
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def enable_tracing() :
+    """enable collection of the tracing spans recorded by the host
+    and the enclaves
+    """
+    pdo_enclave.trace_enable(True)
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def save_trace(trace_file) :
+    """write the collected spans to a file in the chrome trace event
+    format, the file can be loaded in chrome://tracing or perfetto
+    """
+    try :
+        with open(trace_file, "w") as tf :
+            tf.write(pdo_enclave.trace_export())
+        logger.info('trace saved to %s', trace_file)
+    except Exception as e :
+        logger.error('failed to save trace; %s', str(e))
+
 # -----------------------------------------------------------------
 # -----------------------------------------------------------------
 def get_enclave_service_info(spid, config=None) :
@@ -255,6 +276,25 @@ class Enclave(object) :
             logger.error('send_to_contract failed; %s, %s', type(e), str(e.args))
             raise
 
+    # -------------------------------------------------------
+    def resource_usage(self, clear = False) :
+        """
+        return the resources used by the requests processed since the
+        last clear, serialized as a json object keyed by contract id
+
+        :param clear: boolean, reset the counters after reading them
+        """
+        return pdo_enclave.resource_usage_export(clear)
+
+    # -------------------------------------------------------
+    def memory_usage(self) :
+        """
+        return the largest heap, wasm memory, wasm pool and state cache
+        peaks reported by the requests processed since the enclaves
+        were started, serialized as a json object
+        """
+        return pdo_enclave.memory_usage_export()
+
     # -------------------------------------------------------
     def verify_secrets(self, contract_id, owner_id, secret_list) :
         """
@@ -93,6 +93,12 @@ def StartEnclaveService(config, enclave) :
     logger.info('enclave_id: %s', enclave.enclave_id)
     logger.info('storage service: %s', storage_url)
 
+    trace_file = config['EnclaveService'].get('TraceFile')
+    if trace_file :
+        logger.info('tracing enabled, trace file: %s', trace_file)
+        pdo_enclave_helper.enable_tracing()
+        reactor.addSystemEventTrigger('after', 'shutdown', pdo_enclave_helper.save_trace, trace_file)
+
     thread_pool = ThreadPool(minthreads=1, maxthreads=worker_threads)
     thread_pool.start()
     reactor.addSystemEventTrigger('before', 'shutdown', thread_pool.stop)
@@ -101,6 +107,7 @@ def StartEnclaveService(config, enclave) :
     root.putChild(b'info', WSGIResource(reactor, thread_pool, AppWrapperMiddleware(InfoApp(enclave, storage_url))))
     root.putChild(b'initialize', WSGIResource(reactor, thread_pool, AppWrapperMiddleware(InitializeApp(enclave))))
     root.putChild(b'invoke', WSGIResource(reactor, thread_pool, AppWrapperMiddleware(InvokeApp(enclave))))
+    root.putChild(b'usage', WSGIResource(reactor, thread_pool, AppWrapperMiddleware(UsageApp(enclave))))
     root.putChild(b'verify', WSGIResource(reactor, thread_pool, AppWrapperMiddleware(VerifyApp(enclave))))
 
     site = Site(root, timeout=60)
@@ -279,6 +286,7 @@ def Main() :
     parser.add_argument('--loglevel', help='Logging level', type=str)
 
     parser.add_argument('--http', help='Port on which to run the http server', type=int)
+    parser.add_argument('--trace-file', help='Name of the file where tracing spans are saved on shutdown', type=str)
     parser.add_argument('--ledger', help='Default url for connection to the ledger', type=str)
 
     parser.add_argument('--block-store', help='Name of the file where blocks are stored', type=str)
@@ -338,6 +346,8 @@ def Main() :
         }
     if options.http :
         config['EnclaveService']['HttpPort'] = options.http
+    if options.trace_file :
+        config['EnclaveService']['TraceFile'] = options.trace_file
 
     if config.get('EnclaveData') is None :
         config['EnclaveData'] = {
@@ -15,6 +15,7 @@
 from pdo.eservice.wsgi.info import InfoApp
 from pdo.eservice.wsgi.initialize import InitializeApp
 from pdo.eservice.wsgi.invoke import InvokeApp
+from pdo.eservice.wsgi.usage import UsageApp
 from pdo.eservice.wsgi.verify import VerifyApp
 
-__all__ = [ 'InfoApp', 'InitializeApp', 'InvokeApp', 'VerifyApp' ]
+__all__ = [ 'InfoApp', 'InitializeApp', 'InvokeApp', 'UsageApp', 'VerifyApp' ]
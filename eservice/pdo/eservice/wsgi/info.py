@@ -42,6 +42,7 @@ class InfoApp(object) :
             response['enclave_id'] = self.enclave.enclave_id
             response['interpreter'] = self.enclave.interpreter
             response['storage_service_url'] = self.storage_url
+            response['memory_usage'] = json.loads(self.enclave.memory_usage())
 
             result = json.dumps(response).encode()
         except Exception as e :
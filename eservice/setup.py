@@ -120,7 +120,6 @@ module_files = [
     os.path.join(module_src_path, 'enclave/base.cpp'),
     os.path.join(module_src_path, 'enclave/contract.cpp'),
     os.path.join(module_src_path, 'enclave/signup.cpp'),
-    os.path.join(module_src_path, 'enclave/enclave_queue.cpp'),
     os.path.join(module_src_path, 'enclave/enclave.cpp'),
     os.path.join(module_src_path, 'enclave_info.cpp'),
     os.path.join(module_src_path, 'signup_info.cpp'),
@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <map>
 #include <vector>
 #include <assert.h>
 
@@ -30,6 +31,7 @@
 #include <sgx_trts.h>
 #include <sgx_utils.h>  // sgx_get_key, sgx_create_report
 #include <sgx_quote.h>
+#include <sgx_thread.h>
 
 #include "crypto.h"
 #include "error.h"
@@ -62,6 +64,15 @@ static void CreateReportData(const char* pOriginatorPublicKeyHash,
     std::string& enclaveEncryptKey,
     sgx_report_data_t* pReportData);
 
+static pdo_err_t GenerateEnclaveSecret(const EnclaveData& enclaveData,
+    const uint8_t* inSealedSecret,
+    size_t inSealedSecretSize,
+    const std::string& contractId,
+    const std::string& opk,
+    const std::string& enclaveInfo,
+    uint8_t* outSignedSecret,
+    size_t inAllocatedSignedSecretSize);
+
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 pdo_err_t ecall_CalculateSealedEnclaveDataSize(size_t* pSealedEnclaveDataSize)
@@ -433,83 +444,108 @@ pdo_err_t ecall_GenerateEnclaveSecret(const uint8_t* inSealedEnclaveData,
         pdo::error::ThrowIfNull(inEnclaveInfo, "Enclave Info pointer is NULL");
         pdo::error::ThrowIfNull(outSignedSecret, "Signed Secret pointer is NULL");
 
-        pdo_err_t presult;
-
-        //Unseal Secret
-        uint32_t inAllocatedPlainSecretSize = sgx_get_encrypt_txt_len(reinterpret_cast<const sgx_sealed_data_t*>(inSealedSecret));
-
-        ByteArray plainSecretBuffer(inAllocatedPlainSecretSize);
-        ecall_UnsealSecret(inSealedSecret, inSealedSecretSize, plainSecretBuffer.data(), plainSecretBuffer.size());
-
-        HexEncodedString plainSecret = ByteArrayToHexEncodedString(plainSecretBuffer);
-        pdo::error::ThrowIf<pdo::error::ValueError>(
-            plainSecret.length() < ENCODED_SECRET_SIZE,
-            "secret is too short");
-
-        pdo::error::ThrowIf<pdo::error::ValueError>(
-            plainSecret.length() > ENCODED_SECRET_SIZE,
-            "secret is too long");
-
-        const std::string enclaveInfo(inEnclaveInfo);
-        std::string enclaveId;
-        std::string enclaveEncryptKey;
-        const std::string secret(plainSecret);
-        const std::string contractId(inContractId);
-        const std::string opk(inOpk);
-
-        presult = VerifyEnclaveInfo(enclaveInfo, enclaveId, enclaveEncryptKey);
-        if (presult != PDO_SUCCESS)
-            return presult;
-
         // Unseal the enclave persistent data
         EnclaveData enclaveData(inSealedEnclaveData);
 
-        ByteArray message;
-        std::copy(secret.begin(), secret.end(), std::back_inserter(message));
-        std::copy(enclaveId.begin(), enclaveId.end(), std::back_inserter(message));
-        std::copy(contractId.begin(), contractId.end(), std::back_inserter(message));
-        std::copy(opk.begin(), opk.end(), std::back_inserter(message));
+        result = GenerateEnclaveSecret(enclaveData,
+            inSealedSecret,
+            inSealedSecretSize,
+            inContractId,
+            inOpk,
+            inEnclaveInfo,
+            outSignedSecret,
+            inAllocatedSignedSecretSize);
 
-        std::string msg = secret + enclaveId + contractId + opk;
-        SAFE_LOG(PDO_LOG_WARNING, "MESSAGE: <%s>\n", msg.c_str());
+    }catch (pdo::error::Error& e) {
+        SAFE_LOG(
+            PDO_LOG_ERROR,
+            "Error in pdo enclave(ecall_GenerateEnclaveSecret): %04X -- %s",
+            e.error_code(),
+            e.what());
+        ocall_SetErrorMessage(e.what());
+        result = e.error_code();
+    } catch (...) {
+        SAFE_LOG(
+            PDO_LOG_ERROR,
+            "Unknown error in pdo enclave(ecall_GenerateEnclaveSecret)");
+        result = PDO_ERR_UNKNOWN;
+    }
 
-        const ByteArray signature = enclaveData.sign_message(message);
+    return result;
+}// ecall_GenerateEnclaveSecret
 
-        HexEncodedString secretsig = ByteArrayToHexEncodedString(signature);
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+pdo_err_t ecall_GenerateEnclaveSecrets(const uint8_t* inSealedEnclaveData,
+    size_t inSealedEnclaveDataSize,
+    const char* inSecretRequests,
+    uint8_t* outSignedSecrets,
+    size_t inAllocatedSignedSecretsSize,
+    size_t inSignedSecretSize)
+{
+    pdo_err_t result = PDO_SUCCESS;
 
-        int required_padding = 2 * enclaveData.max_sig_size(false) - secretsig.length();
-        secretsig.append(required_padding,'0');
+    try {
+        pdo::error::ThrowIfNull(inSealedEnclaveData, "Sealed enclave data pointer is NULL");
+        pdo::error::ThrowIfNull(inSecretRequests, "Secret requests pointer is NULL");
+        pdo::error::ThrowIfNull(outSignedSecrets, "Signed secrets pointer is NULL");
 
-        pdo::error::ThrowIf<pdo::error::ValueError>(
-            secretsig.length() < enclaveData.max_sig_size(true),
-            "secretsig is too short");
+        JsonValue requestsParsed(json_parse_string(inSecretRequests));
+        pdo::error::ThrowIfNull(requestsParsed.value, "Failed to parse the secret requests, badly formed JSON");
 
-        pdo::error::ThrowIf<pdo::error::ValueError>(
-            secretsig.length() > enclaveData.max_sig_size(true),
-            "secretsig is too long");
+        JSON_Array* request_array = json_value_get_array(requestsParsed);
+        pdo::error::ThrowIfNull(request_array, "Invalid secret requests, expecting array");
 
-        ByteArray enclaveMessage;
-        std::copy(secret.begin(), secret.end(), std::back_inserter(enclaveMessage));
-        std::copy(secretsig.begin(), secretsig.end(), std::back_inserter(enclaveMessage));
+        size_t request_count = json_array_get_count(request_array);
         pdo::error::ThrowIf<pdo::error::ValueError>(
-            enclaveMessage.size() < ENCODED_SECRET_SIZE + enclaveData.max_sig_size(true),
-            "enclaveMessage is too short");
-
-        pdo::crypto::pkenc::PublicKey enclaveKey(enclaveEncryptKey);
-
+            request_count < 1, "there must be at least one secret request");
         pdo::error::ThrowIf<pdo::error::ValueError>(
-            enclaveMessage.size() < secret.length() + secretsig.length(),
-            "enclaveMessage is too short");
+            inSignedSecretSize == 0 ||
+            inAllocatedSignedSecretsSize / inSignedSecretSize != request_count ||
+            inAllocatedSignedSecretsSize % inSignedSecretSize != 0,
+            "Signed secrets buffer does not match the number of requests");
 
-        const ByteArray esecret = enclaveKey.EncryptMessage(enclaveMessage);
+        // the enclave data is unsealed once for the whole batch
+        EnclaveData enclaveData(inSealedEnclaveData);
 
-        Zero(outSignedSecret, inAllocatedSignedSecretSize);
-        memcpy_s(outSignedSecret, inAllocatedSignedSecretSize, esecret.data(), esecret.size());
+        const char* svalue = nullptr;
+        for (size_t i = 0; i < request_count; i++)
+        {
+            JSON_Object* request_object = json_array_get_object(request_array, i);
+            pdo::error::ThrowIfNull(request_object, "Invalid secret request, expecting object");
+
+            svalue = json_object_dotget_string(request_object, "sealed_secret");
+            pdo::error::ThrowIfNull(svalue, "Invalid sealed_secret");
+            const ByteArray sealedSecret = base64_decode(svalue);
+
+            svalue = json_object_dotget_string(request_object, "contract_id");
+            pdo::error::ThrowIfNull(svalue, "Invalid contract_id");
+            const std::string contractId(svalue);
+
+            svalue = json_object_dotget_string(request_object, "opk");
+            pdo::error::ThrowIfNull(svalue, "Invalid opk");
+            const std::string opk(svalue);
+
+            svalue = json_object_dotget_string(request_object, "enclave_info");
+            pdo::error::ThrowIfNull(svalue, "Invalid enclave_info");
+            const std::string enclaveInfo(svalue);
+
+            // a request that fails verification fails the whole batch
+            result = GenerateEnclaveSecret(enclaveData,
+                sealedSecret.data(),
+                sealedSecret.size(),
+                contractId,
+                opk,
+                enclaveInfo,
+                outSignedSecrets + i * inSignedSecretSize,
+                inSignedSecretSize);
+            if (result != PDO_SUCCESS)
+                return result;
+        }
 
     }catch (pdo::error::Error& e) {
         SAFE_LOG(
             PDO_LOG_ERROR,
-            "Error in pdo enclave(ecall_GenerateEnclaveSecret): %04X -- %s",
+            "Error in pdo enclave(ecall_GenerateEnclaveSecrets): %04X -- %s",
             e.error_code(),
             e.what());
         ocall_SetErrorMessage(e.what());
@@ -517,12 +553,12 @@ pdo_err_t ecall_GenerateEnclaveSecret(const uint8_t* inSealedEnclaveData,
     } catch (...) {
         SAFE_LOG(
             PDO_LOG_ERROR,
-            "Unknown error in pdo enclave(ecall_GenerateEnclaveSecret)");
+            "Unknown error in pdo enclave(ecall_GenerateEnclaveSecrets)");
         result = PDO_ERR_UNKNOWN;
     }
 
     return result;
-}// ecall_GenerateEnclaveSecret
+}// ecall_GenerateEnclaveSecrets
 
 
 
@@ -530,6 +566,154 @@ pdo_err_t ecall_GenerateEnclaveSecret(const uint8_t* inSealedEnclaveData,
 // XX Internal helper functions                                      XX
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// cache of verified enclave infos
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
+// verifying the proof data of an enclave info means checking the IAS
+// certificate chain and report signature, adding an enclave to many
+// contracts repeats that work for the same enclave info; the cache
+// maps the verifying key to the hash of the enclave info that passed
+// verification, any change to the enclave info misses the cache
+#define VERIFIED_ENCLAVE_CACHE_SIZE 256
+
+typedef struct
+{
+    ByteArray info_hash;
+    uint64_t last_use;
+} verified_enclave_entry_t;
+
+static sgx_thread_mutex_t verified_enclave_cache_mutex = SGX_THREAD_MUTEX_INITIALIZER;
+static std::map<std::string, verified_enclave_entry_t> g_VerifiedEnclaveCache;
+static uint64_t g_VerifiedEnclaveCacheClock = 0;
+
+class VerifiedEnclaveCacheLock
+{
+public:
+    VerifiedEnclaveCacheLock(void) { sgx_thread_mutex_lock(&verified_enclave_cache_mutex); }
+    ~VerifiedEnclaveCacheLock(void) { sgx_thread_mutex_unlock(&verified_enclave_cache_mutex); }
+};
+
+static bool IsVerifiedEnclaveInfo(const std::string& enclaveId, const ByteArray& infoHash)
+{
+    VerifiedEnclaveCacheLock lock;
+
+    std::map<std::string, verified_enclave_entry_t>::iterator it = g_VerifiedEnclaveCache.find(enclaveId);
+    if (it == g_VerifiedEnclaveCache.end() || it->second.info_hash != infoHash)
+        return false;
+
+    it->second.last_use = ++g_VerifiedEnclaveCacheClock;
+    return true;
+}
+
+static void SaveVerifiedEnclaveInfo(const std::string& enclaveId, const ByteArray& infoHash)
+{
+    VerifiedEnclaveCacheLock lock;
+
+    if (g_VerifiedEnclaveCache.find(enclaveId) == g_VerifiedEnclaveCache.end() &&
+        g_VerifiedEnclaveCache.size() >= VERIFIED_ENCLAVE_CACHE_SIZE)
+    {
+        std::map<std::string, verified_enclave_entry_t>::iterator oldest = g_VerifiedEnclaveCache.begin();
+        std::map<std::string, verified_enclave_entry_t>::iterator it;
+        for (it = g_VerifiedEnclaveCache.begin(); it != g_VerifiedEnclaveCache.end(); it++)
+            if (it->second.last_use < oldest->second.last_use)
+                oldest = it;
+
+        g_VerifiedEnclaveCache.erase(oldest);
+    }
+
+    verified_enclave_entry_t& entry = g_VerifiedEnclaveCache[enclaveId];
+    entry.info_hash = infoHash;
+    entry.last_use = ++g_VerifiedEnclaveCacheClock;
+}
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+static pdo_err_t GenerateEnclaveSecret(const EnclaveData& enclaveData,
+    const uint8_t* inSealedSecret,
+    size_t inSealedSecretSize,
+    const std::string& contractId,
+    const std::string& opk,
+    const std::string& enclaveInfo,
+    uint8_t* outSignedSecret,
+    size_t inAllocatedSignedSecretSize)
+{
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        inSealedSecretSize < sizeof(sgx_sealed_data_t),
+        "sealed secret is too short");
+
+    //Unseal Secret
+    uint32_t inAllocatedPlainSecretSize = sgx_get_encrypt_txt_len(reinterpret_cast<const sgx_sealed_data_t*>(inSealedSecret));
+
+    ByteArray plainSecretBuffer(inAllocatedPlainSecretSize);
+    pdo_err_t presult = ecall_UnsealSecret(inSealedSecret, inSealedSecretSize, plainSecretBuffer.data(), plainSecretBuffer.size());
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        presult != PDO_SUCCESS, "failed to unseal the secret");
+
+    HexEncodedString plainSecret = ByteArrayToHexEncodedString(plainSecretBuffer);
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        plainSecret.length() < ENCODED_SECRET_SIZE,
+        "secret is too short");
+
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        plainSecret.length() > ENCODED_SECRET_SIZE,
+        "secret is too long");
+
+    std::string enclaveId;
+    std::string enclaveEncryptKey;
+    const std::string secret(plainSecret);
+
+    presult = VerifyEnclaveInfo(enclaveInfo, enclaveId, enclaveEncryptKey);
+    if (presult != PDO_SUCCESS)
+        return presult;
+
+    ByteArray message;
+    std::copy(secret.begin(), secret.end(), std::back_inserter(message));
+    std::copy(enclaveId.begin(), enclaveId.end(), std::back_inserter(message));
+    std::copy(contractId.begin(), contractId.end(), std::back_inserter(message));
+    std::copy(opk.begin(), opk.end(), std::back_inserter(message));
+
+    std::string msg = secret + enclaveId + contractId + opk;
+    SAFE_LOG(PDO_LOG_WARNING, "MESSAGE: <%s>\n", msg.c_str());
+
+    const ByteArray signature = enclaveData.sign_message(message);
+
+    HexEncodedString secretsig = ByteArrayToHexEncodedString(signature);
+
+    int required_padding = 2 * enclaveData.max_sig_size(false) - secretsig.length();
+    secretsig.append(required_padding,'0');
+
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        secretsig.length() < enclaveData.max_sig_size(true),
+        "secretsig is too short");
+
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        secretsig.length() > enclaveData.max_sig_size(true),
+        "secretsig is too long");
+
+    ByteArray enclaveMessage;
+    std::copy(secret.begin(), secret.end(), std::back_inserter(enclaveMessage));
+    std::copy(secretsig.begin(), secretsig.end(), std::back_inserter(enclaveMessage));
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        enclaveMessage.size() < ENCODED_SECRET_SIZE + enclaveData.max_sig_size(true),
+        "enclaveMessage is too short");
+
+    pdo::crypto::pkenc::PublicKey enclaveKey(enclaveEncryptKey);
+
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        enclaveMessage.size() < secret.length() + secretsig.length(),
+        "enclaveMessage is too short");
+
+    const ByteArray esecret = enclaveKey.EncryptMessage(enclaveMessage);
+    pdo::error::ThrowIf<pdo::error::ValueError>(
+        esecret.size() > inAllocatedSignedSecretSize,
+        "signed secret buffer is too small");
+
+    Zero(outSignedSecret, inAllocatedSignedSecretSize);
+    memcpy_s(outSignedSecret, inAllocatedSignedSecretSize, esecret.data(), esecret.size());
+
+    return PDO_SUCCESS;
+}  // GenerateEnclaveSecret
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 pdo_err_t VerifyEnclaveInfo(const std::string& enclaveInfo,
     std::string& enclaveId,
@@ -560,7 +744,17 @@ pdo_err_t VerifyEnclaveInfo(const std::string& enclaveInfo,
     pdo::error::ThrowIfNull(svalue, "Invalid owner_id");
     const std::string ownerId(svalue);
 
+    // the keys come from the enclave info itself so an identical
+    // enclave info that was verified before needs no further checks
+    const ByteArray enclaveInfoHash =
+        pdo::crypto::ComputeMessageHash(ByteArray(enclaveInfo.begin(), enclaveInfo.end()));
+    if (IsVerifiedEnclaveInfo(enclaveId, enclaveInfoHash))
+        return result;
+
+    // there is no proof to check in the simulator, the info is still
+    // cached so the cache behaves the same way in simulator tests
     if (IS_SGX_SIMULATOR){
+        SaveVerifiedEnclaveInfo(enclaveId, enclaveInfoHash);
         return result;
     }
 
@@ -676,6 +870,7 @@ pdo_err_t VerifyEnclaveInfo(const std::string& enclaveInfo,
         memcmp(computedReportData.d, expectedReportData.d, SGX_REPORT_DATA_SIZE)  != 0,
         "Invalid Report data: computedReportData does not match expectedReportData");
 
+    SaveVerifiedEnclaveInfo(enclaveId, enclaveInfoHash);
 
     return result;
 }// VerifyEnclaveInfo
@@ -82,3 +82,15 @@ extern pdo_err_t ecall_GenerateEnclaveSecret(
     const char* inEnclaveInfo,
     uint8_t* outSignedSecret,
     size_t inAllocatedSignedSecretSize);
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+// inSecretRequests is a JSON array, each element is an object with the
+// sealed_secret (base64), contract_id, opk and enclave_info; the signed
+// secret for element i is written at offset i * inSignedSecretSize
+extern pdo_err_t ecall_GenerateEnclaveSecrets(
+    const uint8_t* inSealedEnclaveData,
+    size_t inSealedEnclaveDataSize,
+    const char* inSecretRequests,
+    uint8_t* outSignedSecrets,
+    size_t inAllocatedSignedSecretsSize,
+    size_t inSignedSecretSize);
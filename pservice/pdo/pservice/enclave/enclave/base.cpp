@@ -28,6 +28,7 @@
 
 static bool g_IsInitialized = false;
 static std::string g_LastError;
+static pdo::enclave_queue::EnclaveQueue *g_EnclaveReadyQueue;
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 // XX External interface                                             XX
@@ -47,6 +48,12 @@ int pdo::enclave_api::base::IsSgxSimulator()
 #endif // defined(SGX_SIMULATOR)
 } // pdo::enclave_api::base::IsSgxSimulator
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+pdo::enclave_queue::ReadyEnclave pdo::enclave_api::base::GetReadyEnclave()
+{
+    return pdo::enclave_queue::ReadyEnclave(g_EnclaveReadyQueue);
+} // pdo::enclave_api::base::GetReadyEnclave
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 void pdo::enclave_api::base::SetLastError(
     const std::string& message
@@ -64,7 +71,8 @@ std::string pdo::enclave_api::base::GetLastError(void)
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 pdo_err_t pdo::enclave_api::base::Initialize(
     const std::string& inPathToEnclave,
-    const HexEncodedString& inSpid
+    const HexEncodedString& inSpid,
+    const int numOfEnclaves
     )
 {
     pdo_err_t ret = PDO_SUCCESS;
@@ -72,8 +80,26 @@ pdo_err_t pdo::enclave_api::base::Initialize(
     try {
         if (!g_IsInitialized)
         {
-            g_Enclave.SetSpid(inSpid);
-            g_Enclave.Load(inPathToEnclave);
+            pdo::error::ThrowIf<pdo::error::ValueError>(
+                numOfEnclaves < 1, "Invalid number of enclaves");
+
+            if (g_EnclaveReadyQueue == NULL) g_EnclaveReadyQueue = new pdo::enclave_queue::EnclaveQueue();
+
+            // the vector must not reallocate once the enclaves are
+            // loaded, the enclave destructor unloads the enclave
+            g_Enclave.reserve(numOfEnclaves);
+            for (int i = 0; i < numOfEnclaves; ++i)
+            {
+                g_Enclave.push_back(pdo::enclave_api::Enclave());
+                g_EnclaveReadyQueue->push(i);
+            }
+
+            for (pdo::enclave_api::Enclave& enc : g_Enclave)
+            {
+                enc.SetSpid(inSpid);
+                enc.Load(inPathToEnclave);
+            }
+
             g_IsInitialized = true;
         }
     } catch (pdo::error::Error& e) {
@@ -98,7 +124,8 @@ pdo_err_t pdo::enclave_api::base::Terminate()
 
     try {
         if (g_IsInitialized) {
-            g_Enclave.Unload();
+            for (pdo::enclave_api::Enclave& enc : g_Enclave)
+                enc.Unload();
             g_IsInitialized = false;
         }
     } catch (pdo::error::Error& e) {
@@ -118,7 +145,7 @@ pdo_err_t pdo::enclave_api::base::Terminate()
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 size_t pdo::enclave_api::base::GetEnclaveQuoteSize()
 {
-    return g_Enclave.GetQuoteSize();
+    return g_Enclave[0].GetQuoteSize();
 } // pdo::enclave_api::base::GetEnclaveQuoteSize
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -151,7 +178,7 @@ pdo_err_t pdo::enclave_api::base::GetEpidGroup(
      try {
         // Get the EPID group from the enclave and convert it to big endian
         sgx_epid_group_id_t epidGroup = { 0 };
-        g_Enclave.GetEpidGroup(&epidGroup);
+        g_Enclave[0].GetEpidGroup(&epidGroup);
 
         std::reverse((uint8_t*)&epidGroup, (uint8_t*)&epidGroup + sizeof(epidGroup));
 
@@ -185,7 +212,7 @@ pdo_err_t pdo::enclave_api::base::GetEnclaveCharacteristics(
         sgx_measurement_t enclaveMeasurement;
         sgx_basename_t enclaveBasename;
 
-        g_Enclave.GetEnclaveCharacteristics(
+        g_Enclave[0].GetEnclaveCharacteristics(
             &enclaveMeasurement,
             &enclaveBasename);
 
@@ -219,7 +246,9 @@ pdo_err_t pdo::enclave_api::base::SetSignatureRevocationList(
     pdo_err_t ret = PDO_SUCCESS;
 
     try {
-        g_Enclave.SetSignatureRevocationList(inSignatureRevocationList);
+        // every enclave in the pool may be asked for a quote
+        for (pdo::enclave_api::Enclave& enc : g_Enclave)
+            enc.SetSignatureRevocationList(inSignatureRevocationList);
     } catch (pdo::error::Error& e) {
         pdo::enclave_api::base::SetLastError(e.what());
         ret = e.error_code();
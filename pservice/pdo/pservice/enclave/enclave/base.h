@@ -21,6 +21,7 @@
 #include "error.h"
 #include "pdo_error.h"
 #include "types.h"
+#include "untrusted/enclave_queue.h"
 
 namespace pdo
 {
@@ -46,16 +47,24 @@ namespace pdo
             */
             std::string GetLastError(void);
 
+            /*
+              Returns the index of the next available enclave in the pool,
+              the index is returned to the pool when the object is destroyed
+            */
+            pdo::enclave_queue::ReadyEnclave GetReadyEnclave();
+
             /*
               Start the pdo services
 
               inPathToEnclave - A pointer to a string that contains the path to the
               enclave DLL.
               inSpid - A pointer to a string that contains the hex encoded SPID.
+              numOfEnclaves - The number of enclaves to load into the pool.
             */
             pdo_err_t Initialize(
                 const std::string& inPathToEnclave,
-                const HexEncodedString& inSpid
+                const HexEncodedString& inSpid,
+                const int numOfEnclaves = 1
                 );
 
             /*
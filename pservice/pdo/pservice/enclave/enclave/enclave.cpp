@@ -35,7 +35,7 @@
 #include "enclave.h"
 
 extern std::string g_enclaveError;
-pdo::enclave_api::Enclave g_Enclave;
+std::vector<pdo::enclave_api::Enclave> g_Enclave;
 
 namespace pdo {
     namespace error {
@@ -72,7 +72,7 @@ namespace pdo {
             this->quoteSize = size;
 
             //initialize the targetinfo and epid variables
-            ret = g_Enclave.CallSgx([this] () {
+            ret = this->CallSgx([this] () {
                     return sgx_init_quote(&this->reportTargetInfo, &this->epidGroupId);
                 });
             pdo::error::ThrowSgxError(ret, "Failed to initialized quote in enclave constructore");
@@ -129,7 +129,7 @@ namespace pdo {
         {
             sgx_status_t ret;
             //retrieve epid by calling init quote
-            ret = g_Enclave.CallSgx([this] () {
+            ret = this->CallSgx([this] () {
                         return sgx_init_quote(&this->reportTargetInfo, &this->epidGroupId);
                     });
             pdo::error::ThrowSgxError(ret, "Failed to get epid group id from init_quote");
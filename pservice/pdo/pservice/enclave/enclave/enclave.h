@@ -117,4 +117,4 @@ namespace pdo {
 } // namespace pdo
 
 
-extern pdo::enclave_api::Enclave g_Enclave;
+extern std::vector<pdo::enclave_api::Enclave> g_Enclave;
@@ -36,7 +36,7 @@ namespace constants = pdo::crypto::constants;
 
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-static size_t CalculateSealedEnclaveDataSize(void)
+static size_t CalculateSealedEnclaveDataSize(int enclaveIndex)
 {
     size_t sealed_data_size;
 
@@ -44,10 +44,10 @@ static size_t CalculateSealedEnclaveDataSize(void)
     sgx_status_t sresult;
 
     // get the enclave id for passing into the ecall
-    sgx_enclave_id_t enclaveid = g_Enclave.GetEnclaveId();
+    sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
 
     sresult =
-        g_Enclave.CallSgx(
+        g_Enclave[enclaveIndex].CallSgx(
             [ enclaveid,
               &presult,
               &sealed_data_size ] ()
@@ -60,14 +60,14 @@ static size_t CalculateSealedEnclaveDataSize(void)
                 return pdo::error::ConvertErrorStatus(ret, presult);
             });
     pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (ecall_CalculateSealedEnclaveDataSize)");
-    g_Enclave.ThrowPDOError(presult);
+    g_Enclave[enclaveIndex].ThrowPDOError(presult);
 
     return sealed_data_size;
 } // CalculateSealedEnclaveDataSize
 
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-static size_t CalculatePublicEnclaveDataSize(void)
+static size_t CalculatePublicEnclaveDataSize(int enclaveIndex)
 {
     size_t public_data_size;
 
@@ -75,10 +75,10 @@ static size_t CalculatePublicEnclaveDataSize(void)
     sgx_status_t sresult;
 
     // get the enclave id for passing into the ecall
-    sgx_enclave_id_t enclaveid = g_Enclave.GetEnclaveId();
+    sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
 
     sresult =
-        g_Enclave.CallSgx(
+        g_Enclave[enclaveIndex].CallSgx(
             [ enclaveid,
               &presult,
               &public_data_size ] ()
@@ -91,14 +91,15 @@ static size_t CalculatePublicEnclaveDataSize(void)
                 return pdo::error::ConvertErrorStatus(ret, presult);
             });
     pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (ecall_CalculatePublicEnclaveDataSize)");
-    g_Enclave.ThrowPDOError(presult);
+    g_Enclave[enclaveIndex].ThrowPDOError(presult);
 
     return public_data_size;
 } // CalculatePublicEnclaveDataSize
 
 
 static size_t CalculateSealedSecretSize(
-    size_t plain_len
+    size_t plain_len,
+    int enclaveIndex
     )
 {
     size_t sealed_secret_size;
@@ -107,10 +108,10 @@ static size_t CalculateSealedSecretSize(
     sgx_status_t sresult;
 
     // get the enclave id for passing into the ecall
-    sgx_enclave_id_t enclaveid = g_Enclave.GetEnclaveId();
+    sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
 
     sresult =
-        g_Enclave.CallSgx(
+        g_Enclave[enclaveIndex].CallSgx(
             [ enclaveid,
               &presult,
               plain_len,
@@ -125,7 +126,7 @@ static size_t CalculateSealedSecretSize(
                 return pdo::error::ConvertErrorStatus(ret, presult);
             });
     pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (ecall_CalculateSealedSecretSize)");
-    g_Enclave.ThrowPDOError(presult);
+    g_Enclave[enclaveIndex].ThrowPDOError(presult);
 
     return sealed_secret_size;
 } // CalculateSealedEnclaveDataSize
@@ -133,7 +134,8 @@ static size_t CalculateSealedSecretSize(
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 static uint32_t CalculatePlainSecretSize(
-    const Base64EncodedString& inSealedSecret
+    const Base64EncodedString& inSealedSecret,
+    int enclaveIndex
     )
 {
 
@@ -145,10 +147,10 @@ static uint32_t CalculatePlainSecretSize(
     sgx_status_t sresult;
 
     // get the enclave id for passing into the ecall
-    sgx_enclave_id_t enclaveid = g_Enclave.GetEnclaveId();
+    sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
 
     sresult =
-        g_Enclave.CallSgx(
+        g_Enclave[enclaveIndex].CallSgx(
             [ enclaveid,
               &presult,
               sealed_secret,
@@ -164,7 +166,7 @@ static uint32_t CalculatePlainSecretSize(
                 return pdo::error::ConvertErrorStatus(ret, presult);
             });
     pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (ecall_CalculatePlainSecretSize)");
-    g_Enclave.ThrowPDOError(presult);
+    g_Enclave[enclaveIndex].ThrowPDOError(presult);
 
     return plain_secret_size;
 } // CalculatePlainSecretSize
@@ -175,7 +177,8 @@ static uint32_t CalculatePlainSecretSize(
 pdo_err_t pdo::enclave_api::enclave_data::CreateEnclaveData(
     StringArray& outPublicEnclaveData,
     Base64EncodedString& outSealedEnclaveData,
-    Base64EncodedString& outEnclaveQuote
+    Base64EncodedString& outEnclaveQuote,
+    int enclaveIndex
     )
 {
     pdo_err_t result = PDO_SUCCESS;
@@ -184,19 +187,19 @@ pdo_err_t pdo::enclave_api::enclave_data::CreateEnclaveData(
         pdo_err_t presult;
         sgx_status_t sresult;
 
-        outPublicEnclaveData.resize(CalculatePublicEnclaveDataSize());
+        outPublicEnclaveData.resize(CalculatePublicEnclaveDataSize(enclaveIndex));
 
-        ByteArray sealed_enclave_data_buffer(CalculateSealedEnclaveDataSize());
+        ByteArray sealed_enclave_data_buffer(CalculateSealedEnclaveDataSize(enclaveIndex));
 
         // get the enclave id for passing into the ecall
-        sgx_enclave_id_t enclaveid = g_Enclave.GetEnclaveId();
+        sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
 
         // We need target info in order to create signup data report
         sgx_target_info_t target_info = { 0 };
         sgx_epid_group_id_t epidGroupId = { 0 };
 
         sresult =
-            g_Enclave.CallSgx(
+            g_Enclave[enclaveIndex].CallSgx(
                 [&target_info,
                  &epidGroupId] () {
                     return sgx_init_quote(&target_info, &epidGroupId);
@@ -210,7 +213,7 @@ pdo_err_t pdo::enclave_api::enclave_data::CreateEnclaveData(
         size_t computed_public_enclave_data_size;
         size_t computed_sealed_enclave_data_size;
 
-        sresult = g_Enclave.CallSgx(
+        sresult = g_Enclave[enclaveIndex].CallSgx(
             [enclaveid,
              &presult,
              target_info,
@@ -234,7 +237,7 @@ pdo_err_t pdo::enclave_api::enclave_data::CreateEnclaveData(
                 return pdo::error::ConvertErrorStatus(ret, presult);
             });
         pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (ecall_CreateSignupData), failed to create signup data");
-        g_Enclave.ThrowPDOError(presult);
+        g_Enclave[enclaveIndex].ThrowPDOError(presult);
 
         // reset the size of the public data
         outPublicEnclaveData.resize(computed_public_enclave_data_size);
@@ -264,23 +267,24 @@ pdo_err_t pdo::enclave_api::enclave_data::CreateEnclaveData(
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 pdo_err_t pdo::enclave_api::enclave_data::UnsealEnclaveData(
     const Base64EncodedString& inSealedEnclaveData,
-    StringArray& outPublicEnclaveData
+    StringArray& outPublicEnclaveData,
+    int enclaveIndex
     )
 {
     pdo_err_t result = PDO_SUCCESS;
 
     try {
         ByteArray sealed_enclave_data = Base64EncodedStringToByteArray(inSealedEnclaveData);
-        outPublicEnclaveData.resize(CalculatePublicEnclaveDataSize());
+        outPublicEnclaveData.resize(CalculatePublicEnclaveDataSize(enclaveIndex));
 
         // xxxxx call the enclave
-        sgx_enclave_id_t enclaveid = g_Enclave.GetEnclaveId();
+        sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
 
         // Call down into the enclave to unseal the signup data
         size_t computed_public_enclave_data_size;
 
         pdo_err_t presult = PDO_SUCCESS;
-        sgx_status_t sresult = g_Enclave.CallSgx(
+        sgx_status_t sresult = g_Enclave[enclaveIndex].CallSgx(
             [ enclaveid,
               &presult,
               sealed_enclave_data,
@@ -300,7 +304,7 @@ pdo_err_t pdo::enclave_api::enclave_data::UnsealEnclaveData(
             });
 
         pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (ecall_UnsealSignupData)");
-        g_Enclave.ThrowPDOError(presult);
+        g_Enclave[enclaveIndex].ThrowPDOError(presult);
 
         outPublicEnclaveData.resize(computed_public_enclave_data_size);
 
@@ -323,20 +327,21 @@ pdo_err_t pdo::enclave_api::enclave_data::UnsealEnclaveData(
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 pdo_err_t pdo::enclave_api::enclave_data::CreateSealedSecret(
     const size_t secret_len,
-    Base64EncodedString& outSealedSecret
+    Base64EncodedString& outSealedSecret,
+    int enclaveIndex
     )
 {
     pdo_err_t result = PDO_SUCCESS;
 
     try {
 
-        ByteArray sealed_enclave_secret_buffer(CalculateSealedSecretSize(secret_len));
+        ByteArray sealed_enclave_secret_buffer(CalculateSealedSecretSize(secret_len, enclaveIndex));
 
         // xxxxx call the enclave
-        sgx_enclave_id_t enclaveid = g_Enclave.GetEnclaveId();
+        sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
 
         pdo_err_t presult = PDO_SUCCESS;
-        sgx_status_t sresult = g_Enclave.CallSgx(
+        sgx_status_t sresult = g_Enclave[enclaveIndex].CallSgx(
             [ enclaveid,
               &presult,
               secret_len,
@@ -352,7 +357,7 @@ pdo_err_t pdo::enclave_api::enclave_data::CreateSealedSecret(
                 return pdo::error::ConvertErrorStatus(sresult, presult);
             });
         pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (ecall_CreateSealedSecret)");
-        g_Enclave.ThrowPDOError(presult);
+        g_Enclave[enclaveIndex].ThrowPDOError(presult);
 
         outSealedSecret = ByteArrayToBase64EncodedString(sealed_enclave_secret_buffer);
 
@@ -376,7 +381,8 @@ pdo_err_t pdo::enclave_api::enclave_data::CreateSealedSecret(
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 pdo_err_t pdo::enclave_api::enclave_data::UnsealSecret(
     const Base64EncodedString& inSealedSecret,
-    HexEncodedString& outPlainSecret
+    HexEncodedString& outPlainSecret,
+    int enclaveIndex
     )
 {
     pdo_err_t result = PDO_SUCCESS;
@@ -384,13 +390,13 @@ pdo_err_t pdo::enclave_api::enclave_data::UnsealSecret(
     try {
         ByteArray sealed_secret = Base64EncodedStringToByteArray(inSealedSecret);
 
-        ByteArray plain_secret_buffer(CalculatePlainSecretSize(inSealedSecret));
+        ByteArray plain_secret_buffer(CalculatePlainSecretSize(inSealedSecret, enclaveIndex));
 
         // xxxxx call the enclave
-        sgx_enclave_id_t enclaveid = g_Enclave.GetEnclaveId();
+        sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
 
         pdo_err_t presult = PDO_SUCCESS;
-        sgx_status_t sresult = g_Enclave.CallSgx(
+        sgx_status_t sresult = g_Enclave[enclaveIndex].CallSgx(
             [ enclaveid,
               &presult,
               sealed_secret,
@@ -408,7 +414,7 @@ pdo_err_t pdo::enclave_api::enclave_data::UnsealSecret(
             });
 
         pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (ecall_UnsealSecret)");
-        g_Enclave.ThrowPDOError(presult);
+        g_Enclave[enclaveIndex].ThrowPDOError(presult);
 
         outPlainSecret = ByteArrayToHexEncodedString(plain_secret_buffer);
             } catch (pdo::error::Error& e) {
@@ -432,7 +438,8 @@ pdo_err_t pdo::enclave_api::enclave_data::GenerateEnclaveSecret(
         const std::string& inContractId,
         const std::string& inOpk,
         const std::string& inEnclaveInfo,
-        Base64EncodedString& ouSignedSecret
+        Base64EncodedString& ouSignedSecret,
+        int enclaveIndex
     )
 {
     pdo_err_t result = PDO_SUCCESS;
@@ -444,10 +451,10 @@ pdo_err_t pdo::enclave_api::enclave_data::GenerateEnclaveSecret(
         ByteArray signature_buffer(constants::RSA_KEY_SIZE >> 3);
 
         // xxxxx call the enclave
-        sgx_enclave_id_t enclaveid = g_Enclave.GetEnclaveId();
+        sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
 
         pdo_err_t presult = PDO_SUCCESS;
-        sgx_status_t sresult = g_Enclave.CallSgx(
+        sgx_status_t sresult = g_Enclave[enclaveIndex].CallSgx(
             [ enclaveid,
               &presult,
               sealed_enclave_data,
@@ -474,7 +481,7 @@ pdo_err_t pdo::enclave_api::enclave_data::GenerateEnclaveSecret(
             });
 
         pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (ecall_GenerateEnclaveSecret)");
-        g_Enclave.ThrowPDOError(presult);
+        g_Enclave[enclaveIndex].ThrowPDOError(presult);
 
         ouSignedSecret = ByteArrayToBase64EncodedString(signature_buffer);
 
@@ -491,3 +498,73 @@ pdo_err_t pdo::enclave_api::enclave_data::GenerateEnclaveSecret(
 
     return result;
 } // pdo::enclave_api::base::GenerateEnclaveSecret
+
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+pdo_err_t pdo::enclave_api::enclave_data::GenerateEnclaveSecrets(
+        const Base64EncodedString& inSealedEnclaveData,
+        const std::string& inSecretRequests,
+        size_t inRequestCount,
+        std::vector<Base64EncodedString>& outSignedSecrets,
+        int enclaveIndex
+    )
+{
+    pdo_err_t result = PDO_SUCCESS;
+
+    try {
+
+        ByteArray sealed_enclave_data = Base64EncodedStringToByteArray(inSealedEnclaveData);
+
+        // every signed secret occupies a fixed size slot in the buffer
+        const size_t signed_secret_size = constants::RSA_KEY_SIZE >> 3;
+        ByteArray signature_buffer(inRequestCount * signed_secret_size);
+
+        // xxxxx call the enclave
+        sgx_enclave_id_t enclaveid = g_Enclave[enclaveIndex].GetEnclaveId();
+
+        pdo_err_t presult = PDO_SUCCESS;
+        sgx_status_t sresult = g_Enclave[enclaveIndex].CallSgx(
+            [ enclaveid,
+              &presult,
+              &sealed_enclave_data,
+              &inSecretRequests,
+              signed_secret_size,
+              &signature_buffer] ()
+            {
+                sgx_status_t sresult =
+                ecall_GenerateEnclaveSecrets(
+                    enclaveid,
+                    &presult,
+                    sealed_enclave_data.data(),
+                    sealed_enclave_data.size(),
+                    inSecretRequests.c_str(),
+                    signature_buffer.data(),
+                    signature_buffer.size(),
+                    signed_secret_size);
+                return pdo::error::ConvertErrorStatus(sresult, presult);
+            });
+
+        pdo::error::ThrowSgxError(sresult, "SGX enclave call failed (ecall_GenerateEnclaveSecrets)");
+        g_Enclave[enclaveIndex].ThrowPDOError(presult);
+
+        outSignedSecrets.clear();
+        for (size_t i = 0; i < inRequestCount; i++)
+        {
+            ByteArray signed_secret(
+                signature_buffer.begin() + i * signed_secret_size,
+                signature_buffer.begin() + (i + 1) * signed_secret_size);
+            outSignedSecrets.push_back(ByteArrayToBase64EncodedString(signed_secret));
+        }
+
+    } catch (pdo::error::Error& e) {
+        pdo::enclave_api::base::SetLastError(e.what());
+        result = e.error_code();
+    } catch (std::exception& e) {
+        pdo::enclave_api::base::SetLastError(e.what());
+        result = PDO_ERR_UNKNOWN;
+    } catch (...) {
+        pdo::enclave_api::base::SetLastError("Unexpected exception");
+        result = PDO_ERR_UNKNOWN;
+    }
+
+    return result;
+} // pdo::enclave_api::base::GenerateEnclaveSecrets
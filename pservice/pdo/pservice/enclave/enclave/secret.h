@@ -19,6 +19,7 @@
 
 #include "types.h"
 #include <string>
+#include <vector>
 
 namespace pdo
 {
@@ -30,26 +31,30 @@ namespace pdo
             pdo_err_t CreateEnclaveData(
                 StringArray& outPublicEnclaveData,
                 Base64EncodedString& outSealedEnclaveData,
-                Base64EncodedString& outEnclaveQuote
+                Base64EncodedString& outEnclaveQuote,
+                int enclaveIndex
                 );
 
             // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
             pdo_err_t UnsealEnclaveData(
                 const Base64EncodedString& inSealedEnclaveData,
-                StringArray& outPublicEnclaveData
+                StringArray& outPublicEnclaveData,
+                int enclaveIndex
                 );
 
             // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
             pdo_err_t CreateSealedSecret(
                 const size_t secret_len,
-                Base64EncodedString& outSealedSecret
+                Base64EncodedString& outSealedSecret,
+                int enclaveIndex
                 );
 
 
             // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
             pdo_err_t UnsealSecret(
                 const Base64EncodedString& inSealedSecret,
-                HexEncodedString& outPlainSecret
+                HexEncodedString& outPlainSecret,
+                int enclaveIndex
                 );
 
             // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -59,7 +64,20 @@ namespace pdo
                 const std::string& inContractId,
                 const std::string& inOpk,
                 const std::string& inEnclaveInfo,
-                Base64EncodedString& ouSignedSecret
+                Base64EncodedString& ouSignedSecret,
+                int enclaveIndex
+                );
+
+            // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+            // inSecretRequests is a JSON array of inRequestCount objects, each
+            // with the sealed_secret, contract_id, opk and enclave_info; all of
+            // the secrets are generated with a single enclave transition
+            pdo_err_t GenerateEnclaveSecrets(
+                const Base64EncodedString& inSealedEnclaveData,
+                const std::string& inSecretRequests,
+                size_t inRequestCount,
+                std::vector<Base64EncodedString>& outSignedSecrets,
+                int enclaveIndex
                 );
 
 
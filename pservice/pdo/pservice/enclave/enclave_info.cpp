@@ -34,7 +34,8 @@ bool is_sgx_simulator()
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 pdo_enclave_info::pdo_enclave_info(
     const std::string& enclaveModulePath,
-    const std::string& spid
+    const std::string& spid,
+    const int num_of_enclaves
     )
 {
     pdo::logger::SetLogFunction(PyLog);
@@ -42,10 +43,12 @@ pdo_enclave_info::pdo_enclave_info(
     PyLog(PDO_LOG_INFO, "Initializing SGX PDO enclave");
     PyLogV(PDO_LOG_DEBUG, "Enclave path: %s", enclaveModulePath.c_str());
     PyLogV(PDO_LOG_DEBUG, "SPID: %s", spid.c_str());
+    PyLogV(PDO_LOG_DEBUG, "Number of enclaves: %d", num_of_enclaves);
 
     pdo_err_t ret = pdo::enclave_api::base::Initialize(
         enclaveModulePath,
-        spid
+        spid,
+        num_of_enclaves
         );
     ThrowPDOError(ret);
     PyLog(PDO_LOG_INFO, "SGX PDO enclave initialized.");
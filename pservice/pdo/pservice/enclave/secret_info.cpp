@@ -170,11 +170,14 @@ std::map<std::string, std::string> create_enclave_data()
     Base64EncodedString sealed_enclave_data;
     Base64EncodedString enclave_quote;
 
+    pdo::enclave_queue::ReadyEnclave readyEnclave = pdo::enclave_api::base::GetReadyEnclave();
+
     // Create the enclave data
     presult = pdo::enclave_api::enclave_data::CreateEnclaveData(
         public_enclave_data,
         sealed_enclave_data,
-        enclave_quote);
+        enclave_quote,
+        readyEnclave.getIndex());
     ThrowPDOError(presult);
 
     PyLog(PDO_LOG_DEBUG, public_enclave_data.str().c_str());
@@ -207,9 +210,12 @@ std::map<std::string, std::string> unseal_enclave_data(
     pdo_err_t presult;
     StringArray public_enclave_data(0); // UnsealEnclaveData will resize appropriately
 
+    pdo::enclave_queue::ReadyEnclave readyEnclave = pdo::enclave_api::base::GetReadyEnclave();
+
     presult = pdo::enclave_api::enclave_data::UnsealEnclaveData(
         sealed_enclave_data,
-        public_enclave_data);
+        public_enclave_data,
+        readyEnclave.getIndex());
     ThrowPDOError(presult);
 
     // parse the json and save the verifying and encryption keys
@@ -240,9 +246,12 @@ std::map<std::string, std::string> create_sealed_secret(
 
     Base64EncodedString sealed_secret;
 
+    pdo::enclave_queue::ReadyEnclave readyEnclave = pdo::enclave_api::base::GetReadyEnclave();
+
     presult = pdo::enclave_api::enclave_data::CreateSealedSecret(
         key_len,
-        sealed_secret);
+        sealed_secret,
+        readyEnclave.getIndex());
     ThrowPDOError(presult);
 
     PyLog(PDO_LOG_DEBUG,  ("Sealed Secret: "+sealed_secret).c_str());
@@ -265,9 +274,12 @@ std::map<std::string, std::string> unseal_secret(
     HexEncodedString plain_secret;
     // std::string plain_secret;
 
+    pdo::enclave_queue::ReadyEnclave readyEnclave = pdo::enclave_api::base::GetReadyEnclave();
+
     presult = pdo::enclave_api::enclave_data::UnsealSecret(
         sealed_secret,
-        plain_secret);
+        plain_secret,
+        readyEnclave.getIndex());
     ThrowPDOError(presult);
 
     PyLog(PDO_LOG_DEBUG, ("Sealed Secret: " + sealed_secret + "\nPlain Secret: " + plain_secret).c_str());
@@ -292,13 +304,16 @@ std::map<std::string, std::string> generate_enclave_secret(
 
     Base64EncodedString enclave_secret;
 
+    pdo::enclave_queue::ReadyEnclave readyEnclave = pdo::enclave_api::base::GetReadyEnclave();
+
     presult = pdo::enclave_api::enclave_data::GenerateEnclaveSecret(
         sealed_enclave_data,
         sealed_secret,
         contract_id,
         opk,
         enclave_info,
-        enclave_secret);
+        enclave_secret,
+        readyEnclave.getIndex());
     ThrowPDOError(presult);
 
     PyLog(PDO_LOG_DEBUG, ("Enclave Encrypted Secret: " + enclave_secret).c_str());
@@ -309,3 +324,41 @@ std::map<std::string, std::string> generate_enclave_secret(
     return result;
 } // _generate_enclave_secret
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+std::vector<std::string> generate_enclave_secrets(
+    const std::string& sealed_enclave_data,
+    const std::string& secret_requests
+    )
+{
+    pdo_err_t presult;
+
+    // the enclave checks the content of each request, the count is
+    // needed here to size the buffer for the signed secrets
+    size_t request_count;
+    {
+        JsonValue parsed(json_parse_string(secret_requests.c_str()));
+        pdo::error::ThrowIfNull(parsed.value, "failed to parse the secret requests; badly formed JSON");
+
+        JSON_Array* request_array = json_value_get_array(parsed);
+        pdo::error::ThrowIfNull(request_array, "invalid secret requests; expecting array");
+
+        request_count = json_array_get_count(request_array);
+        pdo::error::ThrowIf<pdo::error::ValueError>(
+            request_count < 1, "there must be at least one secret request");
+    }
+
+    std::vector<Base64EncodedString> enclave_secrets;
+
+    pdo::enclave_queue::ReadyEnclave readyEnclave = pdo::enclave_api::base::GetReadyEnclave();
+
+    presult = pdo::enclave_api::enclave_data::GenerateEnclaveSecrets(
+        sealed_enclave_data,
+        secret_requests,
+        request_count,
+        enclave_secrets,
+        readyEnclave.getIndex());
+    ThrowPDOError(presult);
+
+    std::vector<std::string> result(enclave_secrets.begin(), enclave_secrets.end());
+    return result;
+} // _generate_enclave_secrets
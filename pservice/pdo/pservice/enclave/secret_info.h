@@ -83,3 +83,11 @@ std::map<std::string, std::string> generate_enclave_secret(
     const std::string& opk,
     const std::string& enclave_info
     );
+
+// secret_requests is a JSON array of objects with the fields sealed_secret,
+// contract_id, opk and enclave_info; the result holds the encrypted secret
+// for each request in the same order
+std::vector<std::string> generate_enclave_secrets(
+    const std::string& sealed_enclave_data,
+    const std::string& secret_requests
+    );
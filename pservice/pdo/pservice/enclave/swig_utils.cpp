@@ -104,6 +104,10 @@ void PyLog(
         return;
     }
 
+    // the module is built with -threads so the GIL is released
+    // while the enclave runs, acquire it for the python callback
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
     // build msg-string
     PyObject *string = NULL;
     string = Py_BuildValue("s", msg);
@@ -131,6 +135,8 @@ void PyLog(
             break;
     }
     Py_DECREF(string);
+
+    PyGILState_Release(gstate);
 } // PyLog
 
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
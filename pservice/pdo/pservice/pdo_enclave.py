@@ -39,6 +39,7 @@ __all__ = [
     'create_secret',
     'unseal_secret',
     'generate_enclave_secret',
+    'generate_enclave_secrets',
     'shutdown'
 ]
 
@@ -143,6 +144,8 @@ def initialize_with_configuration(config) :
                 '{}'.format(
                     ', '.join(sorted(list(missing_keys)))))
 
+    num_of_enclaves = int(config.get('num_of_enclaves', 1))
+
     if not _ias:
         _ias = \
             ias_client.IasClient(
@@ -154,7 +157,7 @@ def initialize_with_configuration(config) :
     if not _pdo:
         signed_enclave = __find_enclave_library(config)
         logger.debug("Attempting to load enclave at: %s", signed_enclave)
-        _pdo = enclave.pdo_enclave_info(signed_enclave, config['spid'])
+        _pdo = enclave.pdo_enclave_info(signed_enclave, config['spid'], num_of_enclaves)
         logger.info("Basename: %s", get_enclave_basename())
         logger.info("MRENCLAVE: %s", get_enclave_measurement())
 
@@ -208,6 +211,16 @@ def unseal_secret(secret): return enclave.unseal_secret(secret)
 def generate_enclave_secret(enclave_sealed_data, sealed_secret, contract_id, opk, enclave_info):
  return enclave.generate_enclave_secret(enclave_sealed_data, sealed_secret, contract_id, opk, enclave_info)
 
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def generate_enclave_secrets(enclave_sealed_data, secret_requests):
+    """generate the secrets for a list of requests with a single call
+    into the enclave; each request is a dictionary with the fields
+    sealed_secret, contract_id, opk and enclave_info (serialized), the
+    encrypted secrets are returned in the order of the requests
+    """
+    return list(enclave.generate_enclave_secrets(enclave_sealed_data, json.dumps(secret_requests)))
+
 # -----------------------------------------------------------------
 # -----------------------------------------------------------------
 def create_enclave_info(nonce):
@@ -150,6 +150,10 @@ class Enclave(object) :
     def generate_enclave_secret(self, enclave_sealed_data, sealed_secret, contract_id, opk, enclave_info):
         return pdo_enclave.generate_enclave_secret(enclave_sealed_data, sealed_secret, contract_id, opk, enclave_info)
 
+    # -------------------------------------------------------
+    def generate_enclave_secrets(self, enclave_sealed_data, secret_requests):
+        return pdo_enclave.generate_enclave_secrets(enclave_sealed_data, secret_requests)
+
     # -------------------------------------------------------
     def get_enclave_public_info(self) :
         """
@@ -26,6 +26,7 @@ import argparse
 import json
 import hashlib
 import signal
+import threading
 import traceback
 
 from pdo.submitter.create import create_submitter
@@ -44,7 +45,7 @@ logger = logging.getLogger(__name__)
 ## XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
 from twisted.web import server, resource, http
-from twisted.internet import reactor, defer
+from twisted.internet import reactor, defer, threads
 from twisted.web.error import Error
 
 import base64
@@ -67,10 +68,12 @@ class ProvisioningServer(resource.Resource):
         self.__registry_helper = create_submitter(config['Ledger'])
 
         self.secrets_file_path = config['SecretsFilePath']
+        self.secrets_file_lock = threading.Lock()
         self.secret_length = 16
 
         self.RequestMap = {
             'secretRequest' : self._secretreq,
+            'secretRequests' : self._secretreqs,
             'dataRequest' : self._datareq,
         }
 
@@ -81,6 +84,12 @@ class ProvisioningServer(resource.Resource):
         raw format
         """
 
+        # requests run on worker threads, the secrets file is shared
+        with self.secrets_file_lock :
+            return self.__GetContractSecret(contracttxnid)
+
+    ## -----------------------------------------------------------------
+    def __GetContractSecret(self, contracttxnid) :
         file_secrets = dict()
         with open(self.secrets_file_path, "r") as f:
             for line in f:
@@ -132,7 +141,11 @@ class ProvisioningServer(resource.Resource):
         return response
 
     ## -----------------------------------------------------------------
-    def _secretreq(self, minfo) :
+    def _PrepareSecretRequest(self, minfo) :
+        """
+        Validate a request for a contract secret and return the parameters
+        the enclave needs to generate the secret
+        """
         # unpack the request
         try:
             enclave_id = minfo['enclave_id']
@@ -197,13 +210,26 @@ class ProvisioningServer(resource.Resource):
 
         logger.debug("Enclave Info: %s", str(enclave_info))
 
+        secret_request = dict()
+        secret_request['sealed_secret'] = sealed_secret
+        secret_request['contract_id'] = contract_id
+        secret_request['opk'] = opk
+        secret_request['enclave_info'] = json.dumps(enclave_info)
+
+        return (enclave_id, secret_request)
+
+    ## -----------------------------------------------------------------
+    def _secretreq(self, minfo) :
+        (enclave_id, secret_request) = self._PrepareSecretRequest(minfo)
+        contract_id = secret_request['contract_id']
+
         # Generate Secret for Contract Enclave, signs unsealed secret with contract enclave encryption key
         esecret = self.Enclave.generate_enclave_secret(
             self.SealedData,
-            sealed_secret,
+            secret_request['sealed_secret'],
             contract_id,
-            opk,
-            json.dumps(enclave_info),
+            secret_request['opk'],
+            secret_request['enclave_info'],
             )["enclave_secret"]
 
         logger.debug("Encrypted secret for contract %s: %s", contract_id, esecret)
@@ -216,6 +242,35 @@ class ProvisioningServer(resource.Resource):
         logger.info('created secret for contract %s and enclave %s', contract_id, enclave_id)
         return response
 
+    ## -----------------------------------------------------------------
+    def _secretreqs(self, minfo) :
+        """
+        Handle a batch of secret requests, each element of the requests
+        list has the same fields as a secretRequest; all of the secrets
+        are generated with a single call into the enclave
+        """
+        try:
+            requests = minfo['requests']
+        except KeyError as ke:
+            raise Error(http.BAD_REQUEST, 'missing required field {0}'.format(ke))
+
+        if not isinstance(requests, list) or len(requests) == 0 :
+            raise Error(http.BAD_REQUEST, 'requests must be a non-empty list')
+
+        prepared = [ self._PrepareSecretRequest(r) for r in requests ]
+        secret_requests = [ p[1] for p in prepared ]
+
+        esecrets = self.Enclave.generate_enclave_secrets(self.SealedData, secret_requests)
+
+        # create the response
+        response = dict()
+        response['pspk'] = self.PSPK
+        response['encrypted_secrets'] = esecrets
+
+        for (enclave_id, secret_request) in prepared :
+            logger.info('created secret for contract %s and enclave %s', secret_request['contract_id'], enclave_id)
+        return response
+
     ## -----------------------------------------------------------------
     def render_GET(self, request) :
         logger.warn('GET REQUEST: %s', request.uri)
@@ -255,22 +310,35 @@ class ProvisioningServer(resource.Resource):
             logger.warn('exception while decoding http request %s; %s', request.path, traceback.format_exc(20))
             return self.ErrorResponse(request, http.BAD_REQUEST, 'unabled to decode incoming request {0}', data)
 
-        # and finally execute the associated method and send back the results
-        try :
-            response = json.dumps(self.RequestMap[reqtype](minfo))
+        # and finally execute the associated method and send back the results; the
+        # method runs on a worker thread so requests can use the enclaves in parallel
+        d = threads.deferToThread(self.RequestMap[reqtype], minfo)
+        d.addCallbacks(
+            self._RequestComplete, self._RequestFailed,
+            callbackArgs = (request, encoding), errbackArgs = (request, ))
 
-            request.responseHeaders.addRawHeader("content-type", encoding)
-            logger.debug('Return Response: %s', response)
-            return response.encode('utf-8')
+        return server.NOT_DONE_YET
 
-        except Error as e :
-            logger.warn('exception while processing request; %s', str(e))
-            # return self.ErrorResponse(request, int(e.status), 'exception while processing request {0}; {1}', request.path, str(e))
-            return self.ErrorResponse(request, int(e.status), 'exception while processing request')
+    ## -----------------------------------------------------------------
+    def _RequestComplete(self, result, request, encoding) :
+        response = json.dumps(result)
 
-        except :
-            logger.warn('exception while processing http request %s; %s', request.path, traceback.format_exc(20))
-            return self.ErrorResponse(request, http.BAD_REQUEST, 'error processing http request {0}', request.path)
+        request.responseHeaders.addRawHeader("content-type", encoding)
+        logger.debug('Return Response: %s', response)
+        request.write(response.encode('utf-8'))
+        request.finish()
+
+    ## -----------------------------------------------------------------
+    def _RequestFailed(self, failure, request) :
+        if failure.check(Error) :
+            logger.warn('exception while processing request; %s', str(failure.value))
+            msg = self.ErrorResponse(request, int(failure.value.status), 'exception while processing request')
+        else :
+            logger.warn('exception while processing http request %s; %s', request.path, failure.getTraceback())
+            msg = self.ErrorResponse(request, http.BAD_REQUEST, 'error processing http request {0}', request.path)
+
+        request.write(msg.encode('utf-8'))
+        request.finish()
 
 # -----------------------------------------------------------------
 # -----------------------------------------------------------------
@@ -284,6 +352,7 @@ def RunProvisioningService(config, enclave) :
     try :
         http_port = config['ProvisioningService']['HttpPort']
         http_host = config['ProvisioningService']['Host']
+        worker_threads = config['ProvisioningService'].get('WorkerThreads', 8)
     except KeyError as ke :
         logger.error('missing configuration for %s', str(ke))
         sys.exit(-1)
@@ -296,6 +365,9 @@ def RunProvisioningService(config, enclave) :
     signal.signal(signal.SIGQUIT, __shutdown__)
     signal.signal(signal.SIGTERM, __shutdown__)
 
+    # requests are processed on the reactor thread pool
+    reactor.suggestThreadPoolSize(worker_threads)
+
     root = ProvisioningServer(config, enclave)
     site = server.Site(root)
     reactor.listenTCP(http_port, site, interface=http_host)
@@ -112,7 +112,7 @@ module_files = [
 enclave_module = Extension(
     'pdo.pservice.enclave._pdo_enclave_internal',
     module_files,
-    swig_opts = ['-c++'],
+    swig_opts = ['-c++', '-threads'],
     extra_compile_args = compile_args,
     libraries = libraries,
     include_dirs = include_dirs,
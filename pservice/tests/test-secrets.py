@@ -0,0 +1,281 @@
+#!/usr/bin/env python
+
+# Copyright 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""test-secrets.py
+
+Tests for the generation of enclave secrets by the provisioning
+service enclave, one request at a time and in batches. The enclave
+infos are created locally; they carry no attestation so enclave info
+verification only succeeds with the simulator.
+"""
+
+import os
+import sys
+import json
+
+import pdo.pservice.pdo_helper as enclave_helper
+import pdo.pservice.pdo_enclave as pdo_enclave
+
+import pdo.common.keys as keys
+import pdo.common.crypto as crypto
+
+import logging
+import pdo.common.logger as plogger
+
+logger = logging.getLogger(__name__)
+
+import pdo.common.config as pconfig
+
+# -----------------------------------------------------------------
+def ErrorShutdown() :
+    """
+    Perform a clean shutdown after an error
+    """
+    try :
+        pdo_enclave.shutdown()
+    except Exception as e :
+        logger.exception('shutdown failed')
+
+    sys.exit(-1)
+
+## -----------------------------------------------------------------
+ContractHost = os.environ.get("PDO_HOSTNAME", "localhost")
+ContractHome = os.environ.get("PDO_HOME") or os.path.realpath("/opt/pdo")
+ContractEtc = os.path.join(ContractHome, "etc")
+ContractKeys = os.path.join(ContractHome, "keys")
+ContractLogs = os.path.join(ContractHome, "logs")
+ContractData = os.path.join(ContractHome, "data")
+LedgerURL = os.environ.get("PDO_LEDGER_URL", "http://127.0.0.1:6600/")
+ScriptBase = os.path.splitext(os.path.basename(sys.argv[0]))[0]
+
+config_map = {
+    'base' : ScriptBase,
+    'data' : ContractData,
+    'etc'  : ContractEtc,
+    'home' : ContractHome,
+    'host' : ContractHost,
+    'keys' : ContractKeys,
+    'logs' : ContractLogs,
+    'ledger' : LedgerURL
+}
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+conffiles = [ 'pservice1.toml', 'enclave.toml' ]
+confpaths = [ ".", "./etc", ContractEtc ]
+
+import argparse
+parser = argparse.ArgumentParser()
+parser.add_argument('--config', help='configuration file', nargs = '+')
+parser.add_argument('--config-dir', help='configuration file', nargs = '+')
+parser.add_argument('--loglevel', help='Set the logging level', default='INFO')
+parser.add_argument('--logfile', help='Name of the log file', default='__screen__')
+options = parser.parse_args()
+
+config_map['identity'] = 'test-secrets'
+
+try :
+    config = pconfig.parse_configuration_files(conffiles, confpaths, config_map)
+except pconfig.ConfigurationException as e :
+    logger.error(str(e))
+    sys.exit(-1)
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+plogger.setup_loggers({'LogLevel' : options.loglevel.upper(), 'LogFile' : options.logfile})
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+try :
+    enclave_helper.initialize_enclave(config.get('EnclaveModule'))
+    enclave_client = enclave_helper.Enclave.create_new_enclave()
+except Exception as e :
+    logger.exception('failed to initialize the enclave; %s', str(e))
+    ErrorShutdown()
+
+simulator = pdo_enclave.enclave.is_sgx_simulator()
+
+contract_creator_keys = keys.ServiceKeys.create_service_keys()
+opk = contract_creator_keys.verifying_key
+owner_id = contract_creator_keys.identity
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+class TestEnclave(object) :
+    """keys for a contract enclave; the encryption key can be replaced
+    to produce a changed enclave info for the same enclave
+    """
+    def __init__(self) :
+        signing_key = crypto.SIG_PrivateKey()
+        signing_key.Generate()
+        self.verifying_key = signing_key.GetPublicKey().Serialize()
+        self.new_encryption_key()
+
+    def new_encryption_key(self) :
+        self.decryption_key = crypto.PKENC_PrivateKey()
+        self.decryption_key.Generate()
+        self.encryption_key = self.decryption_key.GetPublicKey().Serialize()
+
+    def enclave_info(self) :
+        return json.dumps({
+            'verifying_key' : self.verifying_key,
+            'encryption_key' : self.encryption_key,
+            'owner_id' : owner_id,
+            'proof_data' : ''
+        })
+
+    def decrypt_secret(self, encrypted_secret) :
+        """return the plain secret from an encrypted enclave secret, the
+        secret is the hex encoded prefix of the message
+        """
+        message = self.decryption_key.DecryptMessage(crypto.base64_to_byte_array(encrypted_secret))
+        return bytes(message[:32]).decode('ascii').upper()
+
+def create_contract() :
+    contract_id = crypto.byte_array_to_hex(crypto.random_bit_string(256))[:32]
+    sealed_secret = enclave_client.create_secret(16)['sealed_secret']
+    plain_secret = enclave_client.unseal_secret(sealed_secret)['plain_secret'].upper()
+    return (contract_id, sealed_secret, plain_secret)
+
+def secret_request(contract, enclave, enclave_info = None) :
+    return {
+        'sealed_secret' : contract[1],
+        'contract_id' : contract[0],
+        'opk' : opk,
+        'enclave_info' : enclave_info or enclave.enclave_info()
+    }
+
+def generate_secret(contract, enclave) :
+    request = secret_request(contract, enclave)
+    return enclave_client.generate_enclave_secret(
+        enclave_client.sealed_data,
+        request['sealed_secret'],
+        request['contract_id'],
+        request['opk'],
+        request['enclave_info'])['enclave_secret']
+
+def generate_secrets(requests) :
+    return enclave_client.generate_enclave_secrets(enclave_client.sealed_data, requests)
+
+def expect_failure(message, function, *args) :
+    try :
+        function(*args)
+    except :
+        return
+
+    logger.error(message)
+    ErrorShutdown()
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def test_batch(contract_count, enclave_count) :
+    logger.info('test batch with %d contracts and %d enclaves', contract_count, enclave_count)
+
+    contracts = [ create_contract() for c in range(contract_count) ]
+    enclaves = [ TestEnclave() for e in range(enclave_count) ]
+
+    pairs = [ (c, e) for c in contracts for e in enclaves ]
+    esecrets = generate_secrets([ secret_request(c, e) for (c, e) in pairs ])
+    assert len(esecrets) == len(pairs)
+
+    for ((contract, enclave), esecret) in zip(pairs, esecrets) :
+        assert enclave.decrypt_secret(esecret) == contract[2]
+        assert enclave.decrypt_secret(generate_secret(contract, enclave)) == contract[2]
+
+def test_failed_request() :
+    contracts = [ create_contract() for c in range(3) ]
+    enclave = TestEnclave()
+    requests = [ secret_request(c, enclave) for c in contracts ]
+
+    logger.info('test batch with an invalid enclave info')
+    logger.info('expected error: Invalid encryption_key')
+    bad_info = json.loads(enclave.enclave_info())
+    del bad_info['encryption_key']
+    requests[1] = secret_request(contracts[1], enclave, json.dumps(bad_info))
+    expect_failure('failed to catch an invalid enclave info in a batch', generate_secrets, requests)
+
+    logger.info('test batch with an invalid sealed secret')
+    logger.info('expected error: failed to unseal the secret')
+    requests = [ secret_request(c, enclave) for c in contracts ]
+    requests[2]['sealed_secret'] = contracts[0][1][:-8]
+    expect_failure('failed to catch an invalid sealed secret in a batch', generate_secrets, requests)
+
+    logger.info('test batch with a missing field')
+    requests = [ secret_request(c, enclave) for c in contracts ]
+    del requests[0]['opk']
+    expect_failure('failed to catch a missing field in a batch', generate_secrets, requests)
+
+    logger.info('test that the valid requests still succeed')
+    requests = [ secret_request(c, enclave) for c in contracts ]
+    esecrets = generate_secrets(requests)
+    for (contract, esecret) in zip(contracts, esecrets) :
+        assert enclave.decrypt_secret(esecret) == contract[2]
+
+def test_changed_enclave_info() :
+    logger.info('test a verified enclave info that changes')
+    contract = create_contract()
+    enclave = TestEnclave()
+
+    # the first request verifies the enclave info and caches the result
+    original_info = enclave.enclave_info()
+    original_key = enclave.decryption_key
+    assert enclave.decrypt_secret(generate_secret(contract, enclave)) == contract[2]
+
+    # the same enclave with a new encryption key must not reuse the
+    # result of the earlier verification
+    enclave.new_encryption_key()
+    esecret = generate_secret(contract, enclave)
+    assert enclave.decrypt_secret(esecret) == contract[2]
+    expect_failure('secret encrypted with the original encryption key',
+                   original_key.DecryptMessage, crypto.base64_to_byte_array(esecret))
+
+    esecrets = generate_secrets([
+        secret_request(contract, enclave, original_info),
+        secret_request(contract, enclave) ])
+    original_secret = original_key.DecryptMessage(crypto.base64_to_byte_array(esecrets[0]))
+    assert bytes(original_secret[:32]).decode('ascii').upper() == contract[2]
+    assert enclave.decrypt_secret(esecrets[1]) == contract[2]
+
+def test_unverified_enclave_info() :
+    logger.info('test enclave infos without attestation')
+    logger.info('expected error: Failed to parse the proofData')
+    contract = create_contract()
+    enclave = TestEnclave()
+
+    expect_failure('failed to catch an unverified enclave info', generate_secret, contract, enclave)
+    expect_failure('failed to catch an unverified enclave info in a batch',
+                   generate_secrets, [ secret_request(contract, enclave) ])
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+try :
+    if simulator :
+        test_batch(1, 1)
+        test_batch(4, 3)
+        test_failed_request()
+        test_changed_enclave_info()
+    else :
+        logger.warning('local enclave infos cannot be verified outside the simulator')
+        test_unverified_enclave_info()
+except SystemExit :
+    raise
+except :
+    logger.exception('secret generation test failed')
+    ErrorShutdown()
+
+# this is necessary for a clean shutdown
+pdo_enclave.shutdown()
+sys.exit(0)
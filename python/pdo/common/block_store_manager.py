@@ -94,7 +94,7 @@ class BlockStoreManager(object) :
         self.block_store_env = lmdb.open(
             block_store_file,
             create=create_block_store,
-            max_dbs=2,
+            max_dbs=3,
             subdir=False,
             sync=False,
             map_size=self.map_size)
@@ -129,6 +129,34 @@ class BlockStoreManager(object) :
 
         return block_ids
 
+    # --------------------------------------------------
+    def add_contracts(self, contract_ids) :
+        """Record the contracts whose state is kept in the store; the
+        garbage collector keeps the current state of each of them
+
+        :param contract_ids list of string: contract identifiers
+        """
+        cdb = self.block_store_env.open_db(b'contracts')
+        with self.block_store_env.begin(write=True) as txn :
+            for contract_id in contract_ids :
+                txn.put(contract_id.encode('utf8'), b'', db=cdb, overwrite=False)
+
+    # --------------------------------------------------
+    def list_contracts(self) :
+        """Return the identifiers of the contracts recorded with add_contracts
+
+        :return list of string: contract identifiers
+        """
+        cdb = self.block_store_env.open_db(b'contracts')
+
+        contract_ids = []
+        with self.block_store_env.begin() as txn :
+            cursor = txn.cursor(db=cdb)
+            for key, value in cursor :
+                contract_ids.append(bytes(key).decode('utf8'))
+
+        return contract_ids
+
     # --------------------------------------------------
     def __get_block__(self, block_id, encoding='b64') :
         """Return the data for a block given the hash of the block
@@ -289,27 +317,110 @@ class BlockStoreManager(object) :
         return block_status_list
 
     # --------------------------------------------------
-    def expire_blocks(self) :
-        """Delete data and metadata for blocks that have expired
+    def __is_garbage__(self, metadata, current_time, grace_period) :
+        if metadata.expiration_time < current_time :
+            return True
+        if grace_period is None :
+            return False
+        return metadata.create_time + grace_period < current_time
+
+    # --------------------------------------------------
+    def collect_garbage(self, live_root_ids, grace_period=None, batch_size=1024, encoding='b64') :
+        """Delete the blocks that are not reachable from the live states;
+        the root blocks and the blocks they list are kept even when expired.
+        Other blocks are deleted once they expire or once they are older
+        than the grace period
+
+        The mark and the scan share one read transaction, the sweep
+        deletes the candidates in write transactions of at most batch_size
+        blocks and checks each block again in case it was stored since the
+        scan. Blocks written through the native block store, for example
+        by an enclave service that shares the file, are collected the
+        same way.
+
+        :param live_root_ids list of string: root block identifiers of the live states
+        :param grace_period int: seconds to keep unreachable blocks, None to keep them until they expire
+        :param batch_size int: maximum number of blocks deleted in one write transaction
+        :param encoding string: encoding used for block identifiers, raw/b64
+        :return dict: counts of blocks scanned, live and reclaimed, bytes reclaimed
+        """
+        decoding_fn = lambda x : x
+        if encoding == 'b64' :
+            decoding_fn = lambda x : base64.urlsafe_b64decode(x)
+
+        if batch_size < 1 :
+            batch_size = 1
+
+        stats = { 'roots_missing' : 0, 'blocks_live' : 0, 'blocks_scanned' : 0,
+                  'blocks_reclaimed' : 0, 'bytes_reclaimed' : 0 }
+
+        current_time = int(time.time())
+        mdb = self.block_store_env.open_db(b'meta_data')
+        bdb = self.block_store_env.open_db(b'block_data')
+
+        live = set()
+        candidates = []
+        with self.block_store_env.begin() as txn :
+            # mark
+            for root_id in live_root_ids :
+                root_hash = decoding_fn(root_id)
+                root_block = txn.get(root_hash, db=bdb)
+                if root_block is None :
+                    stats['roots_missing'] += 1
+                    continue
+
+                root_data = decode_root_block(bytes(root_block))
+                live.add(root_hash)
+                live.update([ base64.urlsafe_b64decode(b) for b in root_data['BlockIds'] ])
+
+            stats['blocks_live'] = len(live)
+
+            # scan
+            cursor = txn.cursor(db=mdb)
+            for key, value in cursor :
+                stats['blocks_scanned'] += 1
+                key = bytes(key)
+                if key in live :
+                    continue
+                if self.__is_garbage__(BlockMetadata.unpack(value), current_time, grace_period) :
+                    candidates.append(key)
+
+        # sweep
+        for first in range(0, len(candidates), batch_size) :
+            with self.block_store_env.begin(write=True) as txn :
+                for block_hash in candidates[first:first+batch_size] :
+                    raw_metadata = txn.get(block_hash, db=mdb)
+                    if raw_metadata is None :
+                        continue
+
+                    metadata = BlockMetadata.unpack(raw_metadata)
+                    if not self.__is_garbage__(metadata, current_time, grace_period) :
+                        continue
+
+                    txn.delete(block_hash, db=mdb)
+                    txn.delete(block_hash, db=bdb)
+
+                    stats['blocks_reclaimed'] += 1
+                    stats['bytes_reclaimed'] += metadata.block_size
+
+        logger.debug('block store gc: scanned %d, live %d, reclaimed %d blocks, %d bytes',
+                     stats['blocks_scanned'], stats['blocks_live'],
+                     stats['blocks_reclaimed'], stats['bytes_reclaimed'])
+
+        return stats
+
+    # --------------------------------------------------
+    def expire_blocks(self, live_root_ids=[]) :
+        """Delete data and metadata for blocks that have expired, the
+        blocks of the live states are kept
+
+        :param live_root_ids list of string: root block identifiers of the live states
         """
         try :
-            mdb = self.block_store_env.open_db(b'meta_data')
-            bdb = self.block_store_env.open_db(b'block_data')
-
-            current_time = int(time.time())
-
-            count = 0
-            with self.block_store_env.begin() as txn :
-                cursor = txn.cursor(db=mdb)
-                for key, value in cursor :
-                    metadata = BlockMetadata.unpack(value)
-                    if metadata.expiration_time < current_time :
-                        count += 1
-                        with self.block_store_env.begin(write=True) as dtxn :
-                            assert dtxn.delete(key, db=bdb)
-                            assert dtxn.delete(key, db=mdb)
-
-            logger.info('expired %d blocks', count)
+            stats = self.collect_garbage(live_root_ids)
+            count = stats['blocks_reclaimed']
+
+            logger.info('expired %d blocks, %d bytes', count, stats['bytes_reclaimed'])
         except Exception as e :
             logger.error('garbage collection failed; %s', str(e))
             return None
@@ -350,27 +461,33 @@ def sync_block_store(src_block_store, dst_block_store, root_block_id, root_block
     :param dst_block_store object implementing the block_store_manager interface
     :param root_block_id string: block identifier for the root block
     :param root_block string: block data for the root block
+    :param block_ids list of string: optional ids of the blocks to sync, for example
+        the change set from an update; all blocks in the root block if not given
     """
-    if root_block is None :
-        root_block = src_block_store.get_block(root_block_id)
-
-    block_ids = [root_block_id]
-
-    try :
-        root_block = root_block.decode('utf8')
-    except AttributeError :
-        pass
-
-    root_block = root_block.rstrip('\0')
-    root_block_json = json.loads(root_block)
-    block_ids.extend(root_block_json['BlockIds'])
-
+    block_ids = kwargs.get('block_ids')
     default_minimum_duration = pconfig.shared_configuration(['Replication', 'MinimumDuration'], 5)
     minimum_duration = kwargs.get('minimum_duration', default_minimum_duration)
 
     default_duration = pconfig.shared_configuration(['Replication', 'Duration'], 60)
     duration = kwargs.get('duration', default_duration)
 
+    if block_ids is not None :
+        block_ids = [root_block_id] + [ b for b in block_ids if b != root_block_id ]
+    else :
+        if root_block is None :
+            root_block = src_block_store.get_block(root_block_id)
+
+        block_ids = [root_block_id]
+
+        try :
+            root_block = root_block.decode('utf8')
+        except AttributeError :
+            pass
+
+        root_block = root_block.rstrip('\0')
+        root_block_json = json.loads(root_block)
+        block_ids.extend(root_block_json['BlockIds'])
+
     # check to see which blocks need to be pushed
     blocks_to_push = []
     blocks_to_extend = []
@@ -106,6 +106,16 @@ namespace std {
 
 %ignore ByteArrayToString;
 
+// the incremental and scatter-gather hash interfaces are only used from C++
+%ignore pdo::crypto::Hasher;
+%ignore pdo::crypto::ComputeMessageHash(const ByteArrayRefArray&);
+%ignore pdo::crypto::SHA256Hash(const ByteArrayRefArray&, ByteArray&);
+%ignore pdo::crypto::SHA384Hash(const ByteArrayRefArray&, ByteArray&);
+%ignore pdo::crypto::SHA512Hash(const ByteArrayRefArray&, ByteArray&);
+%ignore pdo::crypto::ComputeMessageHashes;
+%ignore pdo::crypto::ComputeMessageHashesScalar;
+%ignore pdo::crypto::sig::Key::GetHashFunction;
+
 %include "types.h"
 %include "crypto.h"
 %include "crypto_utils.h"
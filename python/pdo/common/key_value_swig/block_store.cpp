@@ -55,6 +55,16 @@ void block_store_put(const std::vector<uint8_t>& block_id, const std::vector<uin
     pdo::error::ThrowIf<pdo::error::IndexError>(status != PDO_SUCCESS, "failed to save block");
 }
 
+// XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+bool block_store_put_if_absent(const std::vector<uint8_t>& block_id, const std::vector<uint8_t>& block_data)
+{
+    bool inserted;
+    pdo_err_t status = pdo::block_store::BlockStorePutIfAbsent(block_id, block_data, &inserted);
+    pdo::error::ThrowIf<pdo::error::IndexError>(status != PDO_SUCCESS, "failed to save block");
+
+    return inserted;
+}
+
 // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 std::map<std::string, metadata_value_type_t> block_store_head(const std::vector<uint8_t>& block_id)
 {
@@ -41,3 +41,9 @@ typedef unsigned long int metadata_value_type_t;
 std::vector<uint8_t> block_store_get(const std::vector<uint8_t>& block_id);
 void block_store_put(const std::vector<uint8_t>& block_id, const std::vector<uint8_t>& block_data);
 std::map<std::string,metadata_value_type_t> block_store_head(const std::vector<uint8_t>& block_id);
+
+/**
+ * Write a block only if it is not already present, returns true if the
+ * block was written
+ */
+bool block_store_put_if_absent(const std::vector<uint8_t>& block_id, const std::vector<uint8_t>& block_data);
@@ -26,6 +26,7 @@ __all__ = [
     "add_enclave_to_contract",
     "add_replication_task",
     "add_transaction_task",
+    "evaluate_speculatively",
     "invocation_request",
     "invocation_response",
     "register_contract",
@@ -46,6 +47,7 @@ from pdo.contract.message import ContractMessage
 from pdo.contract.request import UpdateStateRequest, InitializeStateRequest
 from pdo.contract.response import ContractResponse, UpdateStateResponse, InitializeStateResponse
 from pdo.contract.state import ContractState
+from pdo.contract.speculative import evaluate_speculatively
 
 from pdo.contract.replication import ReplicationRequest
 from pdo.contract.replication import start_replication_service
@@ -160,32 +160,41 @@ class Contract(object) :
         self.contract_state.update_state(state)
 
     # -------------------------------------------------------
-    def create_initialize_request(self, request_originator_keys, enclave_service='random') :
+    def create_initialize_request(self, request_originator_keys, enclave_service='random', state_layout=None) :
         """create a request to initialize the state of the contract
 
         :param request_originator_keys: object of type ServiceKeys
         :param enclave_service: object that implements the enclave service interface
+        :param state_layout: dict with the DataNodeSize and ExtentThreshold of the new state, None for the default
         """
         return InitializeStateRequest(
             'initialize',
             request_originator_keys,
             self,
-            enclave_service=enclave_service)
+            enclave_service=enclave_service,
+            state_layout=state_layout)
 
     # -------------------------------------------------------
-    def create_update_request(self, request_originator_keys, expression, enclave_service='random') :
+    def create_update_request(self, request_originator_keys, expression, enclave_service='random',
+                              report_resource_usage=False, execution_budget=0, report_access_sets=False) :
         """create a request to update the state of the contract
 
         :param request_originator_keys: object of type ServiceKeys
         :param enclave_service: object that implements the enclave service interface
         :param expression: string, the expression to send to the contract
+        :param report_resource_usage: boolean, ask for the resources used by the invocation
+        :param execution_budget: integer, limit on the work done by the invocation
+        :param report_access_sets: boolean, ask for the state keys read and written
         """
         return UpdateStateRequest(
             'update',
             request_originator_keys,
             self,
             enclave_service=enclave_service,
-            invocation_request = expression)
+            invocation_request = expression,
+            report_resource_usage = report_resource_usage,
+            execution_budget = execution_budget,
+            report_access_sets = report_access_sets)
 
     # -------------------------------------------------------
     def save_to_file(self, basename, data_dir = None) :
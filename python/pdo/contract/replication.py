@@ -197,7 +197,8 @@ def __replication_worker__(service_id, *args) :
             request_id = response.commit_id[2]
             try:
                 fail_task = False
-                response_from_replication = service_client.store_blocks(block_data_list, expiration)
+                response_from_replication = service_client.store_blocks(
+                    block_data_list, expiration, contract_id=replication_request.contract_id)
                 if response_from_replication is None :
                     fail_task =  True
                     logger.info("No response from storage service %s for replication request %d",
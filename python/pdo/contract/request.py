@@ -72,6 +72,19 @@ class ContractRequest(object) :
         self.replication_params = contract.replication_params
         self.request_number = ContractRequest.get_request_number()
 
+        # ask the enclave to report the resources used by the invocation
+        self.report_resource_usage = kwargs.get('report_resource_usage', False)
+
+        # limit on the work done by the invocation, 0 selects the enclave default
+        self.execution_budget = kwargs.get('execution_budget', 0)
+
+        # ask the enclave to report the state keys read and written
+        self.report_access_sets = kwargs.get('report_access_sets', False)
+
+        # leave the blocks of a new state in the eservice until the
+        # response calls pull_state, used when the response may be dropped
+        self.defer_state_pull = kwargs.get('defer_state_pull', False)
+
     # -------------------------------------------------------
     def make_channel_keys(self, ledger_type=os.environ.get('PDO_LEDGER_TYPE')):
         if ledger_type=='ccf':
@@ -115,6 +128,15 @@ class UpdateStateRequest(ContractRequest) :
 
         result['ContractMessage'] = self.message.serialize()
 
+        if self.report_resource_usage :
+            result['ReportResourceUsage'] = True
+
+        if self.execution_budget :
+            result['ExecutionBudget'] = self.execution_budget
+
+        if self.report_access_sets :
+            result['ReportAccessSets'] = True
+
         return json.dumps(result)
 
     # -------------------------------------------------------
@@ -183,6 +205,10 @@ class InitializeStateRequest(ContractRequest) :
         self.contract_state = ContractState.create_new_state(self.contract_id)
         self.message = ContractMessage(self.originator_keys, self.channel_id, **kwargs)
 
+        # layout of the new state, a dict with DataNodeSize and ExtentThreshold;
+        # the enclave uses its default layout when this is None
+        self.state_layout = kwargs.get('state_layout')
+
     # -------------------------------------------------------
     def __serialize_for_encryption(self) :
         result = dict()
@@ -193,6 +219,9 @@ class InitializeStateRequest(ContractRequest) :
         result['ContractMessage'] = self.message.serialize()
         result['ContractCode'] = self.contract_code.serialize()
 
+        if self.state_layout :
+            result['StateLayout'] = self.state_layout
+
         return json.dumps(result)
 
     # -------------------------------------------------------
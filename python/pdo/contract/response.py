@@ -66,6 +66,16 @@ class ContractResponse(object) :
         self.status = response['Status']
         self.invocation_response_raw = response['InvocationResponse']
         self.invocation_response = invocation_response(response['InvocationResponse'])
+        self.resource_usage = response.get('ResourceUsage')
+        self.execution_budget_exceeded = response.get('ExecutionBudgetExceeded', False)
+
+        # hashes of the state keys read and written, None unless requested
+        self.read_set = None
+        self.write_set = None
+        access_sets = response.get('AccessSets')
+        if access_sets is not None :
+            self.read_set = frozenset(access_sets['ReadSet'])
+            self.write_set = frozenset(access_sets['WriteSet'])
         self.new_state_object = request.contract_state
         self.new_state_object.changed_block_ids=[]
 
@@ -252,12 +262,40 @@ class UpdateStateResponse(ContractResponse) :
 
         self.raw_state = self.enclave_service.get_block(state_hash_b64)
         self.new_state_object = ContractState(self.contract_id, self.raw_state)
-        self.new_state_object.pull_state_from_eservice(self.enclave_service)
 
-        # compute ids of blocks in the change set (used for replication)
-        self.new_state_object.compute_new_block_ids(request.contract_state.component_block_ids)
+        # the change set from the enclave lists the blocks written by the
+        # update, older enclaves do not report it and the change set is
+        # computed from the full list of blocks
+        self.__change_set__ = response.get('ChangeSet')
+        self.__old_state__ = request.contract_state
+        if self.__change_set__ is not None :
+            self.new_state_object.set_change_set(
+                self.__change_set__['NewBlockIds'], self.__change_set__['SupersededBlockIds'], request.contract_state)
+
+        self.state_pulled = False
+        if not request.defer_state_pull :
+            self.pull_state()
+
         self.replication_params = request.replication_params
 
+    # -------------------------------------------------------
+    def pull_state(self) :
+        """copy the blocks of the new state from the eservice into the
+        local block store, this is done once and must happen before the
+        response is committed
+        """
+        if self.state_pulled :
+            return
+
+        if self.__change_set__ is not None :
+            self.new_state_object.pull_state_from_eservice(
+                self.enclave_service, block_ids=self.new_state_object.changed_block_ids)
+        else :
+            self.new_state_object.pull_state_from_eservice(self.enclave_service)
+            self.new_state_object.compute_new_block_ids(self.__old_state__.component_block_ids)
+
+        self.state_pulled = True
+
     # -------------------------------------------------------
     def serialize_for_signing(self) :
         """serialize the response for enclave signature verification"""
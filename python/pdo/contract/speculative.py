@@ -0,0 +1,146 @@
+# Copyright 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Optimistic evaluation of several update requests for the same contract.
+
+All of the requests are first evaluated in parallel against the current
+state of the contract, with the enclave reporting the state keys each
+invocation read and wrote. The responses are then accepted in request
+order. A speculative response is kept when it is exactly what serial
+evaluation would have produced:
+
+  * no state change has been accepted yet, so it ran on the right state
+  * or it did not change the state and it read none of the keys written
+    by the accepted updates
+
+Every other request is evaluated again against the current state. The
+result is the same sequence of responses that evaluating the requests
+one after the other produces, assuming that the contract methods are
+deterministic.
+
+This limits what speculation can gain. The enclave signs a state change
+together with its input state hash, so a speculative update computed on
+an older state can never be committed, even when its reads do not
+conflict with the accepted writes. Every state-changing request after
+the first accepted update is therefore evaluated twice. Only read-only
+requests, and the requests before the first accepted update, are saved
+an evaluation. Batches that are mostly updates gain nothing and should
+be evaluated serially.
+
+A speculative update leaves the blocks of its new state in the eservice;
+they are pulled into the local block store only when the response is
+accepted, so a discarded response costs no block transfer.
+"""
+
+from concurrent.futures import ThreadPoolExecutor
+
+from pdo.contract.state import ContractState
+
+import logging
+logger = logging.getLogger(__name__)
+
+# -----------------------------------------------------------------
+def __snapshot_state__(contract, raw_state) :
+    return ContractState(contract.contract_id, raw_state)
+
+# -----------------------------------------------------------------
+def __speculative_evaluate__(request) :
+    try :
+        return request.evaluate()
+    except Exception as e :
+        logger.debug('speculative evaluation of request %d failed; %s', request.request_number, str(e))
+        return None
+
+# -----------------------------------------------------------------
+def __is_reusable__(response, state_advanced, accepted_writes) :
+    """check whether a speculative response matches serial evaluation
+
+    :param response: the speculative response, None if the evaluation failed
+    :param state_advanced: boolean, an update has been accepted
+    :param accepted_writes: keys written by the updates accepted so far, None if unknown
+    """
+    if response is None :
+        return False
+
+    # no accepted updates, the response was computed on the current state
+    if not state_advanced :
+        return True
+
+    if response.state_changed :
+        return False
+
+    if accepted_writes is None or response.read_set is None :
+        return False
+
+    return accepted_writes.isdisjoint(response.read_set)
+
+# -----------------------------------------------------------------
+def evaluate_speculatively(contract, requests, max_workers=4) :
+    """evaluate update requests for a contract in order with optimistic concurrency
+
+    The requests must have been created for the contract and must not
+    have been evaluated. The state of the contract is set to the state
+    produced by the last update; the responses that changed state must
+    be committed in order just as with serial evaluation. Only read-only
+    requests benefit once an update has been accepted, see the module
+    documentation.
+
+    :param contract: the Contract object the requests apply to
+    :param requests: list of UpdateStateRequest objects, in invocation order
+    :param max_workers: maximum number of speculative evaluations in flight
+    :return: tuple (list of responses in request order, number of re-evaluations)
+    """
+    if not requests :
+        return ([], 0)
+
+    base_state = contract.contract_state.raw_state
+    for request in requests :
+        request.report_access_sets = True
+        request.defer_state_pull = True
+        request.contract_state = __snapshot_state__(contract, base_state)
+
+    with ThreadPoolExecutor(max_workers=max(1, min(max_workers, len(requests)))) as executor :
+        speculative_responses = list(executor.map(__speculative_evaluate__, requests))
+
+    responses = []
+    reevaluated = 0
+    current_state = base_state
+    state_advanced = False
+    accepted_writes = frozenset()
+
+    for request, response in zip(requests, speculative_responses) :
+        if not __is_reusable__(response, state_advanced, accepted_writes) :
+            # evaluate exactly as the serial client would, errors propagate
+            request.contract_state = __snapshot_state__(contract, current_state)
+            request.defer_state_pull = False
+            response = request.evaluate()
+            reevaluated += 1
+
+        if response.status and response.state_changed :
+            response.pull_state()
+            current_state = response.raw_state
+            state_advanced = True
+            if accepted_writes is not None and response.write_set is not None :
+                accepted_writes = accepted_writes | response.write_set
+            else :
+                accepted_writes = None
+
+        responses.append(response)
+
+    if state_advanced :
+        contract.set_state(current_state)
+
+    logger.debug('speculative evaluation of %d requests, %d evaluated again', len(requests), reevaluated)
+    return (responses, reevaluated)
@@ -152,6 +152,39 @@ class ContractState(object) :
             if state_hash not in self.changed_block_ids:
                 self.changed_block_ids.append(state_hash)
 
+    # --------------------------------------------------
+    def set_change_set(self, new_block_ids, superseded_block_ids, old_state = None) :
+        """ Use the change set reported by the enclave in place of
+        compute_new_block_ids. The new blocks must be part of the
+        state; the root block is included in the change set. Every
+        block of the state that was not part of the old state must be
+        in the change set, the blocks that are not in the change set
+        are neither pulled from the eservice nor replicated.
+
+        :param new_block_ids list of string: b64 ids of blocks added to the state
+        :param superseded_block_ids list of string: b64 ids of blocks no longer in the state
+        :param old_state ContractState: state the update started from, None for a new state
+        """
+
+        known_block_ids = set(self.component_block_ids)
+        known_block_ids.add(self.get_state_hash(encoding='b64'))
+        for block_id in new_block_ids :
+            if block_id not in known_block_ids :
+                raise ValueError('change set references an unknown block; {}'.format(block_id))
+
+        old_block_ids = set()
+        if old_state is not None and old_state.raw_state :
+            old_block_ids.update(old_state.component_block_ids)
+            old_block_ids.add(old_state.get_state_hash(encoding='b64'))
+
+        missing_block_ids = known_block_ids - old_block_ids - set(new_block_ids)
+        if missing_block_ids :
+            raise ValueError('change set omits {} new blocks; {}'.format(
+                len(missing_block_ids), sorted(missing_block_ids)[0]))
+
+        self.changed_block_ids = list(new_block_ids)
+        self.superseded_block_ids = list(superseded_block_ids)
+
     #------------------------------------------------------
     def get_state_hash(self, encoding='raw') :
         """
@@ -195,11 +228,12 @@ class ContractState(object) :
         stat_logger.debug('state length is %d, pushed %d new blocks', len(self.component_block_ids), pushed_blocks)
 
     # --------------------------------------------------
-    def pull_state_from_eservice(self, eservice, data_dir = None) :
+    def pull_state_from_eservice(self, eservice, data_dir = None, block_ids = None) :
         """
-        push the blocks associated with the state to the eservice
+        pull the blocks associated with the state from the eservice
 
         :param eservice EnclaveServiceClient object:
+        :param block_ids list of string: b64 ids of the blocks to pull, all blocks if None
         """
 
         if not self.raw_state :
@@ -207,7 +241,8 @@ class ContractState(object) :
 
         block_manager = pblocks.local_block_manager()
         root_block_id = self.get_state_hash(encoding='b64')
-        pulled_blocks = pblocks.sync_block_store(eservice, block_manager, root_block_id, self.raw_state)
+        pulled_blocks = pblocks.sync_block_store(
+            eservice, block_manager, root_block_id, self.raw_state, block_ids=block_ids)
         logger.debug("Pulled %d new blocks before contract update", pulled_blocks)
 
         stat_logger.debug('state length is %d, pulled %d new blocks', len(self.component_block_ids), pulled_blocks)
@@ -57,6 +57,27 @@ class ProvisioningServiceClient(GenericServiceClient) :
             logger.exception('get_secret')
             return None
 
+    # -----------------------------------------------------------------
+    # requests -- list of dictionaries with the enclave_id, contract_id,
+    # opk and signature fields as passed to get_secret; the response has
+    # one encrypted secret for each request, in the same order
+    # -----------------------------------------------------------------
+    def get_secrets(self, requests) :
+        request = {
+            'reqType': 'secretRequests',
+            'requests': requests,
+        }
+        try :
+            return self._postmsg(request)
+
+        except MessageException as me :
+            logger.warn('Provisioning service get_secrets() failed: %s', me)
+            return None
+
+        except :
+            logger.exception('get_secrets')
+            return None
+
     # -----------------------------------------------------------------
     def get_public_info(self) :
         request = {
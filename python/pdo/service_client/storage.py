@@ -157,11 +157,13 @@ class StorageServiceClient(GenericServiceClient) :
         return self.store_blocks([block_data], duration)
 
     # -----------------------------------------------------------------
-    def store_blocks(self, block_data_list, duration=60) :
+    def store_blocks(self, block_data_list, duration=60, contract_id=None) :
         """Store a list of blocks on the storage server
 
         :param block_data_list: list of blocks represented as byte strings (iterator)
         :param duration: number of seconds to request storage
+        :param contract_id: contract whose state the blocks belong to, the
+            service keeps the current state of the contract
         :returns dictionary: decoded result of the request
         """
         request_identifier = self.request_identifier
@@ -171,7 +173,10 @@ class StorageServiceClient(GenericServiceClient) :
 
         try :
             request_data = dict()
-            request_data['operation'] = (None, json.dumps({'duration' : duration}), 'application/json')
+            operation = {'duration' : duration}
+            if contract_id :
+                operation['contract_id'] = contract_id
+            request_data['operation'] = (None, json.dumps(operation), 'application/json')
             count = 0                     # just needed to uniquify the keys
             for block_data in block_data_list :
                 request_data['block{0}'.format(count)] = ('block{0}'.format(count), block_data, 'application/octet-stream')
@@ -254,6 +254,78 @@ class CCFSubmitter(sub.Submitter):
         **extra_params):
 
         tx_method = "ccl_update"
+        tx_params = self.__build_update_params__(
+            channel_keys,
+            contract_enclave_id,
+            enclave_signature,
+            contract_id,
+            message_hash,
+            current_state_hash,
+            previous_state_hash,
+            dependency_list)
+
+        try:
+            response = self.ccf_client.submit_rpc(tx_method, tx_params)
+            if (response.status_code == http.HTTPStatus.OK) and (response.body.json() is True):
+                  # reponse body will be "True" for enclave registration transaction
+                return tx_params['nonce']
+            else:
+                raise Exception(response.body.json())
+        except Exception as e:
+            logger.info('CCL update TXN failed: {}'.format(str(e)))
+            raise
+
+# -----------------------------------------------------------------
+    def ccl_submit_update(self,
+        channel_keys,
+        contract_enclave_id,
+        enclave_signature,
+        contract_id,
+        message_hash,
+        current_state_hash,
+        previous_state_hash,
+        dependency_list,
+        **extra_params):
+        """ submit an update that the ledger queues, instead of rejecting it,
+        when its previous state or dependencies have not been committed yet.
+        return a dict with the txn_id and committed, committed is False
+        when the update was queued
+        """
+
+        tx_method = "ccl_submit_update"
+        tx_params = self.__build_update_params__(
+            channel_keys,
+            contract_enclave_id,
+            enclave_signature,
+            contract_id,
+            message_hash,
+            current_state_hash,
+            previous_state_hash,
+            dependency_list)
+
+        try:
+            response = self.ccf_client.submit_rpc(tx_method, tx_params)
+            if response.status_code == http.HTTPStatus.OK :
+                result = response.body.json()
+                if isinstance(result, dict) and isinstance(result.get('committed'), bool) :
+                    if not result['committed'] :
+                        logger.debug('CCL update queued until its dependencies are committed')
+                    return { 'txn_id' : tx_params['nonce'], 'committed' : result['committed'] }
+            raise Exception(response.body.json())
+        except Exception as e:
+            logger.info('CCL submit update TXN failed: {}'.format(str(e)))
+            raise
+
+# -----------------------------------------------------------------
+    def __build_update_params__(self,
+        channel_keys,
+        contract_enclave_id,
+        enclave_signature,
+        contract_id,
+        message_hash,
+        current_state_hash,
+        previous_state_hash,
+        dependency_list):
 
         dependencies = []
         for dependency in dependency_list :
@@ -263,7 +335,7 @@ class CCFSubmitter(sub.Submitter):
             temp['state_hash_for_sign'] = dependency['state_hash']
             dependencies.append(temp)
 
-        tx_params = PayloadBuilder.build_update_contract_state_transaction_from_data(
+        return PayloadBuilder.build_update_contract_state_transaction_from_data(
             channel_keys,
             contract_enclave_id,
             crypto.base64_to_byte_array(enclave_signature),
@@ -274,17 +346,6 @@ class CCFSubmitter(sub.Submitter):
             dependencies
             )
 
-        try:
-            response = self.ccf_client.submit_rpc(tx_method, tx_params)
-            if (response.status_code == http.HTTPStatus.OK) and (response.body.json() is True):
-                  # reponse body will be "True" for enclave registration transaction
-                return tx_params['nonce']
-            else:
-                raise Exception(response.body.json())
-        except Exception as e:
-            logger.info('CCL update TXN failed: {}'.format(str(e)))
-            raise
-
 # -----------------------------------------------------------------
     def get_enclave_info(self,
         enclave_id):
@@ -369,6 +430,28 @@ class CCFSubmitter(sub.Submitter):
 
         return state_info
 
+# -----------------------------------------------------------------
+    def get_current_state_hashes(self,
+        contract_ids):
+
+        tx_method = "get_current_state_info_for_contracts"
+        tx_params = PayloadBuilder.build_get_current_state_info_for_contracts_from_data(contract_ids)
+
+        response = self.ccf_client.submit_read_request(tx_method, tx_params)
+
+        # each entry is signed like the response for a single contract
+        result = dict()
+        for state_info in response["contracts"] :
+            contract_id = state_info.pop("contract_id")
+            message = contract_id + state_info["state_hash"]
+
+            if not self.ccf_client.verify_ledger_signature(message, state_info["signature"]):
+                raise Exception("Invalid signature on Get Current State Hash from CCF Ledger")
+
+            result[contract_id] = state_info
+
+        return result
+
 # -----------------------------------------------------------------
     def get_state_details(self,
         contract_id,
@@ -392,6 +475,48 @@ class CCFSubmitter(sub.Submitter):
 
         return state_details
 
+# -----------------------------------------------------------------
+    def get_state_history(self,
+        contract_id,
+        state_hash=None,
+        sequence_number=None,
+        max_entries=64):
+        """return the details of up to max_entries states of the contract, starting
+        at state_hash, at sequence_number or at the current state and walking back
+        toward the initial state; the result has the keys entries and complete
+        """
+
+        state_hash = crypto.base64_to_byte_array(state_hash) if state_hash else []
+        sequence_number = sequence_number if sequence_number is not None else -1
+
+        tx_method = "get_state_history"
+        tx_params = PayloadBuilder.build_get_state_history_from_data(
+            contract_id,
+            state_hash,
+            sequence_number,
+            max_entries)
+
+        state_history = self.ccf_client.submit_read_request(tx_method, tx_params)
+
+        # verify ccf signature, one signature covers the request parameters and all of the entries
+        message = contract_id
+        message += crypto.byte_array_to_base64(state_hash) if state_hash else ""
+        message += str(sequence_number)
+        message += str(max_entries)
+        for entry in state_history["entries"] :
+            message += entry["state_hash"]
+            message += entry["previous_state_hash"]
+            message += entry["message_hash"]
+            message += entry["transaction_id"]
+            message += entry["dependency_list"]
+            message += str(entry["sequence_number"])
+        message += "true" if state_history["complete"] else "false"
+
+        if not self.ccf_client.verify_ledger_signature(message, state_history["signature"]):
+            raise Exception("Invalid signature on Get State History from CCF Ledger")
+
+        return state_history
+
 # -----------------------------------------------------------------
 # Paylaod signature compute fucntions
 # -----------------------------------------------------------------
@@ -509,6 +634,23 @@ class PayloadBuilder(object):
         payloadblob['contract_id'] = contract_id
         return payloadblob
 
+# -----------------------------------------------------------------
+    @staticmethod
+    def build_get_current_state_info_for_contracts_from_data(contract_ids):
+        payloadblob = dict()
+        payloadblob['contract_ids'] = list(contract_ids)
+        return payloadblob
+
+# -----------------------------------------------------------------
+    @staticmethod
+    def build_get_state_history_from_data(contract_id, state_hash, sequence_number, max_entries):
+        payloadblob = dict()
+        payloadblob['contract_id'] = contract_id
+        payloadblob['state_hash'] = state_hash
+        payloadblob['sequence_number'] = sequence_number
+        payloadblob['max_entries'] = max_entries
+        return payloadblob
+
 # -----------------------------------------------------------------
     @staticmethod
     def build_get_details_about_state_from_data(contract_id, state_hash):
@@ -151,6 +151,21 @@ class Submitter(object):
         """
         raise NotImplementedError("Must override get_current_state_hash_for_contract")
 
+# -----------------------------------------------------------------
+    def get_current_state_hashes(self,
+        contract_ids):
+        """ return dict that maps each contract id to the dict returned by
+            get_current_state_hash, contracts that are not found or not yet
+            initialized are left out
+        """
+        result = dict()
+        for contract_id in contract_ids :
+            try :
+                result[contract_id] = self.get_current_state_hash(contract_id)
+            except Exception :
+                pass
+        return result
+
 # -----------------------------------------------------------------
     @abstractmethod
     def get_state_details(self,
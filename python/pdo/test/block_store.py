@@ -0,0 +1,245 @@
+#!/usr/bin/env python
+
+# Copyright 2022 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""block_store.py
+
+Tests for the garbage collector of the local block store manager.
+"""
+
+import os
+import sys
+import time
+import json
+import base64
+import hashlib
+import tempfile
+
+import argparse
+
+import logging
+import pdo.common.logger as plogger
+
+logger = logging.getLogger(__name__)
+
+import pdo.common.block_store_manager as pblocks
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def encode_block_id(block_hash) :
+    return base64.urlsafe_b64encode(block_hash).decode()
+
+def create_state(block_store, count) :
+    """store count component blocks and a root block that lists them,
+    return the identifiers of the component blocks and of the root
+    """
+    block_hashes = block_store.store_blocks([ os.urandom(100) for i in range(count) ], encoding='raw')
+    block_ids = list(map(encode_block_id, block_hashes))
+
+    root_block = json.dumps({ 'BlockIds' : block_ids }).encode('utf8') + b'\0'
+    root_id = encode_block_id(block_store.store_block(root_block, encoding='raw')[0])
+
+    return block_ids, root_id
+
+def expire(block_store, block_ids) :
+    """move the expiration time of the blocks into the past
+    """
+    mdb = block_store.block_store_env.open_db(b'meta_data')
+    with block_store.block_store_env.begin(write=True) as txn :
+        for block_id in block_ids :
+            block_hash = base64.urlsafe_b64decode(block_id)
+            metadata = pblocks.BlockMetadata.unpack(txn.get(block_hash, db=mdb))
+            metadata.expiration_time = int(time.time()) - 1
+            txn.put(block_hash, metadata.pack(), db=mdb, overwrite=True)
+
+def present(block_store, block_ids) :
+    return [ s['block_id'] for s in block_store.check_blocks(block_ids) if s['size'] > 0 ]
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def test_collect_garbage(block_store) :
+    live_ids, live_root = create_state(block_store, 8)
+    dead_ids, dead_root = create_state(block_store, 4)
+    live_ids.append(live_root)
+    dead_ids.append(dead_root)
+
+    # -----------------------------------------------------------------
+    logger.info('nothing is reclaimed before the blocks expire')
+    # -----------------------------------------------------------------
+    stats = block_store.collect_garbage([live_root])
+    assert stats['blocks_live'] == len(live_ids)
+    assert stats['blocks_scanned'] == len(live_ids) + len(dead_ids)
+    assert stats['blocks_reclaimed'] == 0
+
+    # -----------------------------------------------------------------
+    logger.info('expired blocks that are not reachable are reclaimed')
+    # -----------------------------------------------------------------
+    expire(block_store, live_ids + dead_ids)
+    dead_bytes = sum([ s['size'] for s in block_store.check_blocks(dead_ids) ])
+
+    stats = block_store.collect_garbage([live_root, encode_block_id(bytes(32))], batch_size=2)
+    assert stats['roots_missing'] == 1
+    assert stats['blocks_reclaimed'] == len(dead_ids)
+    assert stats['bytes_reclaimed'] == dead_bytes
+    assert present(block_store, dead_ids) == []
+    assert present(block_store, live_ids) == live_ids
+
+    # -----------------------------------------------------------------
+    logger.info('blocks older than the grace period are reclaimed')
+    # -----------------------------------------------------------------
+    fresh_ids, fresh_root = create_state(block_store, 2)
+    fresh_ids.append(fresh_root)
+
+    stats = block_store.collect_garbage([live_root], grace_period=3600)
+    assert stats['blocks_reclaimed'] == 0
+    assert present(block_store, fresh_ids) == fresh_ids
+
+    time.sleep(2)
+    stats = block_store.collect_garbage([live_root], grace_period=1)
+    assert stats['blocks_reclaimed'] == len(fresh_ids)
+
+    # -----------------------------------------------------------------
+    logger.info('expire_blocks reclaims every expired block')
+    # -----------------------------------------------------------------
+    assert block_store.expire_blocks() == len(live_ids)
+    assert block_store.list_blocks() == []
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def test_stored_blocks(block_store) :
+    # -----------------------------------------------------------------
+    logger.info('storing a block again does not keep it once it is unreachable')
+    # -----------------------------------------------------------------
+    shared_block = os.urandom(100)
+    first_ids = list(map(encode_block_id, block_store.store_blocks([shared_block, os.urandom(100)], encoding='raw')))
+    second_ids = list(map(encode_block_id, block_store.store_blocks([shared_block, os.urandom(100)], encoding='raw')))
+
+    shared_id = first_ids[0]
+    assert second_ids[0] == shared_id
+
+    live_root = encode_block_id(
+        block_store.store_block(json.dumps({ 'BlockIds' : second_ids }).encode('utf8') + b'\0', encoding='raw')[0])
+
+    expire(block_store, first_ids + second_ids + [live_root])
+
+    stats = block_store.collect_garbage([live_root])
+    assert stats['blocks_reclaimed'] == 1
+    assert present(block_store, first_ids) == [shared_id]
+    assert present(block_store, second_ids) == second_ids
+
+    # -----------------------------------------------------------------
+    logger.info('the shared block is reclaimed once no live state lists it')
+    # -----------------------------------------------------------------
+    stats = block_store.collect_garbage([])
+    assert stats['blocks_reclaimed'] == 3
+    assert block_store.list_blocks() == []
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def test_native_blocks(block_store_file) :
+    import pdo.common.key_value_swig.key_value_swig as kvs
+
+    # -----------------------------------------------------------------
+    logger.info('blocks put through the native block store are reclaimed')
+    # -----------------------------------------------------------------
+    block_data = [ os.urandom(100) for i in range(3) ]
+    block_ids = [ encode_block_id(hashlib.sha256(b).digest()) for b in block_data ]
+
+    root_block = json.dumps({ 'BlockIds' : block_ids[0:2] }).encode('utf8') + b'\0'
+    root_id = encode_block_id(hashlib.sha256(root_block).digest())
+
+    # the enclave service writes blocks this way, putting a block again
+    # only extends its expiration
+    kvs.block_store_open(block_store_file)
+    try :
+        for data in block_data + [ root_block, block_data[2] ] :
+            kvs.block_store_put(hashlib.sha256(data).digest(), data)
+    finally :
+        kvs.block_store_close()
+
+    block_store = pblocks.BlockStoreManager(block_store_file)
+    try :
+        expire(block_store, block_ids + [root_id])
+
+        stats = block_store.collect_garbage([root_id])
+        assert stats['blocks_reclaimed'] == 1
+        assert present(block_store, block_ids) == block_ids[0:2]
+        assert present(block_store, [root_id]) == [root_id]
+    finally :
+        block_store.close()
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def test_contracts(block_store) :
+    # -----------------------------------------------------------------
+    logger.info('the contracts whose state is kept are recorded once')
+    # -----------------------------------------------------------------
+    assert block_store.list_contracts() == []
+
+    block_store.add_contracts(['contract-a', 'contract-b'])
+    block_store.add_contracts(['contract-a'])
+    assert sorted(block_store.list_contracts()) == ['contract-a', 'contract-b']
+
+    # -----------------------------------------------------------------
+    logger.info('expire_blocks keeps the current states')
+    # -----------------------------------------------------------------
+    live_ids, live_root = create_state(block_store, 2)
+    dead_ids, dead_root = create_state(block_store, 2)
+    live_ids.append(live_root)
+    dead_ids.append(dead_root)
+    expire(block_store, live_ids + dead_ids)
+
+    assert block_store.expire_blocks([live_root]) == len(dead_ids)
+    assert sorted(block_store.list_blocks()) == sorted(live_ids)
+
+    assert block_store.expire_blocks() == len(live_ids)
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def Main() :
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--block-store', help='Name of the file where blocks are stored', type=str)
+    parser.add_argument('--loglevel', help='Set the logging level', default='INFO')
+    parser.add_argument('--logfile', help='Name of the log file', default='__screen__')
+    options = parser.parse_args()
+
+    plogger.setup_loggers({'LogLevel' : options.loglevel.upper(), 'LogFile' : options.logfile})
+
+    block_store_file = options.block_store
+    if block_store_file is None :
+        block_store_file = os.path.join(tempfile.mkdtemp(), 'test_block_store.mdb')
+
+    block_store = pblocks.BlockStoreManager(block_store_file, create_block_store=True)
+
+    try :
+        test_collect_garbage(block_store)
+        test_stored_blocks(block_store)
+        test_contracts(block_store)
+        test_native_blocks(block_store_file + '.native')
+    except Exception as e :
+        logger.exception('block store test failed; %s', str(e))
+        sys.exit(-1)
+    finally :
+        block_store.close()
+        for filename in [ block_store_file, block_store_file + '.native' ] :
+            for suffix in [ '', '-lock' ] :
+                if os.path.exists(filename + suffix) :
+                    os.remove(filename + suffix)
+
+    logger.info('all tests passed')
+    sys.exit(0)
+
+if __name__ == '__main__' :
+    Main()
@@ -308,7 +308,8 @@ def CreateAndRegisterContract(config, enclaves, contract_creator_keys) :
     logger.info('create the initial contract state')
     # --------------------------------------------------
     try :
-        initialize_request = contract.create_initialize_request(contract_creator_keys, enclave_to_use)
+        initialize_request = contract.create_initialize_request(
+            contract_creator_keys, enclave_to_use, config['Contract'].get('StateLayout'))
         initialize_response = initialize_request.evaluate()
         if initialize_response.status is False :
             logger.error('contract initialization failed: %s', initialize_response.invocation_response)
@@ -399,7 +400,14 @@ def UpdateTheContract(config, enclaves, contract, contract_invoker_keys) :
 
         try :
             total_tests += 1
-            update_request = contract.create_update_request(contract_invoker_keys, expression, enclave_to_use)
+            # a test may set a budget, a failure is then expected to come from exhausting
+            # it; a minimum instruction count needs the resource usage in the response
+            execution_budget = test.get('ExecutionBudget', 0)
+            minimum_instructions = test.get('MinimumInstructions', 0)
+            update_request = contract.create_update_request(
+                contract_invoker_keys, expression, enclave_to_use,
+                report_resource_usage = (minimum_instructions > 0),
+                execution_budget = execution_budget)
 
             # run this test as a benchmark if specified
             if test.get('benchmark') and test.get('benchmark') == 'true':
@@ -433,6 +441,10 @@ def UpdateTheContract(config, enclaves, contract, contract_invoker_keys) :
                     total_failed += 1
                     logger.warn('test failed: %s instead of %s', result, test['expected'])
 
+                elif execution_budget and not update_response.execution_budget_exceeded :
+                    total_failed += 1
+                    logger.warn('test failed without exceeding the execution budget')
+
                 continue
 
             logger.info('{0} --> {1}'.format(expression, result))
@@ -441,6 +453,13 @@ def UpdateTheContract(config, enclaves, contract, contract_invoker_keys) :
                 total_failed += 1
                 logger.warn('test failed: %s instead of %s', result, test['expected'])
 
+            if minimum_instructions :
+                instructions = (update_response.resource_usage or {}).get('WasmInstructions', 0)
+                if instructions < minimum_instructions :
+                    total_failed += 1
+                    logger.warn('test failed: %d instructions counted, expected at least %d',
+                                instructions, minimum_instructions)
+
         except Exception as e:
             logger.error('enclave failed to evaluate expression; %s', str(e))
             ErrorShutdown()
@@ -592,6 +611,8 @@ def Main() :
     parser.add_argument('--contract', help='Name of the contract to use', default='mock-contract')
     parser.add_argument('--interpreter', help='Name of the contract to to require', default=ContractInterpreter)
     parser.add_argument('--expressions', help='Name of a file to read for expressions', default=None)
+    parser.add_argument('--data-node-size', help='Size in bytes of the data nodes of the contract state', type=int)
+    parser.add_argument('--extent-threshold', help='Size in bytes of values stored in extents', type=int)
 
     parser.add_argument('--num-provable-replicas', help='Number of sservice signatures needed for proof of replication', type=int, default=1)
     parser.add_argument('--availability-duration', help='duration (in seconds) for which the replicas are stored at storage service', type=int, default=60)
@@ -711,6 +732,14 @@ def Main() :
     if options.source_dir :
         config['Contract']['SourceSearchPath'] = options.source_dir
 
+    state_layout = dict()
+    if options.data_node_size :
+        state_layout['DataNodeSize'] = options.data_node_size
+    if options.extent_threshold :
+        state_layout['ExtentThreshold'] = options.extent_threshold
+    if state_layout :
+        config['Contract']['StateLayout'] = state_layout
+
     if config['Contract'].get('BlockStore') is None :
         config['Contract']['BlockStore'] = os.path.join(config['Contract']['DataDirectory'], "local_cache.mdb"),
 
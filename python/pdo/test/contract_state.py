@@ -0,0 +1,112 @@
+#!/usr/bin/env python
+
+# Copyright 2022 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""contract_state.py
+
+Tests for the validation of the change set that the enclave reports
+with a state update.
+"""
+
+import os
+import sys
+import json
+import base64
+
+import argparse
+
+import logging
+import pdo.common.logger as plogger
+
+logger = logging.getLogger(__name__)
+
+from pdo.contract.state import ContractState
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def random_block_id() :
+    return base64.b64encode(os.urandom(32)).decode()
+
+def create_state(block_ids) :
+    raw_state = json.dumps({ 'BlockIds' : block_ids }).encode('utf8') + b'\0'
+    return ContractState('test-contract', raw_state)
+
+def expect_failure(state, new_block_ids, old_state) :
+    try :
+        state.set_change_set(new_block_ids, [], old_state)
+    except ValueError :
+        return
+    raise Exception('invalid change set accepted')
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def test_change_set() :
+    shared_ids = [ random_block_id() for i in range(4) ]
+    old_ids = [ random_block_id() for i in range(2) ]
+    new_ids = [ random_block_id() for i in range(2) ]
+
+    old_state = create_state(shared_ids + old_ids)
+    new_state = create_state(shared_ids + new_ids)
+    new_root = new_state.get_state_hash(encoding='b64')
+
+    # -----------------------------------------------------------------
+    logger.info('a complete change set is accepted')
+    # -----------------------------------------------------------------
+    new_state.set_change_set(new_ids + [new_root], old_ids, old_state)
+    assert new_state.changed_block_ids == new_ids + [new_root]
+    assert new_state.superseded_block_ids == old_ids
+
+    # -----------------------------------------------------------------
+    logger.info('a change set that omits a new block is rejected')
+    # -----------------------------------------------------------------
+    expect_failure(new_state, new_ids[1:] + [new_root], old_state)
+
+    # -----------------------------------------------------------------
+    logger.info('a change set that omits the new root block is rejected')
+    # -----------------------------------------------------------------
+    expect_failure(new_state, new_ids, old_state)
+
+    # -----------------------------------------------------------------
+    logger.info('a change set with a block outside the state is rejected')
+    # -----------------------------------------------------------------
+    expect_failure(new_state, new_ids + [new_root, random_block_id()], old_state)
+
+    # -----------------------------------------------------------------
+    logger.info('every block of a state without a predecessor is new')
+    # -----------------------------------------------------------------
+    expect_failure(new_state, new_ids + [new_root], None)
+    new_state.set_change_set(shared_ids + new_ids + [new_root], [], None)
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def Main() :
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--loglevel', help='Set the logging level', default='INFO')
+    parser.add_argument('--logfile', help='Name of the log file', default='__screen__')
+    options = parser.parse_args()
+
+    plogger.setup_loggers({'LogLevel' : options.loglevel.upper(), 'LogFile' : options.logfile})
+
+    try :
+        test_change_set()
+    except Exception as e :
+        logger.exception('contract state test failed; %s', str(e))
+        sys.exit(-1)
+
+    logger.info('all tests passed')
+    sys.exit(0)
+
+if __name__ == '__main__' :
+    Main()
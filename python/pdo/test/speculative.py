@@ -0,0 +1,192 @@
+#!/usr/bin/env python
+
+# Copyright 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""speculative.py
+
+Tests for the speculative evaluation of update requests; the enclave is
+replaced by requests that compute their responses locally from the keys
+they read and write.
+"""
+
+import sys
+import json
+import threading
+
+import argparse
+
+import logging
+import pdo.common.logger as plogger
+
+logger = logging.getLogger(__name__)
+
+from pdo.contract.state import ContractState
+from pdo.contract.speculative import evaluate_speculatively
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def encode_state(version) :
+    return json.dumps({ 'BlockIds' : [], 'Version' : version }).encode('utf8') + b'\0'
+
+def decode_state(raw_state) :
+    return json.loads(raw_state.decode('utf8')[0:-1])['Version']
+
+class TestContract(object) :
+    def __init__(self) :
+        self.contract_id = 'test-contract'
+        self.contract_state = ContractState(self.contract_id, encode_state(0))
+
+    def set_state(self, raw_state) :
+        self.contract_state.update_state(raw_state)
+
+class TestResponse(object) :
+    def __init__(self, request, version) :
+        self.status = True
+        self.state_changed = bool(request.write_keys)
+        self.input_version = version
+        self.read_set = frozenset(request.read_keys) if request.report_sets else None
+        self.write_set = frozenset(request.write_keys) if request.report_sets else None
+        self.raw_state = encode_state(version + 1) if self.state_changed else None
+        self.pulled = False
+
+    def pull_state(self) :
+        assert self.state_changed
+        self.pulled = True
+
+class TestRequest(object) :
+    def __init__(self, read_keys, write_keys, report_sets=True, failures=0) :
+        self.request_number = 0
+        self.read_keys = read_keys
+        self.write_keys = write_keys
+        self.report_sets = report_sets
+        self.failures = failures
+        self.responses = []
+        self.lock = threading.Lock()
+
+    def evaluate(self) :
+        with self.lock :
+            if self.failures > 0 :
+                self.failures -= 1
+                raise Exception('evaluation failed')
+
+            response = TestResponse(self, decode_state(self.contract_state.raw_state))
+            self.responses.append(response)
+            return response
+
+def read(*keys) :
+    return TestRequest(list(keys), [])
+
+def update(read_keys, write_keys, **kwargs) :
+    return TestRequest(read_keys, write_keys, **kwargs)
+
+def check_serial(contract, requests, responses) :
+    """check that every response matches the one serial evaluation would
+    have produced and that the contract has the final state; an update
+    must have been computed on the current state, a read on any state
+    since which none of its keys were written
+    """
+    written = []
+    version = 0
+    for request, response in zip(requests, responses) :
+        if response.state_changed :
+            assert response.input_version == version
+            assert response.pulled
+            written.append(set(request.write_keys))
+            version += 1
+        else :
+            assert response.input_version <= version
+            for keys in written[response.input_version:] :
+                assert keys.isdisjoint(request.read_keys)
+
+    assert decode_state(contract.contract_state.raw_state) == version
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def test_speculation() :
+    # -----------------------------------------------------------------
+    logger.info('read-only requests are evaluated once')
+    # -----------------------------------------------------------------
+    contract = TestContract()
+    requests = [ read('a'), read('b'), read('a', 'b'), read('c') ]
+    responses, reevaluated = evaluate_speculatively(contract, requests)
+    assert reevaluated == 0
+    check_serial(contract, requests, responses)
+
+    # -----------------------------------------------------------------
+    logger.info('reads that conflict with an accepted update are evaluated again')
+    # -----------------------------------------------------------------
+    contract = TestContract()
+    requests = [ update(['a'], ['a']), read('b'), read('a'), read('c') ]
+    responses, reevaluated = evaluate_speculatively(contract, requests)
+    assert reevaluated == 1
+    assert len(requests[2].responses) == 2
+    check_serial(contract, requests, responses)
+
+    # -----------------------------------------------------------------
+    logger.info('updates after an accepted update are evaluated again')
+    # -----------------------------------------------------------------
+    contract = TestContract()
+    requests = [ update(['a'], ['a']), update(['b'], ['b']), read('c') ]
+    responses, reevaluated = evaluate_speculatively(contract, requests)
+    assert reevaluated == 1
+    check_serial(contract, requests, responses)
+
+    # -----------------------------------------------------------------
+    logger.info('discarded speculative updates do not pull their state')
+    # -----------------------------------------------------------------
+    speculative_response = requests[1].responses[0]
+    assert speculative_response.input_version == 0
+    assert not speculative_response.pulled
+    assert requests[1].responses[1].pulled
+
+    # -----------------------------------------------------------------
+    logger.info('failed speculative evaluations are evaluated again')
+    # -----------------------------------------------------------------
+    contract = TestContract()
+    requests = [ TestRequest(['a'], [], failures=1), update(['b'], ['b'], failures=1) ]
+    responses, reevaluated = evaluate_speculatively(contract, requests)
+    assert reevaluated == 2
+    check_serial(contract, requests, responses)
+
+    # -----------------------------------------------------------------
+    logger.info('requests after an update without access sets are evaluated again')
+    # -----------------------------------------------------------------
+    contract = TestContract()
+    requests = [ update(['a'], ['a'], report_sets=False), read('b'), read('c') ]
+    responses, reevaluated = evaluate_speculatively(contract, requests)
+    assert reevaluated == 2
+    check_serial(contract, requests, responses)
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def Main() :
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--loglevel', help='Set the logging level', default='INFO')
+    parser.add_argument('--logfile', help='Name of the log file', default='__screen__')
+    options = parser.parse_args()
+
+    plogger.setup_loggers({'LogLevel' : options.loglevel.upper(), 'LogFile' : options.logfile})
+
+    try :
+        test_speculation()
+    except Exception as e :
+        logger.exception('speculative evaluation test failed; %s', str(e))
+        sys.exit(-1)
+
+    logger.info('all tests passed')
+    sys.exit(0)
+
+if __name__ == '__main__' :
+    Main()
@@ -0,0 +1,206 @@
+#!/usr/bin/env python
+
+# Copyright 2023 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""submitter.py
+
+Tests for the handling of ledger responses by the CCF submitter; the
+ledger is replaced by a client that returns canned responses.
+"""
+
+import os
+import sys
+import http
+
+import argparse
+
+import logging
+import pdo.common.logger as plogger
+
+logger = logging.getLogger(__name__)
+
+import pdo.common.crypto as crypto
+from pdo.submitter.ccf.ccf_submitter import CCFSubmitter
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+class CannedBody(object) :
+    def __init__(self, result) :
+        self.result = result
+
+    def json(self) :
+        return self.result
+
+class CannedResponse(object) :
+    def __init__(self, status_code, result) :
+        self.status_code = status_code
+        self.body = CannedBody(result)
+
+class CannedClient(object) :
+    def __init__(self) :
+        self.responses = []
+        self.methods = []
+
+    def submit_rpc(self, tx_method, tx_params) :
+        self.methods.append(tx_method)
+        return self.responses.pop(0)
+
+    def submit_read_request(self, tx_method, tx_params) :
+        return self.submit_rpc(tx_method, tx_params).body.json()
+
+    # the canned ledger "signs" a document by returning it
+    def verify_ledger_signature(self, message, signature) :
+        return message == signature
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def submit_update(submitter, method) :
+    return method(
+        crypto.byte_array_to_base64(os.urandom(32)),
+        'enclave-id',
+        crypto.byte_array_to_base64(os.urandom(64)),
+        'contract-id',
+        crypto.byte_array_to_base64(os.urandom(32)),
+        list(os.urandom(32)),
+        list(os.urandom(32)),
+        [])
+
+def expect_failure(submitter, method) :
+    try :
+        submit_update(submitter, method)
+    except Exception :
+        return
+    raise Exception('failed update reported as a success')
+
+def test_submit_update(client, submitter) :
+    # -----------------------------------------------------------------
+    logger.info('a committed update is reported as committed')
+    # -----------------------------------------------------------------
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, { 'committed' : True }))
+    result = submit_update(submitter, submitter.ccl_submit_update)
+    assert client.methods[-1] == 'ccl_submit_update'
+    assert result['committed'] is True
+    assert result['txn_id']
+
+    # -----------------------------------------------------------------
+    logger.info('a queued update is reported as queued')
+    # -----------------------------------------------------------------
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, { 'committed' : False }))
+    result = submit_update(submitter, submitter.ccl_submit_update)
+    assert result['committed'] is False
+    assert result['txn_id']
+
+    # -----------------------------------------------------------------
+    logger.info('rejected and malformed responses raise an exception')
+    # -----------------------------------------------------------------
+    client.responses.append(CannedResponse(http.HTTPStatus.BAD_REQUEST, 'Pending update queue is full'))
+    expect_failure(submitter, submitter.ccl_submit_update)
+
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, True))
+    expect_failure(submitter, submitter.ccl_submit_update)
+
+    # -----------------------------------------------------------------
+    logger.info('ccl_update still expects a committed update')
+    # -----------------------------------------------------------------
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, True))
+    assert submit_update(submitter, submitter.ccl_update)
+    assert client.methods[-1] == 'ccl_update'
+
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, { 'committed' : False }))
+    expect_failure(submitter, submitter.ccl_update)
+
+def history_page(contract_id, state_hash, sequence_number, max_entries) :
+    entry = {
+        'state_hash' : crypto.byte_array_to_base64(os.urandom(32)),
+        'sequence_number' : 0,
+        'transaction_id' : crypto.byte_array_to_base64(os.urandom(16)),
+        'previous_state_hash' : '',
+        'message_hash' : crypto.byte_array_to_base64(os.urandom(32)),
+        'dependency_list' : '[]',
+    }
+
+    signature = contract_id + state_hash + str(sequence_number) + str(max_entries)
+    signature += entry['state_hash'] + entry['previous_state_hash'] + entry['message_hash']
+    signature += entry['transaction_id'] + entry['dependency_list'] + str(entry['sequence_number'])
+    signature += 'true'
+
+    return { 'entries' : [ entry ], 'complete' : True, 'signature' : signature }
+
+def expect_history_failure(submitter, *args, **kwargs) :
+    try :
+        submitter.get_state_history(*args, **kwargs)
+    except Exception :
+        return
+    raise Exception('history page accepted for the wrong request')
+
+def test_state_history(client, submitter) :
+    state_hash = crypto.byte_array_to_base64(os.urandom(32))
+
+    # -----------------------------------------------------------------
+    logger.info('a history page signed for the request is accepted')
+    # -----------------------------------------------------------------
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, history_page('contract-a', '', -1, 64)))
+    history = submitter.get_state_history('contract-a')
+    assert client.methods[-1] == 'get_state_history'
+    assert history['complete'] is True
+
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, history_page('contract-a', state_hash, -1, 8)))
+    submitter.get_state_history('contract-a', state_hash=state_hash, max_entries=8)
+
+    # -----------------------------------------------------------------
+    logger.info('a history page signed for another request is rejected')
+    # -----------------------------------------------------------------
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, history_page('contract-a', '', -1, 64)))
+    expect_history_failure(submitter, 'contract-b')
+
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, history_page('contract-a', '', -1, 64)))
+    expect_history_failure(submitter, 'contract-a', sequence_number=3)
+
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, history_page('contract-a', '', -1, 64)))
+    expect_history_failure(submitter, 'contract-a', max_entries=8)
+
+    page = history_page('contract-a', '', -1, 64)
+    page['complete'] = False
+    client.responses.append(CannedResponse(http.HTTPStatus.OK, page))
+    expect_history_failure(submitter, 'contract-a')
+
+# -----------------------------------------------------------------
+# -----------------------------------------------------------------
+def Main() :
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--loglevel', help='Set the logging level', default='INFO')
+    parser.add_argument('--logfile', help='Name of the log file', default='__screen__')
+    options = parser.parse_args()
+
+    plogger.setup_loggers({'LogLevel' : options.loglevel.upper(), 'LogFile' : options.logfile})
+
+    # the submitter reuses the cached client for the end point rather
+    # than connecting to a ledger
+    client = CannedClient()
+    CCFSubmitter.ccf_client_cache['127.0.0.1:6600'] = client
+    submitter = CCFSubmitter({ 'LedgerURL' : 'http://127.0.0.1:6600' })
+
+    try :
+        test_submit_update(client, submitter)
+        test_state_history(client, submitter)
+    except Exception as e :
+        logger.exception('submitter test failed; %s', str(e))
+        sys.exit(-1)
+
+    logger.info('all tests passed')
+    sys.exit(0)
+
+if __name__ == '__main__' :
+    Main()
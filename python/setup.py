@@ -195,6 +195,10 @@ setup(name='pdo_common_library',
               'pdo-test-contract = pdo.test.contract:Main',
               'pdo-test-request = pdo.test.request:Main',
               'pdo-test-storage = pdo.test.storage:Main',
+              'pdo-test-block-store = pdo.test.block_store:Main',
+              'pdo-test-contract-state = pdo.test.contract_state:Main',
+              'pdo-test-submitter = pdo.test.submitter:Main',
+              'pdo-test-speculative = pdo.test.speculative:Main',
           ]
       }
 )
@@ -26,6 +26,7 @@ import signal
 
 from pdo.common.block_store_manager import BlockStoreManager
 from pdo.common.wsgi import AppWrapperMiddleware
+from pdo.submitter.create import create_submitter
 from pdo.sservice.wsgi import *
 from pdo.sservice.wsgi import wsgi_block_operation_map
 
@@ -72,16 +73,36 @@ def ErrorResponse(request, error_code, msg) :
 
 ## XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 ## XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
-def GarbageCollector(block_store) :
+def CurrentStateHashes(block_store, ledger_config) :
+    """Return the root block identifiers of the current states of the
+    contracts whose state was replicated to this service
+    """
+    contract_ids = block_store.list_contracts()
+    if not contract_ids :
+        return []
+
+    submitter = create_submitter(ledger_config)
+    state_info = submitter.get_current_state_hashes(contract_ids)
+    return [ s['state_hash'] for s in state_info.values() if s.get('is_active', True) ]
+
+def GarbageCollector(block_store, ledger_config) :
     logger.debug('run the garbage collector')
     try :
-        block_store.expire_blocks()
+        # without the current states the collector would drop the blocks
+        # of live states that have expired, wait for the next run
+        live_root_ids = CurrentStateHashes(block_store, ledger_config)
+    except Exception as e :
+        logger.error('failed to get the current contract states from the ledger; %s', str(e))
+        return
+
+    try :
+        block_store.expire_blocks(live_root_ids)
     except Exception as e :
         logger.error('garbage collection failed; %s', str(e))
         return
 
-def StartGarbageCollector(block_store, gcinterval) :
-    loop = task.LoopingCall(GarbageCollector, block_store)
+def StartGarbageCollector(block_store, ledger_config, gcinterval) :
+    loop = task.LoopingCall(GarbageCollector, block_store, ledger_config)
     loopDeferred = loop.start(gcinterval)
 
 ## XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
@@ -188,7 +209,7 @@ def LocalMain(config) :
                 gcinterval = 0            # gcinterval 0 means don't run the garbage collector
 
             if gcinterval > 0 :
-                StartGarbageCollector(block_store, gcinterval)
+                StartGarbageCollector(block_store, config['Ledger'], gcinterval)
             StartStorageService(config, block_store, service_keys)
         except Exception as e :
             logger.error('failed to start services; %s', str(e))
@@ -248,6 +269,7 @@ def Main() :
     parser.add_argument('--loglevel', help='Logging level', type=str)
 
     parser.add_argument('--http', help='Port on which to run the http server', type=int)
+    parser.add_argument('--ledger', help='Default url for connection to the ledger', type=str)
 
     options = parser.parse_args()
 
@@ -296,6 +318,14 @@ def Main() :
     if options.key_dir :
         config['Key']['SearchPath'] = options.key_dir
 
+    # set up the ledger configuration
+    if config.get('Ledger') is None :
+        config['Ledger'] = {
+            'LedgerURL' : 'http://localhost:6600',
+        }
+    if options.ledger :
+        config['Ledger']['LedgerURL'] = options.ledger
+
     # set up the storage service configuration
     if config.get('StorageService') is None :
         config['StorageService'] = {
@@ -66,6 +66,7 @@ class StoreBlocksApp(object) :
 
             minfo = json.loads(data)
             duration = minfo['duration']
+            contract_id = minfo.get('contract_id')
         except Exception as e :
             logger.exception('StoreBlocksApp')
             return ErrorResponse(start_response, "unknown exception while unpacking block store request")
@@ -75,6 +76,10 @@ class StoreBlocksApp(object) :
             # the need to make a copy of the data blocks
             block_list = self.block_data_iterator(request)
             block_hashes = self.block_store.store_blocks(block_list, duration=duration, encoding='b64')
+
+            # the garbage collector keeps the current state of the contract
+            if contract_id :
+                self.block_store.add_contracts([contract_id])
         except Exception as e :
             logger.exception('StoreBlocksApp')
             return ErrorResponse(start_response, "unknown exception while storing blocks")